@@ -40,6 +40,9 @@
 #include <string>
 #include "TAppDecCfg.h"
 #include "TAppCommon/program_options_lite.h"
+#if SIMD_KERNELS
+#include "TLibCommon/TComSimd.h"
+#endif
 #if SVC_EXTENSION
 #include <cassert>
 #endif
@@ -79,6 +82,9 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
 #endif
 
   string cfg_TargetDecLayerIdSetFile;
+#if SIMD_KERNELS
+  SimdLevel cfg_SimdLevel;
+#endif
 
   po::Options opts;
   opts.addOptions()
@@ -114,6 +120,15 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
   ("SEIpictureDigest", m_decodedPictureHashSEIEnabled, 1, "deprecated alias for SEIDecodedPictureHash")
   ("TarDecLayerIdSetFile,l", cfg_TargetDecLayerIdSetFile, string(""), "targetDecLayerIdSet file name. The file should include white space separated LayerId values to be decoded. Omitting the option or a value of -1 in the file decodes all layers.")
   ("RespectDefDispWindow,w", m_respectDefDispWindow, 0, "Only output content inside the default display window\n")
+#if ILR_ON_DEMAND_UPSAMPLING
+  ("OnDemandUpsampling", m_onDemandUpsampling, true, "Resample the inter-layer reference pictures by CTU rows when they are first referenced")
+#endif
+#if TOOL_THREAD_POOL
+  ("Threads", m_numThreads, 0, "Number of worker threads of the parallel decoding tools (0: none)")
+#endif
+#if SIMD_KERNELS
+  ("SIMD", cfg_SimdLevel, detectSimdLevel(), "Instruction set of the vectorised kernels: none, sse4, avx2 (default: best supported by the CPU)")
+#endif
 #if Q0074_COLOUR_REMAPPING_SEI
   ("SEIColourRemappingInfo", m_colourRemapSEIEnabled, false, "Control handling of Colour Remapping Information SEI messages\n"
                                               "\t1: apply colour remapping on decoded pictures if available in the bitstream\n"
@@ -164,6 +179,10 @@ Bool TAppDecCfg::parseCfg( Int argc, Char* argv[] )
     return false;
   }
 
+#if SIMD_KERNELS
+  setSimdLevel( cfg_SimdLevel );
+#endif
+
   if ( !cfg_TargetDecLayerIdSetFile.empty() )
   {
     FILE* targetDecLayerIdSetFile = fopen ( cfg_TargetDecLayerIdSetFile.c_str(), "r" );
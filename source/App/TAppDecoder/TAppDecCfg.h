@@ -85,6 +85,12 @@ protected:
 
   std::vector<Int> m_targetDecLayerIdSet;             ///< set of LayerIds to be included in the sub-bitstream extraction process.
   Int           m_respectDefDispWindow;               ///< Only output content inside the default display window 
+#if ILR_ON_DEMAND_UPSAMPLING
+  Bool          m_onDemandUpsampling;                 ///< resample the inter-layer reference pictures by CTU rows when they are first referenced
+#endif
+#if TOOL_THREAD_POOL
+  Int           m_numThreads;                         ///< number of worker threads of the parallel decoding tools, 0: none
+#endif
 #if OUTPUT_LAYER_SET_INDEX
   CommonDecoderParams             m_commonDecoderParams;
 #endif
@@ -111,6 +117,12 @@ public:
 #endif
 #endif
   , m_respectDefDispWindow(0)
+#if ILR_ON_DEMAND_UPSAMPLING
+  , m_onDemandUpsampling(true)
+#endif
+#if TOOL_THREAD_POOL
+  , m_numThreads(0)
+#endif
   {}
   virtual ~TAppDecCfg() {}
   
@@ -121,8 +121,14 @@ Void TAppDecTop::decode()
   Int                poc;
   TComList<TComPic*>* pcListPic = NULL;
 
+#if ANNEXB_MAPPED_INPUT
+  MappedFileBuffer bitstreamBuffer(m_pchBitstreamFile);
+  istream bitstreamFile(&bitstreamBuffer);
+  if (!bitstreamBuffer.isOpen())
+#else
   ifstream bitstreamFile(m_pchBitstreamFile, ifstream::in | ifstream::binary);
   if (!bitstreamFile)
+#endif
   {
     fprintf(stderr, "\nfailed to open bitstream file `%s' for reading\n", m_pchBitstreamFile);
     exit(EXIT_FAILURE);
@@ -363,8 +369,14 @@ Void TAppDecTop::decode()
   Int                 poc;
   TComList<TComPic*>* pcListPic = NULL;
 
+#if ANNEXB_MAPPED_INPUT
+  MappedFileBuffer bitstreamBuffer(m_pchBitstreamFile);
+  istream bitstreamFile(&bitstreamBuffer);
+  if (!bitstreamBuffer.isOpen())
+#else
   ifstream bitstreamFile(m_pchBitstreamFile, ifstream::in | ifstream::binary);
   if (!bitstreamFile)
+#endif
   {
     fprintf(stderr, "\nfailed to open bitstream file `%s' for reading\n", m_pchBitstreamFile);
     exit(EXIT_FAILURE);
@@ -512,6 +524,9 @@ Void TAppDecTop::decode()
 
 Void TAppDecTop::xCreateDecLib()
 {
+#if TOOL_THREAD_POOL
+  m_cThreadPool.create( m_numThreads );
+#endif
 #if SVC_EXTENSION
   // initialize global variables
   initROM();
@@ -557,6 +572,9 @@ Void TAppDecTop::xDestroyDecLib()
   // destroy decoder class
   m_cTDecTop.destroy();
 #endif
+#if TOOL_THREAD_POOL
+  m_cThreadPool.destroy();
+#endif
 }
 
 Void TAppDecTop::xInitDecLib()
@@ -571,6 +589,12 @@ Void TAppDecTop::xInitDecLib()
     m_acTDecTop[layer].setColourRemappingInfoSEIEnabled(m_colourRemapSEIEnabled);
 #endif
     m_acTDecTop[layer].setNumLayer( m_tgtLayerId + 1 );
+#if ILR_ON_DEMAND_UPSAMPLING
+    m_acTDecTop[layer].setOnDemandUpsampling( m_onDemandUpsampling );
+#endif
+#if TOOL_THREAD_POOL
+    m_acTDecTop[layer].setThreadPool( &m_cThreadPool );
+#endif
 #if OUTPUT_LAYER_SET_INDEX
     m_acTDecTop[layer].setCommonDecoderParams( this->getCommonDecoderParams() );
 #endif
@@ -581,6 +605,9 @@ Void TAppDecTop::xInitDecLib()
 #if Q0074_COLOUR_REMAPPING_SEI
   m_cTDecTop.setColourRemappingInfoSEIEnabled(m_colourRemapSEIEnabled);
 #endif
+#if TOOL_THREAD_POOL
+  m_cTDecTop.setThreadPool( &m_cThreadPool );
+#endif
 #endif
 }
 
@@ -671,6 +698,16 @@ TComSPS* activeSPS = m_acTDecTop[layerId].getActiveSPS();
       {
         // write to file
         numPicsNotYetDisplayed = numPicsNotYetDisplayed-2;
+#if DEC_PICTURE_PIPELINE
+        // the pictures decoded last may still be decoded or filtered
+#if SVC_EXTENSION
+        m_acTDecTop[layerId].waitForFinishedPicture( pcPicTop );
+        m_acTDecTop[layerId].waitForFinishedPicture( pcPicBottom );
+#else
+        m_cTDecTop.waitForFinishedPicture( pcPicTop );
+        m_cTDecTop.waitForFinishedPicture( pcPicBottom );
+#endif
+#endif
 #if SVC_EXTENSION
         if ( m_pchReconFile[layerId] )
         {
@@ -775,6 +812,14 @@ TComSPS* activeSPS = m_acTDecTop[layerId].getActiveSPS();
         {
           dpbFullness--;
         }
+#if DEC_PICTURE_PIPELINE
+        // the pictures decoded last may still be decoded or filtered
+#if SVC_EXTENSION
+        m_acTDecTop[layerId].waitForFinishedPicture( pcPic );
+#else
+        m_cTDecTop.waitForFinishedPicture( pcPic );
+#endif
+#endif
 #if SVC_EXTENSION
         if( m_pchReconFile[layerId] )
         {
@@ -854,6 +899,13 @@ Void TAppDecTop::xFlushOutput( TComList<TComPic*>* pcListPic )
   {
     return;
   }
+#if DEC_PICTURE_PIPELINE
+#if SVC_EXTENSION
+  m_acTDecTop[layerId].waitForFinishedPictures();
+#else
+  m_cTDecTop.waitForFinishedPictures();
+#endif
+#endif
   TComList<TComPic*>::iterator iterPic   = pcListPic->begin();
 
   iterPic   = pcListPic->begin();
@@ -1083,6 +1135,9 @@ Bool TAppDecTop::isNaluWithinTargetDecLayerIdSet( InputNALUnit* nalu )
 // Function outputs a picture, and marks it as not needed for output.
 Void TAppDecTop::xOutputAndMarkPic( TComPic *pic, const Char *reconFile, const Int layerIdx, Int &pocLastDisplay, DpbStatus &dpbStatus )
 {
+#if DEC_PICTURE_PIPELINE
+  m_acTDecTop[layerIdx].waitForFinishedPicture( pic );
+#endif
   if ( reconFile )
   {
     const Window &conf = pic->getConformanceWindow();
@@ -1187,6 +1242,13 @@ Void TAppDecTop::markAllPicturesAsErased()
 
 Void TAppDecTop::markAllPicturesAsErased(Int layerIdx)
 {
+#if DEC_PICTURE_PIPELINE
+  // the pictures of the layer may be read by the pictures of the higher layers being decoded
+  for( Int i = layerIdx; i < MAX_LAYERS; i++ )
+  {
+    m_acTDecTop[i].waitForFinishedPictures();
+  }
+#endif
   TComList<TComPic*>::iterator  iterPic = m_acTDecTop[layerIdx].getListPic()->begin();
   Int iSize = Int( m_acTDecTop[layerIdx].getListPic()->size() );
   
@@ -46,6 +46,9 @@
 #include "TLibCommon/TComList.h"
 #include "TLibCommon/TComPicYuv.h"
 #include "TLibDecoder/TDecTop.h"
+#if TOOL_THREAD_POOL
+#include "TLibCommon/TComThreadPool.h"
+#endif
 #include "TAppDecCfg.h"
 
 //! \ingroup TAppDecoder
@@ -70,6 +73,9 @@ private:
   TDecTop                         m_cTDecTop;                     ///< decoder class
   TVideoIOYuv                     m_cTVideoIOYuvReconFile;        ///< reconstruction YUV class
 #endif
+#if TOOL_THREAD_POOL
+  TComThreadPool                  m_cThreadPool;                  ///< worker threads of the parallel decoding tools
+#endif
   
   // for output control  
 #if SVC_EXTENSION
@@ -38,7 +38,11 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <time.h>
+#include <iostream>
 #include "TAppDecTop.h"
+#include "TAppCommon/program_options_lite.h"
+
+namespace po = df::program_options_lite;
 
 //! \ingroup TAppDecoder
 //! \{
@@ -69,9 +73,17 @@ int main(int argc, char* argv[])
   cTAppDecTop.create();
 
   // parse configuration
-  if(!cTAppDecTop.parseCfg( argc, argv ))
+  try
+  {
+    if(!cTAppDecTop.parseCfg( argc, argv ))
+    {
+      cTAppDecTop.destroy();
+      return 1;
+    }
+  }
+  catch (po::ParseFailure& e)
   {
-    cTAppDecTop.destroy();
+    std::cerr << "Error parsing option \""<< e.arg <<"\" with argument \""<< e.val <<"\"." << std::endl;
     return 1;
   }
 
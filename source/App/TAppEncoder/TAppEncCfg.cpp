@@ -869,6 +869,12 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("FastSearch",              m_iFastSearch,                1, "0:Full search  1:Diamond  2:PMVFAST")
   ("SearchRange,-sr",         m_iSearchRange,              96, "Motion search range")
   ("BipredSearchRange",       m_bipredSearchRange,          4, "Motion search range for bipred refinement")
+#if IL_MOTION_SEED
+  ("ILMotionSeed",            m_ilMotionSeed,               0, "EL motion search seeded with the BL motion 0:off  1:extra start points  2:and search range reduced to a quarter when it agrees with the predictor")
+#endif
+#if LOOKAHEAD_ME
+  ("LookaheadME",             m_lookaheadME,                0, "Hierarchical ME on downsampled source pictures 0:off  1:start points of the motion search  2:and TZ search radius reduced to a quarter")
+#endif
   ("HadamardME",              m_bUseHADME,               true, "Hadamard ME for fractional-pel")
   ("ASR",                     m_bUseASR,                false, "Adaptive motion search range")
 
@@ -909,6 +915,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 #endif
   ("RDOQ",                          m_useRDOQ,                  true )
   ("RDOQTS",                        m_useRDOQTS,                true )
+#if FAST_RDOQ
+  ("RDOQFast",                      m_useRDOQFast,             false, "Fast RDOQ: rates estimated at the start of the slice, coefficient groups in the dead zone of the quantiser are skipped")
+#endif
   ("RDpenalty",                     m_rdPenalty,                0,  "RD-penalty for 32x32 TU for intra in non-intra slices. 0:disbaled  1:RD-penalty  2:maximum RD-penalty")
   
   // Deblocking filter parameters
@@ -965,6 +974,18 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
   ("WaveFrontSynchro%d",          cfg_waveFrontSynchro,             0,  MAX_LAYERS,          "0: no synchro; 1 synchro with TR; 2 TRR etc")
 #else
   ("WaveFrontSynchro",            m_iWaveFrontSynchro,             0,          "0: no synchro; 1 synchro with TR; 2 TRR etc")
+#endif
+#if TOOL_THREAD_POOL
+  ("Threads",                     m_numThreads,                    0,          "Number of worker threads of the parallel coding tools (0: none)")
+#endif
+#if PARALLEL_ME
+  ("METhreads",                   m_numMEThreads,                  0,          "Number of reference pictures of a PU searched concurrently by the motion estimation of each layer (0, 1: serial), not used by the WPP worker threads")
+#endif
+#if SIMD_KERNELS
+  ("SIMD",                        m_simdLevel,          detectSimdLevel(),          "Instruction set of the vectorised kernels: none, sse4, avx2 (default: best supported by the CPU)")
+#endif
+#if FAST_YUV_IO
+  ("InputReadAhead",              m_inputReadAhead,                0,          "Number of frames of each input file read ahead in a background thread (0: frames are read when needed)")
 #endif
   ("ScalingList",                 m_useScalingListId,              0,          "0: no scaling list, 1: default scaling lists, 2: scaling lists specified in ScalingListFile")
   ("ScalingListFile",             cfg_ScalingListFile,             string(""), "Scaling list file name")
@@ -987,6 +1008,12 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 #if FAST_INTRA_SHVC
   ("FIS", m_useFastIntraScalable, false, "Fast Intra Decision for Scalable HEVC")
 #endif
+#if FAST_CU_SHVC
+  ("FCS", m_useFastCUScalable, false, "Fast CU Decision for Scalable HEVC: EL depths around the co-located BL depths, no AMP and intra for skipped BL blocks")
+#endif
+#if FAST_INTRA_SEARCH
+  ("FastIntraSearch", m_useFastIntraSearch, false, "Coarse to fine Hadamard pre-selection of the intra modes seeded with the gradient directions of the PU")
+#endif
 #if RC_SHVC_HARMONIZATION
   ("RateControl%d", cfg_RCEnableRateControl, false, MAX_LAYERS, "Rate control: enable rate control for layer %d")
   ("TargetBitrate%d", cfg_RCTargetBitRate, 0, MAX_LAYERS, "Rate control: target bitrate for layer %d")
@@ -1123,6 +1150,9 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
 #if M0040_ADAPTIVE_RESOLUTION_CHANGE
   ("AdaptiveResolutionChange",     m_adaptiveResolutionChange, 0, "Adaptive resolution change frame number. Should coincide with EL RAP picture. (0: disable)")
 #endif
+#if ENC_LAYER_PIPELINE
+  ("LayerPipeline",                m_layerPipeline, false, "Encode the enhancement layer picture of an access unit concurrently with the base layer picture of the next access unit")
+#endif
 #if HIGHER_LAYER_IRAP_SKIP_FLAG
   ("SkipPictureAtArcSwitch",     m_skipPictureAtArcSwitch, false, "Code the higher layer picture in ARC up-switching as a skip picture. (0: disable)")
 #endif
@@ -2303,6 +2333,18 @@ Bool TAppEncCfg::parseCfg( Int argc, Char* argv[] )
     }
   }
 #endif
+#if SIMD_KERNELS
+  setSimdLevel( m_simdLevel );
+#if SIMD_X86
+  if( getSimdLevel() != SIMD_NONE && !TComRdCost::checkSimdKernels() )
+  {
+    printf( "Warning: the vectorised distortion functions do not match the C code, SIMD is disabled\n" );
+    setSimdLevel( SIMD_NONE );
+  }
+#endif
+  m_simdLevel = getSimdLevel();
+#endif
+
   // check validity of input parameters
   xCheckParameter();
   
@@ -2389,6 +2431,21 @@ Void TAppEncCfg::xCheckParameter()
   xConfirmPara( m_iFastSearch < 0 || m_iFastSearch > 2,                                     "Fast Search Mode is not supported value (0:Full search  1:Diamond  2:PMVFAST)" );
   xConfirmPara( m_iSearchRange < 0 ,                                                        "Search Range must be more than 0" );
   xConfirmPara( m_bipredSearchRange < 0 ,                                                   "Search Range must be more than 0" );
+#if IL_MOTION_SEED
+  xConfirmPara( m_ilMotionSeed < 0 || m_ilMotionSeed > 2,                                   "ILMotionSeed must be 0, 1 or 2" );
+#endif
+#if LOOKAHEAD_ME
+  xConfirmPara( m_lookaheadME < 0 || m_lookaheadME > 2,                                     "LookaheadME must be 0, 1 or 2" );
+#endif
+#if PARALLEL_ME
+  {
+    // one helper thread per reference picture of both lists
+    const Int iMaxNumMEThreads = 2*MAX_NUM_REF;
+    std::ostringstream cOSS;
+    cOSS<<"METhreads must be in the range of 0 to "<<iMaxNumMEThreads;
+    xConfirmPara( m_numMEThreads < 0 || m_numMEThreads > iMaxNumMEThreads,                  cOSS.str().c_str() );
+  }
+#endif
   xConfirmPara( m_iMaxDeltaQP > 7,                                                          "Absolute Delta QP exceeds supported range (0 to 7)" );
 #if LAYER_CTB
   for(UInt layer = 0; layer < MAX_LAYERS; layer++)
@@ -3510,6 +3567,34 @@ Void TAppEncCfg::xCheckParameter()
 #if Q0048_CGS_3D_ASYMLUT
   xConfirmPara( m_nCGSFlag < 0 || m_nCGSFlag > 1 , "0<=CGS<=1" );
 #endif
+#if ENC_LAYER_PIPELINE
+  if( m_layerPipeline )
+  {
+    // each layer encodes with its own coding context, the adaptive QP buffer and the inter-layer WP parameters are still shared between the layers
+    Bool pipelineSupported = m_numLayers > 1 && !m_isField && !m_bUseAdaptQpSelect;
+#if LAYER_CTB
+    pipelineSupported = false;
+#endif
+#if M0040_ADAPTIVE_RESOLUTION_CHANGE
+    pipelineSupported &= m_adaptiveResolutionChange == 0;
+#endif
+#if VPS_AVC_BL_FLAG_REMOVAL
+    pipelineSupported &= !m_nonHEVCBaseLayerFlag;
+#endif
+#if O0194_WEIGHTED_PREDICTION_CGS
+    pipelineSupported &= !m_useInterLayerWeightedPred;
+#endif
+    for( UInt layer = 1; layer < m_numLayers; layer++ )
+    {
+      pipelineSupported &= m_acLayerCfg[layer].m_iIntraPeriod == m_acLayerCfg[0].m_iIntraPeriod;
+    }
+    if( !pipelineSupported )
+    {
+      printf("Warning: LayerPipeline requires frame-coded layers with equal intra periods and no ARC, AdaptiveQpSelection or inter-layer weighted prediction, layers are encoded sequentially\n");
+      m_layerPipeline = false;
+    }
+  }
+#endif
 #endif //SVC_EXTENSION
 #undef xConfirmPara
   if (check_failed)
@@ -3603,6 +3688,9 @@ Void TAppEncCfg::xPrintParameter()
 #if M0040_ADAPTIVE_RESOLUTION_CHANGE
   printf("Adaptive Resolution Change    : %d\n", m_adaptiveResolutionChange );
 #endif
+#if ENC_LAYER_PIPELINE
+  printf("Layer pipeline                : %d\n", m_layerPipeline );
+#endif
 #if HIGHER_LAYER_IRAP_SKIP_FLAG
   printf("Skip picture at ARC switch    : %d\n", m_skipPictureAtArcSwitch );
 #endif
@@ -3701,9 +3789,18 @@ Void TAppEncCfg::xPrintParameter()
   printf("HAD:%d ", m_bUseHADME           );
   printf("RDQ:%d ", m_useRDOQ            );
   printf("RDQTS:%d ", m_useRDOQTS        );
+#if FAST_RDOQ
+  printf("RDQFast:%d ", m_useRDOQFast    );
+#endif
   printf("RDpenalty:%d ", m_rdPenalty  );
   printf("SQP:%d ", m_uiDeltaQpRD         );
   printf("ASR:%d ", m_bUseASR             );
+#if IL_MOTION_SEED
+  printf("ILMS:%d ", m_ilMotionSeed       );
+#endif
+#if LOOKAHEAD_ME
+  printf("LAME:%d ", m_lookaheadME        );
+#endif
   printf("FEN:%d ", m_bUseFastEnc         );
   printf("ECU:%d ", m_bUseEarlyCU         );
   printf("FDM:%d ", m_useFastDecisionForMerge );
@@ -3711,6 +3808,12 @@ Void TAppEncCfg::xPrintParameter()
   printf("ESD:%d ", m_useEarlySkipDetection  );
 #if FAST_INTRA_SHVC
   printf("FIS:%d ", m_useFastIntraScalable  );
+#endif
+#if FAST_CU_SHVC
+  printf("FCS:%d ", m_useFastCUScalable  );
+#endif
+#if FAST_INTRA_SEARCH
+  printf("FISR:%d ", m_useFastIntraSearch  );
 #endif
   printf("RQT:%d ", 1     );
   printf("TransformSkip:%d ",     m_useTransformSkip              );
@@ -3772,6 +3875,18 @@ Void TAppEncCfg::xPrintParameter()
 #if R0179_ENC_OPT_3DLUT_SIZE
   printf("CGSSizeRDO:%d " , m_nCGSLutSizeRDO );
 #endif
+#if TOOL_THREAD_POOL
+  printf("Threads:%d " , m_numThreads );
+#endif
+#if PARALLEL_ME
+  printf("METhreads:%d " , m_numMEThreads );
+#endif
+#if SIMD_KERNELS
+  printf("SIMD:%s " , getSimdLevelName( m_simdLevel ) );
+#endif
+#if FAST_YUV_IO
+  printf("ReadAhead:%d " , m_inputReadAhead );
+#endif
 
   printf("\n\n");
   
@@ -41,6 +41,9 @@
 #include "TLibCommon/CommonDef.h"
 
 #include "TLibEncoder/TEncCfg.h"
+#if SIMD_KERNELS
+#include "TLibCommon/TComSimd.h"
+#endif
 #if SVC_EXTENSION
 #include "TAppEncLayerCfg.h"
 #endif
@@ -230,10 +233,22 @@ protected:
   Bool      m_bUseHADME;                                      ///< flag for using HAD in sub-pel ME
   Bool      m_useRDOQ;                                       ///< flag for using RD optimized quantization
   Bool      m_useRDOQTS;                                     ///< flag for using RD optimized quantization for transform skip
+#if FAST_RDOQ
+  Bool      m_useRDOQFast;                                   ///< flag for using the fast variant of the RD optimized quantization
+#endif
   Int       m_rdPenalty;                                      ///< RD-penalty for 32x32 TU for intra in non-intra slices (0: no RD-penalty, 1: RD-penalty, 2: maximum RD-penalty) 
   Int       m_iFastSearch;                                    ///< ME mode, 0 = full, 1 = diamond, 2 = PMVFAST
   Int       m_iSearchRange;                                   ///< ME search range
   Int       m_bipredSearchRange;                              ///< ME search range for bipred refinement
+#if IL_MOTION_SEED
+  Int       m_ilMotionSeed;                                   ///< EL ME seeded with the BL motion, 0 = off, 1 = start points, 2 = start points and reduced search range
+#endif
+#if LOOKAHEAD_ME
+  Int       m_lookaheadME;                                    ///< hierarchical ME on downsampled source pictures, 0 = off, 1 = start points, 2 = start points and reduced search range
+#endif
+#if PARALLEL_ME
+  Int       m_numMEThreads;                                   ///< number of concurrent motion searches of the reference pictures of a PU, 0 or 1 = serial
+#endif
   Bool      m_bUseFastEnc;                                    ///< flag for using fast encoder setting
   Bool      m_bUseEarlyCU;                                    ///< flag for using Early CU setting
   Bool      m_useFastDecisionForMerge;                        ///< flag for using Fast Decision Merge RD-Cost 
@@ -241,6 +256,12 @@ protected:
   Bool      m_useEarlySkipDetection;                         ///< flag for using Early SKIP Detection
 #if FAST_INTRA_SHVC
   Bool      m_useFastIntraScalable;                          ///< flag for using Fast Intra Decision for Scalable HEVC
+#endif
+#if FAST_CU_SHVC
+  Bool      m_useFastCUScalable;                             ///< flag for using Fast CU Decision for Scalable HEVC
+#endif
+#if FAST_INTRA_SEARCH
+  Bool      m_useFastIntraSearch;                            ///< flag for using the coarse to fine intra mode pre-selection
 #endif
   Int       m_sliceMode;                                     ///< 0: no slice limits, 1 : max number of CTBs per slice, 2: max number of bytes per slice, 
                                                              ///< 3: max number of tiles per slice
@@ -259,6 +280,15 @@ protected:
 #if !SVC_EXTENSION
   Int       m_iWaveFrontSynchro; //< 0: no WPP. >= 1: WPP is enabled, the "Top right" from which inheritance occurs is this LCU offset in the line above the current.
   Int       m_iWaveFrontSubstreams; //< If iWaveFrontSynchro, this is the number of substreams per frame (dependent tiles) or per tile (independent tiles).
+#endif
+#if TOOL_THREAD_POOL
+  Int       m_numThreads;                                     ///< number of worker threads of the parallel coding tools, 0: none
+#endif
+#if SIMD_KERNELS
+  SimdLevel m_simdLevel;                                      ///< instruction set of the vectorised kernels
+#endif
+#if FAST_YUV_IO
+  Int       m_inputReadAhead;                                 ///< number of input frames read ahead in a background thread, 0: none
 #endif
   Bool      m_bUseConstrainedIntraPred;                       ///< flag for using constrained intra prediction
   Int       m_decodedPictureHashSEIEnabled;                    ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
@@ -415,6 +445,9 @@ protected:
 #if M0040_ADAPTIVE_RESOLUTION_CHANGE
   Int       m_adaptiveResolutionChange;                       ///< Indicate adaptive resolution change frame
 #endif
+#if ENC_LAYER_PIPELINE
+  Bool      m_layerPipeline;                                  ///< encode the layers of consecutive access units concurrently
+#endif
 #if HIGHER_LAYER_IRAP_SKIP_FLAG
   Bool      m_skipPictureAtArcSwitch;                         ///< Indicates that when ARC up-switching is performed the higher layer picture is a skip picture
 #endif
@@ -74,6 +74,12 @@ TAppEncTop::~TAppEncTop()
 #if SVC_EXTENSION
 Void TAppEncTop::xInitLibCfg()
 {
+  // the layers of the encoder share the VPS held by the base layer encoder
+  for(UInt layer = 1; layer < m_numLayers; layer++)
+  {
+    m_acTEncTop[layer].shareVPS( m_acTEncTop[0].getVPS() );
+  }
+
   TComVPS* vps = m_acTEncTop[0].getVPS();
 
 #if P0297_VPS_POC_LSB_ALIGNED_FLAG
@@ -403,6 +409,15 @@ Void TAppEncTop::xInitLibCfg()
     m_acTEncTop[layer].setFastSearch                   ( m_iFastSearch  );
     m_acTEncTop[layer].setSearchRange                  ( m_iSearchRange );
     m_acTEncTop[layer].setBipredSearchRange            ( m_bipredSearchRange );
+#if IL_MOTION_SEED
+    m_acTEncTop[layer].setILMotionSeed                 ( m_ilMotionSeed );
+#endif
+#if LOOKAHEAD_ME
+    m_acTEncTop[layer].setLookaheadME                  ( m_lookaheadME );
+#endif
+#if PARALLEL_ME
+    m_acTEncTop[layer].setNumMEThreads                 ( m_numMEThreads );
+#endif
 
     //====== Quality control ========
     m_acTEncTop[layer].setMaxDeltaQP                   ( m_iMaxDeltaQP  );
@@ -425,6 +440,9 @@ Void TAppEncTop::xInitLibCfg()
     m_acTEncTop[layer].setdQPs                         ( m_acLayerCfg[layer].getdQPs() );
     m_acTEncTop[layer].setUseRDOQ                      ( m_useRDOQ     );
     m_acTEncTop[layer].setUseRDOQTS                    ( m_useRDOQTS   );
+#if FAST_RDOQ
+    m_acTEncTop[layer].setUseRDOQFast                  ( m_useRDOQFast );
+#endif
     m_acTEncTop[layer].setRDpenalty                    ( m_rdPenalty );
 #if LAYER_CTB
     m_acTEncTop[layer].setQuadtreeTULog2MaxSize        ( m_acLayerCfg[layer].m_uiQuadtreeTULog2MaxSize );
@@ -445,6 +463,12 @@ Void TAppEncTop::xInitLibCfg()
 #if FAST_INTRA_SHVC
     m_acTEncTop[layer].setUseFastIntraScalable         ( m_useFastIntraScalable );
 #endif
+#if FAST_CU_SHVC
+    m_acTEncTop[layer].setUseFastCUScalable            ( m_useFastCUScalable );
+#endif
+#if FAST_INTRA_SEARCH
+    m_acTEncTop[layer].setUseFastIntraSearch           ( m_useFastIntraSearch );
+#endif
 
     m_acTEncTop[layer].setUseTransformSkip             ( m_useTransformSkip      );
     m_acTEncTop[layer].setUseTransformSkipFast         ( m_useTransformSkipFast  );
@@ -714,6 +738,12 @@ Void TAppEncTop::xInitLibCfg()
 #if M0040_ADAPTIVE_RESOLUTION_CHANGE
     m_acTEncTop[layer].setAdaptiveResolutionChange( m_adaptiveResolutionChange );
 #endif
+#if ENC_LAYER_PIPELINE
+    m_acTEncTop[layer].setLayerPipeline( m_layerPipeline );
+#endif
+#if TOOL_THREAD_POOL
+    m_acTEncTop[layer].setThreadPool( &m_cThreadPool );
+#endif
 #if AUXILIARY_PICTURES
     m_acTEncTop[layer].setChromaFormatIDC( m_acLayerCfg[layer].m_chromaFormatIDC );
 #endif
@@ -766,6 +796,9 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setFrameOnlyConstraintFlag(m_frameOnlyConstraintFlag);
 
   m_cTEncTop.setFrameRate                    ( m_iFrameRate );
+#if TOOL_THREAD_POOL
+  m_cTEncTop.setThreadPool                   ( &m_cThreadPool );
+#endif
   m_cTEncTop.setFrameSkip                    ( m_FrameSkip );
   m_cTEncTop.setSourceWidth                  ( m_iSourceWidth );
   m_cTEncTop.setSourceHeight                 ( m_iSourceHeight );
@@ -808,6 +841,15 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setFastSearch                   ( m_iFastSearch  );
   m_cTEncTop.setSearchRange                  ( m_iSearchRange );
   m_cTEncTop.setBipredSearchRange            ( m_bipredSearchRange );
+#if IL_MOTION_SEED
+  m_cTEncTop.setILMotionSeed                 ( m_ilMotionSeed );
+#endif
+#if LOOKAHEAD_ME
+  m_cTEncTop.setLookaheadME                  ( m_lookaheadME );
+#endif
+#if PARALLEL_ME
+  m_cTEncTop.setNumMEThreads                 ( m_numMEThreads );
+#endif
 
   //====== Quality control ========
   m_cTEncTop.setMaxDeltaQP                   ( m_iMaxDeltaQP  );
@@ -830,6 +872,9 @@ Void TAppEncTop::xInitLibCfg()
   m_cTEncTop.setdQPs                         ( m_aidQP        );
   m_cTEncTop.setUseRDOQ                      ( m_useRDOQ     );
   m_cTEncTop.setUseRDOQTS                    ( m_useRDOQTS   );
+#if FAST_RDOQ
+  m_cTEncTop.setUseRDOQFast                  ( m_useRDOQFast );
+#endif
   m_cTEncTop.setRDpenalty                 ( m_rdPenalty );
   m_cTEncTop.setQuadtreeTULog2MaxSize        ( m_uiQuadtreeTULog2MaxSize );
   m_cTEncTop.setQuadtreeTULog2MinSize        ( m_uiQuadtreeTULog2MinSize );
@@ -843,6 +888,12 @@ Void TAppEncTop::xInitLibCfg()
 #if FAST_INTRA_SHVC
   m_cTEncTop.setUseFastIntraScalable            ( m_useFastIntraScalable );
 #endif
+#if FAST_CU_SHVC
+  m_cTEncTop.setUseFastCUScalable               ( m_useFastCUScalable );
+#endif
+#if FAST_INTRA_SEARCH
+  m_cTEncTop.setUseFastIntraSearch              ( m_useFastIntraSearch );
+#endif
 
   m_cTEncTop.setUseTransformSkip             ( m_useTransformSkip      );
   m_cTEncTop.setUseTransformSkipFast         ( m_useTransformSkipFast  );
@@ -1041,6 +1092,9 @@ Void TAppEncTop::xInitLibCfg()
 
 Void TAppEncTop::xCreateLib()
 {
+#if TOOL_THREAD_POOL
+  m_cThreadPool.create( m_numThreads );
+#endif
   // Video I/O
 #if SVC_EXTENSION
   // initialize global variables
@@ -1068,6 +1122,9 @@ Void TAppEncTop::xCreateLib()
     m_acTVideoIOYuvInputFile[layer].open( (Char *)m_acLayerCfg[layer].getInputFile().c_str(),  false, m_inputBitDepthY, m_inputBitDepthC, m_internalBitDepthY, m_internalBitDepthC );  // read  mode
 #endif
     m_acTVideoIOYuvInputFile[layer].skipFrames(m_FrameSkip, m_acLayerCfg[layer].getSourceWidth() - m_acLayerCfg[layer].getPad()[0], m_acLayerCfg[layer].getSourceHeight() - m_acLayerCfg[layer].getPad()[1]);
+#if FAST_YUV_IO
+    m_acTVideoIOYuvInputFile[layer].setReadAhead( m_inputReadAhead );
+#endif
 
     if (!m_acLayerCfg[layer].getReconFile().empty())
     {
@@ -1083,6 +1140,9 @@ Void TAppEncTop::xCreateLib()
 #else //SVC_EXTENSION
   m_cTVideoIOYuvInputFile.open( m_pchInputFile,     false, m_inputBitDepthY, m_inputBitDepthC, m_internalBitDepthY, m_internalBitDepthC );  // read  mode
   m_cTVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1]);
+#if FAST_YUV_IO
+  m_cTVideoIOYuvInputFile.setReadAhead( m_inputReadAhead );
+#endif
 
   if (m_pchReconFile)
     m_cTVideoIOYuvReconFile.open(m_pchReconFile, true, m_outputBitDepthY, m_outputBitDepthC, m_internalBitDepthY, m_internalBitDepthC);  // write mode
@@ -1120,6 +1180,9 @@ Void TAppEncTop::xDestroyLib()
   // Neo Decoder
   m_cTEncTop.destroy();
 #endif //SVC_EXTENSION
+#if TOOL_THREAD_POOL
+  m_cThreadPool.destroy();
+#endif
 }
 
 Void TAppEncTop::xInitLib(Bool isFieldCoding)
@@ -1931,16 +1994,17 @@ Void TAppEncTop::encode()
 
   list<AccessUnit> outputAccessUnits; ///< list of access units to write out.  is populated by the encoding process
 
+#if ENC_LAYER_PIPELINE
+  if( m_layerPipeline )
+  {
+    m_cLayerThreadPool.create( m_numLayers );
+  }
+#endif
+
   for(UInt layer=0; layer<m_numLayers; layer++)
   {
-#if O0194_DIFFERENT_BITDEPTH_EL_BL
-    //5
-    g_bitDepthY = m_acLayerCfg[layer].m_internalBitDepthY;
-    g_bitDepthC = m_acLayerCfg[layer].m_internalBitDepthC;
+    m_acTEncTop[layer].getCodingContext().bind();
 
-    g_uiPCMBitDepthLuma = m_bPCMInputBitDepthFlag ? m_acLayerCfg[layer].m_inputBitDepthY : m_acLayerCfg[layer].m_internalBitDepthY;
-    g_uiPCMBitDepthChroma = m_bPCMInputBitDepthFlag ? m_acLayerCfg[layer].m_inputBitDepthC : m_acLayerCfg[layer].m_internalBitDepthC;
-#endif
     // allocate original YUV buffer
     pcPicYuvOrg[layer] = new TComPicYuv;
     if( m_isField )
@@ -1994,20 +2058,7 @@ Void TAppEncTop::encode()
     {
       for(UInt layer=0; layer<m_numLayers; layer++)
       {
-#if O0194_DIFFERENT_BITDEPTH_EL_BL
-        //6
-        g_bitDepthY = m_acLayerCfg[layer].m_internalBitDepthY;
-        g_bitDepthC = m_acLayerCfg[layer].m_internalBitDepthC;
-
-        g_uiPCMBitDepthLuma = m_bPCMInputBitDepthFlag ? m_acLayerCfg[layer].m_inputBitDepthY : m_acLayerCfg[layer].m_internalBitDepthY;
-        g_uiPCMBitDepthChroma = m_bPCMInputBitDepthFlag ? m_acLayerCfg[layer].m_inputBitDepthC : m_acLayerCfg[layer].m_internalBitDepthC;
-#endif
-#if LAYER_CTB
-        g_uiMaxCUWidth  = g_auiLayerMaxCUWidth[layer];
-        g_uiMaxCUHeight = g_auiLayerMaxCUHeight[layer];
-        g_uiMaxCUDepth  = g_auiLayerMaxCUDepth[layer];
-        g_uiAddCUDepth  = g_auiLayerAddCUDepth[layer];
-#endif
+        m_acTEncTop[layer].getCodingContext().bind();
 
         // get buffers
         xGetBuffer(pcPicYuvRec, layer);
@@ -2077,31 +2128,24 @@ Void TAppEncTop::encode()
     }
 #endif
 
+#if ENC_LAYER_PIPELINE
+    if( m_layerPipeline )
+    {
+      TComPicYuv* pcPicYuvOrgGOP[MAX_LAYERS];
+      for(UInt layer=0; layer<m_numLayers; layer++)
+      {
+        pcPicYuvOrgGOP[layer] = flush ? 0 : pcPicYuvOrg[layer];
+      }
+      xEncodeLayersPipelined( pcPicYuvOrgGOP, bFirstFrame ? 1 : m_iGOPSize, outputAccessUnits );
+    }
+    else
+#endif
     // loop through frames in one GOP
     for ( UInt iPicIdInGOP=0; iPicIdInGOP < (bFirstFrame? 1:m_iGOPSize); iPicIdInGOP++ )
     {
-      // layer by layer for each frame
+      // layer by layer for each frame, the encoder of each layer switches to its own coding state
       for(UInt layer=0; layer<m_numLayers; layer++)
       {
-#if O0194_DIFFERENT_BITDEPTH_EL_BL
-        //7
-        g_bitDepthY = m_acLayerCfg[layer].m_internalBitDepthY;
-        g_bitDepthC = m_acLayerCfg[layer].m_internalBitDepthC;
-
-        g_uiPCMBitDepthLuma = m_bPCMInputBitDepthFlag ? m_acLayerCfg[layer].m_inputBitDepthY : m_acLayerCfg[layer].m_internalBitDepthY;
-        g_uiPCMBitDepthChroma = m_bPCMInputBitDepthFlag ? m_acLayerCfg[layer].m_inputBitDepthC : m_acLayerCfg[layer].m_internalBitDepthC;
-#endif
-#if LAYER_CTB
-        g_uiMaxCUWidth  = g_auiLayerMaxCUWidth[layer];
-        g_uiMaxCUHeight = g_auiLayerMaxCUHeight[layer];
-        g_uiMaxCUDepth  = g_auiLayerMaxCUDepth[layer];
-        g_uiAddCUDepth  = g_auiLayerAddCUDepth[layer];
-
-        memcpy( g_auiZscanToRaster, g_auiLayerZscanToRaster[layer], sizeof( g_auiZscanToRaster ) );
-        memcpy( g_auiRasterToZscan, g_auiLayerRasterToZscan[layer], sizeof( g_auiRasterToZscan ) );
-        memcpy( g_auiRasterToPelX,  g_auiLayerRasterToPelX[layer],  sizeof( g_auiRasterToPelX ) );
-        memcpy( g_auiRasterToPelY,  g_auiLayerRasterToPelY[layer],  sizeof( g_auiRasterToPelY ) );
-#endif
         // call encoding function for one frame
         if ( m_isField )
         {
@@ -2154,14 +2198,8 @@ Void TAppEncTop::encode()
     iTotalNumEncoded = 0;
     for(UInt layer=0; layer<m_numLayers; layer++)
     {
-#if O0194_DIFFERENT_BITDEPTH_EL_BL
-      //8
-      g_bitDepthY = m_acLayerCfg[layer].m_internalBitDepthY;
-      g_bitDepthC = m_acLayerCfg[layer].m_internalBitDepthC;
+      m_acTEncTop[layer].getCodingContext().bind();
 
-      g_uiPCMBitDepthLuma = m_bPCMInputBitDepthFlag ? m_acLayerCfg[layer].m_inputBitDepthY : m_acLayerCfg[layer].m_internalBitDepthY;
-      g_uiPCMBitDepthChroma = m_bPCMInputBitDepthFlag ? m_acLayerCfg[layer].m_inputBitDepthC : m_acLayerCfg[layer].m_internalBitDepthC;
-#endif
       // write bistream to file if necessary
       iNumEncoded = m_acTEncTop[layer].getNumPicRcvd();
       if ( iNumEncoded > 0 )
@@ -2212,6 +2250,9 @@ Void TAppEncTop::encode()
     // delete used buffers in encoder class
     m_acTEncTop[layer].deletePicBuffer();
   }
+#if ENC_LAYER_PIPELINE
+  m_cLayerThreadPool.destroy();
+#endif
 
   // delete buffers & classes
   xDeleteBuffer();
@@ -2222,6 +2263,38 @@ Void TAppEncTop::encode()
   return;
 }
 
+#if ENC_LAYER_PIPELINE
+/**
+ - each layer encodes its pictures of the GOP in a separate thread
+ - the layer encoders synchronise on the reconstruction of the reference layer picture of the same access unit
+ - access units are collected per picture and layer and appended in the order of sequential encoding
+ .
+ */
+Void TAppEncTop::xEncodeLayersPipelined(TComPicYuv** pcPicYuvOrg, UInt numPicsInGOP, list<AccessUnit>& accessUnits)
+{
+  std::vector< list<AccessUnit> > layerAccessUnits( numPicsInGOP * m_numLayers );
+
+  for(UInt layer=0; layer<m_numLayers; layer++)
+  {
+    m_cLayerThreadPool.addJob( std::bind( &TAppEncTop::xEncodeLayerGOP, this, layer, pcPicYuvOrg[layer], numPicsInGOP, &layerAccessUnits[0] ) );
+  }
+  m_cLayerThreadPool.waitForAll();
+
+  for(UInt i=0; i<layerAccessUnits.size(); i++)
+  {
+    accessUnits.splice( accessUnits.end(), layerAccessUnits[i] );
+  }
+}
+
+Void TAppEncTop::xEncodeLayerGOP(UInt layer, TComPicYuv* pcPicYuvOrg, UInt numPicsInGOP, list<AccessUnit>* pcAccessUnits)
+{
+  for( UInt iPicIdInGOP=0; iPicIdInGOP < numPicsInGOP; iPicIdInGOP++ )
+  {
+    m_acTEncTop[layer].encode( pcPicYuvOrg, m_acListPicYuvRec[layer], pcAccessUnits[iPicIdInGOP * m_numLayers + layer], iPicIdInGOP );
+  }
+}
+#endif
+
 Void TAppEncTop::printOutSummary(Bool isField)
 {
   UInt layer;
@@ -65,6 +65,9 @@ private:
   TVideoIOYuv                m_acTVideoIOYuvReconFile [MAX_LAYERS];       ///< output reconstruction file
 
   TComList<TComPicYuv*>      m_acListPicYuvRec [MAX_LAYERS];              ///< list of reconstruction YUV files
+#if ENC_LAYER_PIPELINE
+  TComThreadPool             m_cLayerThreadPool;                          ///< one thread per layer for pipelined encoding
+#endif
 #else
   TEncTop                    m_cTEncTop;                    ///< encoder class
   TVideoIOYuv                m_cTVideoIOYuvInputFile;       ///< input YUV file
@@ -72,6 +75,9 @@ private:
   
   TComList<TComPicYuv*>      m_cListPicYuvRec;              ///< list of reconstruction YUV files
 #endif
+#if TOOL_THREAD_POOL
+  TComThreadPool             m_cThreadPool;                 ///< worker threads of the parallel coding tools
+#endif
   
   Int                        m_iFrameRcvd;                  ///< number of received frames
   
@@ -96,6 +102,10 @@ protected:
   
   // file I/O
 #if SVC_EXTENSION
+#if ENC_LAYER_PIPELINE
+  Void xEncodeLayersPipelined(TComPicYuv** pcPicYuvOrg, UInt numPicsInGOP, std::list<AccessUnit>& accessUnits); ///< encode one GOP of all layers concurrently
+  Void xEncodeLayerGOP(UInt layer, TComPicYuv* pcPicYuvOrg, UInt numPicsInGOP, std::list<AccessUnit>* pcAccessUnits);
+#endif
   Void xWriteRecon(UInt layer, Int iNumEncoded);
   Void xWriteStream(std::ostream& bitstreamFile, Int iNumEncoded, const std::list<AccessUnit>& accessUnits);
   Void printOutSummary(Bool isField);
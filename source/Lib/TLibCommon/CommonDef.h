@@ -99,6 +99,12 @@
 
 #define NVM_BITS          "[%d bit] ", (sizeof(void*) == 8 ? 64 : 32) ///< used for checking 64-bit O/S
 
+#ifdef _MSC_VER
+#define THREAD_LOCAL      __declspec(thread)    ///< storage class of trivially constructible coding state owned by the thread of an encoder/decoder instance
+#else
+#define THREAD_LOCAL      __thread
+#endif
+
 #ifndef NULL
 #define NULL              0
 #endif
@@ -128,17 +134,17 @@
 // ====================================================================================================================
 // Macro functions
 // ====================================================================================================================
-extern Int g_bitDepthY;
-extern Int g_bitDepthC;
+extern THREAD_LOCAL Int g_bitDepthY;
+extern THREAD_LOCAL Int g_bitDepthC;
 #if O0194_DIFFERENT_BITDEPTH_EL_BL
-extern Int  g_bitDepthYLayer[MAX_LAYERS];
-extern Int  g_bitDepthCLayer[MAX_LAYERS];
+extern THREAD_LOCAL Int  g_bitDepthYLayer[MAX_LAYERS];
+extern THREAD_LOCAL Int  g_bitDepthCLayer[MAX_LAYERS];
 
-extern UInt g_uiPCMBitDepthLumaDec[MAX_LAYERS];    // PCM bit-depth
-extern UInt g_uiPCMBitDepthChromaDec[MAX_LAYERS];    // PCM bit-depth
+extern THREAD_LOCAL UInt g_uiPCMBitDepthLumaDec[MAX_LAYERS];    // PCM bit-depth
+extern THREAD_LOCAL UInt g_uiPCMBitDepthChromaDec[MAX_LAYERS];    // PCM bit-depth
 #endif
 #if O0194_WEIGHTED_PREDICTION_CGS
-extern void* g_refWeightACDCParam; //type:wpACDCParam
+extern THREAD_LOCAL void* g_refWeightACDCParam; //type:wpACDCParam
 #endif
 /** clip x, such that 0 <= x <= #g_maxLumaVal */
 template <typename T> inline T ClipY(T x) { return std::min<T>(T((1 << g_bitDepthY)-1), std::max<T>( T(0), x)); }
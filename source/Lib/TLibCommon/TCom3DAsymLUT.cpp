@@ -7,6 +7,13 @@
 #include "TypeDef.h"
 #include "TCom3DAsymLUT.h"
 #include "TComPicYuv.h"
+#include "TComSimd.h"
+#if TOOL_THREAD_POOL
+#include "TComThreadPool.h"
+#endif
+#if SIMD_X86
+#include <immintrin.h>
+#endif
 
 #if Q0048_CGS_3D_ASYMLUT
 
@@ -109,36 +116,255 @@ Void TCom3DAsymLUT::xUpdatePartitioning( Int nCurOctantDepth , Int nCurYPartNumL
 #endif
 }
 
+#if TOOL_THREAD_POOL
+Void TCom3DAsymLUT::colorMapping( TComPicYuv * pcPic, TComPicYuv * pcPicDst, TComThreadPool * pcThreadPool )
+#else
 Void TCom3DAsymLUT::colorMapping( TComPicYuv * pcPic, TComPicYuv * pcPicDst )
+#endif
 {
-  Int nWidth = pcPic->getWidth();
+  // alignment padding
+  pcPic->setBorderExtension( false );
+  pcPic->extendPicBorder();
+
+#if R0151_CGS_3D_ASYMLUT_IMPROVE
+  // coefficients of the cuboids indexed by ( yIdx * USize + uIdx ) * VSize + vIdx, gathered by the vectorised mapping
+  Int nNumCuboids = m_nYSize * m_nUSize * m_nVSize;
+  for( Int c = 0 ; c < 3 ; c++ )
+  {
+    for( Int k = 0 ; k < 4 ; k++ )
+    {
+      m_aiCuboidCoeff[c][k].resize( nNumCuboids );
+    }
+  }
+  for( Int yIdx = 0 ; yIdx < m_nYSize ; yIdx++ )
+  {
+    for( Int uIdx = 0 ; uIdx < m_nUSize ; uIdx++ )
+    {
+      for( Int vIdx = 0 ; vIdx < m_nVSize ; vIdx++ )
+      {
+        const SCuboid & rCuboid = m_pCuboid[yIdx][uIdx][vIdx];
+        Int idx = ( yIdx * m_nUSize + uIdx ) * m_nVSize + vIdx;
+        for( Int k = 0 ; k < 4 ; k++ )
+        {
+          m_aiCuboidCoeff[0][k][idx] = rCuboid.P[k].Y;
+          m_aiCuboidCoeff[1][k][idx] = rCuboid.P[k].U;
+          m_aiCuboidCoeff[2][k][idx] = rCuboid.P[k].V;
+        }
+      }
+    }
+  }
+#endif
+
   Int nHeight = pcPic->getHeight();
+#if TOOL_THREAD_POOL
+  if( pcThreadPool && pcThreadPool->getNumThreads() > 1 )
+  {
+    // one band per worker, the bands have an even number of rows as a chroma row is mapped with a pair of luma rows
+    Int nNumBands   = std::min<Int>( pcThreadPool->getNumThreads(), nHeight >> 1 );
+    Int nBandHeight = ( ( ( nHeight >> 1 ) + nNumBands - 1 ) / nNumBands ) << 1;
+    TComSyncCounter cDone;
+    Int nNumJobs = 0;
+    for( Int y = 0 ; y < nHeight ; y += nBandHeight, nNumJobs++ )
+    {
+      pcThreadPool->addJob( std::bind( &TCom3DAsymLUT::xMapRowsJob, this, pcPic, pcPicDst, y, std::min<Int>( y + nBandHeight, nHeight ), &cDone ) );
+    }
+    cDone.waitFor( nNumJobs );
+    return;
+  }
+#endif
+  xMapRows( pcPic, pcPicDst, 0, nHeight );
+}
+
+#if TOOL_THREAD_POOL
+Void TCom3DAsymLUT::xMapRowsJob( TComPicYuv * pcPic , TComPicYuv * pcPicDst , Int yStart , Int yEnd , TComSyncCounter * pcDone )
+{
+  xMapRows( pcPic, pcPicDst, yStart, yEnd );
+  pcDone->increment();
+}
+#endif
+
+#if SIMD_X86 && R0151_CGS_3D_ASYMLUT_IMPROVE
+/// cuboid look-up and mapping parameters of the vectorised colour mapping
+struct TComColorMappingParam
+{
+  const Int * coeff[3][4];  ///< cuboid coefficients per component and vertex
+  Int   yShift2Idx;
+  Int   uShift2Idx;
+  Int   vShift2Idx;
+  Bool  adaptC;             ///< two chroma partitions split at the adaptive thresholds
+  Int   thresholdU;
+  Int   thresholdV;
+  Int   uSize;
+  Int   vSize;
+  Int   mappingOffset;
+  Int   mappingShift;
+  Int   maxValY;
+  Int   maxValC;
+};
+
+/** Flat cuboid index of 8 samples, as xGetYIdx(), xGetUIdx() and xGetVIdx()
+ */
+SIMD_TARGET_AVX2
+static inline __m256i xCuboidIdxAVX2( const TComColorMappingParam & p , __m256i y , __m256i u , __m256i v )
+{
+  __m256i yIdx = _mm256_sra_epi32( y, _mm_cvtsi32_si128( p.yShift2Idx ) );
+  __m256i uIdx, vIdx;
+  if( p.adaptC )
+  {
+    uIdx = _mm256_sub_epi32( _mm256_setzero_si256(), _mm256_cmpgt_epi32( u, _mm256_set1_epi32( p.thresholdU - 1 ) ) );
+    vIdx = _mm256_sub_epi32( _mm256_setzero_si256(), _mm256_cmpgt_epi32( v, _mm256_set1_epi32( p.thresholdV - 1 ) ) );
+  }
+  else
+  {
+    uIdx = _mm256_sra_epi32( u, _mm_cvtsi32_si128( p.uShift2Idx ) );
+    vIdx = _mm256_sra_epi32( v, _mm_cvtsi32_si128( p.vShift2Idx ) );
+  }
+  __m256i idx = _mm256_add_epi32( _mm256_mullo_epi32( yIdx, _mm256_set1_epi32( p.uSize ) ), uIdx );
+  return _mm256_add_epi32( _mm256_mullo_epi32( idx, _mm256_set1_epi32( p.vSize ) ), vIdx );
+}
+
+/** Map one component of 8 samples, as xMapY() and xMapUV(): the result is converted to Pel and clipped
+ */
+SIMD_TARGET_AVX2
+static inline __m256i xMapCompAVX2( const TComColorMappingParam & p , const Int * const * coeff , __m256i idx , __m256i y , __m256i u , __m256i v , Int maxVal )
+{
+  __m256i sum = _mm256_set1_epi32( p.mappingOffset );
+  sum = _mm256_add_epi32( sum, _mm256_mullo_epi32( _mm256_i32gather_epi32( coeff[0], idx, 4 ), y ) );
+  sum = _mm256_add_epi32( sum, _mm256_mullo_epi32( _mm256_i32gather_epi32( coeff[1], idx, 4 ), u ) );
+  sum = _mm256_add_epi32( sum, _mm256_mullo_epi32( _mm256_i32gather_epi32( coeff[2], idx, 4 ), v ) );
+  sum = _mm256_add_epi32( _mm256_sra_epi32( sum, _mm_cvtsi32_si128( p.mappingShift ) ), _mm256_i32gather_epi32( coeff[3], idx, 4 ) );
+  sum = _mm256_srai_epi32( _mm256_slli_epi32( sum, 16 ), 16 );
+  return _mm256_min_epi32( _mm256_max_epi32( sum, _mm256_setzero_si256() ), _mm256_set1_epi32( maxVal ) );
+}
+
+SIMD_TARGET_AVX2
+static inline __m256i xLoadChromaAVX2( const Pel * p )
+{
+  return _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)p ) );
+}
+
+/** Map a pair of luma rows and the co-located chroma row by 8 chroma columns, bit-exact with the C code of xMapRows()
+ * \returns number of mapped chroma columns
+ */
+SIMD_TARGET_AVX2
+static Int xMapRowPairAVX2( const TComColorMappingParam & p , const Pel * pY , Int nStrideY , const Pel * pU , const Pel * pV , const Pel * pUPrev , const Pel * pVPrev , const Pel * pUNext , const Pel * pVNext ,
+                            Pel * pYDst , Int nDstStrideY , Pel * pUDst , Pel * pVDst , Int nWidthC )
+{
+  const __m256i two  = _mm256_set1_epi32( 2 );
+  const __m256i four = _mm256_set1_epi32( 4 );
+  const Int nWidthC8 = nWidthC & ~7;
+
+  for( Int xC = 0 ; xC < nWidthC8 ; xC += 8 )
+  {
+    // luma samples of the even and odd columns
+    __m256i r0 = _mm256_loadu_si256( (const __m256i*)( pY + ( xC << 1 ) ) );
+    __m256i r1 = _mm256_loadu_si256( (const __m256i*)( pY + ( xC << 1 ) + nStrideY ) );
+    __m256i y00 = _mm256_srai_epi32( _mm256_slli_epi32( r0, 16 ), 16 );
+    __m256i y01 = _mm256_srai_epi32( r0, 16 );
+    __m256i y10 = _mm256_srai_epi32( _mm256_slli_epi32( r1, 16 ), 16 );
+    __m256i y11 = _mm256_srai_epi32( r1, 16 );
+
+    // chroma phase alignment
+    __m256i u  = xLoadChromaAVX2( pU + xC );
+    __m256i v  = xLoadChromaAVX2( pV + xC );
+    __m256i u3 = _mm256_add_epi32( _mm256_add_epi32( u, u ), u );
+    __m256i v3 = _mm256_add_epi32( _mm256_add_epi32( v, v ), v );
+    __m256i a  = _mm256_add_epi32( xLoadChromaAVX2( pU + xC + 1 ), u );
+    __m256i b  = _mm256_add_epi32( xLoadChromaAVX2( pV + xC + 1 ), v );
+    __m256i a3 = _mm256_add_epi32( _mm256_add_epi32( a, a ), a );
+    __m256i b3 = _mm256_add_epi32( _mm256_add_epi32( b, b ), b );
+
+    __m256i uP = xLoadChromaAVX2( pUPrev + xC );
+    __m256i vP = xLoadChromaAVX2( pVPrev + xC );
+    __m256i tmpU00 = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( uP, u3 ), two ), 2 );
+    __m256i tmpV00 = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( vP, v3 ), two ), 2 );
+    __m256i tmpU01 = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( a3, uP ), _mm256_add_epi32( xLoadChromaAVX2( pUPrev + xC + 1 ), four ) ), 3 );
+    __m256i tmpV01 = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( b3, vP ), _mm256_add_epi32( xLoadChromaAVX2( pVPrev + xC + 1 ), four ) ), 3 );
+
+    __m256i uN = xLoadChromaAVX2( pUNext + xC );
+    __m256i vN = xLoadChromaAVX2( pVNext + xC );
+    __m256i tmpU10 = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( uN, u3 ), two ), 2 );
+    __m256i tmpV10 = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( vN, v3 ), two ), 2 );
+    __m256i tmpU11 = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( a3, uN ), _mm256_add_epi32( xLoadChromaAVX2( pUNext + xC + 1 ), four ) ), 3 );
+    __m256i tmpV11 = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( b3, vN ), _mm256_add_epi32( xLoadChromaAVX2( pVNext + xC + 1 ), four ) ), 3 );
+
+    __m256i d00 = xMapCompAVX2( p, p.coeff[0], xCuboidIdxAVX2( p, y00, tmpU00, tmpV00 ), y00, tmpU00, tmpV00, p.maxValY );
+    __m256i d01 = xMapCompAVX2( p, p.coeff[0], xCuboidIdxAVX2( p, y01, tmpU01, tmpV01 ), y01, tmpU01, tmpV01, p.maxValY );
+    __m256i d10 = xMapCompAVX2( p, p.coeff[0], xCuboidIdxAVX2( p, y10, tmpU10, tmpV10 ), y10, tmpU10, tmpV10, p.maxValY );
+    __m256i d11 = xMapCompAVX2( p, p.coeff[0], xCuboidIdxAVX2( p, y11, tmpU11, tmpV11 ), y11, tmpU11, tmpV11, p.maxValY );
+    _mm256_storeu_si256( (__m256i*)( pYDst + ( xC << 1 ) ),               _mm256_or_si256( d00, _mm256_slli_epi32( d01, 16 ) ) );
+    _mm256_storeu_si256( (__m256i*)( pYDst + ( xC << 1 ) + nDstStrideY ), _mm256_or_si256( d10, _mm256_slli_epi32( d11, 16 ) ) );
+
+    __m256i yAver = _mm256_srai_epi32( _mm256_add_epi32( _mm256_add_epi32( y00, y10 ), _mm256_set1_epi32( 1 ) ), 1 );
+    __m256i idxC  = xCuboidIdxAVX2( p, yAver, u, v );
+    __m256i dU    = xMapCompAVX2( p, p.coeff[1], idxC, yAver, u, v, p.maxValC );
+    __m256i dV    = xMapCompAVX2( p, p.coeff[2], idxC, yAver, u, v, p.maxValC );
+    _mm_storeu_si128( (__m128i*)( pUDst + xC ), _mm_packs_epi32( _mm256_castsi256_si128( dU ), _mm256_extracti128_si256( dU, 1 ) ) );
+    _mm_storeu_si128( (__m128i*)( pVDst + xC ), _mm_packs_epi32( _mm256_castsi256_si128( dV ), _mm256_extracti128_si256( dV, 1 ) ) );
+  }
+  return nWidthC8;
+}
+#endif
+
+/** Map the luma rows yStart to yEnd-1 and the co-located chroma rows, yStart and yEnd are even
+ */
+Void TCom3DAsymLUT::xMapRows( TComPicYuv * pcPic , TComPicYuv * pcPicDst , Int yStart , Int yEnd )
+{
+  Int nWidth = pcPic->getWidth();
   Int nStrideY = pcPic->getStride();
   Int nStrideC = pcPic->getCStride();
-  Pel * pY = pcPic->getLumaAddr();
-  Pel * pU = pcPic->getCbAddr();
-  Pel * pV = pcPic->getCrAddr();
+  Pel * pY = pcPic->getLumaAddr() + yStart * nStrideY;
+  Pel * pU = pcPic->getCbAddr() + ( yStart >> 1 ) * nStrideC;
+  Pel * pV = pcPic->getCrAddr() + ( yStart >> 1 ) * nStrideC;
 
   Int nDstStrideY = pcPicDst->getStride();
   Int nDstStrideC = pcPicDst->getCStride();
-  Pel * pYDst = pcPicDst->getLumaAddr();
-  Pel * pUDst = pcPicDst->getCbAddr();
-  Pel * pVDst = pcPicDst->getCrAddr();
+  Pel * pYDst = pcPicDst->getLumaAddr() + yStart * nDstStrideY;
+  Pel * pUDst = pcPicDst->getCbAddr() + ( yStart >> 1 ) * nDstStrideC;
+  Pel * pVDst = pcPicDst->getCrAddr() + ( yStart >> 1 ) * nDstStrideC;
 
-  Pel *pUPrev = pU;
-  Pel *pVPrev = pV;
+  Pel *pUPrev = yStart > 0 ? pU - nStrideC : pU;
+  Pel *pVPrev = yStart > 0 ? pV - nStrideC : pV;
   Pel *pUNext = pU+nStrideC;
   Pel *pVNext = pV+nStrideC;
 
-  // alignment padding
-  pcPic->setBorderExtension( false );
-  pcPic->extendPicBorder();
-
   Pel iMaxValY = (1<<getOutputBitDepthY())-1;
   Pel iMaxValC = (1<<getOutputBitDepthC())-1;
-  for( Int y = 0 ; y < nHeight ; y += 2 )
+
+#if SIMD_X86 && R0151_CGS_3D_ASYMLUT_IMPROVE
+  Bool bAVX2 = getSimdLevel() >= SIMD_AVX2;
+  TComColorMappingParam cParam;
+  for( Int c = 0 ; c < 3 ; c++ )
   {
-    for( Int xY = 0 , xC = 0 ; xY < nWidth ; xY += 2 , xC++ )
+    for( Int k = 0 ; k < 4 ; k++ )
+    {
+      cParam.coeff[c][k] = &m_aiCuboidCoeff[c][k][0];
+    }
+  }
+  cParam.yShift2Idx    = m_nYShift2Idx;
+  cParam.uShift2Idx    = m_nUShift2Idx;
+  cParam.vShift2Idx    = m_nVShift2Idx;
+  cParam.adaptC        = m_nCurOctantDepth == 1;
+  cParam.thresholdU    = m_nAdaptCThresholdU;
+  cParam.thresholdV    = m_nAdaptCThresholdV;
+  cParam.uSize         = m_nUSize;
+  cParam.vSize         = m_nVSize;
+  cParam.mappingOffset = m_nMappingOffset;
+  cParam.mappingShift  = m_nMappingShift;
+  cParam.maxValY       = iMaxValY;
+  cParam.maxValC       = iMaxValC;
+#endif
+
+  for( Int y = yStart ; y < yEnd ; y += 2 )
+  {
+    Int xC0 = 0;
+#if SIMD_X86 && R0151_CGS_3D_ASYMLUT_IMPROVE
+    if( bAVX2 )
+    {
+      xC0 = xMapRowPairAVX2( cParam, pY, nStrideY, pU, pV, pUPrev, pVPrev, pUNext, pVNext, pYDst, nDstStrideY, pUDst, pVDst, nWidth >> 1 );
+    }
+#endif
+    for( Int xY = xC0 << 1 , xC = xC0 ; xY < nWidth ; xY += 2 , xC++ )
     {
       Pel srcY00 = pY[xY];
       Pel srcY01 = pY[xY+1];
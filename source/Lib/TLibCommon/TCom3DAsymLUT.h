@@ -3,9 +3,9 @@
 #define __TCOM3DASYMLUT__
 
 #include "TypeDef.h"
+#include <vector>
 #if R0150_CGS_SIGNAL_CONSTRAINTS
 #include <cassert>
-#include <vector>
 #endif
 
 #if Q0048_CGS_3D_ASYMLUT
@@ -21,6 +21,10 @@ typedef struct _SCuboid // vertexes for tetrahedral interpolation
 }SCuboid;
 
 class TComPicYuv;
+#if TOOL_THREAD_POOL
+class TComThreadPool;
+class TComSyncCounter;
+#endif
 
 class TCom3DAsymLUT
 {
@@ -71,7 +75,11 @@ public:
   Int   getMaxCSize() { return 1<<m_nMaxOctantDepth; }
 #endif 
 
+#if TOOL_THREAD_POOL
+  Void  colorMapping( TComPicYuv * pcPicSrc,  TComPicYuv * pcPicDst, TComThreadPool * pcThreadPool = NULL );
+#else
   Void  colorMapping( TComPicYuv * pcPicSrc,  TComPicYuv * pcPicDst );
+#endif
   Void  copy3DAsymLUT( TCom3DAsymLUT * pSrc );
 
   SYUVP xGetCuboidVertexPredAll( Int yIdx , Int uIdx , Int vIdx , Int nVertexIdx , SCuboid *** pCurCuboid=NULL );
@@ -123,6 +131,9 @@ private:
   Bool  *** m_pCuboidExplicit;
   Bool  *** m_pCuboidFilled;
 #endif
+#if R0151_CGS_3D_ASYMLUT_IMPROVE
+  std::vector<Int> m_aiCuboidCoeff[3][4];  ///< cuboid coefficients per component and vertex, in the order of the flat cuboid index used by the vectorised mapping
+#endif
 
 protected:
   template <class T> 
@@ -140,6 +151,10 @@ protected:
   SYUVP xGetCuboidVertexPredA( Int yIdx , Int uIdx , Int vIdx , Int nVertexIdx );
   Pel   xMapY( Pel y , Pel u , Pel v );
   SYUVP xMapUV( Pel y , Pel u , Pel v );
+  Void  xMapRows( TComPicYuv * pcPic , TComPicYuv * pcPicDst , Int yStart , Int yEnd );
+#if TOOL_THREAD_POOL
+  Void  xMapRowsJob( TComPicYuv * pcPic , TComPicYuv * pcPicDst , Int yStart , Int yEnd , TComSyncCounter * pcDone );
+#endif
   Int   xGetMaxPartNumLog2()  { return m_nMaxPartNumLog2; }
   Int   xGetYSize()  { return m_nYSize;  }
   Int   xGetUSize()  { return m_nUSize;  }
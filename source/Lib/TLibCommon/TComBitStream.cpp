@@ -352,6 +352,17 @@ TComInputBitstream *TComInputBitstream::extractSubstream( UInt uiNumBits )
   UInt uiNumBytes = uiNumBits/8;
   std::vector<uint8_t>* buf = new std::vector<uint8_t>;
   UInt uiByte;
+#if DEC_CABAC_64BIT_WINDOW
+  if (m_num_held_bits == 0)
+  {
+    // byte aligned: copy the whole bytes at once
+    assert(m_fifo_idx + uiNumBytes <= m_fifo->size());
+    buf->assign(m_fifo->begin() + m_fifo_idx, m_fifo->begin() + m_fifo_idx + uiNumBytes);
+    m_fifo_idx    += uiNumBytes;
+    m_numBitsRead += 8 * uiNumBytes;
+  }
+  else
+#endif
   for (UInt ui = 0; ui < uiNumBytes; ui++)
   {
     read(8, uiByte);
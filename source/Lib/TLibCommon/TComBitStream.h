@@ -197,6 +197,37 @@ public:
     assert(m_fifo_idx > 0);
     byte = (*m_fifo)[m_fifo_idx - 1];
   }
+#if DEC_CABAC_64BIT_WINDOW
+
+  /** Read up to 4 whole bytes as a big-endian word, the bytes past the end of the fifo are read as zero
+   *  (the read index still moves past them, so that rewindBytes() can return them)
+   */
+  UInt        readBytes       ( UInt uiNumBytes )
+  {
+    assert( uiNumBytes <= 4 && m_num_held_bits == 0 );
+    UInt uiWord = 0;
+    if( uiNumBytes == 4 && m_fifo_idx + 4 <= m_fifo->size() )
+    {
+      const uint8_t* pBytes = &(*m_fifo)[m_fifo_idx];
+      uiWord = ( pBytes[0] << 24 ) | ( pBytes[1] << 16 ) | ( pBytes[2] << 8 ) | pBytes[3];
+      m_fifo_idx += 4;
+      return uiWord;
+    }
+    for( UInt ui = 0; ui < uiNumBytes; ui++, m_fifo_idx++ )
+    {
+      uiWord = ( uiWord << 8 ) | ( m_fifo_idx < m_fifo->size() ? (*m_fifo)[m_fifo_idx] : 0 );
+    }
+    return uiWord;
+  }
+
+  /** Return the last bytes taken by readBytes() to the fifo
+   */
+  Void        rewindBytes     ( UInt uiNumBytes )
+  {
+    assert( uiNumBytes <= m_fifo_idx );
+    m_fifo_idx -= uiNumBytes;
+  }
+#endif
   
   Void        readOutTrailingBits ();
   UChar getHeldBits  ()          { return m_held_bits;          }
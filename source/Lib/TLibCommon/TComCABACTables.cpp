@@ -120,4 +120,26 @@ const UChar TComCABACTables::sm_aucRenormTable[32] =
   1,  1,  1,  1
 };
 
+#if DEC_CABAC_64BIT_WINDOW
+const UChar TComCABACTables::sm_aucRenormTableRange[64] =
+{
+  6,  5,  4,  4,
+  3,  3,  3,  3,
+  2,  2,  2,  2,
+  2,  2,  2,  2,
+  1,  1,  1,  1,
+  1,  1,  1,  1,
+  1,  1,  1,  1,
+  1,  1,  1,  1,
+  0,  0,  0,  0,
+  0,  0,  0,  0,
+  0,  0,  0,  0,
+  0,  0,  0,  0,
+  0,  0,  0,  0,
+  0,  0,  0,  0,
+  0,  0,  0,  0,
+  0,  0,  0,  0
+};
+#endif
+
 //! \}
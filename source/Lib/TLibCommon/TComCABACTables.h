@@ -52,6 +52,9 @@ class TComCABACTables
 public:
   const static UChar  sm_aucLPSTable[64][4];
   const static UChar  sm_aucRenormTable[32];
+#if DEC_CABAC_64BIT_WINDOW
+  const static UChar  sm_aucRenormTableRange[64];  ///< renormalisation shift of any range below 512, indexed by range >> 3
+#endif
 };
 
 
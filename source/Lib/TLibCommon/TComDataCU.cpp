@@ -3528,16 +3528,16 @@ TComDataCU* TComDataCU::getBaseColCU( UInt refLayerIdc, UInt pelX, UInt pelY, UI
 
 #if REF_REGION_OFFSET
   const Window &windowRL = baseColPic->getSlice(0)->getPPS()->getRefLayerWindow(refLayerIdc);
-  Int iBX = (((uiPelX - leftStartL)*g_posScalingFactor[refLayerIdc][0] + (1<<15)) >> 16) + windowRL.getWindowLeftOffset();
-  Int iBY = (((uiPelY - topStartL )*g_posScalingFactor[refLayerIdc][1] + (1<<15)) >> 16) + windowRL.getWindowTopOffset();
+  Int iBX = (((uiPelX - leftStartL)*m_pcSlice->getPosScalingFactor(refLayerIdc, 0) + (1<<15)) >> 16) + windowRL.getWindowLeftOffset();
+  Int iBY = (((uiPelY - topStartL )*m_pcSlice->getPosScalingFactor(refLayerIdc, 1) + (1<<15)) >> 16) + windowRL.getWindowTopOffset();
 #else
 #if Q0200_CONFORMANCE_BL_SIZE
   Int chromaFormatIdc = baseColPic->getSlice(0)->getChromaFormatIdc();
-  Int iBX = (((uiPelX - leftStartL)*g_posScalingFactor[refLayerIdc][0] + (1<<15)) >> 16) + baseColPic->getConformanceWindow().getWindowLeftOffset() * TComSPS::getWinUnitX( chromaFormatIdc );
-  Int iBY = (((uiPelY - topStartL )*g_posScalingFactor[refLayerIdc][1] + (1<<15)) >> 16) + baseColPic->getConformanceWindow().getWindowTopOffset() * TComSPS::getWinUnitY( chromaFormatIdc );
+  Int iBX = (((uiPelX - leftStartL)*m_pcSlice->getPosScalingFactor(refLayerIdc, 0) + (1<<15)) >> 16) + baseColPic->getConformanceWindow().getWindowLeftOffset() * TComSPS::getWinUnitX( chromaFormatIdc );
+  Int iBY = (((uiPelY - topStartL )*m_pcSlice->getPosScalingFactor(refLayerIdc, 1) + (1<<15)) >> 16) + baseColPic->getConformanceWindow().getWindowTopOffset() * TComSPS::getWinUnitY( chromaFormatIdc );
 #else
-  Int iBX = ((uiPelX - leftStartL)*g_posScalingFactor[refLayerIdc][0] + (1<<15)) >> 16;
-  Int iBY = ((uiPelY - topStartL )*g_posScalingFactor[refLayerIdc][1] + (1<<15)) >> 16;
+  Int iBX = ((uiPelX - leftStartL)*m_pcSlice->getPosScalingFactor(refLayerIdc, 0) + (1<<15)) >> 16;
+  Int iBY = ((uiPelY - topStartL )*m_pcSlice->getPosScalingFactor(refLayerIdc, 1) + (1<<15)) >> 16;
 #endif
 #endif
 
@@ -3596,7 +3596,7 @@ Void TComDataCU::scaleBaseMV( UInt refLayerIdc, TComMvField& rcMvFieldEnhance, T
   TComMvField cMvFieldBase;
   TComMv cMv;
 
-  cMv = rcMvFieldBase.getMv().scaleMv( g_mvScalingFactor[refLayerIdc][0], g_mvScalingFactor[refLayerIdc][1] );
+  cMv = rcMvFieldBase.getMv().scaleMv( m_pcSlice->getMvScalingFactor(refLayerIdc, 0), m_pcSlice->getMvScalingFactor(refLayerIdc, 1) );
 
   rcMvFieldEnhance.setMvField( cMv, rcMvFieldBase.getRefIdx() );
 }
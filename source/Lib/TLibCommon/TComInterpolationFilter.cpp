@@ -42,7 +42,11 @@
 
 #include "TComRom.h"
 #include "TComInterpolationFilter.h"
+#include "TComSimd.h"
 #include <assert.h>
+#if SIMD_X86
+#include <immintrin.h>
+#endif
 
 
 //! \ingroup TLibCommon
@@ -72,6 +76,154 @@ const Short TComInterpolationFilter::m_chromaFilter[8][NTAPS_CHROMA] =
   { -2, 10, 58, -2 }
 };
 
+#if SIMD_X86
+// ====================================================================================================================
+// Vectorised kernels, bit-exact with the C code of filter()
+// ====================================================================================================================
+
+/** Rounding, shift and clipping of 8 sums, the results are truncated to 16 bits like the Short value of the C code
+ */
+template<Bool isLast>
+SIMD_TARGET_SSE41
+static inline __m128i xRoundPackSSE41( __m128i sumLo, __m128i sumHi, __m128i vShift, __m128i vMax )
+{
+  sumLo = _mm_sra_epi32( sumLo, vShift );
+  sumHi = _mm_sra_epi32( sumHi, vShift );
+  __m128i val = _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( sumLo, 16 ), 16 ), _mm_srai_epi32( _mm_slli_epi32( sumHi, 16 ), 16 ) );
+  if ( isLast )
+  {
+    val = _mm_min_epi16( _mm_max_epi16( val, _mm_setzero_si128() ), vMax );
+  }
+  return val;
+}
+
+/** Filter of one row from column col, 8 and 4 columns per iteration, the last 2 columns in C
+ */
+template<Int N, Bool isLast>
+SIMD_TARGET_SSE41
+static inline Void xFilterRowSSE41( const Pel* src, Int cStride, Short* dst, Int col, Int width, const __m128i* vCoeff, const Short* c, Int offset, Int shift, Short maxVal )
+{
+  const __m128i vOffset = _mm_set1_epi32( offset );
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m128i vMax    = _mm_set1_epi16( maxVal );
+  for( ; col + 8 <= width; col += 8 )
+  {
+    __m128i sumLo = vOffset;
+    __m128i sumHi = vOffset;
+    for( Int k = 0; k < N / 2; k++ )
+    {
+      __m128i a = _mm_loadu_si128( (const __m128i*)( src + col + ( 2 * k     ) * cStride ) );
+      __m128i b = _mm_loadu_si128( (const __m128i*)( src + col + ( 2 * k + 1 ) * cStride ) );
+      sumLo = _mm_add_epi32( sumLo, _mm_madd_epi16( _mm_unpacklo_epi16( a, b ), vCoeff[k] ) );
+      sumHi = _mm_add_epi32( sumHi, _mm_madd_epi16( _mm_unpackhi_epi16( a, b ), vCoeff[k] ) );
+    }
+    _mm_storeu_si128( (__m128i*)( dst + col ), xRoundPackSSE41<isLast>( sumLo, sumHi, vShift, vMax ) );
+  }
+  if( col + 4 <= width )
+  {
+    __m128i sum = vOffset;
+    for( Int k = 0; k < N / 2; k++ )
+    {
+      __m128i a = _mm_loadl_epi64( (const __m128i*)( src + col + ( 2 * k     ) * cStride ) );
+      __m128i b = _mm_loadl_epi64( (const __m128i*)( src + col + ( 2 * k + 1 ) * cStride ) );
+      sum = _mm_add_epi32( sum, _mm_madd_epi16( _mm_unpacklo_epi16( a, b ), vCoeff[k] ) );
+    }
+    _mm_storel_epi64( (__m128i*)( dst + col ), xRoundPackSSE41<isLast>( sum, sum, vShift, vMax ) );
+    col += 4;
+  }
+  for( ; col < width; col++ )
+  {
+    Int sum = 0;
+    for( Int k = 0; k < N; k++ )
+    {
+      sum += src[ col + k * cStride] * c[k];
+    }
+    Short val = ( sum + offset ) >> shift;
+    if ( isLast )
+    {
+      val = ( val < 0 ) ? 0 : val;
+      val = ( val > maxVal ) ? maxVal : val;
+    }
+    dst[col] = val;
+  }
+}
+
+/** Pairs of taps interleaved for _mm_madd_epi16()
+ */
+SIMD_TARGET_SSE41
+static inline __m128i xCoeffPairSSE41( const Short* c, Int k )
+{
+  return _mm_set1_epi32( (Int)( (UInt)(UShort)c[2 * k] | ( (UInt)(UShort)c[2 * k + 1] << 16 ) ) );
+}
+
+template<Int N, Bool isLast>
+SIMD_TARGET_SSE41
+static Void xFilterSSE41( const Pel* src, Int srcStride, Int cStride, Short* dst, Int dstStride, Int width, Int height, const Short* c, Int offset, Int shift, Short maxVal )
+{
+  __m128i vCoeff[N / 2];
+  for( Int k = 0; k < N / 2; k++ )
+  {
+    vCoeff[k] = xCoeffPairSSE41( c, k );
+  }
+
+  for( Int row = 0; row < height; row++ )
+  {
+    xFilterRowSSE41<N, isLast>( src, cStride, dst, 0, width, vCoeff, c, offset, shift, maxVal );
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+/** 16 columns per iteration, the unpacking and packing within the 128-bit lanes keep the column order
+ */
+template<Int N, Bool isLast>
+SIMD_TARGET_AVX2
+static Void xFilterAVX2( const Pel* src, Int srcStride, Int cStride, Short* dst, Int dstStride, Int width, Int height, const Short* c, Int offset, Int shift, Short maxVal )
+{
+  __m128i vCoeff[N / 2];
+  __m256i vCoeff2[N / 2];
+  for( Int k = 0; k < N / 2; k++ )
+  {
+    vCoeff[k]  = xCoeffPairSSE41( c, k );
+    vCoeff2[k] = _mm256_broadcastsi128_si256( vCoeff[k] );
+  }
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m256i vMax    = _mm256_set1_epi16( maxVal );
+  const __m256i vOffset = _mm256_set1_epi32( offset );
+  const Int     width16 = width & ~15;
+
+  for( Int row = 0; row < height; row++ )
+  {
+    for( Int col = 0; col < width16; col += 16 )
+    {
+      __m256i sumLo = vOffset;
+      __m256i sumHi = vOffset;
+      for( Int k = 0; k < N / 2; k++ )
+      {
+        __m256i a = _mm256_loadu_si256( (const __m256i*)( src + col + ( 2 * k     ) * cStride ) );
+        __m256i b = _mm256_loadu_si256( (const __m256i*)( src + col + ( 2 * k + 1 ) * cStride ) );
+        sumLo = _mm256_add_epi32( sumLo, _mm256_madd_epi16( _mm256_unpacklo_epi16( a, b ), vCoeff2[k] ) );
+        sumHi = _mm256_add_epi32( sumHi, _mm256_madd_epi16( _mm256_unpackhi_epi16( a, b ), vCoeff2[k] ) );
+      }
+      sumLo = _mm256_sra_epi32( sumLo, vShift );
+      sumHi = _mm256_sra_epi32( sumHi, vShift );
+      __m256i val = _mm256_packs_epi32( _mm256_srai_epi32( _mm256_slli_epi32( sumLo, 16 ), 16 ), _mm256_srai_epi32( _mm256_slli_epi32( sumHi, 16 ), 16 ) );
+      if ( isLast )
+      {
+        val = _mm256_min_epi16( _mm256_max_epi16( val, _mm256_setzero_si256() ), vMax );
+      }
+      _mm256_storeu_si256( (__m256i*)( dst + col ), val );
+    }
+    if( width16 < width )
+    {
+      xFilterRowSSE41<N, isLast>( src, cStride, dst, width16, width, vCoeff, c, offset, shift, maxVal );
+    }
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+#endif
+
 // ====================================================================================================================
 // Private member functions
 // ====================================================================================================================
@@ -206,6 +358,19 @@ Void TComInterpolationFilter::filter(Int bitDepth, Short const *src, Int srcStri
     offset = (isFirst) ? -IF_INTERNAL_OFFS << shift : 0;
     maxVal = 0;
   }
+
+#if SIMD_X86
+  if( getSimdLevel() >= SIMD_AVX2 && width >= 16 )
+  {
+    xFilterAVX2<N, isLast>( src, srcStride, cStride, dst, dstStride, width, height, c, offset, shift, maxVal );
+    return;
+  }
+  if( getSimdLevel() >= SIMD_SSE41 )
+  {
+    xFilterSSE41<N, isLast>( src, srcStride, cStride, dst, dstStride, width, height, c, offset, shift, maxVal );
+    return;
+  }
+#endif
   
   for (row = 0; row < height; row++)
   {
@@ -38,6 +38,14 @@
 #include "TComLoopFilter.h"
 #include "TComSlice.h"
 #include "TComMv.h"
+#include "TComSimd.h"
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+#if LOOP_FILTER_PARALLEL
+#include "TComThreadPool.h"
+#include <atomic>
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -66,6 +74,252 @@ const UChar TComLoopFilter::sm_betaTable[52] =
   0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,6,7,8,9,10,11,12,13,14,15,16,17,18,20,22,24,26,28,30,32,34,36,38,40,42,44,46,48,50,52,54,56,58,60,62,64
 };
 
+#if SIMD_X86
+// ====================================================================================================================
+// Vectorised kernels, bit-exact with the C code of xEdgeFilterLuma() and xEdgeFilterChroma()
+// ====================================================================================================================
+
+/** Samples of 4 lines across an edge, from the fourth sample before the edge: m[k] holds sample k-4 of the lines
+ *  0 to 3 in its 32-bit lanes. The lines of a vertical edge are rows, they are transposed.
+ */
+SIMD_TARGET_SSE41
+static inline Void xLoadLinesSSE41( const Pel* piSrc, Int iOffset, Int iSrcStep, Int iNumSamples, __m128i* m )
+{
+  if( iOffset == 1 )
+  {
+    __m128i r0, r1, r2, r3;
+    if( iNumSamples == 8 )
+    {
+      r0 = _mm_loadu_si128( (const __m128i*)( piSrc - 4 ) );
+      r1 = _mm_loadu_si128( (const __m128i*)( piSrc + iSrcStep - 4 ) );
+      r2 = _mm_loadu_si128( (const __m128i*)( piSrc + 2 * iSrcStep - 4 ) );
+      r3 = _mm_loadu_si128( (const __m128i*)( piSrc + 3 * iSrcStep - 4 ) );
+    }
+    else
+    {
+      r0 = _mm_loadl_epi64( (const __m128i*)( piSrc - 2 ) );
+      r1 = _mm_loadl_epi64( (const __m128i*)( piSrc + iSrcStep - 2 ) );
+      r2 = _mm_loadl_epi64( (const __m128i*)( piSrc + 2 * iSrcStep - 2 ) );
+      r3 = _mm_loadl_epi64( (const __m128i*)( piSrc + 3 * iSrcStep - 2 ) );
+    }
+    const __m128i a = _mm_unpacklo_epi16( r0, r1 );
+    const __m128i b = _mm_unpacklo_epi16( r2, r3 );
+    const __m128i c = _mm_unpackhi_epi16( r0, r1 );
+    const __m128i d = _mm_unpackhi_epi16( r2, r3 );
+    __m128i cols[4] = { _mm_unpacklo_epi32( a, b ), _mm_unpackhi_epi32( a, b ), _mm_unpacklo_epi32( c, d ), _mm_unpackhi_epi32( c, d ) };
+    for( Int k = 0; k < iNumSamples; k += 2 )
+    {
+      m[k]     = _mm_cvtepi16_epi32( cols[k >> 1] );
+      m[k + 1] = _mm_cvtepi16_epi32( _mm_srli_si128( cols[k >> 1], 8 ) );
+    }
+  }
+  else
+  {
+    const Pel* piLine = piSrc - ( iNumSamples >> 1 ) * iOffset;
+    for( Int k = 0; k < iNumSamples; k++, piLine += iOffset )
+    {
+      m[k] = _mm_cvtepi16_epi32( _mm_loadl_epi64( (const __m128i*)piLine ) );
+    }
+  }
+}
+
+/** Store the samples of 4 lines loaded by xLoadLinesSSE41(), the samples of a horizontal edge from iFirst to
+ *  iEnd only. The lines of a vertical edge are stored entirely.
+ */
+SIMD_TARGET_SSE41
+static inline Void xStoreLinesSSE41( Pel* piSrc, Int iOffset, Int iSrcStep, Int iNumSamples, const __m128i* m, Int iFirst, Int iEnd )
+{
+  if( iOffset == 1 )
+  {
+    __m128i cols[4];
+    for( Int k = 0; k < iNumSamples; k += 2 )
+    {
+      cols[k >> 1] = _mm_packs_epi32( m[k], m[k + 1] );
+    }
+    const __m128i t0 = _mm_unpacklo_epi16( cols[0], cols[1] );
+    const __m128i t1 = _mm_unpackhi_epi16( cols[0], cols[1] );
+    const __m128i u0 = _mm_unpacklo_epi16( t0, t1 );
+    const __m128i u1 = _mm_unpackhi_epi16( t0, t1 );
+    if( iNumSamples == 8 )
+    {
+      const __m128i t2 = _mm_unpacklo_epi16( cols[2], cols[3] );
+      const __m128i t3 = _mm_unpackhi_epi16( cols[2], cols[3] );
+      const __m128i u2 = _mm_unpacklo_epi16( t2, t3 );
+      const __m128i u3 = _mm_unpackhi_epi16( t2, t3 );
+      _mm_storeu_si128( (__m128i*)( piSrc - 4 ),                _mm_unpacklo_epi64( u0, u2 ) );
+      _mm_storeu_si128( (__m128i*)( piSrc + iSrcStep - 4 ),     _mm_unpackhi_epi64( u0, u2 ) );
+      _mm_storeu_si128( (__m128i*)( piSrc + 2 * iSrcStep - 4 ), _mm_unpacklo_epi64( u1, u3 ) );
+      _mm_storeu_si128( (__m128i*)( piSrc + 3 * iSrcStep - 4 ), _mm_unpackhi_epi64( u1, u3 ) );
+    }
+    else
+    {
+      _mm_storel_epi64( (__m128i*)( piSrc - 2 ),                u0 );
+      _mm_storel_epi64( (__m128i*)( piSrc + iSrcStep - 2 ),     _mm_srli_si128( u0, 8 ) );
+      _mm_storel_epi64( (__m128i*)( piSrc + 2 * iSrcStep - 2 ), u1 );
+      _mm_storel_epi64( (__m128i*)( piSrc + 3 * iSrcStep - 2 ), _mm_srli_si128( u1, 8 ) );
+    }
+  }
+  else
+  {
+    Pel* piLine = piSrc + ( iFirst - ( iNumSamples >> 1 ) ) * iOffset;
+    for( Int k = iFirst; k < iEnd; k++, piLine += iOffset )
+    {
+      _mm_storel_epi64( (__m128i*)piLine, _mm_packs_epi32( m[k], m[k] ) );
+    }
+  }
+}
+
+SIMD_TARGET_SSE41
+static inline __m128i xClip3SSE41( __m128i vMin, __m128i vMax, __m128i v )
+{
+  return _mm_min_epi32( _mm_max_epi32( vMin, v ), vMax );
+}
+
+/** Decisions and filtering of a 4-line luma edge segment, as xEdgeFilterLuma(), xPelFilterLuma() and xUseStrongFiltering()
+ */
+SIMD_TARGET_SSE41
+static Void xEdgeFilterLumaSSE41( Pel* piSrc, Int iOffset, Int iSrcStep, Int iTc, Int iBeta, Int iSideThreshold, Int iThrCut, Bool bPartPNoFilter, Bool bPartQNoFilter, Int iMaxVal )
+{
+  __m128i m[8];
+  xLoadLinesSSE41( piSrc, iOffset, iSrcStep, 8, m );
+
+  const __m128i vDP = _mm_abs_epi32( _mm_add_epi32( _mm_sub_epi32( m[1], _mm_slli_epi32( m[2], 1 ) ), m[3] ) );
+  const __m128i vDQ = _mm_abs_epi32( _mm_add_epi32( _mm_sub_epi32( m[4], _mm_slli_epi32( m[5], 1 ) ), m[6] ) );
+  const Int dp0 = _mm_cvtsi128_si32( vDP );
+  const Int dq0 = _mm_cvtsi128_si32( vDQ );
+  const Int dp3 = _mm_extract_epi32( vDP, 3 );
+  const Int dq3 = _mm_extract_epi32( vDQ, 3 );
+  const Int d0 = dp0 + dq0;
+  const Int d3 = dp3 + dq3;
+  const Int d  = d0 + d3;
+  if( d >= iBeta )
+  {
+    return;
+  }
+  const Bool bFilterP = ( dp0 + dp3 < iSideThreshold );
+  const Bool bFilterQ = ( dq0 + dq3 < iSideThreshold );
+
+  const __m128i vDStrong = _mm_add_epi32( _mm_abs_epi32( _mm_sub_epi32( m[0], m[3] ) ), _mm_abs_epi32( _mm_sub_epi32( m[7], m[4] ) ) );
+  const __m128i vD34     = _mm_abs_epi32( _mm_sub_epi32( m[3], m[4] ) );
+  const Int iTcStrong = ( iTc * 5 + 1 ) >> 1;
+  const Bool sw = _mm_cvtsi128_si32( vDStrong ) < ( iBeta >> 3 ) && 2 * d0 < ( iBeta >> 2 ) && _mm_cvtsi128_si32( vD34 ) < iTcStrong
+               && _mm_extract_epi32( vDStrong, 3 ) < ( iBeta >> 3 ) && 2 * d3 < ( iBeta >> 2 ) && _mm_extract_epi32( vD34, 3 ) < iTcStrong;
+
+  __m128i n[8];
+  for( Int k = 0; k < 8; k++ )
+  {
+    n[k] = m[k];
+  }
+  if( sw )
+  {
+    const __m128i vTc2   = _mm_set1_epi32( 2 * iTc );
+    const __m128i vTwo   = _mm_set1_epi32( 2 );
+    const __m128i vFour  = _mm_set1_epi32( 4 );
+    const __m128i vSum2  = _mm_add_epi32( _mm_add_epi32( m[2], m[3] ), m[4] );
+    const __m128i vSum5  = _mm_add_epi32( _mm_add_epi32( m[3], m[4] ), m[5] );
+    const __m128i vSumP  = _mm_add_epi32( vSum2, m[1] );
+    const __m128i vSumQ  = _mm_add_epi32( vSum5, m[6] );
+    n[3] = xClip3SSE41( _mm_sub_epi32( m[3], vTc2 ), _mm_add_epi32( m[3], vTc2 ), _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( _mm_slli_epi32( vSum2, 1 ), _mm_add_epi32( m[1], m[5] ) ), vFour ), 3 ) );
+    n[4] = xClip3SSE41( _mm_sub_epi32( m[4], vTc2 ), _mm_add_epi32( m[4], vTc2 ), _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( _mm_slli_epi32( vSum5, 1 ), _mm_add_epi32( m[2], m[6] ) ), vFour ), 3 ) );
+    n[2] = xClip3SSE41( _mm_sub_epi32( m[2], vTc2 ), _mm_add_epi32( m[2], vTc2 ), _mm_srai_epi32( _mm_add_epi32( vSumP, vTwo ), 2 ) );
+    n[5] = xClip3SSE41( _mm_sub_epi32( m[5], vTc2 ), _mm_add_epi32( m[5], vTc2 ), _mm_srai_epi32( _mm_add_epi32( vSumQ, vTwo ), 2 ) );
+    n[1] = xClip3SSE41( _mm_sub_epi32( m[1], vTc2 ), _mm_add_epi32( m[1], vTc2 ), _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( vSumP, _mm_slli_epi32( _mm_add_epi32( m[0], m[1] ), 1 ) ), vFour ), 3 ) );
+    n[6] = xClip3SSE41( _mm_sub_epi32( m[6], vTc2 ), _mm_add_epi32( m[6], vTc2 ), _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( vSumQ, _mm_slli_epi32( _mm_add_epi32( m[6], m[7] ), 1 ) ), vFour ), 3 ) );
+  }
+  else
+  {
+    // weak filter of the lines with abs(delta) < iThrCut
+    const __m128i vZero   = _mm_setzero_si128();
+    const __m128i vMax    = _mm_set1_epi32( iMaxVal );
+    const __m128i vTc     = _mm_set1_epi32( iTc );
+    const __m128i vNegTc  = _mm_set1_epi32( -iTc );
+    const __m128i vTc2    = _mm_set1_epi32( iTc >> 1 );
+    const __m128i vNegTc2 = _mm_set1_epi32( -( iTc >> 1 ) );
+    const __m128i vOne    = _mm_set1_epi32( 1 );
+    __m128i vDelta = _mm_add_epi32( _mm_sub_epi32( _mm_mullo_epi32( _mm_sub_epi32( m[4], m[3] ), _mm_set1_epi32( 9 ) ), _mm_mullo_epi32( _mm_sub_epi32( m[5], m[2] ), _mm_set1_epi32( 3 ) ) ), _mm_set1_epi32( 8 ) );
+    vDelta = _mm_srai_epi32( vDelta, 4 );
+    const __m128i vFilter = _mm_cmplt_epi32( _mm_abs_epi32( vDelta ), _mm_set1_epi32( iThrCut ) );
+    vDelta = xClip3SSE41( vNegTc, vTc, vDelta );
+    n[3] = xClip3SSE41( vZero, vMax, _mm_add_epi32( m[3], vDelta ) );
+    n[4] = xClip3SSE41( vZero, vMax, _mm_sub_epi32( m[4], vDelta ) );
+    if( bFilterP )
+    {
+      const __m128i vDelta1 = xClip3SSE41( vNegTc2, vTc2, _mm_srai_epi32( _mm_add_epi32( _mm_sub_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( m[1], m[3] ), vOne ), 1 ), m[2] ), vDelta ), 1 ) );
+      n[2] = xClip3SSE41( vZero, vMax, _mm_add_epi32( m[2], vDelta1 ) );
+    }
+    if( bFilterQ )
+    {
+      const __m128i vDelta2 = xClip3SSE41( vNegTc2, vTc2, _mm_srai_epi32( _mm_sub_epi32( _mm_sub_epi32( _mm_srai_epi32( _mm_add_epi32( _mm_add_epi32( m[6], m[4] ), vOne ), 1 ), m[5] ), vDelta ), 1 ) );
+      n[5] = xClip3SSE41( vZero, vMax, _mm_add_epi32( m[5], vDelta2 ) );
+    }
+    for( Int k = 2; k < 6; k++ )
+    {
+      n[k] = _mm_blendv_epi8( m[k], n[k], vFilter );
+    }
+  }
+
+  if( bPartPNoFilter )
+  {
+    n[1] = m[1];
+    n[2] = m[2];
+    n[3] = m[3];
+  }
+  if( bPartQNoFilter )
+  {
+    n[4] = m[4];
+    n[5] = m[5];
+    n[6] = m[6];
+  }
+  xStoreLinesSSE41( piSrc, iOffset, iSrcStep, 8, n, 1, 7 );
+}
+
+/** Filtering of the lines of a chroma edge, 4 lines at a time, as xPelFilterChroma(): the lines with a tc of 0
+ *  are left unchanged
+ */
+SIMD_TARGET_SSE41
+static Void xEdgeFilterChromaSSE41( Pel* piSrc, Int iOffset, Int iSrcStep, Int iNumLines, const Int* piTc, const Int* piPartPNoFilter, const Int* piPartQNoFilter, Int iMaxVal )
+{
+  const __m128i vZero = _mm_setzero_si128();
+  const __m128i vMax  = _mm_set1_epi32( iMaxVal );
+  for( Int iLine = 0; iLine < iNumLines; iLine += 4, piSrc += 4 * iSrcStep )
+  {
+    const __m128i vTc = _mm_loadu_si128( (const __m128i*)( piTc + iLine ) );
+    if( _mm_testz_si128( vTc, vTc ) )
+    {
+      continue;
+    }
+    __m128i m[4];
+    xLoadLinesSSE41( piSrc, iOffset, iSrcStep, 4, m );
+
+    __m128i vDelta = _mm_add_epi32( _mm_add_epi32( _mm_slli_epi32( _mm_sub_epi32( m[2], m[1] ), 2 ), _mm_sub_epi32( m[0], m[3] ) ), _mm_set1_epi32( 4 ) );
+    vDelta = xClip3SSE41( _mm_sub_epi32( vZero, vTc ), vTc, _mm_srai_epi32( vDelta, 3 ) );
+
+    __m128i n[4] = { m[0], xClip3SSE41( vZero, vMax, _mm_add_epi32( m[1], vDelta ) ), xClip3SSE41( vZero, vMax, _mm_sub_epi32( m[2], vDelta ) ), m[3] };
+    n[1] = _mm_blendv_epi8( n[1], m[1], _mm_loadu_si128( (const __m128i*)( piPartPNoFilter + iLine ) ) );
+    n[2] = _mm_blendv_epi8( n[2], m[2], _mm_loadu_si128( (const __m128i*)( piPartQNoFilter + iLine ) ) );
+    xStoreLinesSSE41( piSrc, iOffset, iSrcStep, 4, n, 1, 3 );
+  }
+}
+#endif
+
+#if LOOP_FILTER_PARALLEL
+/// bands of CTUs of a deblocking pass, each band is filtered by the first thread taking it
+struct TComLoopFilterBands
+{
+  TComLoopFilter**  ppcFilters;                   ///< filter of each band
+  TComPic*          pcPic;
+  UInt              uiFirstCol;
+  UInt              uiEndCol;
+  UInt              uiFirstRow;
+  UInt              uiEndRow;
+  Int               iEdge;
+  Bool              bRowBands;                    ///< bands of CTU rows, otherwise of CTU columns
+  Int               iNumBands;
+  std::atomic<Int>  iNextBand;                    ///< next band to be taken
+  TComSyncCounter   cNumFilteredBands;
+};
+#endif
+
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
 // ====================================================================================================================
@@ -73,6 +327,9 @@ const UChar TComLoopFilter::sm_betaTable[52] =
 TComLoopFilter::TComLoopFilter()
 : m_uiNumPartitions(0)
 , m_bLFCrossTileBoundary(true)
+#if LOOP_FILTER_PARALLEL
+, m_uiMaxCUDepth(0)
+#endif
 {
   for( UInt uiDir = 0; uiDir < 2; uiDir++ )
   {
@@ -96,6 +353,9 @@ Void TComLoopFilter::setCfg( Bool bLFCrossTileBoundary )
 Void TComLoopFilter::create( UInt uiMaxCUDepth )
 {
   destroy();
+#if LOOP_FILTER_PARALLEL
+  m_uiMaxCUDepth = uiMaxCUDepth;
+#endif
   m_uiNumPartitions = 1 << ( uiMaxCUDepth<<1 );
   for( UInt uiDir = 0; uiDir < 2; uiDir++ )
   {
@@ -119,15 +379,38 @@ Void TComLoopFilter::destroy()
       m_aapbEdgeFilter[uiDir] = NULL;
     }
   }
+#if LOOP_FILTER_PARALLEL
+  for( UInt ui = 0; ui < m_apcBandFilters.size(); ui++ )
+  {
+    m_apcBandFilters[ui]->destroy();
+    delete m_apcBandFilters[ui];
+  }
+  m_apcBandFilters.clear();
+#endif
 }
 
 /**
  - call deblocking function for every CU
  .
  \param  pcPic   picture class (TComPic) pointer
+ \param  pcThreadPool worker threads filtering the bands of CTUs, the picture is filtered by the calling thread if NULL
  */
+#if LOOP_FILTER_PARALLEL
+Void TComLoopFilter::loopFilterPic( TComPic* pcPic, TComThreadPool* pcThreadPool )
+#else
 Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
+#endif
 {
+#if LOOP_FILTER_PARALLEL
+  if( pcThreadPool && pcThreadPool->getNumThreads() > 1 )
+  {
+    // the vertical edges modify the samples of their CTU row only and the horizontal edges those of their CTU column
+    xDeblockBands( pcPic, 0, pcPic->getFrameWidthInCU(), 0, pcPic->getFrameHeightInCU(), EDGE_VER, true,  pcThreadPool );
+    xDeblockBands( pcPic, 0, pcPic->getFrameWidthInCU(), 0, pcPic->getFrameHeightInCU(), EDGE_HOR, false, pcThreadPool );
+    return;
+  }
+#endif
+
   // Horizontal filtering
   for ( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame(); uiCUAddr++ )
   {
@@ -153,11 +436,177 @@ Void TComLoopFilter::loopFilterPic( TComPic* pcPic )
   }
 }
 
+#if DEC_CTU_ROW_FILTER
+/**
+ - call deblocking function for every CU of a CTU row
+ .
+ \param  pcPic    picture class (TComPic) pointer
+ \param  uiCtuRow CTU row
+ \param  pcThreadPool worker threads filtering bands of CTU columns of the row, the row is filtered by the calling thread if NULL
+ \note   The horizontal edges of a row modify the bottom samples of the row above, and the vertical edges
+ *       modify only samples of the row itself: the rows must be filtered in order, each after the intra
+ *       prediction of the row below has used its unfiltered bottom samples.
+ */
+#if LOOP_FILTER_PARALLEL
+Void TComLoopFilter::loopFilterCtuRow( TComPic* pcPic, UInt uiCtuRow, TComThreadPool* pcThreadPool )
+#else
+Void TComLoopFilter::loopFilterCtuRow( TComPic* pcPic, UInt uiCtuRow )
+#endif
+{
+#if LOOP_FILTER_PARALLEL
+  if( pcThreadPool && pcThreadPool->getNumThreads() > 1 )
+  {
+    xDeblockBands( pcPic, 0, pcPic->getFrameWidthInCU(), uiCtuRow, uiCtuRow + 1, EDGE_VER, false, pcThreadPool );
+    xDeblockBands( pcPic, 0, pcPic->getFrameWidthInCU(), uiCtuRow, uiCtuRow + 1, EDGE_HOR, false, pcThreadPool );
+    return;
+  }
+#endif
+
+  const UInt uiFirstCUAddr = uiCtuRow * pcPic->getFrameWidthInCU();
+  const UInt uiEndCUAddr   = uiFirstCUAddr + pcPic->getFrameWidthInCU();
+
+  // Horizontal filtering
+  for ( UInt uiCUAddr = uiFirstCUAddr; uiCUAddr < uiEndCUAddr; uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+
+    ::memset( m_aapucBS       [EDGE_VER], 0, sizeof( UChar ) * m_uiNumPartitions );
+    ::memset( m_aapbEdgeFilter[EDGE_VER], 0, sizeof( Bool  ) * m_uiNumPartitions );
+
+    // CU-based deblocking
+    xDeblockCU( pcCU, 0, 0, EDGE_VER );
+  }
+
+  // Vertical filtering
+  for ( UInt uiCUAddr = uiFirstCUAddr; uiCUAddr < uiEndCUAddr; uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+
+    ::memset( m_aapucBS       [EDGE_HOR], 0, sizeof( UChar ) * m_uiNumPartitions );
+    ::memset( m_aapbEdgeFilter[EDGE_HOR], 0, sizeof( Bool  ) * m_uiNumPartitions );
+
+    // CU-based deblocking
+    xDeblockCU( pcCU, 0, 0, EDGE_HOR );
+  }
+}
+#endif
+
 
 // ====================================================================================================================
 // Protected member functions
 // ====================================================================================================================
 
+#if LOOP_FILTER_PARALLEL
+/**
+ - call deblocking function for every CU of a rectangle of CTUs, in raster order
+ .
+ \param  pcPic      picture class (TComPic) pointer
+ \param  uiFirstCol first CTU column
+ \param  uiEndCol   CTU column following the last one
+ \param  uiFirstRow first CTU row
+ \param  uiEndRow   CTU row following the last one
+ \param  Edge       the direction of the edges
+ */
+Void TComLoopFilter::xDeblockCUs( TComPic* pcPic, UInt uiFirstCol, UInt uiEndCol, UInt uiFirstRow, UInt uiEndRow, Int Edge )
+{
+  for ( UInt uiRow = uiFirstRow; uiRow < uiEndRow; uiRow++ )
+  {
+    for ( UInt uiCol = uiFirstCol; uiCol < uiEndCol; uiCol++ )
+    {
+      TComDataCU* pcCU = pcPic->getCU( uiRow * pcPic->getFrameWidthInCU() + uiCol );
+
+      ::memset( m_aapucBS       [Edge], 0, sizeof( UChar ) * m_uiNumPartitions );
+      ::memset( m_aapbEdgeFilter[Edge], 0, sizeof( Bool  ) * m_uiNumPartitions );
+
+      // CU-based deblocking
+      xDeblockCU( pcCU, 0, 0, Edge );
+    }
+  }
+}
+
+/**
+ - split the deblocking of the edges of one direction of a rectangle of CTUs into bands filtered concurrently
+ .
+ \param  pcPic        picture class (TComPic) pointer
+ \param  uiFirstCol   first CTU column
+ \param  uiEndCol     CTU column following the last one
+ \param  uiFirstRow   first CTU row
+ \param  uiEndRow     CTU row following the last one
+ \param  Edge         the direction of the edges
+ \param  bRowBands    bands of CTU rows, otherwise bands of CTU columns
+ \param  pcThreadPool worker threads
+ \note   The filtering of an edge reads at most four samples on each side of it and the edges of one direction are
+ *       eight samples apart, so that the bands give the result of the raster order. Each band has its own Bs and
+ *       edge arrays. The calling thread takes bands as well, so that it may be a worker thread itself: the jobs
+ *       started after all bands are taken return at once.
+ */
+Void TComLoopFilter::xDeblockBands( TComPic* pcPic, UInt uiFirstCol, UInt uiEndCol, UInt uiFirstRow, UInt uiEndRow, Int Edge, Bool bRowBands, TComThreadPool* pcThreadPool )
+{
+  const Int iNumUnits = bRowBands ? uiEndRow - uiFirstRow : uiEndCol - uiFirstCol;
+  const Int iNumBands = std::min<Int>( iNumUnits, 2 * pcThreadPool->getNumThreads() );
+  if( iNumBands < 2 )
+  {
+    xDeblockCUs( pcPic, uiFirstCol, uiEndCol, uiFirstRow, uiEndRow, Edge );
+    return;
+  }
+
+  while( (Int)m_apcBandFilters.size() < iNumBands )
+  {
+    TComLoopFilter* pcFilter = new TComLoopFilter;
+    pcFilter->create( m_uiMaxCUDepth );
+    m_apcBandFilters.push_back( pcFilter );
+  }
+  for( Int i = 0; i < iNumBands; i++ )
+  {
+    m_apcBandFilters[i]->setCfg( m_bLFCrossTileBoundary );
+  }
+
+  std::shared_ptr<TComLoopFilterBands> pcBands = std::make_shared<TComLoopFilterBands>();
+  pcBands->ppcFilters = &m_apcBandFilters[0];
+  pcBands->pcPic      = pcPic;
+  pcBands->uiFirstCol = uiFirstCol;
+  pcBands->uiEndCol   = uiEndCol;
+  pcBands->uiFirstRow = uiFirstRow;
+  pcBands->uiEndRow   = uiEndRow;
+  pcBands->iEdge      = Edge;
+  pcBands->bRowBands  = bRowBands;
+  pcBands->iNumBands  = iNumBands;
+  pcBands->iNextBand  = 0;
+
+  const Int iNumJobs = std::min<Int>( iNumBands - 1, pcThreadPool->getNumThreads() );
+  for( Int i = 0; i < iNumJobs; i++ )
+  {
+    pcThreadPool->addJob( std::bind( &TComLoopFilter::xDeblockBandsJob, pcBands ) );
+  }
+  xDeblockBandsJob( pcBands );
+  pcBands->cNumFilteredBands.waitFor( iNumBands );
+}
+
+/**
+ - filter the bands of a pass which are not taken yet
+ .
+ \param  pcBands bands of the pass, kept alive by the jobs which have not run yet
+ */
+Void TComLoopFilter::xDeblockBandsJob( std::shared_ptr<TComLoopFilterBands> pcBands )
+{
+  const Int iNumUnits = pcBands->bRowBands ? pcBands->uiEndRow - pcBands->uiFirstRow : pcBands->uiEndCol - pcBands->uiFirstCol;
+  for( Int iBand = pcBands->iNextBand++; iBand < pcBands->iNumBands; iBand = pcBands->iNextBand++ )
+  {
+    const UInt uiFirst = iNumUnits * iBand / pcBands->iNumBands;
+    const UInt uiEnd   = iNumUnits * ( iBand + 1 ) / pcBands->iNumBands;
+    if( pcBands->bRowBands )
+    {
+      pcBands->ppcFilters[iBand]->xDeblockCUs( pcBands->pcPic, pcBands->uiFirstCol, pcBands->uiEndCol, pcBands->uiFirstRow + uiFirst, pcBands->uiFirstRow + uiEnd, pcBands->iEdge );
+    }
+    else
+    {
+      pcBands->ppcFilters[iBand]->xDeblockCUs( pcBands->pcPic, pcBands->uiFirstCol + uiFirst, pcBands->uiFirstCol + uiEnd, pcBands->uiFirstRow, pcBands->uiEndRow, pcBands->iEdge );
+    }
+    pcBands->cNumFilteredBands.increment();
+  }
+}
+#endif
+
 /**
  - Deblocking filter process in CU-based (the same function as conventional's)
  .
@@ -595,6 +1044,24 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
       UInt  uiBlocksInPart = uiPelsInPart / 4 ? uiPelsInPart / 4 : 1;
       for (UInt iBlkIdx = 0; iBlkIdx<uiBlocksInPart; iBlkIdx ++)
       {
+#if SIMD_X86
+        if (bPCMFilter || pcCU->getSlice()->getPPS()->getTransquantBypassEnableFlag())
+        {
+          // Check if each of PUs is I_PCM with LF disabling
+          bPartPNoFilter = (bPCMFilter && pcCUP->getIPCMFlag(uiPartPIdx));
+          bPartQNoFilter = (bPCMFilter && pcCUQ->getIPCMFlag(uiPartQIdx));
+
+          // check if each of PUs is lossless coded
+          bPartPNoFilter = bPartPNoFilter || (pcCUP->isLosslessCoded(uiPartPIdx) );
+          bPartQNoFilter = bPartQNoFilter || (pcCUQ->isLosslessCoded(uiPartQIdx) );
+        }
+
+        if( getSimdLevel() >= SIMD_SSE41 )
+        {
+          xEdgeFilterLumaSSE41( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4), iOffset, iSrcStep, iTc, iBeta, iSideThreshold, iThrCut, bPartPNoFilter, bPartQNoFilter, (1 << g_bitDepthY) - 1 );
+          continue;
+        }
+#endif
         Int dp0 = xCalcDP( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+0), iOffset);
         Int dq0 = xCalcDQ( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+0), iOffset);
         Int dp3 = xCalcDP( piTmpSrc+iSrcStep*(iIdx*uiPelsInPart+iBlkIdx*4+3), iOffset);
@@ -606,6 +1073,7 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
         Int dq = dq0 + dq3;
         Int d =  d0 + d3;
         
+#if !SIMD_X86
         if (bPCMFilter || pcCU->getSlice()->getPPS()->getTransquantBypassEnableFlag())
         {
           // Check if each of PUs is I_PCM with LF disabling
@@ -616,6 +1084,7 @@ Void TComLoopFilter::xEdgeFilterLuma( TComDataCU* pcCU, UInt uiAbsZorderIdx, UIn
           bPartPNoFilter = bPartPNoFilter || (pcCUP->isLosslessCoded(uiPartPIdx) );
           bPartQNoFilter = bPartQNoFilter || (pcCUQ->isLosslessCoded(uiPartQIdx) );
         }
+#endif
 
         if (d < iBeta)
         { 
@@ -693,6 +1162,21 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
     piTmpSrcCb += iEdge*iStride*uiPelsInPartChroma;
     piTmpSrcCr += iEdge*iStride*uiPelsInPartChroma;
   }
+
+#if SIMD_X86
+  // tc and PCM/lossless masks of the lines of the edge gathered for the vectorised filtering, tc is 0 for the lines not filtered
+  const UInt uiNumLines = uiNumParts*uiPelsInPartChroma;
+  const Bool bSimd = getSimdLevel() >= SIMD_SSE41 && (uiNumLines & 3) == 0;
+  Int aaiTc[2][MAX_CU_SIZE/2];
+  Int aiPartPNoFilter[MAX_CU_SIZE/2];
+  Int aiPartQNoFilter[MAX_CU_SIZE/2];
+  if (bSimd)
+  {
+    ::memset( aaiTc, 0, sizeof( aaiTc ) );
+    ::memset( aiPartPNoFilter, 0, sizeof( aiPartPNoFilter ) );
+    ::memset( aiPartQNoFilter, 0, sizeof( aiPartQNoFilter ) );
+  }
+#endif
   
   for ( UInt iIdx = 0; iIdx < uiNumParts; iIdx++ )
   {
@@ -737,6 +1221,18 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
         Int iIndexTC = Clip3(0, MAX_QP+DEFAULT_INTRA_TC_OFFSET, iQP + DEFAULT_INTRA_TC_OFFSET*(ucBs - 1) + (tcOffsetDiv2 << 1));
         Int iTc =  sm_tcTable[iIndexTC]*iBitdepthScale;
 
+#if SIMD_X86
+        if (bSimd)
+        {
+          for ( UInt uiStep = 0; uiStep < uiPelsInPartChroma; uiStep++ )
+          {
+            aaiTc[chromaIdx][uiStep+iIdx*uiPelsInPartChroma] = iTc;
+            aiPartPNoFilter [uiStep+iIdx*uiPelsInPartChroma] = bPartPNoFilter ? -1 : 0;
+            aiPartQNoFilter [uiStep+iIdx*uiPelsInPartChroma] = bPartQNoFilter ? -1 : 0;
+          }
+          continue;
+        }
+#endif
         for ( UInt uiStep = 0; uiStep < uiPelsInPartChroma; uiStep++ )
         {
           xPelFilterChroma( piTmpSrcChroma + iSrcStep*(uiStep+iIdx*uiPelsInPartChroma), iOffset, iTc , bPartPNoFilter, bPartQNoFilter);
@@ -744,6 +1240,14 @@ Void TComLoopFilter::xEdgeFilterChroma( TComDataCU* pcCU, UInt uiAbsZorderIdx, U
       }
     }
   }
+
+#if SIMD_X86
+  if (bSimd)
+  {
+    xEdgeFilterChromaSSE41( piTmpSrcCb, iOffset, iSrcStep, uiNumLines, aaiTc[0], aiPartPNoFilter, aiPartQNoFilter, (1 << g_bitDepthC) - 1 );
+    xEdgeFilterChromaSSE41( piTmpSrcCr, iOffset, iSrcStep, uiNumLines, aaiTc[1], aiPartPNoFilter, aiPartQNoFilter, (1 << g_bitDepthC) - 1 );
+  }
+#endif
 }
 
 /**
@@ -40,12 +40,21 @@
 
 #include "CommonDef.h"
 #include "TComPic.h"
+#if LOOP_FILTER_PARALLEL
+#include <vector>
+#include <memory>
+#endif
 
 //! \ingroup TLibCommon
 //! \{
 
 #define DEBLOCK_SMALLEST_BLOCK  8
 
+#if LOOP_FILTER_PARALLEL
+class TComThreadPool;
+struct TComLoopFilterBands;
+#endif
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -60,10 +69,21 @@ private:
   LFCUParam m_stLFCUParam;                  ///< status structure
   
   Bool      m_bLFCrossTileBoundary;
+#if LOOP_FILTER_PARALLEL
+  UInt      m_uiMaxCUDepth;
+  std::vector<TComLoopFilter*> m_apcBandFilters;   ///< filters with their own Bs and edge arrays, one per band of a parallel pass
+#endif
 
 protected:
   /// CU-level deblocking function
   Void xDeblockCU                 ( TComDataCU* pcCU, UInt uiAbsZorderIdx, UInt uiDepth, Int Edge );
+#if LOOP_FILTER_PARALLEL
+  /// deblocking of the edges of one direction of a rectangle of CTUs
+  Void xDeblockCUs                ( TComPic* pcPic, UInt uiFirstCol, UInt uiEndCol, UInt uiFirstRow, UInt uiEndRow, Int Edge );
+  /// deblocking of the edges of one direction of a rectangle of CTUs, split into bands of rows or columns filtered concurrently
+  Void xDeblockBands              ( TComPic* pcPic, UInt uiFirstCol, UInt uiEndCol, UInt uiFirstRow, UInt uiEndRow, Int Edge, Bool bRowBands, TComThreadPool* pcThreadPool );
+  static Void xDeblockBandsJob    ( std::shared_ptr<TComLoopFilterBands> pcBands );
+#endif
 
   // set / get functions
   Void xSetLoopfilterParam        ( TComDataCU* pcCU, UInt uiAbsZorderIdx );
@@ -111,8 +131,22 @@ public:
   /// set configuration
   Void setCfg( Bool bLFCrossTileBoundary );
   
+#if LOOP_FILTER_PARALLEL
+  /// picture-level deblocking filter, the vertical edges are filtered by bands of CTU rows and the horizontal ones by bands of CTU columns
+  Void loopFilterPic( TComPic* pcPic, TComThreadPool* pcThreadPool = NULL );
+#else
   /// picture-level deblocking filter
   Void loopFilterPic( TComPic* pcPic );
+#endif
+#if DEC_CTU_ROW_FILTER
+#if LOOP_FILTER_PARALLEL
+  /// deblocking filter of a CTU row, the rows filtered in order give the result of loopFilterPic()
+  Void loopFilterCtuRow( TComPic* pcPic, UInt uiCtuRow, TComThreadPool* pcThreadPool = NULL );
+#else
+  /// deblocking filter of a CTU row, the rows filtered in order give the result of loopFilterPic()
+  Void loopFilterCtuRow( TComPic* pcPic, UInt uiCtuRow );
+#endif
+#endif
 
   static Int getBeta( Int qp )
   {
@@ -37,6 +37,9 @@
 
 #include "TComPic.h"
 #include "SEI.h"
+#if ILR_ON_DEMAND_UPSAMPLING
+#include "TComUpsampleFilter.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -59,6 +62,10 @@ TComPic::TComPic()
 #if SVC_EXTENSION
 , m_layerId( 0 )
 #endif
+#if ILR_ON_DEMAND_UPSAMPLING
+, m_pcUpsampleFilter                      (NULL)
+, m_uiUpsampleRefLayerIdc                 (0)
+#endif
 {
 #if SVC_EXTENSION
   memset( m_pcFullPelBaseRec, 0, sizeof( m_pcFullPelBaseRec ) );
@@ -67,6 +74,10 @@ TComPic::TComPic()
 #endif
   m_apcPicYuv[0]      = NULL;
   m_apcPicYuv[1]      = NULL;
+#if DEC_PICTURE_PIPELINE
+  // a picture which is not decoded, e.g. an inter-layer reference picture, never blocks its readers
+  m_cReconRows.set( MAX_INT );
+#endif
 }
 
 TComPic::~TComPic()
@@ -256,6 +267,49 @@ Void copyOnetoOnePicture(    // SVC_NONCOLL
   }
 }
 
+#if DEC_PICTURE_PIPELINE
+/** Wait until the CTU rows covering the luma rows 0 to iNumLumaRows-1 are reconstructed and filtered, the picture may be decoded by another thread
+ */
+Void TComPic::waitForReconstructedRows( Int iNumLumaRows )
+{
+  if( iNumLumaRows <= 0 || isReconstructionFinished() )
+  {
+    return;
+  }
+  const Int iCUHeight = m_apcPicSym->getSlice(0)->getSPS()->getMaxCUHeight();
+  m_cReconRows.waitFor( ( iNumLumaRows + iCUHeight - 1 ) / iCUHeight );
+}
+
+#endif
+#if ILR_ON_DEMAND_UPSAMPLING
+/** Resample the luma rows iTop to iBottom-1 of the inter-layer reference picture, and the co-located chroma rows, if they are not yet resampled
+ */
+Void TComPic::upsampleRows( Int iTop, Int iBottom )
+{
+  if( m_pcUpsampleFilter )
+  {
+    m_pcUpsampleFilter->upsampleRows( m_uiUpsampleRefLayerIdc, iTop, iBottom );
+  }
+}
+
+#if DEC_PICTURE_PIPELINE
+/** Wait until the rows of the reference layer picture which the resampling of the luma rows 0 to iBottom-1 of the inter-layer reference picture,
+ * and of the co-located chroma rows, reads are reconstructed. The reference layer picture may be decoded concurrently.
+ */
+Void TComPic::waitForUpsampleSource( Int iBottom )
+{
+  if( m_pcUpsampleFilter )
+  {
+    TComPic* pcBasePic = getSlice(0)->getBaseColPic( m_uiUpsampleRefLayerIdc );
+    if( !pcBasePic->isReconstructionFinished() )
+    {
+      pcBasePic->waitForReconstructedRows( m_pcUpsampleFilter->getNumSourceRows( m_uiUpsampleRefLayerIdc, iBottom ) );
+    }
+  }
+}
+#endif
+
+#endif
 Void TComPic::copyUpsampledPictureYuv(TComPicYuv*   pcPicYuvIn, TComPicYuv*   pcPicYuvOut)
 {
   Int upsampledRowWidthLuma = pcPicYuvOut->getStride(); // 2 * pcPicYuvOut->getLumaMargin() + pcPicYuvOut->getWidth(); 
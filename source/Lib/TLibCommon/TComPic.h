@@ -47,10 +47,17 @@
 #if AVC_BASE
 #include <fstream>
 #endif
+#if DEC_PICTURE_PIPELINE
+#include "TComThreadPool.h"
+#endif
 
 //! \ingroup TLibCommon
 //! \{
 
+#if ILR_ON_DEMAND_UPSAMPLING
+class TComUpsampleFilter;
+
+#endif
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -83,6 +90,9 @@ private:
   std::vector<std::vector<TComDataCU*> > m_vSliceCUDataLink;
 
   SEIMessages  m_SEIs; ///< Any SEI messages that have been received.  If !NULL we own the object.
+#if DEC_PICTURE_PIPELINE
+  TComSyncCounter       m_cReconRows;           ///< number of leading CTU rows which are reconstructed and filtered, MAX_INT once the picture is complete
+#endif
 #if SVC_EXTENSION
   UInt                  m_layerId;              //  Layer ID
   Bool                  m_bSpatialEnhLayer[MAX_LAYERS];       // whether current layer is a spatial enhancement layer,
@@ -90,6 +100,10 @@ private:
 #if REF_IDX_MFM
   Bool                  m_equalPictureSizeAndOffsetFlag[MAX_LAYERS]; 
 #endif
+#if ILR_ON_DEMAND_UPSAMPLING
+  TComUpsampleFilter*   m_pcUpsampleFilter;     ///< resampling filter writing the samples of the inter-layer reference picture, NULL when they are complete
+  UInt                  m_uiUpsampleRefLayerIdc; ///< reference layer of the inter-layer reference picture in the resampling filter
+#endif
 #endif
 #if Q0048_CGS_3D_ASYMLUT
   Int                   m_nFrameBit;
@@ -148,6 +162,15 @@ public:
   UInt          getMinCUWidth()         { return m_apcPicSym->getMinCUWidth();         }
   UInt          getMinCUHeight()        { return m_apcPicSym->getMinCUHeight();        }
   
+#if DEC_PICTURE_PIPELINE
+  Void          startReconstruction     ()                 { m_cReconRows.set( 0 );         }
+  Void          setReconstructedRows    ( UInt uiNumRows ) { m_cReconRows.set( uiNumRows ); }
+  Void          finishReconstruction    ()                 { m_cReconRows.set( MAX_INT );   }
+  Bool          isReconstructionFinished()                 { return m_cReconRows.get() == MAX_INT; }
+  Void          waitForReconstruction   ()                 { m_cReconRows.waitFor( MAX_INT ); }
+  Void          waitForReconstructedRows( Int iNumLumaRows );   ///< wait until the CTU rows covering the first iNumLumaRows luma rows are reconstructed and filtered
+#endif
+
   UInt          getParPelX(UChar uhPartIdx) { return getParPelX(uhPartIdx); }
   UInt          getParPelY(UChar uhPartIdx) { return getParPelX(uhPartIdx); }
   
@@ -217,6 +240,14 @@ public:
   ChromaFormat  getChromaFormat() const { return m_apcPicYuv[1]->getChromaFormat(); }
 #endif
   Void  copyUpsampledPictureYuv(TComPicYuv*   pcPicYuvIn, TComPicYuv*   pcPicYuvOut); 
+#if ILR_ON_DEMAND_UPSAMPLING
+  Void                setUpsampleFilter( TComUpsampleFilter* p, UInt refLayerIdc ) { m_pcUpsampleFilter = p; m_uiUpsampleRefLayerIdc = refLayerIdc; }
+  TComUpsampleFilter* getUpsampleFilter()                                          { return m_pcUpsampleFilter; }
+  Void                upsampleRows( Int iTop, Int iBottom );
+#if DEC_PICTURE_PIPELINE
+  Void                waitForUpsampleSource( Int iBottom );   ///< wait until the reference layer rows read by the resampling of the luma rows above iBottom are reconstructed
+#endif
+#endif
 #endif
 
 #if Q0048_CGS_3D_ASYMLUT
@@ -291,6 +291,53 @@ Void TComPicYuv::extendPicBorder ()
   m_bIsBorderExtended = true;
 }
 
+#if ILR_ON_DEMAND_UPSAMPLING
+/** Extend the border of the luma rows iTop to iBottom-1 and of the co-located chroma rows
+ * The top and bottom borders are extended when the rows include the first and the last row of the picture.
+ */
+Void TComPicYuv::extendPicBorderRows ( Int iTop, Int iBottom )
+{
+  xExtendPicCompBorderRows( getLumaAddr(), getStride(),  getWidth(),      getHeight(),      m_iLumaMarginX,   m_iLumaMarginY,   iTop,      iBottom      );
+  xExtendPicCompBorderRows( getCbAddr()  , getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY, iTop >> 1, iBottom >> 1 );
+  xExtendPicCompBorderRows( getCrAddr()  , getCStride(), getWidth() >> 1, getHeight() >> 1, m_iChromaMarginX, m_iChromaMarginY, iTop >> 1, iBottom >> 1 );
+}
+
+Void TComPicYuv::xExtendPicCompBorderRows  (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY, Int iTop, Int iBottom)
+{
+  Int   x, y;
+  Pel*  pi;
+
+  pi = piTxt + iTop * iStride;
+  for ( y = iTop; y < iBottom; y++ )
+  {
+    for ( x = 0; x < iMarginX; x++ )
+    {
+      pi[ -iMarginX + x ] = pi[0];
+      pi[    iWidth + x ] = pi[iWidth-1];
+    }
+    pi += iStride;
+  }
+
+  if ( iTop == 0 )
+  {
+    pi = piTxt - iMarginX;
+    for ( y = 0; y < iMarginY; y++ )
+    {
+      ::memcpy( pi - (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    }
+  }
+
+  if ( iBottom == iHeight )
+  {
+    pi = piTxt + (iHeight-1) * iStride - iMarginX;
+    for ( y = 0; y < iMarginY; y++ )
+    {
+      ::memcpy( pi + (y+1)*iStride, pi, sizeof(Pel)*(iWidth + (iMarginX<<1)) );
+    }
+  }
+}
+#endif
+
 Void TComPicYuv::xExtendPicCompBorder  (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY)
 {
   Int   x, y;
@@ -101,6 +101,9 @@ private:
   
 protected:
   Void  xExtendPicCompBorder (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY);
+#if ILR_ON_DEMAND_UPSAMPLING
+  Void  xExtendPicCompBorderRows (Pel* piTxt, Int iStride, Int iWidth, Int iHeight, Int iMarginX, Int iMarginY, Int iTop, Int iBottom);
+#endif
   
 public:
   TComPicYuv         ();
@@ -179,12 +182,16 @@ public:
   
   //  Extend function of picture buffer
   Void  extendPicBorder      ();
+#if ILR_ON_DEMAND_UPSAMPLING
+  Void  extendPicBorderRows  ( Int iTop, Int iBottom );
+#endif
   
   //  Dump picture
   Void  dump (Char* pFileName, Bool bAdd = false);
 
   // Set border extension flag
   Void  setBorderExtension(Bool b) { m_bIsBorderExtended = b; }
+  Bool  isBorderExtended  ()       { return m_bIsBorderExtended; }
   
 #if SVC_EXTENSION
   Void   setHeight   ( Int iPicHeight )     { m_iPicHeight = iPicHeight; }
@@ -503,6 +503,14 @@ Void TComPrediction::xPredInterUni ( TComDataCU* pcCU, UInt uiPartAddr, Int iWid
 #endif
     }
 
+#if ILR_ON_DEMAND_UPSAMPLING
+    if( refPic->getUpsampleFilter() )
+    {
+      // resample the rows of the inter-layer reference picture under the interpolation filter taps of the block
+      Int iTop = pcCU->getCUPelY() + g_auiRasterToPelY[g_auiZscanToRaster[uiPartAddr]] + ( cMv.getVer() >> 2 );
+      refPic->upsampleRows( iTop - ( NTAPS_LUMA >> 1 ), iTop + iHeight + ( NTAPS_LUMA >> 1 ) );
+    }
+#endif
   }
 #endif
 
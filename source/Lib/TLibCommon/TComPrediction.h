@@ -134,6 +134,9 @@ public:
   Void upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic, TComPicYuv* pcBasePic, TComPicYuv* pcTempPic, const Window window );
 #endif
 #endif
+#if ILR_ON_DEMAND_UPSAMPLING
+  TComUpsampleFilter* getUpsampleFilter() { return &m_cUsf; }
+#endif
 #endif //SVC_EXTENSION
 };
 
@@ -39,6 +39,10 @@
 #include <assert.h>
 #include "TComRom.h"
 #include "TComRdCost.h"
+#if SIMD_X86
+#include <vector>
+#include <immintrin.h>
+#endif
 
 //! \ingroup TLibCommon
 //! \{
@@ -219,6 +223,10 @@ Void TComRdCost::init()
   m_afpDistortFunc[27] = TComRdCost::xGetHADs;
   m_afpDistortFunc[28] = TComRdCost::xGetHADs;
 
+#if SIMD_X86
+  xInitSimdDistortFunc( getSimdLevel() );
+#endif
+
 #if !FIX203
   m_puiComponentCostOriginP = NULL;
   m_puiComponentCost        = NULL;
@@ -394,6 +402,14 @@ TComRdCost::setDistParam( DistParam& rcDP, Int bitDepth, Pel* p1, Int iStride1,
 
 UInt TComRdCost::calcHAD(Int bitDepth, Pel* pi0, Int iStride0, Pel* pi1, Int iStride1, Int iWidth, Int iHeight )
 {
+#if SIMD_X86
+  // same 8x8 or 4x4 partitioning as xGetHADs(), which may be replaced by a vectorised kernel
+  assert(iWidth % 4 == 0 && iHeight % 4 == 0);
+  DistParam cDtParam;
+  setDistParam( cDtParam, bitDepth, pi0, iStride0, pi1, iStride1, iWidth, iHeight, true );
+  cDtParam.bApplyWeight = false;
+  return cDtParam.DistFunc( &cDtParam );
+#else
   UInt uiSum = 0;
   Int x, y;
 
@@ -425,7 +441,7 @@ UInt TComRdCost::calcHAD(Int bitDepth, Pel* pi0, Int iStride0, Pel* pi1, Int iSt
   }
 
   return uiSum >> DISTORTION_PRECISION_ADJUSTMENT(bitDepth-8);
-
+#endif
 }
 
 UInt TComRdCost::getDistPart(Int bitDepth, Pel* piCur, Int iCurStride,  Pel* piOrg, Int iOrgStride, UInt uiBlkWidth, UInt uiBlkHeight, TextType eText, DFunc eDFunc)
@@ -1661,4 +1677,557 @@ UInt TComRdCost::xGetHADs( DistParam* pcDtParam )
   return uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8);
 }
 
+#if SIMD_X86
+// ====================================================================================================================
+// Vectorised distortion functions, bit-exact with the C code
+// ====================================================================================================================
+
+// The samples are Pel values of at most 15 bits, their differences are computed on 16 bits.
+// The sums are accumulated modulo 2^32 in 32-bit lanes like the UInt sums of the C code.
+
+SIMD_TARGET_SSE41
+static inline UInt xHorSumSSE41( __m128i v )
+{
+  v = _mm_add_epi32( v, _mm_shuffle_epi32( v, 0x4e ) );
+  v = _mm_add_epi32( v, _mm_shuffle_epi32( v, 0xb1 ) );
+  return (UInt)_mm_cvtsi128_si32( v );
+}
+
+SIMD_TARGET_AVX2
+static inline UInt xHorSumAVX2( __m256i v )
+{
+  return xHorSumSSE41( _mm_add_epi32( _mm256_castsi256_si128( v ), _mm256_extracti128_si256( v, 1 ) ) );
+}
+
+/** Sum of absolute differences of one row, 8 samples per iteration and 4 remaining samples
+ */
+template<Int iWidth>
+SIMD_TARGET_SSE41
+static inline __m128i xSADRowSSE41( const Pel* piOrg, const Pel* piCur, Int iCols, __m128i vSum )
+{
+  const __m128i vOne = _mm_set1_epi16( 1 );
+  const Int iW = iWidth ? iWidth : iCols;
+  Int n = 0;
+  for( ; n + 8 <= iW; n += 8 )
+  {
+    __m128i vDiff = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)( piOrg + n ) ), _mm_loadu_si128( (const __m128i*)( piCur + n ) ) );
+    vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_abs_epi16( vDiff ), vOne ) );
+  }
+  if( iW & 4 )
+  {
+    __m128i vDiff = _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)( piOrg + n ) ), _mm_loadl_epi64( (const __m128i*)( piCur + n ) ) );
+    vSum = _mm_add_epi32( vSum, _mm_madd_epi16( _mm_abs_epi16( vDiff ), vOne ) );
+  }
+  return vSum;
+}
+
+template<Int iWidth>
+SIMD_TARGET_SSE41
+static UInt xGetSADSSE41( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, Int iCols, Int iSubStep )
+{
+  __m128i vSum = _mm_setzero_si128();
+  for( ; iRows != 0; iRows -= iSubStep )
+  {
+    vSum = xSADRowSSE41<iWidth>( piOrg, piCur, iCols, vSum );
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  return xHorSumSSE41( vSum );
+}
+
+/** Sum of absolute differences, 16 samples per iteration and the remaining 8 or 4 samples with SSE4.1
+ */
+template<Int iWidth>
+SIMD_TARGET_AVX2
+static UInt xGetSADAVX2( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, Int iCols, Int iSubStep )
+{
+  const __m256i vOne = _mm256_set1_epi16( 1 );
+  const Int iW   = iWidth ? iWidth : iCols;
+  const Int iW16 = iW & ~15;
+  __m256i vSum  = _mm256_setzero_si256();
+  __m128i vTail = _mm_setzero_si128();
+  for( ; iRows != 0; iRows -= iSubStep )
+  {
+    for( Int n = 0; n < iW16; n += 16 )
+    {
+      __m256i vDiff = _mm256_sub_epi16( _mm256_loadu_si256( (const __m256i*)( piOrg + n ) ), _mm256_loadu_si256( (const __m256i*)( piCur + n ) ) );
+      vSum = _mm256_add_epi32( vSum, _mm256_madd_epi16( _mm256_abs_epi16( vDiff ), vOne ) );
+    }
+    if( iW & 15 )
+    {
+      vTail = xSADRowSSE41<iWidth & 15>( piOrg + iW16, piCur + iW16, iW & 15, vTail );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  return xHorSumAVX2( vSum ) + xHorSumSSE41( vTail );
+}
+
+/** Sum of squared differences, each square is shifted before the accumulation as in the C code
+ */
+template<Int iWidth>
+SIMD_TARGET_SSE41
+static UInt xGetSSESSE41( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, Int iCols, UInt uiShift )
+{
+  const __m128i vShift = _mm_cvtsi32_si128( uiShift );
+  const Int iW = iWidth ? iWidth : iCols;
+  __m128i vSum = _mm_setzero_si128();
+  for( ; iRows != 0; iRows-- )
+  {
+    for( Int n = 0; n < iW; n += 8 )
+    {
+      __m128i vDiff = iW - n >= 8 ? _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)( piOrg + n ) ), _mm_loadu_si128( (const __m128i*)( piCur + n ) ) )
+                                  : _mm_sub_epi16( _mm_loadl_epi64( (const __m128i*)( piOrg + n ) ), _mm_loadl_epi64( (const __m128i*)( piCur + n ) ) );
+      __m128i vLo = _mm_mullo_epi16( vDiff, vDiff );
+      __m128i vHi = _mm_mulhi_epi16( vDiff, vDiff );
+      vSum = _mm_add_epi32( vSum, _mm_srl_epi32( _mm_unpacklo_epi16( vLo, vHi ), vShift ) );
+      vSum = _mm_add_epi32( vSum, _mm_srl_epi32( _mm_unpackhi_epi16( vLo, vHi ), vShift ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  return xHorSumSSE41( vSum );
+}
+
+template<Int iWidth>
+SIMD_TARGET_AVX2
+static UInt xGetSSEAVX2( const Pel* piOrg, Int iStrideOrg, const Pel* piCur, Int iStrideCur, Int iRows, Int iCols, UInt uiShift )
+{
+  const __m128i vShift = _mm_cvtsi32_si128( uiShift );
+  const Int iW = iWidth ? iWidth : iCols;
+  __m256i vSum = _mm256_setzero_si256();
+  for( ; iRows != 0; iRows-- )
+  {
+    for( Int n = 0; n < iW; n += 16 )
+    {
+      __m256i vDiff = _mm256_sub_epi16( _mm256_loadu_si256( (const __m256i*)( piOrg + n ) ), _mm256_loadu_si256( (const __m256i*)( piCur + n ) ) );
+      __m256i vLo   = _mm256_mullo_epi16( vDiff, vDiff );
+      __m256i vHi   = _mm256_mulhi_epi16( vDiff, vDiff );
+      vSum = _mm256_add_epi32( vSum, _mm256_srl_epi32( _mm256_unpacklo_epi16( vLo, vHi ), vShift ) );
+      vSum = _mm256_add_epi32( vSum, _mm256_srl_epi32( _mm256_unpackhi_epi16( vLo, vHi ), vShift ) );
+    }
+    piOrg += iStrideOrg;
+    piCur += iStrideCur;
+  }
+  return xHorSumAVX2( vSum );
+}
+
+/** 4-point Hadamard butterflies of 4 vectors
+ */
+SIMD_TARGET_SSE41
+static inline Void xHadamard4SSE41( __m128i* v )
+{
+  __m128i a0 = _mm_add_epi32( v[0], v[1] );
+  __m128i a1 = _mm_sub_epi32( v[0], v[1] );
+  __m128i a2 = _mm_add_epi32( v[2], v[3] );
+  __m128i a3 = _mm_sub_epi32( v[2], v[3] );
+  v[0] = _mm_add_epi32( a0, a2 );
+  v[1] = _mm_sub_epi32( a0, a2 );
+  v[2] = _mm_add_epi32( a1, a3 );
+  v[3] = _mm_sub_epi32( a1, a3 );
+}
+
+SIMD_TARGET_SSE41
+static inline Void xTranspose4x4SSE41( __m128i* v )
+{
+  __m128i t0 = _mm_unpacklo_epi32( v[0], v[1] );
+  __m128i t1 = _mm_unpacklo_epi32( v[2], v[3] );
+  __m128i t2 = _mm_unpackhi_epi32( v[0], v[1] );
+  __m128i t3 = _mm_unpackhi_epi32( v[2], v[3] );
+  v[0] = _mm_unpacklo_epi64( t0, t1 );
+  v[1] = _mm_unpackhi_epi64( t0, t1 );
+  v[2] = _mm_unpacklo_epi64( t2, t3 );
+  v[3] = _mm_unpackhi_epi64( t2, t3 );
+}
+
+SIMD_TARGET_SSE41
+static inline __m128i xLoadDiff4SSE41( const Pel* piOrg, const Pel* piCur )
+{
+  return _mm_sub_epi32( _mm_cvtepi16_epi32( _mm_loadl_epi64( (const __m128i*)piOrg ) ), _mm_cvtepi16_epi32( _mm_loadl_epi64( (const __m128i*)piCur ) ) );
+}
+
+/** 4x4 Hadamard transform on 32 bits, the coefficients are those of xCalcHADs4x4() up to their order and sign
+ */
+SIMD_TARGET_SSE41
+static UInt xCalcHADs4x4SSE41( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m128i v[4];
+  for( Int k = 0; k < 4; k++ )
+  {
+    v[k] = xLoadDiff4SSE41( piOrg + k * iStrideOrg, piCur + k * iStrideCur );
+  }
+  xHadamard4SSE41( v );
+  xTranspose4x4SSE41( v );
+  xHadamard4SSE41( v );
+  __m128i vSum = _mm_add_epi32( _mm_add_epi32( _mm_abs_epi32( v[0] ), _mm_abs_epi32( v[1] ) ), _mm_add_epi32( _mm_abs_epi32( v[2] ), _mm_abs_epi32( v[3] ) ) );
+  UInt satd = xHorSumSSE41( vSum );
+  return ( satd + 1 ) >> 1;
+}
+
+/** 8-point Hadamard butterflies of 8 vectors
+ */
+SIMD_TARGET_SSE41
+static inline Void xHadamard8SSE41( __m128i* v )
+{
+  __m128i a[8], b[8];
+  for( Int k = 0; k < 4; k++ )
+  {
+    a[k]     = _mm_add_epi32( v[k], v[k + 4] );
+    a[k + 4] = _mm_sub_epi32( v[k], v[k + 4] );
+  }
+  for( Int k = 0; k < 8; k += 4 )
+  {
+    b[k]     = _mm_add_epi32( a[k],     a[k + 2] );
+    b[k + 1] = _mm_add_epi32( a[k + 1], a[k + 3] );
+    b[k + 2] = _mm_sub_epi32( a[k],     a[k + 2] );
+    b[k + 3] = _mm_sub_epi32( a[k + 1], a[k + 3] );
+  }
+  for( Int k = 0; k < 8; k += 2 )
+  {
+    v[k]     = _mm_add_epi32( b[k], b[k + 1] );
+    v[k + 1] = _mm_sub_epi32( b[k], b[k + 1] );
+  }
+}
+
+SIMD_TARGET_AVX2
+static inline Void xHadamard8AVX2( __m256i* v )
+{
+  __m256i a[8], b[8];
+  for( Int k = 0; k < 4; k++ )
+  {
+    a[k]     = _mm256_add_epi32( v[k], v[k + 4] );
+    a[k + 4] = _mm256_sub_epi32( v[k], v[k + 4] );
+  }
+  for( Int k = 0; k < 8; k += 4 )
+  {
+    b[k]     = _mm256_add_epi32( a[k],     a[k + 2] );
+    b[k + 1] = _mm256_add_epi32( a[k + 1], a[k + 3] );
+    b[k + 2] = _mm256_sub_epi32( a[k],     a[k + 2] );
+    b[k + 3] = _mm256_sub_epi32( a[k + 1], a[k + 3] );
+  }
+  for( Int k = 0; k < 8; k += 2 )
+  {
+    v[k]     = _mm256_add_epi32( b[k], b[k + 1] );
+    v[k + 1] = _mm256_sub_epi32( b[k], b[k + 1] );
+  }
+}
+
+/** 8x8 Hadamard transform on 32 bits, the rows are split in a left and a right half of 4 samples
+ */
+SIMD_TARGET_SSE41
+static UInt xCalcHADs8x8SSE41( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m128i vL[8], vR[8];
+  for( Int k = 0; k < 8; k++ )
+  {
+    vL[k] = xLoadDiff4SSE41( piOrg + k * iStrideOrg,     piCur + k * iStrideCur );
+    vR[k] = xLoadDiff4SSE41( piOrg + k * iStrideOrg + 4, piCur + k * iStrideCur + 4 );
+  }
+  // vertical
+  xHadamard8SSE41( vL );
+  xHadamard8SSE41( vR );
+
+  // transpose the four 4x4 quarters, the columns 0-3 are then in vL and the columns 4-7 in vR
+  __m128i vT[8];
+  xTranspose4x4SSE41( vL );
+  xTranspose4x4SSE41( vL + 4 );
+  xTranspose4x4SSE41( vR );
+  xTranspose4x4SSE41( vR + 4 );
+  for( Int k = 0; k < 4; k++ )
+  {
+    vT[k]     = vL[k];
+    vT[k + 4] = vR[k];
+    vR[k]     = vL[k + 4];
+  }
+  for( Int k = 0; k < 8; k++ )
+  {
+    vL[k] = vT[k];
+  }
+  xHadamard8SSE41( vL );
+  xHadamard8SSE41( vR );
+
+  __m128i vSum = _mm_setzero_si128();
+  for( Int k = 0; k < 8; k++ )
+  {
+    vSum = _mm_add_epi32( vSum, _mm_add_epi32( _mm_abs_epi32( vL[k] ), _mm_abs_epi32( vR[k] ) ) );
+  }
+  UInt sad = xHorSumSSE41( vSum );
+  return ( sad + 2 ) >> 2;
+}
+
+/** 8x8 Hadamard transform on 32 bits, one row per vector
+ */
+SIMD_TARGET_AVX2
+static UInt xCalcHADs8x8AVX2( const Pel* piOrg, const Pel* piCur, Int iStrideOrg, Int iStrideCur )
+{
+  __m256i v[8];
+  for( Int k = 0; k < 8; k++ )
+  {
+    v[k] = _mm256_sub_epi32( _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)( piOrg + k * iStrideOrg ) ) ),
+                             _mm256_cvtepi16_epi32( _mm_loadu_si128( (const __m128i*)( piCur + k * iStrideCur ) ) ) );
+  }
+  // vertical
+  xHadamard8AVX2( v );
+
+  // transpose
+  __m256i t[8], u[8];
+  for( Int k = 0; k < 8; k += 2 )
+  {
+    t[k]     = _mm256_unpacklo_epi32( v[k], v[k + 1] );
+    t[k + 1] = _mm256_unpackhi_epi32( v[k], v[k + 1] );
+  }
+  for( Int k = 0; k < 8; k += 4 )
+  {
+    u[k]     = _mm256_unpacklo_epi64( t[k],     t[k + 2] );
+    u[k + 1] = _mm256_unpackhi_epi64( t[k],     t[k + 2] );
+    u[k + 2] = _mm256_unpacklo_epi64( t[k + 1], t[k + 3] );
+    u[k + 3] = _mm256_unpackhi_epi64( t[k + 1], t[k + 3] );
+  }
+  for( Int k = 0; k < 4; k++ )
+  {
+    v[k]     = _mm256_permute2x128_si256( u[k], u[k + 4], 0x20 );
+    v[k + 4] = _mm256_permute2x128_si256( u[k], u[k + 4], 0x31 );
+  }
+  xHadamard8AVX2( v );
+
+  __m256i vSum = _mm256_setzero_si256();
+  for( Int k = 0; k < 8; k++ )
+  {
+    vSum = _mm256_add_epi32( vSum, _mm256_abs_epi32( v[k] ) );
+  }
+  UInt sad = xHorSumAVX2( vSum );
+  return ( sad + 2 ) >> 2;
+}
+
+template<Int iWidth, SimdLevel eLevel>
+UInt TComRdCost::xGetSADSIMD( DistParam* pcDtParam )
+{
+  // as in the C code, the weighted SAD is not used for the 16NxM function
+  if ( iWidth != 0 && pcDtParam->bApplyWeight )
+  {
+    return xGetSADw( pcDtParam );
+  }
+  Int  iSubShift  = pcDtParam->iSubShift;
+  Int  iSubStep   = ( 1 << iSubShift );
+  Int  iStrideCur = pcDtParam->iStrideCur*iSubStep;
+  Int  iStrideOrg = pcDtParam->iStrideOrg*iSubStep;
+
+  UInt uiSum = eLevel >= SIMD_AVX2 && ( iWidth == 0 || iWidth >= 16 )
+             ? xGetSADAVX2 <iWidth>( pcDtParam->pOrg, iStrideOrg, pcDtParam->pCur, iStrideCur, pcDtParam->iRows, pcDtParam->iCols, iSubStep )
+             : xGetSADSSE41<iWidth>( pcDtParam->pOrg, iStrideOrg, pcDtParam->pCur, iStrideCur, pcDtParam->iRows, pcDtParam->iCols, iSubStep );
+
+  uiSum <<= iSubShift;
+  return uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8);
+}
+
+template<Int iWidth, SimdLevel eLevel>
+UInt TComRdCost::xGetSSESIMD( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    assert( iWidth == 0 || pcDtParam->iCols == iWidth );
+    return xGetSSEw( pcDtParam );
+  }
+  UInt uiShift = DISTORTION_PRECISION_ADJUSTMENT((pcDtParam->bitDepth-8) << 1);
+
+  if( eLevel >= SIMD_AVX2 && ( iWidth == 0 || iWidth >= 16 ) )
+  {
+    return xGetSSEAVX2<iWidth>( pcDtParam->pOrg, pcDtParam->iStrideOrg, pcDtParam->pCur, pcDtParam->iStrideCur, pcDtParam->iRows, pcDtParam->iCols, uiShift );
+  }
+  return xGetSSESSE41<iWidth>( pcDtParam->pOrg, pcDtParam->iStrideOrg, pcDtParam->pCur, pcDtParam->iStrideCur, pcDtParam->iRows, pcDtParam->iCols, uiShift );
+}
+
+template<SimdLevel eLevel>
+UInt TComRdCost::xGetHADsSIMD( DistParam* pcDtParam )
+{
+  if ( pcDtParam->bApplyWeight )
+  {
+    return xGetHADsw( pcDtParam );
+  }
+  Pel* piOrg   = pcDtParam->pOrg;
+  Pel* piCur   = pcDtParam->pCur;
+  Int  iRows   = pcDtParam->iRows;
+  Int  iCols   = pcDtParam->iCols;
+  Int  iStrideCur = pcDtParam->iStrideCur;
+  Int  iStrideOrg = pcDtParam->iStrideOrg;
+
+  UInt uiSum = 0;
+
+  assert( pcDtParam->iStep == 1 );
+  if( ( iRows % 8 == 0) && (iCols % 8 == 0) )
+  {
+    for ( Int y=0; y<iRows; y+= 8 )
+    {
+      for ( Int x=0; x<iCols; x+= 8 )
+      {
+        uiSum += eLevel >= SIMD_AVX2 ? xCalcHADs8x8AVX2( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur ) : xCalcHADs8x8SSE41( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg<<3;
+      piCur += iStrideCur<<3;
+    }
+  }
+  else if( ( iRows % 4 == 0) && (iCols % 4 == 0) )
+  {
+    for ( Int y=0; y<iRows; y+= 4 )
+    {
+      for ( Int x=0; x<iCols; x+= 4 )
+      {
+        uiSum += xCalcHADs4x4SSE41( &piOrg[x], &piCur[x], iStrideOrg, iStrideCur );
+      }
+      piOrg += iStrideOrg<<2;
+      piCur += iStrideCur<<2;
+    }
+  }
+  else
+  {
+    return xGetHADs( pcDtParam );
+  }
+
+  return uiSum >> DISTORTION_PRECISION_ADJUSTMENT(pcDtParam->bitDepth-8);
+}
+
+Void TComRdCost::xInitSimdDistortFunc( SimdLevel eLevel )
+{
+  if( eLevel >= SIMD_AVX2 )
+  {
+    m_afpDistortFunc[DF_SSE4  ] = xGetSSESIMD< 4, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SSE8  ] = xGetSSESIMD< 8, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SSE16 ] = xGetSSESIMD<16, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SSE32 ] = xGetSSESIMD<32, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SSE64 ] = xGetSSESIMD<64, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SSE16N] = xGetSSESIMD< 0, SIMD_AVX2>;
+
+    m_afpDistortFunc[DF_SAD4  ] = m_afpDistortFunc[DF_SADS4  ] = xGetSADSIMD< 4, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SAD8  ] = m_afpDistortFunc[DF_SADS8  ] = xGetSADSIMD< 8, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SAD16 ] = m_afpDistortFunc[DF_SADS16 ] = xGetSADSIMD<16, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SAD32 ] = m_afpDistortFunc[DF_SADS32 ] = xGetSADSIMD<32, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SAD64 ] = m_afpDistortFunc[DF_SADS64 ] = xGetSADSIMD<64, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SAD16N] = m_afpDistortFunc[DF_SADS16N] = xGetSADSIMD< 0, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SAD12 ] = m_afpDistortFunc[DF_SADS12 ] = xGetSADSIMD<12, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SAD24 ] = m_afpDistortFunc[DF_SADS24 ] = xGetSADSIMD<24, SIMD_AVX2>;
+    m_afpDistortFunc[DF_SAD48 ] = m_afpDistortFunc[DF_SADS48 ] = xGetSADSIMD<48, SIMD_AVX2>;
+
+    for( Int i = DF_HADS; i <= DF_HADS16N; i++ )
+    {
+      m_afpDistortFunc[i] = xGetHADsSIMD<SIMD_AVX2>;
+    }
+  }
+  else if( eLevel >= SIMD_SSE41 )
+  {
+    m_afpDistortFunc[DF_SSE4  ] = xGetSSESIMD< 4, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SSE8  ] = xGetSSESIMD< 8, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SSE16 ] = xGetSSESIMD<16, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SSE32 ] = xGetSSESIMD<32, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SSE64 ] = xGetSSESIMD<64, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SSE16N] = xGetSSESIMD< 0, SIMD_SSE41>;
+
+    m_afpDistortFunc[DF_SAD4  ] = m_afpDistortFunc[DF_SADS4  ] = xGetSADSIMD< 4, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SAD8  ] = m_afpDistortFunc[DF_SADS8  ] = xGetSADSIMD< 8, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SAD16 ] = m_afpDistortFunc[DF_SADS16 ] = xGetSADSIMD<16, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SAD32 ] = m_afpDistortFunc[DF_SADS32 ] = xGetSADSIMD<32, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SAD64 ] = m_afpDistortFunc[DF_SADS64 ] = xGetSADSIMD<64, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SAD16N] = m_afpDistortFunc[DF_SADS16N] = xGetSADSIMD< 0, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SAD12 ] = m_afpDistortFunc[DF_SADS12 ] = xGetSADSIMD<12, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SAD24 ] = m_afpDistortFunc[DF_SADS24 ] = xGetSADSIMD<24, SIMD_SSE41>;
+    m_afpDistortFunc[DF_SAD48 ] = m_afpDistortFunc[DF_SADS48 ] = xGetSADSIMD<48, SIMD_SSE41>;
+
+    for( Int i = DF_HADS; i <= DF_HADS16N; i++ )
+    {
+      m_afpDistortFunc[i] = xGetHADsSIMD<SIMD_SSE41>;
+    }
+  }
+}
+
+/** Check that the distortion functions of the selected instruction set level give the results of the C code
+ * \returns true when all the results are identical
+ */
+Bool TComRdCost::checkSimdKernels()
+{
+  if( getSimdLevel() == SIMD_NONE )
+  {
+    return true;
+  }
+
+  TComRdCost cSimd;
+
+  SimdLevel eLevel = getSimdLevel();
+  setSimdLevel( SIMD_NONE );
+  TComRdCost cRef;
+  setSimdLevel( eLevel );
+
+  const Int iStride = 160;
+  const Int iSize   = iStride * 72;
+  std::vector<Pel> acOrg( iSize ), acCur( iSize );
+
+  static const Int aiHeight[] = { 4, 8, 12, 16, 24, 32, 64 };
+  UInt uiSeed = 12345;
+
+  for( Int iTest = 0; iTest < 4; iTest++ )
+  {
+    for( Int bitDepth = 8; bitDepth <= 10; bitDepth += 2 )
+    {
+      const Int iMax = ( 1 << bitDepth ) - 1;
+      for( Int i = 0; i < iSize; i++ )
+      {
+        uiSeed = uiSeed * 1103515245 + 12345;
+        Int iVal = ( uiSeed >> 16 ) % ( iMax + 1 );
+        // extreme values in the last tests
+        acOrg[i] = iTest < 2 ? iVal : ( iTest == 2 ? iMax : ( iVal & 1 ) * iMax );
+        acCur[i] = iTest < 2 ? ( iTest == 0 ? iVal ^ ( uiSeed >> 8 & 3 ) : iMax - iVal ) : ( iTest == 2 ? 0 : iMax - acOrg[i] );
+      }
+
+      for( Int iFunc = DF_SSE4; iFunc <= DF_SAD48; iFunc++ )
+      {
+        if( ( iFunc > DF_HADS16N && iFunc < DF_SAD12 ) || cSimd.m_afpDistortFunc[iFunc] == cRef.m_afpDistortFunc[iFunc] )
+        {
+          continue;
+        }
+        Int iWidth;
+        switch( iFunc )
+        {
+        case DF_SAD12: case DF_SADS12: iWidth = 12; break;
+        case DF_SAD24: case DF_SADS24: iWidth = 24; break;
+        case DF_SAD48: case DF_SADS48: iWidth = 48; break;
+        default:
+          {
+            Int iIdx = ( iFunc - DF_SSE4 ) % ( DF_SAD4 - DF_SSE4 );
+            iWidth   = iIdx == DF_SSE16N - DF_SSE4 ? 128 : 4 << iIdx;
+            if( iFunc >= DF_HADS && iFunc <= DF_HADS16N )
+            {
+              // the Hadamard functions support any multiple of 4
+              iWidth = iIdx == DF_SSE16N - DF_SSE4 ? 12 : iWidth;
+            }
+          }
+          break;
+        }
+
+        for( Int h = 0; h < Int( sizeof( aiHeight ) / sizeof( aiHeight[0] ) ); h++ )
+        {
+          for( Int iSubShift = 0; iSubShift <= ( iFunc >= DF_SAD && iFunc < DF_HADS ? 1 : 0 ); iSubShift++ )
+          {
+            DistParam cDtParam;
+            cDtParam.pOrg         = &acOrg[iTest * 3];
+            cDtParam.pCur         = &acCur[iTest];
+            cDtParam.iStrideOrg   = iStride - iTest;
+            cDtParam.iStrideCur   = iStride;
+            cDtParam.iRows        = aiHeight[h];
+            cDtParam.iCols        = iWidth;
+            cDtParam.iStep        = 1;
+            cDtParam.iSubShift    = iSubShift;
+            cDtParam.bitDepth     = bitDepth;
+            cDtParam.bApplyWeight = false;
+
+            if( cSimd.m_afpDistortFunc[iFunc]( &cDtParam ) != cRef.m_afpDistortFunc[iFunc]( &cDtParam ) )
+            {
+              return false;
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+#endif
+
 //! \}
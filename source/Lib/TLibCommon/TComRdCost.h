@@ -45,6 +45,7 @@
 
 #include "TComSlice.h"
 #include "TComRdCostWeightPrediction.h"
+#include "TComSimd.h"
 
 //! \ingroup TLibCommon
 //! \{
@@ -232,10 +233,23 @@ private:
   static UInt xCalcHADs2x2      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
   static UInt xCalcHADs4x4      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
   static UInt xCalcHADs8x8      ( Pel *piOrg, Pel *piCurr, Int iStrideOrg, Int iStrideCur, Int iStep );
+
+#if SIMD_X86
+  // vectorised versions of the distortion functions, iWidth = 0 stands for any multiple of 16
+  template<Int iWidth, SimdLevel eLevel> static UInt xGetSSESIMD  ( DistParam* pcDtParam );
+  template<Int iWidth, SimdLevel eLevel> static UInt xGetSADSIMD  ( DistParam* pcDtParam );
+  template<SimdLevel eLevel>             static UInt xGetHADsSIMD ( DistParam* pcDtParam );
+
+  Void    xInitSimdDistortFunc( SimdLevel eLevel );          ///< replace the C distortion functions by the kernels of the instruction set level
+#endif
   
 public:
   UInt   getDistPart(Int bitDepth, Pel* piCur, Int iCurStride,  Pel* piOrg, Int iOrgStride, UInt uiBlkWidth, UInt uiBlkHeight, TextType eText = TEXT_LUMA, DFunc eDFunc = DF_SSE );
 
+#if SIMD_X86
+  static Bool checkSimdKernels();                             ///< compare the distortion kernels of the selected instruction set level with the C code
+#endif
+
 };// END CLASS DEFINITION TComRdCost
 
 //! \}
@@ -40,12 +40,12 @@
 #include "TComRdCost.h"
 #include "TComRdCostWeightPrediction.h"
 
-Int   TComRdCostWeightPrediction::m_w0        = 0;
-Int   TComRdCostWeightPrediction::m_w1        = 0;
-Int   TComRdCostWeightPrediction::m_shift     = 0;
-Int   TComRdCostWeightPrediction::m_offset    = 0;
-Int   TComRdCostWeightPrediction::m_round     = 0;
-Bool  TComRdCostWeightPrediction::m_xSetDone  = false;
+THREAD_LOCAL Int   TComRdCostWeightPrediction::m_w0        = 0;
+THREAD_LOCAL Int   TComRdCostWeightPrediction::m_w1        = 0;
+THREAD_LOCAL Int   TComRdCostWeightPrediction::m_shift     = 0;
+THREAD_LOCAL Int   TComRdCostWeightPrediction::m_offset    = 0;
+THREAD_LOCAL Int   TComRdCostWeightPrediction::m_round     = 0;
+THREAD_LOCAL Bool  TComRdCostWeightPrediction::m_xSetDone  = false;
 
 // ====================================================================================================================
 // Distortion functions
@@ -56,11 +56,11 @@ class TComPattern;
 class TComRdCostWeightPrediction
 {
 private:
-  static  Int   m_w0, m_w1; // current wp scaling values
-  static  Int   m_shift;
-  static  Int   m_offset;
-  static  Int   m_round;
-  static  Bool  m_xSetDone;
+  static  THREAD_LOCAL Int   m_w0, m_w1; // current wp scaling values
+  static  THREAD_LOCAL Int   m_shift;
+  static  THREAD_LOCAL Int   m_offset;
+  static  THREAD_LOCAL Int   m_round;
+  static  THREAD_LOCAL Bool  m_xSetDone;
 
 public:
   TComRdCostWeightPrediction();
@@ -37,8 +37,10 @@
 
 #include "TComRom.h"
 #include <memory.h>
+#include <assert.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <mutex>
 // ====================================================================================================================
 // Initialize / destroy functions
 // ====================================================================================================================
@@ -46,9 +48,18 @@
 //! \ingroup TLibCommon
 //! \{
 
+static std::mutex s_cROMMutex;
+static Int        s_iROMRefCount = 0;         ///< number of encoder/decoder instances using the ROM tables
+
 // initialize ROM variables
 Void initROM()
 {
+  std::lock_guard<std::mutex> cLock( s_cROMMutex );
+  if ( s_iROMRefCount++ > 0 )
+  {
+    return;
+  }
+
   Int i, c;
   
   // g_aucConvertToBit[ x ]: log2(x/4), if x=4 -> 0, x=8 -> 1, x=16 -> 2, ...
@@ -74,6 +85,12 @@ Void initROM()
 
 Void destroyROM()
 {
+  std::lock_guard<std::mutex> cLock( s_cROMMutex );
+  if ( s_iROMRefCount == 0 || --s_iROMRefCount > 0 )
+  {
+    return;
+  }
+
   for (Int i=0; i<MAX_CU_DEPTH; i++ )
   {
     delete[] g_auiSigLastScan[0][i];
@@ -86,14 +103,14 @@ Void destroyROM()
 // Data structure related table & variable
 // ====================================================================================================================
 
-UInt g_uiMaxCUWidth  = MAX_CU_SIZE;
-UInt g_uiMaxCUHeight = MAX_CU_SIZE;
-UInt g_uiMaxCUDepth  = MAX_CU_DEPTH;
-UInt g_uiAddCUDepth  = 0;
-UInt g_auiZscanToRaster [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
-UInt g_auiRasterToZscan [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
-UInt g_auiRasterToPelX  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
-UInt g_auiRasterToPelY  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
+THREAD_LOCAL UInt g_uiMaxCUWidth  = MAX_CU_SIZE;
+THREAD_LOCAL UInt g_uiMaxCUHeight = MAX_CU_SIZE;
+THREAD_LOCAL UInt g_uiMaxCUDepth  = MAX_CU_DEPTH;
+THREAD_LOCAL UInt g_uiAddCUDepth  = 0;
+THREAD_LOCAL UInt g_auiZscanToRaster [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
+THREAD_LOCAL UInt g_auiRasterToZscan [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
+THREAD_LOCAL UInt g_auiRasterToPelX  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
+THREAD_LOCAL UInt g_auiRasterToPelY  [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ] = { 0, };
 
 UInt g_auiPUOffset[8] = { 0, 8, 4, 4, 2, 10, 1, 5};
 
@@ -301,11 +318,11 @@ const UChar g_aucConvertTxtTypeToIdx[4] = { 0, 1, 1, 2 };
 // Bit-depth
 // ====================================================================================================================
 
-Int  g_bitDepthY = 8;
-Int  g_bitDepthC = 8;
+THREAD_LOCAL Int  g_bitDepthY = 8;
+THREAD_LOCAL Int  g_bitDepthC = 8;
 
-UInt g_uiPCMBitDepthLuma     = 8;    // PCM bit-depth
-UInt g_uiPCMBitDepthChroma   = 8;    // PCM bit-depth
+THREAD_LOCAL UInt g_uiPCMBitDepthLuma     = 8;    // PCM bit-depth
+THREAD_LOCAL UInt g_uiPCMBitDepthChroma   = 8;    // PCM bit-depth
 
 // ====================================================================================================================
 // Misc.
@@ -505,21 +522,19 @@ Int  g_eTTable[4] = {0,3,1,2};
 
 #if SVC_EXTENSION
 #if FAST_INTRA_SHVC
-UInt g_reducedSetIntraModes[NUM_INTRA_MODE-1] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 }; 
+THREAD_LOCAL UInt g_reducedSetIntraModes[NUM_INTRA_MODE-1] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 }; 
 UInt g_predefSetIntraModes[NUM_INTRA_MODE-1] = {26,10,18,34,2,22,14,30,6,24,12,28,8,20,16,32,4,17,19,15,21,13,23,11,25,9,27,7,29,5,31,3,33,0,2};
 #endif
 #if O0194_DIFFERENT_BITDEPTH_EL_BL
-Int  g_bitDepthYLayer[MAX_LAYERS];
-Int  g_bitDepthCLayer[MAX_LAYERS];
+THREAD_LOCAL Int  g_bitDepthYLayer[MAX_LAYERS];
+THREAD_LOCAL Int  g_bitDepthCLayer[MAX_LAYERS];
 
-UInt g_uiPCMBitDepthLumaDec[MAX_LAYERS];    // PCM bit-depth
-UInt g_uiPCMBitDepthChromaDec[MAX_LAYERS];    // PCM bit-depth
+THREAD_LOCAL UInt g_uiPCMBitDepthLumaDec[MAX_LAYERS];    // PCM bit-depth
+THREAD_LOCAL UInt g_uiPCMBitDepthChromaDec[MAX_LAYERS];    // PCM bit-depth
 #endif
 #if O0194_WEIGHTED_PREDICTION_CGS
-void * g_refWeightACDCParam; // type=wpACDCParam
+THREAD_LOCAL void * g_refWeightACDCParam; // type=wpACDCParam
 #endif
-Int g_mvScalingFactor  [MAX_LAYERS][2] = {{0,0}, {0,0}};
-Int g_posScalingFactor [MAX_LAYERS][2] = {{0,0}, {0,0}};
 
 std::string NaluToStr( NalUnitType nalu )
 {
@@ -578,4 +593,72 @@ UInt g_auiLayerRasterToPelY[MAX_LAYERS][ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
 #endif
 #endif //SVC_EXTENSION
 
+// ====================================================================================================================
+// Coding context
+// ====================================================================================================================
+
+TComCodingContext::TComCodingContext()
+: m_bValid         ( false )
+, m_bLayerBitDepths( false )
+{
+}
+
+/** store the thread-local coding state of the calling thread
+ * \param bLayerBitDepths include the bit-depth tables of all layers, which are only consistent within one encoder instance
+ */
+Void TComCodingContext::save( Bool bLayerBitDepths )
+{
+  m_bitDepthY           = g_bitDepthY;
+  m_bitDepthC           = g_bitDepthC;
+  m_uiPCMBitDepthLuma   = g_uiPCMBitDepthLuma;
+  m_uiPCMBitDepthChroma = g_uiPCMBitDepthChroma;
+  m_uiMaxCUWidth        = g_uiMaxCUWidth;
+  m_uiMaxCUHeight       = g_uiMaxCUHeight;
+  m_uiMaxCUDepth        = g_uiMaxCUDepth;
+  m_uiAddCUDepth        = g_uiAddCUDepth;
+  ::memcpy( m_auiZscanToRaster, g_auiZscanToRaster, sizeof( m_auiZscanToRaster ) );
+  ::memcpy( m_auiRasterToZscan, g_auiRasterToZscan, sizeof( m_auiRasterToZscan ) );
+  ::memcpy( m_auiRasterToPelX,  g_auiRasterToPelX,  sizeof( m_auiRasterToPelX ) );
+  ::memcpy( m_auiRasterToPelY,  g_auiRasterToPelY,  sizeof( m_auiRasterToPelY ) );
+#if O0194_DIFFERENT_BITDEPTH_EL_BL
+  if ( bLayerBitDepths )
+  {
+    ::memcpy( m_bitDepthYLayer,         g_bitDepthYLayer,         sizeof( m_bitDepthYLayer ) );
+    ::memcpy( m_bitDepthCLayer,         g_bitDepthCLayer,         sizeof( m_bitDepthCLayer ) );
+    ::memcpy( m_uiPCMBitDepthLumaDec,   g_uiPCMBitDepthLumaDec,   sizeof( m_uiPCMBitDepthLumaDec ) );
+    ::memcpy( m_uiPCMBitDepthChromaDec, g_uiPCMBitDepthChromaDec, sizeof( m_uiPCMBitDepthChromaDec ) );
+  }
+#endif
+  m_bLayerBitDepths     = bLayerBitDepths;
+  m_bValid              = true;
+}
+
+/** replace the thread-local coding state of the calling thread by the saved one
+ */
+Void TComCodingContext::bind() const
+{
+  assert( m_bValid );
+  g_bitDepthY           = m_bitDepthY;
+  g_bitDepthC           = m_bitDepthC;
+  g_uiPCMBitDepthLuma   = m_uiPCMBitDepthLuma;
+  g_uiPCMBitDepthChroma = m_uiPCMBitDepthChroma;
+  g_uiMaxCUWidth        = m_uiMaxCUWidth;
+  g_uiMaxCUHeight       = m_uiMaxCUHeight;
+  g_uiMaxCUDepth        = m_uiMaxCUDepth;
+  g_uiAddCUDepth        = m_uiAddCUDepth;
+  ::memcpy( g_auiZscanToRaster, m_auiZscanToRaster, sizeof( m_auiZscanToRaster ) );
+  ::memcpy( g_auiRasterToZscan, m_auiRasterToZscan, sizeof( m_auiRasterToZscan ) );
+  ::memcpy( g_auiRasterToPelX,  m_auiRasterToPelX,  sizeof( m_auiRasterToPelX ) );
+  ::memcpy( g_auiRasterToPelY,  m_auiRasterToPelY,  sizeof( m_auiRasterToPelY ) );
+#if O0194_DIFFERENT_BITDEPTH_EL_BL
+  if ( m_bLayerBitDepths )
+  {
+    ::memcpy( g_bitDepthYLayer,         m_bitDepthYLayer,         sizeof( m_bitDepthYLayer ) );
+    ::memcpy( g_bitDepthCLayer,         m_bitDepthCLayer,         sizeof( m_bitDepthCLayer ) );
+    ::memcpy( g_uiPCMBitDepthLumaDec,   m_uiPCMBitDepthLumaDec,   sizeof( m_uiPCMBitDepthLumaDec ) );
+    ::memcpy( g_uiPCMBitDepthChromaDec, m_uiPCMBitDepthChromaDec, sizeof( m_uiPCMBitDepthChromaDec ) );
+  }
+#endif
+}
+
 //! \}
@@ -67,23 +67,23 @@ Void         initSigLastScan(UInt* pBuffD, UInt* pBuffH, UInt* pBuffV, Int iWidt
 // ====================================================================================================================
 
 // flexible conversion from relative to absolute index
-extern       UInt   g_auiZscanToRaster[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
-extern       UInt   g_auiRasterToZscan[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+extern THREAD_LOCAL UInt g_auiZscanToRaster[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+extern THREAD_LOCAL UInt g_auiRasterToZscan[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
 
 Void         initZscanToRaster ( Int iMaxDepth, Int iDepth, UInt uiStartVal, UInt*& rpuiCurrIdx );
 Void         initRasterToZscan ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxDepth         );
 
 // conversion of partition index to picture pel position
-extern       UInt   g_auiRasterToPelX[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
-extern       UInt   g_auiRasterToPelY[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+extern THREAD_LOCAL UInt g_auiRasterToPelX[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+extern THREAD_LOCAL UInt g_auiRasterToPelY[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
 
 Void         initRasterToPelXY ( UInt uiMaxCUWidth, UInt uiMaxCUHeight, UInt uiMaxDepth );
 
 // global variable (LCU width/height, max. CU depth)
-extern       UInt g_uiMaxCUWidth;
-extern       UInt g_uiMaxCUHeight;
-extern       UInt g_uiMaxCUDepth;
-extern       UInt g_uiAddCUDepth;
+extern THREAD_LOCAL UInt g_uiMaxCUWidth;
+extern THREAD_LOCAL UInt g_uiMaxCUHeight;
+extern THREAD_LOCAL UInt g_uiMaxCUDepth;
+extern THREAD_LOCAL UInt g_uiAddCUDepth;
 
 #define MAX_TS_WIDTH  4
 #define MAX_TS_HEIGHT 4
@@ -133,10 +133,10 @@ extern const UChar  g_aucIntraModeNumFast[ MAX_CU_DEPTH ];
 // Bit-depth
 // ====================================================================================================================
 
-extern        Int g_bitDepthY;
-extern        Int g_bitDepthC;
-extern       UInt g_uiPCMBitDepthLuma;
-extern       UInt g_uiPCMBitDepthChroma;
+extern THREAD_LOCAL Int  g_bitDepthY;
+extern THREAD_LOCAL Int  g_bitDepthC;
+extern THREAD_LOCAL UInt g_uiPCMBitDepthLuma;
+extern THREAD_LOCAL UInt g_uiPCMBitDepthChroma;
 
 // ====================================================================================================================
 // Texture type to integer mapping
@@ -272,11 +272,9 @@ extern Int  g_eTTable[4];
 
 #if SVC_EXTENSION
 #if FAST_INTRA_SHVC
-extern UInt g_reducedSetIntraModes[NUM_INTRA_MODE-1];
+extern THREAD_LOCAL UInt g_reducedSetIntraModes[NUM_INTRA_MODE-1];
 extern UInt g_predefSetIntraModes[NUM_INTRA_MODE-1];
 #endif
-extern Int g_mvScalingFactor  [MAX_LAYERS][2];
-extern Int g_posScalingFactor [MAX_LAYERS][2];
 std::string NaluToStr( NalUnitType nalu );
 #if LAYER_CTB
 extern       UInt g_auiLayerMaxCUWidth[MAX_LAYERS];
@@ -290,6 +288,43 @@ extern       UInt g_auiLayerRasterToPelY[MAX_LAYERS][ MAX_NUM_SPU_W*MAX_NUM_SPU_
 #endif
 #endif //SVC_EXTENSION
 
+// ====================================================================================================================
+// Coding context
+// ====================================================================================================================
+
+/// copy of the thread-local coding state (bit-depths, CU structure and partition index tables) of one layer
+class TComCodingContext
+{
+private:
+  Bool  m_bValid;                                                 ///< state has been saved
+  Bool  m_bLayerBitDepths;                                        ///< per-layer bit-depth tables are part of the state
+  Int   m_bitDepthY;
+  Int   m_bitDepthC;
+  UInt  m_uiPCMBitDepthLuma;
+  UInt  m_uiPCMBitDepthChroma;
+  UInt  m_uiMaxCUWidth;
+  UInt  m_uiMaxCUHeight;
+  UInt  m_uiMaxCUDepth;
+  UInt  m_uiAddCUDepth;
+  UInt  m_auiZscanToRaster[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt  m_auiRasterToZscan[ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt  m_auiRasterToPelX [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+  UInt  m_auiRasterToPelY [ MAX_NUM_SPU_W*MAX_NUM_SPU_W ];
+#if O0194_DIFFERENT_BITDEPTH_EL_BL
+  Int   m_bitDepthYLayer[MAX_LAYERS];
+  Int   m_bitDepthCLayer[MAX_LAYERS];
+  UInt  m_uiPCMBitDepthLumaDec[MAX_LAYERS];
+  UInt  m_uiPCMBitDepthChromaDec[MAX_LAYERS];
+#endif
+
+public:
+  TComCodingContext();
+
+  Void  save    ( Bool bLayerBitDepths = false );                 ///< take over the state of the calling thread
+  Void  bind    () const;                                         ///< make the saved state the state of the calling thread
+  Bool  isValid () const { return m_bValid; }
+};
+
 //! \}
 
 #endif  //__TCOMROM__
@@ -36,6 +36,10 @@
 */
 
 #include "TComSampleAdaptiveOffset.h"
+#include "TComSimd.h"
+#if SIMD_X86
+#include <immintrin.h>
+#endif
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
@@ -380,6 +384,165 @@ Void TComSampleAdaptiveOffset::reconstructBlkSAOParams(TComPic* pic, SAOBlkParam
 }
 
 
+#if SIMD_X86
+// ====================================================================================================================
+// Vectorised kernels, bit-exact with the C code of offsetBlock()
+// ====================================================================================================================
+
+/** Signs of c - n of 8 samples
+ */
+SIMD_TARGET_SSE41
+static inline __m128i xSignSSE41( __m128i c, __m128i n )
+{
+  return _mm_sub_epi16( _mm_cmpgt_epi16( n, c ), _mm_cmpgt_epi16( c, n ) );
+}
+
+/** Look-up of 8 16-bit entries in a table of 8 entries
+ */
+SIMD_TARGET_SSE41
+static inline __m128i xLookupSSE41( __m128i vTable, __m128i vIdx )
+{
+  return _mm_shuffle_epi8( vTable, _mm_add_epi16( _mm_mullo_epi16( vIdx, _mm_set1_epi16( 0x0202 ) ), _mm_set1_epi16( 0x0100 ) ) );
+}
+
+/** Edge offset of the samples of a rectangle. The edge class of a sample is sgn(c - a) + sgn(c - b) with its
+ *  neighbours a and b, which the C code derives incrementally with its sign lines. The last 8 samples of a
+ *  row overlap the previous ones and are computed again from the source samples.
+ */
+SIMD_TARGET_SSE41
+static Void xOffsetEdgeRectSSE41( const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int startX, Int endX, Int startY, Int endY
+                                , Int nbOffsetA, Int nbOffsetB, const Int* offset, const Int* offsetClip, Int maxVal )
+{
+  Short aiTable[8] = { 0 };
+  for( Int k = 0; k < 5; k++ )
+  {
+    aiTable[k] = (Short)offset[k];
+  }
+  const __m128i vTable = _mm_loadu_si128( (const __m128i*)aiTable );
+  const __m128i vTwo   = _mm_set1_epi16( 2 );
+  const __m128i vZero  = _mm_setzero_si128();
+  const __m128i vMax   = _mm_set1_epi16( (Short)maxVal );
+  for( Int y = startY; y < endY; y++ )
+  {
+    const Pel* srcLine = srcBlk + y * srcStride;
+    Pel*       resLine = resBlk + y * resStride;
+    if( endX - startX < 8 )
+    {
+      for( Int x = startX; x < endX; x++ )
+      {
+        Int edgeType = sgn( srcLine[x] - srcLine[x + nbOffsetA] ) + sgn( srcLine[x] - srcLine[x + nbOffsetB] );
+        resLine[x] = offsetClip[srcLine[x] + offset[edgeType + 2]];
+      }
+      continue;
+    }
+    for( Int x = startX; x < endX; x += 8 )
+    {
+      if( x + 8 > endX )
+      {
+        x = endX - 8;
+      }
+      const __m128i c = _mm_loadu_si128( (const __m128i*)( srcLine + x ) );
+      const __m128i a = _mm_loadu_si128( (const __m128i*)( srcLine + x + nbOffsetA ) );
+      const __m128i b = _mm_loadu_si128( (const __m128i*)( srcLine + x + nbOffsetB ) );
+      const __m128i vIdx = _mm_add_epi16( _mm_add_epi16( xSignSSE41( c, a ), xSignSSE41( c, b ) ), vTwo );
+      _mm_storeu_si128( (__m128i*)( resLine + x ), _mm_min_epi16( _mm_max_epi16( _mm_add_epi16( c, xLookupSSE41( vTable, vIdx ) ), vZero ), vMax ) );
+    }
+  }
+}
+
+/** Band offset of the samples of a block, the offsets of the 32 bands are looked up in 4 tables of 8 bands
+ */
+SIMD_TARGET_SSE41
+static Void xOffsetBandSSE41( const Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height
+                            , Int shiftBits, const Int* offset, const Int* offsetClip, Int maxVal )
+{
+  Short aiTable[NUM_SAO_BO_CLASSES];
+  for( Int k = 0; k < NUM_SAO_BO_CLASSES; k++ )
+  {
+    aiTable[k] = (Short)offset[k];
+  }
+  __m128i vTable[NUM_SAO_BO_CLASSES / 8];
+  for( Int i = 0; i < NUM_SAO_BO_CLASSES / 8; i++ )
+  {
+    vTable[i] = _mm_loadu_si128( (const __m128i*)( aiTable + 8 * i ) );
+  }
+  const __m128i vShift = _mm_cvtsi32_si128( shiftBits );
+  const __m128i vSeven = _mm_set1_epi16( 7 );
+  const __m128i vZero  = _mm_setzero_si128();
+  const __m128i vMax   = _mm_set1_epi16( (Short)maxVal );
+  for( Int y = 0; y < height; y++ )
+  {
+    const Pel* srcLine = srcBlk + y * srcStride;
+    Pel*       resLine = resBlk + y * resStride;
+    if( width < 8 )
+    {
+      for( Int x = 0; x < width; x++ )
+      {
+        resLine[x] = offsetClip[ srcLine[x] + offset[srcLine[x] >> shiftBits] ];
+      }
+      continue;
+    }
+    for( Int x = 0; x < width; x += 8 )
+    {
+      if( x + 8 > width )
+      {
+        x = width - 8;
+      }
+      const __m128i c     = _mm_loadu_si128( (const __m128i*)( srcLine + x ) );
+      const __m128i vBand = _mm_srl_epi16( c, vShift );
+      const __m128i vIdx  = _mm_and_si128( vBand, vSeven );
+      const __m128i vSel  = _mm_srli_epi16( vBand, 3 );
+      __m128i vOffset = xLookupSSE41( vTable[0], vIdx );
+      for( Int i = 1; i < NUM_SAO_BO_CLASSES / 8; i++ )
+      {
+        vOffset = _mm_blendv_epi8( vOffset, xLookupSSE41( vTable[i], vIdx ), _mm_cmpeq_epi16( vSel, _mm_set1_epi16( i ) ) );
+      }
+      _mm_storeu_si128( (__m128i*)( resLine + x ), _mm_min_epi16( _mm_max_epi16( _mm_add_epi16( c, vOffset ), vZero ), vMax ) );
+    }
+  }
+}
+
+/** Vectorised offsetBlock(), the samples of each class of edges are those of the C code
+ */
+SIMD_TARGET_SSE41
+static Void xOffsetBlockSSE41( Int typeIdx, Int* offset, Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride, Int width, Int height
+                             , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail
+                             , Int bitDepth, const Int* offsetClip )
+{
+  const Int maxVal = ( 1 << bitDepth ) - 1;
+  const Int startX = isLeftAvail ? 0 : 1;
+  const Int endX   = isRightAvail ? width : (width -1);
+  switch(typeIdx)
+  {
+  case SAO_TYPE_EO_0:
+    xOffsetEdgeRectSSE41( srcBlk, resBlk, srcStride, resStride, startX, endX, 0, height, -1, 1, offset, offsetClip, maxVal );
+    break;
+  case SAO_TYPE_EO_90:
+    xOffsetEdgeRectSSE41( srcBlk, resBlk, srcStride, resStride, 0, width, isAboveAvail ? 0 : 1, isBelowAvail ? height : height-1, -srcStride, srcStride, offset, offsetClip, maxVal );
+    break;
+  case SAO_TYPE_EO_135:
+    xOffsetEdgeRectSSE41( srcBlk, resBlk, srcStride, resStride, isAboveLeftAvail ? 0 : 1, isAboveAvail ? endX : 1, 0, 1, -srcStride-1, srcStride+1, offset, offsetClip, maxVal );
+    xOffsetEdgeRectSSE41( srcBlk, resBlk, srcStride, resStride, startX, endX, 1, height-1, -srcStride-1, srcStride+1, offset, offsetClip, maxVal );
+    xOffsetEdgeRectSSE41( srcBlk, resBlk, srcStride, resStride, isBelowAvail ? startX : (width -1), isBelowRightAvail ? width : (width -1), height-1, height, -srcStride-1, srcStride+1, offset, offsetClip, maxVal );
+    break;
+  case SAO_TYPE_EO_45:
+    xOffsetEdgeRectSSE41( srcBlk, resBlk, srcStride, resStride, isAboveAvail ? startX : (width -1), isAboveRightAvail ? width : (width-1), 0, 1, -srcStride+1, srcStride-1, offset, offsetClip, maxVal );
+    xOffsetEdgeRectSSE41( srcBlk, resBlk, srcStride, resStride, startX, endX, 1, height-1, -srcStride+1, srcStride-1, offset, offsetClip, maxVal );
+    xOffsetEdgeRectSSE41( srcBlk, resBlk, srcStride, resStride, isBelowLeftAvail ? 0 : 1, isBelowAvail ? endX : 1, height-1, height, -srcStride+1, srcStride-1, offset, offsetClip, maxVal );
+    break;
+  case SAO_TYPE_BO:
+    xOffsetBandSSE41( srcBlk, resBlk, srcStride, resStride, width, height, bitDepth - NUM_SAO_BO_CLASSES_LOG2, offset, offsetClip, maxVal );
+    break;
+  default:
+    {
+      printf("Not a supported SAO types\n");
+      assert(0);
+      exit(-1);
+    }
+  }
+}
+#endif
+
 Void TComSampleAdaptiveOffset::offsetBlock(Int compIdx, Int typeIdx, Int* offset  
                                           , Pel* srcBlk, Pel* resBlk, Int srcStride, Int resStride,  Int width, Int height
                                           , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail)
@@ -397,6 +560,16 @@ Void TComSampleAdaptiveOffset::offsetBlock(Int compIdx, Int typeIdx, Int* offset
 
   Int* offsetClip = m_offsetClip[compIdx];
 
+#if SIMD_X86
+  if( getSimdLevel() >= SIMD_SSE41 )
+  {
+    xOffsetBlockSSE41( typeIdx, offset, srcBlk, resBlk, srcStride, resStride, width, height
+                     , isLeftAvail, isRightAvail, isAboveAvail, isBelowAvail, isAboveLeftAvail, isAboveRightAvail, isBelowLeftAvail, isBelowRightAvail
+                     , (compIdx == SAO_Y)?g_bitDepthY:g_bitDepthC, offsetClip );
+    return;
+  }
+#endif
+
   Int x,y, startX, startY, endX, endY, edgeType;
   Int firstLineStartX, firstLineEndX, lastLineStartX, lastLineEndX;
   Char signLeft, signRight, signDown;
@@ -739,6 +912,61 @@ Void TComSampleAdaptiveOffset::SAOProcess(TComPic* pDecPic)
   } //ctu
 }
 
+#if DEC_CTU_ROW_FILTER
+/** copy the samples of a CTU row into the SAO source picture
+ * \param pDecPic deblocked picture
+ * \param ctuRow CTU row
+ * \returns Void
+ *
+ * \note The deblocking of the row must be final, the horizontal edges of the row below included.
+ */
+Void TComSampleAdaptiveOffset::saveDeblockedCtuRow(TComPic* pDecPic, Int ctuRow)
+{
+  TComPicYuv* resYuv = pDecPic->getPicYuvRec();
+  TComPicYuv* srcYuv = m_tempPicYuv;
+  Int yPos   = ctuRow*m_maxCUHeight;
+  Int height = (yPos + m_maxCUHeight > m_picHeight)?(m_picHeight- yPos):m_maxCUHeight;
+
+  for(Int compIdx= 0; compIdx < NUM_SAO_COMPONENTS; compIdx++)
+  {
+    Int  formatShift= (compIdx == SAO_Y)?0:1;
+    Int  resStride  = (compIdx == SAO_Y)?resYuv->getStride():resYuv->getCStride();
+    Int  srcStride  = (compIdx == SAO_Y)?srcYuv->getStride():srcYuv->getCStride();
+    Pel* resLine    = getPicBuf(resYuv, compIdx)+ (yPos >> formatShift)*resStride;
+    Pel* srcLine    = getPicBuf(srcYuv, compIdx)+ (yPos >> formatShift)*srcStride;
+
+    for(Int y = 0; y < (height >> formatShift); y++)
+    {
+      ::memcpy(srcLine, resLine, sizeof(Pel)*(m_picWidth >> formatShift));
+      resLine += resStride;
+      srcLine += srcStride;
+    }
+  }
+}
+
+/** SAO of a CTU row, the result of SAOProcess() when applied to the rows in order.
+ * \param pDecPic deblocked picture
+ * \param ctuRow CTU row
+ * \returns Void
+ *
+ * \note The rows above and below must have been copied with saveDeblockedCtuRow().
+ */
+Void TComSampleAdaptiveOffset::SAOProcessCtuRow(TComPic* pDecPic, Int ctuRow)
+{
+  SAOBlkParam* saoBlkParams = pDecPic->getPicSym()->getSAOBlkParam();
+
+  for(Int ctu= ctuRow*m_numCTUInWidth; ctu < (ctuRow+1)*m_numCTUInWidth; ctu++)
+  {
+    std::vector<SAOBlkParam*> mergeList;
+    getMergeList(pDecPic, ctu, saoBlkParams, mergeList);
+
+    reconstructBlkSAOParam(saoBlkParams[ctu], mergeList);
+
+    offsetCTU(ctu, m_tempPicYuv, pDecPic->getPicYuvRec(), saoBlkParams[ctu], pDecPic);
+  } //ctu
+}
+#endif
+
 
 Pel* TComSampleAdaptiveOffset::getPicBuf(TComPicYuv* pPicYuv, Int compIdx)
 {
@@ -801,6 +1029,28 @@ Void TComSampleAdaptiveOffset::xPCMRestoration(TComPic* pcPic)
   }
 }
 
+#if DEC_CTU_ROW_FILTER
+/** PCM LF disable process of a CTU row. 
+ * \param pcPic picture (TComPic) pointer
+ * \param ctuRow CTU row
+ * \returns Void
+ */
+Void TComSampleAdaptiveOffset::PCMLFDisableProcessCtuRow (TComPic* pcPic, Int ctuRow)
+{
+  Bool  bPCMFilter = (pcPic->getSlice(0)->getSPS()->getUsePCM() && pcPic->getSlice(0)->getSPS()->getPCMFilterDisableFlag())? true : false;
+
+  if(bPCMFilter || pcPic->getSlice(0)->getPPS()->getTransquantBypassEnableFlag())
+  {
+    for( UInt uiCUAddr = ctuRow*pcPic->getFrameWidthInCU(); uiCUAddr < (ctuRow+1)*pcPic->getFrameWidthInCU() ; uiCUAddr++ )
+    {
+      TComDataCU* pcCU = pcPic->getCU(uiCUAddr);
+
+      xPCMCURestoration(pcCU, 0, 0); 
+    } 
+  }
+}
+#endif
+
 /** PCM CU restoration. 
  * \param pcCU pointer to current CU
  * \param uiAbsPartIdx part index
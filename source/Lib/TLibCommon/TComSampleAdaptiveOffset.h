@@ -76,6 +76,11 @@ public:
   Void destroy();
   Void reconstructBlkSAOParams(TComPic* pic, SAOBlkParam* saoBlkParams);
   Void PCMLFDisableProcess (TComPic* pcPic);
+#if DEC_CTU_ROW_FILTER
+  Void saveDeblockedCtuRow (TComPic* pDecPic, Int ctuRow);        ///< copy a CTU row whose deblocking is final into the SAO source picture
+  Void SAOProcessCtuRow    (TComPic* pDecPic, Int ctuRow);        ///< reconstruct the SAO parameters of a CTU row and apply them
+  Void PCMLFDisableProcessCtuRow (TComPic* pcPic, Int ctuRow);
+#endif
 #if SVC_EXTENSION
   UInt* getSaoMaxOffsetQVal() { return m_saoMaxOffsetQVal; } 
 #endif
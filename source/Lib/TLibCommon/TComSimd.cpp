@@ -0,0 +1,140 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComSimd.cpp
+    \brief    instruction set detection for the vectorised kernels
+*/
+
+#include "TComSimd.h"
+#include <string>
+
+#if SIMD_X86 && defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+/// selected level, detected on first use so that it is valid during static initialisation of other modules
+static SimdLevel& xSimdLevel()
+{
+  static SimdLevel s_eSimdLevel = detectSimdLevel();
+  return s_eSimdLevel;
+}
+
+/** Query the CPU for the supported instruction sets
+ * \returns the highest level that has kernels in this build
+ */
+SimdLevel detectSimdLevel()
+{
+#if SIMD_X86
+#ifdef _MSC_VER
+  Int aiInfo[4];
+  __cpuid( aiInfo, 0 );
+  Int iMaxLeaf = aiInfo[0];
+  __cpuid( aiInfo, 1 );
+  Bool bSSE41   = ( aiInfo[2] & ( 1 << 19 ) ) != 0;
+  Bool bOSXSave = ( aiInfo[2] & ( 1 << 27 ) ) != 0;
+  Bool bAVX     = ( aiInfo[2] & ( 1 << 28 ) ) != 0;
+  Bool bAVX2    = false;
+  if( iMaxLeaf >= 7 && bOSXSave && bAVX && ( _xgetbv( 0 ) & 6 ) == 6 )
+  {
+    __cpuidex( aiInfo, 7, 0 );
+    bAVX2 = ( aiInfo[1] & ( 1 << 5 ) ) != 0;
+  }
+#else
+  __builtin_cpu_init();
+  Bool bSSE41 = __builtin_cpu_supports( "sse4.1" ) != 0;
+  Bool bAVX2  = __builtin_cpu_supports( "avx2" ) != 0;
+#endif
+  if( bSSE41 && bAVX2 )
+  {
+    return SIMD_AVX2;
+  }
+  if( bSSE41 )
+  {
+    return SIMD_SSE41;
+  }
+#endif
+  return SIMD_NONE;
+}
+
+SimdLevel getSimdLevel()
+{
+  return xSimdLevel();
+}
+
+/** Select the instruction set level of the kernels
+ * \param eLevel requested level, levels above the CPU capabilities fall back to the highest supported one
+ */
+Void setSimdLevel( SimdLevel eLevel )
+{
+  SimdLevel eSupported = detectSimdLevel();
+  xSimdLevel() = eLevel < eSupported ? eLevel : eSupported;
+}
+
+static const struct MapStrToSimdLevel {
+  const Char* str;
+  SimdLevel value;
+} strToSimdLevel[] = {
+  {"none", SIMD_NONE},
+  {"sse4", SIMD_SSE41},
+  {"avx2", SIMD_AVX2},
+};
+
+const Char* getSimdLevelName( SimdLevel eLevel )
+{
+  return strToSimdLevel[eLevel].str;
+}
+
+/** Read an instruction set level from its name, used by the option parsers of the applications
+ * \returns the stream, with the failbit set for an unknown name
+ */
+std::istream& operator>>( std::istream& in, SimdLevel& eLevel )
+{
+  std::string str;
+  in >> str;
+  for( UInt i = 0; i < sizeof(strToSimdLevel)/sizeof(*strToSimdLevel); i++ )
+  {
+    if( str == strToSimdLevel[i].str )
+    {
+      eLevel = strToSimdLevel[i].value;
+      return in;
+    }
+  }
+  in.setstate( std::ios::failbit );
+  return in;
+}
+
+//! \}
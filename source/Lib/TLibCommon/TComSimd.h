@@ -0,0 +1,96 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComSimd.h
+    \brief    instruction set detection for the vectorised kernels (header)
+*/
+
+#ifndef __TCOMSIMD__
+#define __TCOMSIMD__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "CommonDef.h"
+#include <istream>
+
+//! \ingroup TLibCommon
+//! \{
+
+#if SIMD_KERNELS
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_X86                         1      ///< x86 kernels are compiled
+#else
+#define SIMD_X86                         0
+#endif
+#else
+#define SIMD_X86                         0
+#endif
+
+#if SIMD_X86
+#ifdef _MSC_VER
+#define SIMD_TARGET_SSE41
+#define SIMD_TARGET_AVX2
+#else
+#define SIMD_TARGET_SSE41 __attribute__((target("sse4.1")))         ///< function may use SSE4.1 instructions
+#define SIMD_TARGET_AVX2  __attribute__((target("avx2")))           ///< function may use AVX2 instructions
+#endif
+#endif
+
+// ====================================================================================================================
+// Enumeration
+// ====================================================================================================================
+
+/// instruction set levels of the vectorised kernels
+enum SimdLevel
+{
+  SIMD_NONE  = 0,     ///< C reference code
+  SIMD_SSE41 = 1,     ///< SSE4.1
+  SIMD_AVX2  = 2      ///< AVX2
+};
+
+// ====================================================================================================================
+// Function declarations
+// ====================================================================================================================
+
+SimdLevel detectSimdLevel();                    ///< highest level supported by the CPU and the OS
+SimdLevel getSimdLevel();                       ///< level used to select the kernels
+Void      setSimdLevel( SimdLevel eLevel );     ///< limit the level used by the kernels, clipped to the CPU capabilities
+
+const Char*   getSimdLevelName( SimdLevel eLevel );                ///< name of a level: none, sse4 or avx2
+std::istream& operator>>( std::istream& in, SimdLevel& eLevel );   ///< read a level from its name
+
+//! \}
+
+#endif // __TCOMSIMD__
@@ -45,13 +45,6 @@
 //! \ingroup TLibCommon
 //! \{
 
-#if SVC_EXTENSION
-ParameterSetMap<TComVPS> ParameterSetManager::m_vpsMap(MAX_NUM_VPS);
-ParameterSetMap<TComSPS> ParameterSetManager::m_spsMap(MAX_NUM_SPS);
-ParameterSetMap<TComPPS> ParameterSetManager::m_ppsMap(MAX_NUM_PPS);
-Int ParameterSetManager::m_activeVPSId = -1;
-#endif
-
 TComSlice::TComSlice()
 : m_iPPSId                        ( -1 )
 , m_iPOC                          ( 0 )
@@ -142,6 +135,8 @@ TComSlice::TComSlice()
 
 #if SVC_EXTENSION
   memset( m_pcBaseColPic, 0, sizeof( m_pcBaseColPic ) );
+  ::memset( m_posScalingFactor, 0, sizeof( m_posScalingFactor ) );
+  ::memset( m_mvScalingFactor,  0, sizeof( m_mvScalingFactor ) );
   m_activeNumILRRefIdx        = 0; 
   m_interLayerPredEnabledFlag = 0;
   ::memset( m_interLayerPredLayerIdc, 0, sizeof(m_interLayerPredLayerIdc) );
@@ -605,13 +600,13 @@ Void TComSlice::setRefPicList( TComList<TComPic*>& rcListPic, Bool checkNumPocTo
 #if O0194_DIFFERENT_BITDEPTH_EL_BL
         Bool sameBitDepths = ( g_bitDepthYLayer[m_layerId] == g_bitDepthYLayer[refLayerId] ) && ( g_bitDepthCLayer[m_layerId] == g_bitDepthCLayer[refLayerId] );
 
-        if( !( g_posScalingFactor[refLayerIdc][0] == 65536 && g_posScalingFactor[refLayerIdc][1] == 65536 ) || !scalingOffset || !sameBitDepths 
+        if( !( m_posScalingFactor[refLayerIdc][0] == 65536 && m_posScalingFactor[refLayerIdc][1] == 65536 ) || !scalingOffset || !sameBitDepths 
 #if Q0048_CGS_3D_ASYMLUT
           || getPPS()->getCGSFlag()
 #endif
           ) // ratio 1x
 #else
-        if(!( g_posScalingFactor[refLayerIdc][0] == 65536 && g_posScalingFactor[refLayerIdc][1] == 65536 ) || (!scalingOffset)) // ratio 1x
+        if(!( m_posScalingFactor[refLayerIdc][0] == 65536 && m_posScalingFactor[refLayerIdc][1] == 65536 ) || (!scalingOffset)) // ratio 1x
 #endif
         {
 #if MOTION_RESAMPLING_CONSTRAINT
@@ -1287,6 +1282,8 @@ Void TComSlice::copySliceInfo(TComSlice *pSrc)
   m_activeNumILRRefIdx         = pSrc->m_activeNumILRRefIdx;
   m_interLayerPredEnabledFlag  = pSrc->m_interLayerPredEnabledFlag;
   memcpy( m_interLayerPredLayerIdc, pSrc->m_interLayerPredLayerIdc, sizeof( m_interLayerPredLayerIdc ) );
+  memcpy( m_posScalingFactor, pSrc->m_posScalingFactor, sizeof( m_posScalingFactor ) );
+  memcpy( m_mvScalingFactor, pSrc->m_mvScalingFactor, sizeof( m_mvScalingFactor ) );
 #if P0312_VERT_PHASE_ADJ
   memcpy( m_vertPhasePositionFlag, pSrc->m_vertPhasePositionFlag, sizeof( m_vertPhasePositionFlag ) );
 #endif
@@ -1344,7 +1341,7 @@ Void TComSlice::copySliceInfo(TComSlice *pSrc)
   m_maxNumMergeCand               = pSrc->m_maxNumMergeCand;
 }
 
-Int TComSlice::m_prevTid0POC = 0;
+THREAD_LOCAL Int TComSlice::m_prevTid0POC = 0;
 
 /** Function for setting the slice's temporal layer ID and corresponding temporal_layer_switching_point_flag.
  * \param uiTLayer Temporal layer ID of the current slice
@@ -4029,17 +4026,13 @@ Void TComScalingList::checkDcOfMatrix()
 }
 
 ParameterSetManager::ParameterSetManager()
-#if SVC_EXTENSION
-: m_activeSPSId(-1)
-, m_activePPSId(-1)
-#else
-: m_vpsMap(MAX_NUM_VPS)
+: m_pcStorage(this)
+, m_vpsMap(MAX_NUM_VPS)
 , m_spsMap(MAX_NUM_SPS)
 , m_ppsMap(MAX_NUM_PPS)
 , m_activeVPSId(-1)
 , m_activeSPSId(-1)
 , m_activePPSId(-1)
-#endif
 {
 }
 
@@ -4052,13 +4045,13 @@ ParameterSetManager::~ParameterSetManager()
 //! \returns true, if activation is successful
 Bool ParameterSetManager::activateSPSWithSEI(Int spsId)
 {
-  TComSPS *sps = m_spsMap.getPS(spsId);
+  TComSPS *sps = m_pcStorage->m_spsMap.getPS(spsId);
   if (sps)
   {
     Int vpsId = sps->getVPSId();
-    if (m_vpsMap.getPS(vpsId))
+    if (m_pcStorage->m_vpsMap.getPS(vpsId))
     {
-      m_activeVPSId = vpsId;
+      m_pcStorage->m_activeVPSId = vpsId;
       m_activeSPSId = spsId;
       return true;
     }
@@ -4078,7 +4071,7 @@ Bool ParameterSetManager::activateSPSWithSEI(Int spsId)
 //! \returns true, if activation is successful
 Bool ParameterSetManager::activatePPS(Int ppsId, Bool isIRAP)
 {
-  TComPPS *pps = m_ppsMap.getPS(ppsId);
+  TComPPS *pps = m_pcStorage->m_ppsMap.getPS(ppsId);
   if (pps)
   {
     Int spsId = pps->getSPSId();
@@ -4087,19 +4080,19 @@ Bool ParameterSetManager::activatePPS(Int ppsId, Bool isIRAP)
       printf("Warning: tried to activate PPS referring to a inactive SPS at non-IRAP.");
       return false;
     }
-    TComSPS *sps = m_spsMap.getPS(spsId);
+    TComSPS *sps = m_pcStorage->m_spsMap.getPS(spsId);
     if (sps)
     {
       Int vpsId = sps->getVPSId();
-      if (!isIRAP && (vpsId != m_activeVPSId))
+      if (!isIRAP && (vpsId != m_pcStorage->m_activeVPSId))
       {
         printf("Warning: tried to activate PPS referring to a inactive VPS at non-IRAP.");
         return false;
       }
-      if (m_vpsMap.getPS(vpsId))
+      if (m_pcStorage->m_vpsMap.getPS(vpsId))
       {
         m_activePPSId = ppsId;
-        m_activeVPSId = vpsId;
+        m_pcStorage->m_activeVPSId = vpsId;
         m_activeSPSId = spsId;
 
         return true;
@@ -4218,6 +4211,10 @@ Void TComSlice::setILRPic(TComPic **pcIlpPic)
       // copy scalability ratio, it is needed to get the correct location for the motion field of the corresponding reference layer block
       pcIlpPic[refLayerIdc]->setSpatialEnhLayerFlag( refLayerIdc, m_pcPic->isSpatialEnhLayer(refLayerIdc) );
 
+#if ILR_ON_DEMAND_UPSAMPLING
+      // the samples of the inter-layer reference picture are resampled in place and their border is extended by the resampling filter
+      if( !pcIlpPic[refLayerIdc]->getUpsampleFilter() )
+#endif
       pcIlpPic[refLayerIdc]->copyUpsampledPictureYuv( m_pcPic->getFullPelBaseRec( refLayerIdc ), pcIlpPic[refLayerIdc]->getPicYuvRec() );      
       pcIlpPic[refLayerIdc]->getSlice(0)->setBaseColPic( refLayerIdc, pcRefPicBL );
 
@@ -4230,8 +4227,13 @@ Void TComSlice::setILRPic(TComPic **pcIlpPic)
       //copy layer id from the reference layer 
       pcIlpPic[refLayerIdc]->setLayerId( pcRefPicBL->getLayerId() );
 
-      pcIlpPic[refLayerIdc]->getPicYuvRec()->setBorderExtension( false );
-      pcIlpPic[refLayerIdc]->getPicYuvRec()->extendPicBorder();
+#if ILR_ON_DEMAND_UPSAMPLING
+      if( !pcIlpPic[refLayerIdc]->getUpsampleFilter() )
+#endif
+      {
+        pcIlpPic[refLayerIdc]->getPicYuvRec()->setBorderExtension( false );
+        pcIlpPic[refLayerIdc]->getPicYuvRec()->extendPicBorder();
+      }
       for (Int j=0; j<pcIlpPic[refLayerIdc]->getPicSym()->getNumberOfCUsInFrame(); j++)    // set reference CU layerId
       {
         pcIlpPic[refLayerIdc]->getPicSym()->getCU(j)->setLayerId( pcIlpPic[refLayerIdc]->getLayerId() );
@@ -4279,6 +4281,9 @@ Void TComSlice::setILRPic(TComPic **pcIlpPic)
           }
         }
 
+        // the motion field of the inter-layer picture is mapped with the scaling factors of the current picture
+        memcpy( pcIlpPic[refLayerIdc]->getSlice(0)->m_posScalingFactor, m_posScalingFactor, sizeof(m_posScalingFactor) );
+        memcpy( pcIlpPic[refLayerIdc]->getSlice(0)->m_mvScalingFactor, m_mvScalingFactor, sizeof(m_mvScalingFactor) );
         pcIlpPic[refLayerIdc]->copyUpsampledMvField( refLayerIdc, m_pcBaseColPic[refLayerIdc] );
       }
       else
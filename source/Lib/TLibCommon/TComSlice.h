@@ -2199,7 +2199,7 @@ private:
   Int         m_associatedIrapPocBeforeReset;
 #endif
   NalUnitType m_iAssociatedIRAPType;
-  static Int  m_prevTid0POC;
+  static THREAD_LOCAL Int  m_prevTid0POC;
   TComReferencePictureSet *m_pcRPS;
   TComReferencePictureSet m_LocalRPS;
   Int         m_iBDidx; 
@@ -2296,6 +2296,8 @@ private:
   UInt        m_layerId;
   TComPic*    m_pcBaseColPic[MAX_LAYERS];
   TComPicYuv* m_pcFullPelBaseRec[MAX_LAYERS];
+  Int         m_posScalingFactor[MAX_LAYERS][2];   ///< horizontal and vertical sample position scaling of each reference layer (16 fractional bits)
+  Int         m_mvScalingFactor[MAX_LAYERS][2];    ///< horizontal and vertical motion vector scaling of each reference layer (8 fractional bits)
   Int         m_numMotionPredRefLayers;
 #if REF_IDX_MFM
   Bool        m_bMFMEnabledFlag;
@@ -2612,6 +2614,10 @@ public:
   Void      setBaseColPic       (UInt refLayerIdc, TComPic* p)     { m_pcBaseColPic[refLayerIdc] = p; }
   TComPic*  getBaseColPic       (UInt refLayerIdc)                { return m_pcBaseColPic[refLayerIdc]; }
   TComPic** getBaseColPic       ()                { return &m_pcBaseColPic[0]; }
+  Int       getPosScalingFactor (UInt refLayerIdc, Int dir)             { return m_posScalingFactor[refLayerIdc][dir]; }
+  Void      setPosScalingFactor (UInt refLayerIdc, Int dir, Int factor) { m_posScalingFactor[refLayerIdc][dir] = factor; }
+  Int       getMvScalingFactor  (UInt refLayerIdc, Int dir)             { return m_mvScalingFactor[refLayerIdc][dir]; }
+  Void      setMvScalingFactor  (UInt refLayerIdc, Int dir, Int factor) { m_mvScalingFactor[refLayerIdc][dir] = factor; }
 #if MFM_ENCCONSTRAINT
   TComPic*  getBaseColPic( TComList<TComPic*>& rcListPic );
 #endif
@@ -2800,6 +2806,11 @@ public:
     return (m_paramsetMap.begin() == m_paramsetMap.end() ) ? NULL : m_paramsetMap.begin()->second;
   }
 
+  Bool empty()
+  {
+    return m_paramsetMap.empty();
+  }
+
 private:
   std::map<Int,T *> m_paramsetMap;
   Int               m_maxId;
@@ -2811,23 +2822,28 @@ public:
   ParameterSetManager();
   virtual ~ParameterSetManager();
 
+#if SVC_EXTENSION
+  //! use the parameter sets and the active VPS stored by pcBase, the manager of the base layer
+  Void shareParameterSets(ParameterSetManager *pcBase) { m_pcStorage = pcBase->m_pcStorage; };
+
+#endif
   //! store sequence parameter set and take ownership of it 
-  Void storeVPS(TComVPS *vps) { m_vpsMap.storePS( vps->getVPSId(), vps); };
+  Void storeVPS(TComVPS *vps) { m_pcStorage->m_vpsMap.storePS( vps->getVPSId(), vps); };
   //! get pointer to existing video parameter set  
-  TComVPS* getVPS(Int vpsId)  { return m_vpsMap.getPS(vpsId); };
-  TComVPS* getFirstVPS()      { return m_vpsMap.getFirstPS(); };
+  TComVPS* getVPS(Int vpsId)  { return m_pcStorage->m_vpsMap.getPS(vpsId); };
+  TComVPS* getFirstVPS()      { return m_pcStorage->m_vpsMap.getFirstPS(); };
   
   //! store sequence parameter set and take ownership of it 
-  Void storeSPS(TComSPS *sps) { m_spsMap.storePS( sps->getSPSId(), sps); };
+  Void storeSPS(TComSPS *sps) { m_pcStorage->m_spsMap.storePS( sps->getSPSId(), sps); };
   //! get pointer to existing sequence parameter set  
-  TComSPS* getSPS(Int spsId)  { return m_spsMap.getPS(spsId); };
-  TComSPS* getFirstSPS()      { return m_spsMap.getFirstPS(); };
+  TComSPS* getSPS(Int spsId)  { return m_pcStorage->m_spsMap.getPS(spsId); };
+  TComSPS* getFirstSPS()      { return m_pcStorage->m_spsMap.getFirstPS(); };
 
   //! store picture parameter set and take ownership of it 
-  Void storePPS(TComPPS *pps) { m_ppsMap.storePS( pps->getPPSId(), pps); };
+  Void storePPS(TComPPS *pps) { m_pcStorage->m_ppsMap.storePS( pps->getPPSId(), pps); };
   //! get pointer to existing picture parameter set  
-  TComPPS* getPPS(Int ppsId)  { return m_ppsMap.getPS(ppsId); };
-  TComPPS* getFirstPPS()      { return m_ppsMap.getFirstPS(); };
+  TComPPS* getPPS(Int ppsId)  { return m_pcStorage->m_ppsMap.getPS(ppsId); };
+  TComPPS* getFirstPPS()      { return m_pcStorage->m_ppsMap.getFirstPS(); };
 
   //! activate a SPS from a active parameter sets SEI message
   //! \returns true, if activation is successful
@@ -2837,27 +2853,18 @@ public:
   //! \returns true, if activation is successful
   Bool activatePPS(Int ppsId, Bool isIRAP);
 
-  TComVPS* getActiveVPS(){ return m_vpsMap.getPS(m_activeVPSId); };
-  TComSPS* getActiveSPS(){ return m_spsMap.getPS(m_activeSPSId); };
-  TComPPS* getActivePPS(){ return m_ppsMap.getPS(m_activePPSId); };
+  TComVPS* getActiveVPS(){ return m_pcStorage->m_vpsMap.getPS(m_pcStorage->m_activeVPSId); };
+  TComSPS* getActiveSPS(){ return m_pcStorage->m_spsMap.getPS(m_activeSPSId); };
+  TComPPS* getActivePPS(){ return m_pcStorage->m_ppsMap.getPS(m_activePPSId); };
 
 protected:
 
-#if SVC_EXTENSION
-  static ParameterSetMap<TComVPS> m_vpsMap;
-  static ParameterSetMap<TComSPS> m_spsMap; 
-  static ParameterSetMap<TComPPS> m_ppsMap;
-#else
+  ParameterSetManager*     m_pcStorage;   ///< manager storing the parameter sets and the active VPS, this one unless they are shared with the base layer
   ParameterSetMap<TComVPS> m_vpsMap;
   ParameterSetMap<TComSPS> m_spsMap; 
   ParameterSetMap<TComPPS> m_ppsMap;
-#endif
 
-#if SVC_EXTENSION
-  static Int m_activeVPSId;
-#else
   Int m_activeVPSId;
-#endif
   Int m_activeSPSId;
   Int m_activePPSId;
 };
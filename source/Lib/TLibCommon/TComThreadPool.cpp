@@ -0,0 +1,227 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.cpp
+    \brief    thread pool and synchronisation primitives
+*/
+
+#include "TComThreadPool.h"
+#include "TComRom.h"
+
+//! \ingroup TLibCommon
+//! \{
+
+std::mutex g_cOutputMutex;
+
+// ====================================================================================================================
+// TComSyncCounter
+// ====================================================================================================================
+
+TComSyncCounter::TComSyncCounter()
+: m_iValue( 0 )
+{
+}
+
+TComSyncCounter::~TComSyncCounter()
+{
+}
+
+Void TComSyncCounter::set( Int iValue )
+{
+  std::lock_guard<std::mutex> cLock( m_mutex );
+  m_iValue = iValue;
+  m_cCond.notify_all();
+}
+
+Void TComSyncCounter::increment()
+{
+  std::lock_guard<std::mutex> cLock( m_mutex );
+  m_iValue++;
+  m_cCond.notify_all();
+}
+
+Int TComSyncCounter::get()
+{
+  std::lock_guard<std::mutex> cLock( m_mutex );
+  return m_iValue;
+}
+
+Void TComSyncCounter::waitFor( Int iValue )
+{
+  std::unique_lock<std::mutex> cLock( m_mutex );
+  while ( m_iValue < iValue )
+  {
+    m_cCond.wait( cLock );
+  }
+}
+
+// ====================================================================================================================
+// TComThreadPool
+// ====================================================================================================================
+
+TComThreadPool::TComThreadPool()
+: m_iNumBusy( 0 )
+, m_bStop   ( false )
+#if PARALLEL_ME
+, m_bFixedContext( false )
+#endif
+{
+}
+
+TComThreadPool::~TComThreadPool()
+{
+  destroy();
+}
+
+/** create worker threads
+ * \param iNumThreads number of worker threads, jobs are executed by the calling thread when 0
+ */
+Void TComThreadPool::create( Int iNumThreads )
+{
+  destroy();
+  m_bStop = false;
+#if PARALLEL_ME
+  m_bFixedContext = false;
+#endif
+  for ( Int i = 0; i < iNumThreads; i++ )
+  {
+    m_acThreads.push_back( std::thread( &TComThreadPool::xWorkerLoop, this ) );
+  }
+}
+
+#if PARALLEL_ME
+/** create worker threads running all the jobs in the same coding state, for short jobs of one layer
+ * \param iNumThreads number of worker threads
+ * \param rcContext   coding state of the jobs
+ */
+Void TComThreadPool::create( Int iNumThreads, const TComCodingContext& rcContext )
+{
+  create( iNumThreads );
+  m_cContext      = rcContext;
+  m_bFixedContext = true;
+}
+#endif
+
+/** finish pending jobs and join worker threads
+ */
+Void TComThreadPool::destroy()
+{
+  {
+    std::lock_guard<std::mutex> cLock( m_mutex );
+    m_bStop = true;
+    m_cJobAvailable.notify_all();
+  }
+  for ( UInt i = 0; i < m_acThreads.size(); i++ )
+  {
+    m_acThreads[i].join();
+  }
+  m_acThreads.clear();
+}
+
+/** queue a job
+ * \param rcJob job to be executed
+ * The job runs with the coding state of the calling thread at the time of the call.
+ */
+Void TComThreadPool::addJob( const std::function<Void()>& rcJob )
+{
+  if ( m_acThreads.empty() )
+  {
+    rcJob();
+    return;
+  }
+#if PARALLEL_ME
+  if ( m_bFixedContext )
+  {
+    std::lock_guard<std::mutex> cLock( m_mutex );
+    m_cJobs.push_back( rcJob );
+    m_cJobAvailable.notify_one();
+    return;
+  }
+#endif
+  TComCodingContext cContext;
+  cContext.save( true );
+
+  std::lock_guard<std::mutex> cLock( m_mutex );
+  m_cJobs.push_back( [cContext, rcJob]() { cContext.bind(); rcJob(); } );
+  m_cJobAvailable.notify_one();
+}
+
+Void TComThreadPool::waitForAll()
+{
+  std::unique_lock<std::mutex> cLock( m_mutex );
+  while ( !m_cJobs.empty() || m_iNumBusy > 0 )
+  {
+    m_cJobsDone.wait( cLock );
+  }
+}
+
+Void TComThreadPool::xWorkerLoop()
+{
+  std::unique_lock<std::mutex> cLock( m_mutex );
+#if PARALLEL_ME
+  Bool bBound = false;
+#endif
+  while ( true )
+  {
+    while ( m_cJobs.empty() && !m_bStop )
+    {
+      m_cJobAvailable.wait( cLock );
+    }
+    if ( m_cJobs.empty() )
+    {
+      return;
+    }
+    std::function<Void()> cJob = m_cJobs.front();
+    m_cJobs.pop_front();
+    m_iNumBusy++;
+
+#if PARALLEL_ME
+    if ( m_bFixedContext && !bBound )
+    {
+      m_cContext.bind();
+      bBound = true;
+    }
+#endif
+    cLock.unlock();
+    cJob();
+    cLock.lock();
+
+    m_iNumBusy--;
+    if ( m_cJobs.empty() && m_iNumBusy == 0 )
+    {
+      m_cJobsDone.notify_all();
+    }
+  }
+}
+
+//! \}
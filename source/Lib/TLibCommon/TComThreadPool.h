@@ -0,0 +1,119 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TComThreadPool.h
+    \brief    thread pool and synchronisation primitives (header)
+*/
+
+#ifndef __TCOMTHREADPOOL__
+#define __TCOMTHREADPOOL__
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "CommonDef.h"
+#if PARALLEL_ME
+#include "TComRom.h"
+#endif
+
+//! \ingroup TLibCommon
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// monotonic counter that threads can block on until it reaches a given value
+class TComSyncCounter
+{
+private:
+  std::mutex              m_mutex;
+  std::condition_variable m_cCond;
+  Int                     m_iValue;
+
+public:
+  TComSyncCounter();
+  virtual ~TComSyncCounter();
+
+  Void  set       ( Int iValue );                       ///< set counter value and wake up waiting threads
+  Void  increment ();                                   ///< increment counter value and wake up waiting threads
+  Int   get       ();                                   ///< get current counter value
+  Void  waitFor   ( Int iValue );                       ///< block until counter value is not less than iValue
+};
+
+/// fixed-size pool of worker threads executing jobs in FIFO order
+class TComThreadPool
+{
+private:
+  std::vector<std::thread>          m_acThreads;        ///< worker threads
+  std::deque< std::function<Void()> > m_cJobs;          ///< pending jobs
+  std::mutex                        m_mutex;
+  std::condition_variable           m_cJobAvailable;    ///< signalled when a job is queued or the pool is stopped
+  std::condition_variable           m_cJobsDone;        ///< signalled when the last running job finishes
+  Int                               m_iNumBusy;         ///< number of jobs currently executing
+  Bool                              m_bStop;
+#if PARALLEL_ME
+  Bool                              m_bFixedContext;    ///< the worker threads run all the jobs in m_cContext
+  TComCodingContext                 m_cContext;
+#endif
+
+  Void  xWorkerLoop ();
+
+public:
+  TComThreadPool();
+  virtual ~TComThreadPool();
+
+  Void  create      ( Int iNumThreads );
+#if PARALLEL_ME
+  Void  create      ( Int iNumThreads, const TComCodingContext& rcContext ); ///< worker threads bound once to the coding state rcContext, which is not saved for each job
+#endif
+  Void  destroy     ();
+
+  Int   getNumThreads ()                                { return (Int)m_acThreads.size(); }
+
+  Void  addJob      ( const std::function<Void()>& rcJob ); ///< queue a job running with the coding state of the caller, executed immediately when the pool has no threads
+  Void  waitForAll  ();                                     ///< block until all queued jobs have finished
+};
+
+extern std::mutex g_cOutputMutex;                       ///< serialises per-picture console output of concurrently coded pictures
+
+//! \}
+
+#endif // __TCOMTHREADPOOL__
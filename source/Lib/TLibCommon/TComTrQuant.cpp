@@ -41,6 +41,10 @@
 #include "TComTrQuant.h"
 #include "TComPic.h"
 #include "ContextTables.h"
+#include "TComSimd.h"
+#if SIMD_X86
+#include <immintrin.h>
+#endif
 #define MAYBE_BUGFIX 1
 typedef struct
 {
@@ -97,6 +101,10 @@ TComTrQuant::TComTrQuant()
   
   // allocate bit estimation class  (for RDOQ)
   m_pcEstBitsSbac = new estBitsSbacStruct;
+#if FAST_RDOQ
+  m_pcEstBitsSbacTU = m_pcEstBitsSbac;
+  m_useRDOQFast     = false;
+#endif
   initScalingList();
 }
 
@@ -110,6 +118,9 @@ TComTrQuant::~TComTrQuant()
   }
   
   // delete bit estimation class
+#if FAST_RDOQ
+  m_pcEstBitsSbac = m_pcEstBitsSbacTU;
+#endif
   if ( m_pcEstBitsSbac )
   {
     delete m_pcEstBitsSbac;
@@ -787,6 +798,205 @@ void partialButterflyInverse32(Short *src,Short *dst,Int shift, Int line)
   }
 }
 
+#if SIMD_X86
+// ====================================================================================================================
+// Vectorised kernels, bit-exact with the C code of xTrMxN() and xITrMxN()
+// ====================================================================================================================
+
+/// transposed transform matrices, the 1D transforms of the rows of a block are products with them
+struct TComTrMatricesTransposed
+{
+  Short aiDST4[4*4];
+  Short aiT4  [4*4];
+  Short aiT8  [8*8];
+  Short aiT16 [16*16];
+  Short aiT32 [32*32];
+
+  TComTrMatricesTransposed()
+  {
+    xTranspose( &g_as_DST_MAT_4[0][0], aiDST4, 4 );
+    xTranspose( &g_aiT4 [0][0], aiT4,  4 );
+    xTranspose( &g_aiT8 [0][0], aiT8,  8 );
+    xTranspose( &g_aiT16[0][0], aiT16, 16 );
+    xTranspose( &g_aiT32[0][0], aiT32, 32 );
+  }
+  static Void xTranspose( const Short* piSrc, Short* piDst, Int iSize )
+  {
+    for( Int i = 0; i < iSize; i++ )
+    {
+      for( Int j = 0; j < iSize; j++ )
+      {
+        piDst[j*iSize + i] = piSrc[i*iSize + j];
+      }
+    }
+  }
+};
+
+static const TComTrMatricesTransposed g_cTrMatricesTransposed;
+
+/** Pair of 16-bit values broadcast to the 32-bit lanes, the multiplicands of pmaddwd
+ */
+static inline Int xPairOf( const Short* pi )
+{
+  return (Int)( (UInt)(UShort)pi[0] | ( (UInt)(UShort)pi[1] << 16 ) );
+}
+
+/** C = ( A * B + rounding ) >> shift for NxN matrices. A row of C is the sum of the rows of B weighted by the
+ *  row of A, two rows of B at a time with pmaddwd, so that both passes of a 2D transform run along the rows
+ *  without transposing the data. The sums are those of the partial butterflies, the results are clipped to
+ *  16 bits as in the inverse transforms or truncated as in the forward transforms.
+ *  Only the first iInner (even) columns of A and rows of B are summed, the other ones being zero, and only the
+ *  first iCols columns of C, rounded up to the vector size, are computed.
+ */
+template<Int N, Bool bClip>
+SIMD_TARGET_SSE41
+static Void xMatrixMulSSE41( const Short* piA, const Short* piB, Short* piC, Int iShift, Int iInner, Int iCols )
+{
+  const Int iNumVec = N < 8 ? 1 : ( ( iCols + 7 ) >> 3 ) << 1;   // vectors of 4 32-bit sums per row
+  __m128i avB[N/2][N < 8 ? 1 : N / 4];
+  for( Int i = 0; i < iInner; i += 2 )
+  {
+    if( N < 8 )
+    {
+      avB[i>>1][0] = _mm_unpacklo_epi16( _mm_loadl_epi64( (const __m128i*)( piB + i*N ) ), _mm_loadl_epi64( (const __m128i*)( piB + (i+1)*N ) ) );
+      continue;
+    }
+    for( Int c = 0; c < 4 * iNumVec; c += 8 )
+    {
+      const __m128i vB0 = _mm_loadu_si128( (const __m128i*)( piB + i*N + c ) );
+      const __m128i vB1 = _mm_loadu_si128( (const __m128i*)( piB + (i+1)*N + c ) );
+      avB[i>>1][(c>>2)  ] = _mm_unpacklo_epi16( vB0, vB1 );
+      avB[i>>1][(c>>2)+1] = _mm_unpackhi_epi16( vB0, vB1 );
+    }
+  }
+
+  const __m128i vAdd   = _mm_set1_epi32( 1 << ( iShift - 1 ) );
+  const __m128i vShift = _mm_cvtsi32_si128( iShift );
+  for( Int r = 0; r < N; r++ )
+  {
+    __m128i avSum[N < 8 ? 1 : N / 4];
+    for( Int k = 0; k < iNumVec; k++ )
+    {
+      avSum[k] = vAdd;
+    }
+    for( Int i = 0; i < iInner; i += 2 )
+    {
+      const __m128i vA = _mm_set1_epi32( xPairOf( piA + r*N + i ) );
+      for( Int k = 0; k < iNumVec; k++ )
+      {
+        avSum[k] = _mm_add_epi32( avSum[k], _mm_madd_epi16( avB[i>>1][k], vA ) );
+      }
+    }
+    for( Int k = 0; k < iNumVec; k++ )
+    {
+      avSum[k] = _mm_sra_epi32( avSum[k], vShift );
+      if( !bClip )
+      {
+        avSum[k] = _mm_srai_epi32( _mm_slli_epi32( avSum[k], 16 ), 16 );
+      }
+    }
+    if( N < 8 )
+    {
+      _mm_storel_epi64( (__m128i*)( piC + r*N ), _mm_packs_epi32( avSum[0], avSum[0] ) );
+      continue;
+    }
+    for( Int k = 0; k < iNumVec; k += 2 )
+    {
+      _mm_storeu_si128( (__m128i*)( piC + r*N + 4*k ), _mm_packs_epi32( avSum[k], avSum[k+1] ) );
+    }
+  }
+}
+
+/** xMatrixMulSSE41() with 16 columns per vector. The interleaving and packing within the 128-bit lanes keep the
+ *  columns in order.
+ */
+template<Int N, Bool bClip>
+SIMD_TARGET_AVX2
+static Void xMatrixMulAVX2( const Short* piA, const Short* piB, Short* piC, Int iShift, Int iInner, Int iCols )
+{
+  const Int iNumVec = ( ( iCols + 15 ) >> 4 ) << 1;
+  __m256i avB[N/2][N/8];
+  for( Int i = 0; i < iInner; i += 2 )
+  {
+    for( Int c = 0; c < 8 * iNumVec; c += 16 )
+    {
+      const __m256i vB0 = _mm256_loadu_si256( (const __m256i*)( piB + i*N + c ) );
+      const __m256i vB1 = _mm256_loadu_si256( (const __m256i*)( piB + (i+1)*N + c ) );
+      avB[i>>1][(c>>3)  ] = _mm256_unpacklo_epi16( vB0, vB1 );
+      avB[i>>1][(c>>3)+1] = _mm256_unpackhi_epi16( vB0, vB1 );
+    }
+  }
+
+  const __m256i vAdd   = _mm256_set1_epi32( 1 << ( iShift - 1 ) );
+  const __m128i vShift = _mm_cvtsi32_si128( iShift );
+  for( Int r = 0; r < N; r++ )
+  {
+    __m256i avSum[N/8];
+    for( Int k = 0; k < iNumVec; k++ )
+    {
+      avSum[k] = vAdd;
+    }
+    for( Int i = 0; i < iInner; i += 2 )
+    {
+      const __m256i vA = _mm256_set1_epi32( xPairOf( piA + r*N + i ) );
+      for( Int k = 0; k < iNumVec; k++ )
+      {
+        avSum[k] = _mm256_add_epi32( avSum[k], _mm256_madd_epi16( avB[i>>1][k], vA ) );
+      }
+    }
+    for( Int k = 0; k < iNumVec; k++ )
+    {
+      avSum[k] = _mm256_sra_epi32( avSum[k], vShift );
+      if( !bClip )
+      {
+        avSum[k] = _mm256_srai_epi32( _mm256_slli_epi32( avSum[k], 16 ), 16 );
+      }
+    }
+    for( Int k = 0; k < iNumVec; k += 2 )
+    {
+      _mm256_storeu_si256( (__m256i*)( piC + r*N + 8*k ), _mm256_packs_epi32( avSum[k], avSum[k+1] ) );
+    }
+  }
+}
+
+/** Selection of the matrix product kernel of NxN matrices
+ */
+template<Int N, Bool bClip>
+static inline Void xMatrixMulSIMD( const Short* piA, const Short* piB, Short* piC, Int iShift, Int iInner = N, Int iCols = N )
+{
+  if( N >= 16 && getSimdLevel() >= SIMD_AVX2 )
+  {
+    xMatrixMulAVX2<( N < 16 ? 16 : N ), bClip>( piA, piB, piC, iShift, iInner, iCols );
+  }
+  else
+  {
+    xMatrixMulSSE41<N, bClip>( piA, piB, piC, iShift, iInner, iCols );
+  }
+}
+
+/** Vectorised 2D transforms of NxN blocks: coeff = T * ( block * T' ) and block = ( T' * coeff ) * T
+ */
+template<Int N>
+static Void xTrMxNSIMD( const Short* piT, const Short* piTt, Short* block, Short* coeff, Int shift_1st, Int shift_2nd )
+{
+  Short tmp[ N * N ];
+  xMatrixMulSIMD<N, false>( block, piTt, tmp, shift_1st );
+  xMatrixMulSIMD<N, false>( piT, tmp, coeff, shift_2nd );
+}
+
+/** The coefficients outside of the first iNumCoeffRows rows and iNumCoeffCols columns are zero, the columns of
+ *  the first pass on the other ones are zero as well.
+ */
+template<Int N>
+static Void xITrMxNSIMD( const Short* piT, const Short* piTt, Short* coeff, Short* block, Int shift_1st, Int shift_2nd, Int iNumCoeffCols, Int iNumCoeffRows )
+{
+  Short tmp[ N * N ];
+  const Int iNumCols = std::min( ( iNumCoeffCols + 1 ) & ~1, N );
+  xMatrixMulSIMD<N, true>( piTt, coeff, tmp, shift_1st, std::min( ( iNumCoeffRows + 1 ) & ~1, N ), iNumCols );
+  xMatrixMulSIMD<N, true>( tmp, piT, block, shift_2nd, iNumCols, N );
+}
+#endif
+
 /** MxN forward transform (2D)
 *  \param block input data (residual)
 *  \param coeff output data (transform coefficients)
@@ -800,6 +1010,34 @@ void xTrMxN(Int bitDepth, Short *block,Short *coeff, Int iWidth, Int iHeight, UI
 
   Short tmp[ 64 * 64 ];
 
+#if SIMD_X86
+  if( iWidth == iHeight && getSimdLevel() >= SIMD_SSE41 )
+  {
+    switch( iWidth )
+    {
+    case 4:
+      if (uiMode != REG_DCT)
+      {
+        xTrMxNSIMD<4>( &g_as_DST_MAT_4[0][0], g_cTrMatricesTransposed.aiDST4, block, coeff, shift_1st, shift_2nd );
+      }
+      else
+      {
+        xTrMxNSIMD<4>( &g_aiT4[0][0], g_cTrMatricesTransposed.aiT4, block, coeff, shift_1st, shift_2nd );
+      }
+      return;
+    case 8:
+      xTrMxNSIMD<8>( &g_aiT8[0][0], g_cTrMatricesTransposed.aiT8, block, coeff, shift_1st, shift_2nd );
+      return;
+    case 16:
+      xTrMxNSIMD<16>( &g_aiT16[0][0], g_cTrMatricesTransposed.aiT16, block, coeff, shift_1st, shift_2nd );
+      return;
+    case 32:
+      xTrMxNSIMD<32>( &g_aiT32[0][0], g_cTrMatricesTransposed.aiT32, block, coeff, shift_1st, shift_2nd );
+      return;
+    }
+  }
+#endif
+
   if( iWidth == 4 && iHeight == 4)
   {
     if (uiMode != REG_DCT)
@@ -836,12 +1074,61 @@ void xTrMxN(Int bitDepth, Short *block,Short *coeff, Int iWidth, Int iHeight, UI
 *  \param iWidth input data (width of transform)
 *  \param iHeight input data (height of transform)
 */
+#if INV_TRANSFORM_ZERO_SKIP
+void xITrMxN(Int bitDepth, Short *coeff,Short *block, Int iWidth, Int iHeight, UInt uiMode, Int iNumCoeffCols, Int iNumCoeffRows)
+#else
 void xITrMxN(Int bitDepth, Short *coeff,Short *block, Int iWidth, Int iHeight, UInt uiMode)
+#endif
 {
   Int shift_1st = SHIFT_INV_1ST;
   Int shift_2nd = SHIFT_INV_2ND - (bitDepth-8);
 
+#if INV_TRANSFORM_ZERO_SKIP
+  if( iNumCoeffCols <= 1 && iNumCoeffRows <= 1 && !( iWidth == 4 && uiMode != REG_DCT ) )
+  {
+    // DC only, the first row of the DCT matrices is 64 so that both passes give constant lines
+    Int iDC = Clip3( -32768, 32767, ( 64 * ( iNumCoeffCols ? coeff[0] : 0 ) + ( 1 << ( shift_1st - 1 ) ) ) >> shift_1st );
+    iDC     = Clip3( -32768, 32767, ( 64 * iDC + ( 1 << ( shift_2nd - 1 ) ) ) >> shift_2nd );
+    for( Int j = 0; j < iWidth * iHeight; j++ )
+    {
+      block[j] = (Short)iDC;
+    }
+    return;
+  }
+#endif
+
   Short tmp[ 64*64];
+#if SIMD_X86
+  if( iWidth == iHeight && getSimdLevel() >= SIMD_SSE41 )
+  {
+#if !INV_TRANSFORM_ZERO_SKIP
+    const Int iNumCoeffCols = iWidth;
+    const Int iNumCoeffRows = iHeight;
+#endif
+    switch( iWidth )
+    {
+    case 4:
+      if (uiMode != REG_DCT)
+      {
+        xITrMxNSIMD<4>( &g_as_DST_MAT_4[0][0], g_cTrMatricesTransposed.aiDST4, coeff, block, shift_1st, shift_2nd, iNumCoeffCols, iNumCoeffRows );
+      }
+      else
+      {
+        xITrMxNSIMD<4>( &g_aiT4[0][0], g_cTrMatricesTransposed.aiT4, coeff, block, shift_1st, shift_2nd, iNumCoeffCols, iNumCoeffRows );
+      }
+      return;
+    case 8:
+      xITrMxNSIMD<8>( &g_aiT8[0][0], g_cTrMatricesTransposed.aiT8, coeff, block, shift_1st, shift_2nd, iNumCoeffCols, iNumCoeffRows );
+      return;
+    case 16:
+      xITrMxNSIMD<16>( &g_aiT16[0][0], g_cTrMatricesTransposed.aiT16, coeff, block, shift_1st, shift_2nd, iNumCoeffCols, iNumCoeffRows );
+      return;
+    case 32:
+      xITrMxNSIMD<32>( &g_aiT32[0][0], g_cTrMatricesTransposed.aiT32, coeff, block, shift_1st, shift_2nd, iNumCoeffCols, iNumCoeffRows );
+      return;
+    }
+  }
+#endif
   if( iWidth == 4 && iHeight == 4)
   {
     if (uiMode != REG_DCT)
@@ -1202,6 +1489,9 @@ Void TComTrQuant::init( UInt uiMaxTrSize,
                        Bool bEnc, Bool useTransformSkipFast
 #if ADAPTIVE_QP_SELECTION
                        , Bool bUseAdaptQpSelect
+#endif
+#if FAST_RDOQ
+                       , Bool useRDOQFast
 #endif
                        )
 {
@@ -1213,6 +1503,9 @@ Void TComTrQuant::init( UInt uiMaxTrSize,
   m_bUseAdaptQpSelect = bUseAdaptQpSelect;
 #endif
   m_useTransformSkipFast = useTransformSkipFast;
+#if FAST_RDOQ
+  m_useRDOQFast = useRDOQFast;
+#endif
 }
 
 Void TComTrQuant::transformNxN( TComDataCU* pcCU, 
@@ -1395,7 +1688,27 @@ Void TComTrQuant::xIT(Int bitDepth, UInt uiMode, Int* plCoef, Pel* pResidual, UI
     {    
       coeff[j] = (Short)plCoef[j];
     }
+#if INV_TRANSFORM_ZERO_SKIP
+    // bounding box of the non-zero coefficients, most blocks only have a few low frequency ones
+    Int iNumCoeffCols = 0;
+    Int iNumCoeffRows = 0;
+    for ( Int y = 0; y < iHeight; y++ )
+    {
+      Int x = iWidth - 1;
+      while ( x >= 0 && coeff[y * iWidth + x] == 0 )
+      {
+        x--;
+      }
+      if ( x >= 0 )
+      {
+        iNumCoeffRows = y + 1;
+        iNumCoeffCols = std::max( iNumCoeffCols, x + 1 );
+      }
+    }
+    xITrMxN(bitDepth, coeff, block, iWidth, iHeight, uiMode, iNumCoeffCols, iNumCoeffRows );
+#else
     xITrMxN(bitDepth, coeff, block, iWidth, iHeight, uiMode );
+#endif
     {
       for ( j = 0; j < iHeight; j++ )
       {    
@@ -1589,11 +1902,87 @@ Void TComTrQuant::xRateDistOptQuant                 ( TComDataCU*
   Int iScanPos;
   coeffGroupRDStats rdStats;     
   
+#if FAST_RDOQ
+  Bool abCGHasLevel[ MLS_GRP_NUM ];
+  if( m_useRDOQFast )
+  {
+    // coefficient groups with a level in the dead zone quantisation of xQuant() without RDOQ, the others are taken as zero
+    const Int64 iLevelThreshold = ( 1 << iQBits ) - ( ( pcCU->getSlice()->getSliceType() == I_SLICE ? 171 : 85 ) << ( iQBits - 9 ) );
+    Bool bHasLevel = false;
+    for( Int iCGScanPos = 0; iCGScanPos < uiCGNum; iCGScanPos++ )
+    {
+      abCGHasLevel[ iCGScanPos ] = false;
+      for( Int iPos = iCGScanPos*uiCGSize; iPos < ( iCGScanPos+1 )*uiCGSize; iPos++ )
+      {
+        UInt uiBlkPos = scan[ iPos ];
+        abCGHasLevel[ iCGScanPos ] |= (Int64)abs( plSrcCoeff[ uiBlkPos ] ) * piQCoef[ uiBlkPos ] >= iLevelThreshold;
+      }
+      bHasLevel |= abCGHasLevel[ iCGScanPos ];
+    }
+    if( !bHasLevel )
+    {
+      ::memset( piDstCoeff, 0, sizeof(TCoeff) * uiMaxNumCoeff );
+#if ADAPTIVE_QP_SELECTION
+      if( m_bUseAdaptQpSelect )
+      {
+        for( UInt uiBlkPos = 0; uiBlkPos < uiMaxNumCoeff; uiBlkPos++ )
+        {
+          piArlDstCoeff[ uiBlkPos ] = ( abs( plSrcCoeff[ uiBlkPos ] ) * piQCoef[ uiBlkPos ] + iAddC ) >> iQBitsC;
+        }
+      }
+#endif
+      return;
+    }
+  }
+#endif
+
   for (Int iCGScanPos = uiCGNum-1; iCGScanPos >= 0; iCGScanPos--)
   {
     UInt uiCGBlkPos = scanCG[ iCGScanPos ];
     UInt uiCGPosY   = uiCGBlkPos / uiNumBlkSide;
     UInt uiCGPosX   = uiCGBlkPos - (uiCGPosY * uiNumBlkSide);
+#if FAST_RDOQ
+    if( m_useRDOQFast && !abCGHasLevel[ iCGScanPos ] && ( iCGLastScanPos < 0 || iCGScanPos > 0 ) )
+    {
+      // early termination on a group quantised to zero, only its distortion and its sig_coeff_group_flag are counted
+      for (Int iScanPosinCG = uiCGSize-1; iScanPosinCG >= 0; iScanPosinCG--)
+      {
+        iScanPos = iCGScanPos*uiCGSize + iScanPosinCG;
+        UInt    uiBlkPos          = scan[iScanPos];
+        Int     lLevelDouble      = abs( plSrcCoeff[ uiBlkPos ] ) * piQCoef[ uiBlkPos ];
+#if ADAPTIVE_QP_SELECTION
+        if( m_bUseAdaptQpSelect )
+        {
+          piArlDstCoeff[uiBlkPos] = ( lLevelDouble + iAddC ) >> iQBitsC;
+        }
+#endif
+        Double  dErr              = Double( lLevelDouble );
+        pdCostCoeff0[ iScanPos ]  = dErr * dErr * pdErrScale[ uiBlkPos ];
+        d64BlockUncodedCost      += pdCostCoeff0[ iScanPos ];
+        d64BaseCost              += pdCostCoeff0[ iScanPos ];
+        piDstCoeff[ uiBlkPos ]    = 0;
+      }
+      if( iCGLastScanPos >= 0 )
+      {
+        //===== context set update =====
+        c2                = 0;
+        uiGoRiceParam     = 0;
+        c1Idx             = 0;
+        c2Idx             = 0;
+        uiCtxSet          = (iScanPos == SCAN_SET_SIZE || eTType!=TEXT_LUMA) ? 0 : 2;
+        if( c1 == 0 )
+        {
+          uiCtxSet++;
+        }
+        c1 = 1;
+
+        UInt  uiCtxSig = getSigCoeffGroupCtxInc( uiSigCoeffGroupFlag, uiCGPosX, uiCGPosY, uiWidth, uiHeight);
+        pdCostCoeffGroupSig[ iCGScanPos ] = xGetRateSigCoeffGroup(0, uiCtxSig);
+        d64BaseCost += pdCostCoeffGroupSig[ iCGScanPos ];
+      }
+      continue;
+    }
+#endif
 #if MAYBE_BUGFIX
     rdStats.init();
 #else
@@ -2524,6 +2913,40 @@ Void TComTrQuant::processScalingListDec( Int *coeff, Int *dequantcoeff, Int invQ
   }
 }
 
+#if ENC_WPP_PARALLEL || DEC_TILE_WPP_PARALLEL
+/** copy the lambdas, the RDOQ settings and the quantization matrices set for the slice from another instance
+ * \param pcTrQuant transform and quantization class the settings are taken from
+ */
+Void TComTrQuant::copySliceSettings( TComTrQuant* pcTrQuant )
+{
+#if RDOQ_CHROMA_LAMBDA
+  setLambdas( pcTrQuant->m_lambdas );
+#endif
+  m_dLambda      = pcTrQuant->m_dLambda;
+  m_uiRDOQOffset = pcTrQuant->m_uiRDOQOffset;
+#if ADAPTIVE_QP_SELECTION
+  memcpy( m_qpDelta, pcTrQuant->m_qpDelta, sizeof( m_qpDelta ) );
+#endif
+  m_scalingListEnabledFlag = pcTrQuant->m_scalingListEnabledFlag;
+#if FAST_RDOQ
+  memcpy( m_acSliceEstBits, pcTrQuant->m_acSliceEstBits, sizeof( m_acSliceEstBits ) );
+#endif
+
+  for(UInt sizeId = 0; sizeId < SCALING_LIST_SIZE_NUM; sizeId++)
+  {
+    for(UInt listId = 0; listId < g_scalingListNum[sizeId]; listId++)
+    {
+      for(UInt qp = 0; qp < SCALING_LIST_REM_NUM; qp++)
+      {
+        memcpy( m_quantCoef  [sizeId][listId][qp], pcTrQuant->m_quantCoef  [sizeId][listId][qp], sizeof( Int    ) * g_scalingListSize[sizeId] );
+        memcpy( m_dequantCoef[sizeId][listId][qp], pcTrQuant->m_dequantCoef[sizeId][listId][qp], sizeof( Int    ) * g_scalingListSize[sizeId] );
+        memcpy( m_errScale   [sizeId][listId][qp], pcTrQuant->m_errScale   [sizeId][listId][qp], sizeof( Double ) * g_scalingListSize[sizeId] );
+      }
+    }
+  }
+}
+#endif
+
 /** initialization process of scaling list array
  */
 Void TComTrQuant::initScalingList()
@@ -124,6 +124,9 @@ public:
 #if ADAPTIVE_QP_SELECTION
     , Bool bUseAdaptQpSelect = false
 #endif 
+#if FAST_RDOQ
+    , Bool useRDOQFast = false
+#endif
     );
   
   // transform & inverse transform functions
@@ -157,6 +160,11 @@ public:
   Void setRDOQOffset( UInt uiRDOQOffset ) { m_uiRDOQOffset = uiRDOQOffset; }
   
   estBitsSbacStruct* m_pcEstBitsSbac;
+#if FAST_RDOQ
+  Bool               getUseRDOQFast    ()                                { return m_useRDOQFast; }
+  estBitsSbacStruct* getSliceEstBits   ( UInt uiWidth, TextType eTType ) { return &m_acSliceEstBits[ (Int)g_aucConvertToBit[ uiWidth ] ][ eTType == TEXT_LUMA ? 0 : 1 ]; } ///< rates of a TU size estimated at the start of the slice
+  Void               selectSliceEstBits( UInt uiWidth, TextType eTType ) { m_pcEstBitsSbac = getSliceEstBits( uiWidth, eTType ); }                                   ///< use the slice rates instead of the ones of the TU
+#endif
   
   static Int      calcPatternSigCtx( const UInt* sigCoeffGroupFlag, UInt posXCG, UInt posYCG, Int width, Int height );
 
@@ -188,6 +196,9 @@ public:
   Void setScalingListDec   ( TComScalingList *scalingList);
   Void processScalingListEnc( Int *coeff, Int *quantcoeff, Int quantScales, UInt height, UInt width, UInt ratio, Int sizuNum, UInt dc);
   Void processScalingListDec( Int *coeff, Int *dequantcoeff, Int invQuantScales, UInt height, UInt width, UInt ratio, Int sizuNum, UInt dc);
+#if ENC_WPP_PARALLEL || DEC_TILE_WPP_PARALLEL
+  Void copySliceSettings   ( TComTrQuant* pcTrQuant );   ///< copy the lambdas and quantization matrices set for the slice
+#endif
 #if ADAPTIVE_QP_SELECTION
   Void    initSliceQpDelta() ;
   Void    storeSliceQpNext(TComSlice* pcSlice);
@@ -218,6 +229,11 @@ protected:
   Bool     m_bUseAdaptQpSelect;
 #endif
   Bool     m_useTransformSkipFast;
+#if FAST_RDOQ
+  Bool     m_useRDOQFast;
+  estBitsSbacStruct  m_acSliceEstBits[SCALING_LIST_SIZE_NUM][2];  ///< rates of the luma and chroma TUs of each size at the start of the slice
+  estBitsSbacStruct* m_pcEstBitsSbacTU;                           ///< rates estimated for each TU, m_pcEstBitsSbac points to them unless the slice rates are selected
+#endif
   Bool     m_scalingListEnabledFlag;
   Int      *m_quantCoef      [SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM][SCALING_LIST_REM_NUM]; ///< array of quantization matrix coefficient 4x4
   Int      *m_dequantCoef    [SCALING_LIST_SIZE_NUM][SCALING_LIST_NUM][SCALING_LIST_REM_NUM]; ///< array of dequantization matrix coefficient 4x4
@@ -1,6 +1,10 @@
 #include "TypeDef.h"
 #if SVC_EXTENSION
 #include "TComUpsampleFilter.h"
+#include "TComSimd.h"
+#if SIMD_X86
+#include <immintrin.h>
+#endif
 
 const Int TComUpsampleFilter::m_lumaFixedFilter[16][NTAPS_US_LUMA] =
 {
@@ -43,7 +47,18 @@ const Int TComUpsampleFilter::m_chromaFixedFilter[16][NTAPS_US_CHROMA] =
 };
 
 TComUpsampleFilter::TComUpsampleFilter(void)
+#if ILR_ON_DEMAND_UPSAMPLING
+: m_bDeferred   ( false )
+, m_iBandHeight ( 0 )
+#endif
 {
+#if ILR_ON_DEMAND_UPSAMPLING
+  for( Int i = 0; i < MAX_LAYERS; i++ )
+  {
+    m_apcDeferredPic[i] = NULL;
+    m_aiNumBandsLeft[i] = 0;
+  }
+#endif
 }
 
 TComUpsampleFilter::~TComUpsampleFilter(void)
@@ -73,6 +88,17 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 
   Int i, j;
 
+#if ILR_ON_DEMAND_UPSAMPLING
+  m_apcDeferredPic[refLayerIdc] = NULL;
+
+#endif
+#if ILR_ON_DEMAND_UPSAMPLING && DEC_PICTURE_PIPELINE && O0194_JOINT_US_BITSHIFT
+  // the decoder of a reference layer picture extends the border of its rows as they are completed, while the picture
+  // is still decoded or already extended it is left as it is, since other threads may read it
+  const Bool bExtendBase = !m_bDeferred || ( currSlice->getBaseColPic(refLayerIdc)->isReconstructionFinished() && !pcBasePic->isBorderExtended() );
+#else
+  const Bool bExtendBase = true;
+#endif
 #if O0194_JOINT_US_BITSHIFT
   UInt currLayerId = currSlice->getLayerId();
   UInt refLayerId  = currSlice->getVPS()->getRefLayerId( currLayerId, refLayerIdc );
@@ -156,8 +182,8 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
   Pel* piSrcV;
   Pel* piDstV;
 
-  Int scaleX = g_posScalingFactor[refLayerIdc][0];
-  Int scaleY = g_posScalingFactor[refLayerIdc][1];
+  Int scaleX = currSlice->getPosScalingFactor(refLayerIdc, 0);
+  Int scaleY = currSlice->getPosScalingFactor(refLayerIdc, 1);
 
   // non-normative software optimization for certain simple resampling cases
   if( scaleX == 65536 && scaleY == 65536 ) // ratio 1x
@@ -238,7 +264,9 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
     Int refPos16 = 0;
     Int phase    = 0;
     Int refPos   = 0;
+#if !R0220_REMOVE_EL_CLIP
     Int* coeff = m_chromaFilter[phase];
+#endif
     for ( i = 0; i < 16; i++)
     {
       memcpy(   m_lumaFilter[i],   m_lumaFixedFilter[i], sizeof(Int) * NTAPS_US_LUMA   );
@@ -248,8 +276,11 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
     assert ( widthEL >= widthBL );
     assert ( heightEL >= heightBL );
 
-    pcBasePic->setBorderExtension(false);
-    pcBasePic->extendPicBorder(); // extend the border.
+    if( bExtendBase )
+    {
+      pcBasePic->setBorderExtension(false);
+      pcBasePic->extendPicBorder(); // extend the border.
+    }
 
     Int   shiftX = 16;
     Int   shiftY = 16;
@@ -352,6 +383,20 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #endif
 
     //========== horizontal upsampling ===========
+    TComUpsamplePlane& planeY = m_acPlane[refLayerIdc][0];
+    planeY.srcBuf    = piSrcBufY;
+    planeY.srcStride = strideBL;
+    planeY.srcHeight = heightBL;
+    planeY.tmpBuf    = piTempBufY;
+    planeY.dstBuf    = piDstBufY;
+    planeY.stride    = strideEL;
+    planeY.width     = widthEL;
+    planeY.height    = heightEL;
+    planeY.numTaps   = NTAPS_US_LUMA;
+    planeY.shift1    = shift1;
+    planeY.horRefPos.resize( widthEL );
+    planeY.horPhase.resize( widthEL );
+
     for( i = 0; i < widthEL; i++ )
     {
 #if R0220_REMOVE_EL_CLIP
@@ -378,24 +423,23 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #if R0220_REMOVE_EL_CLIP
       refPos   = Clip3( rlClipL, rlClipR, refPos );
 #endif
-      coeff = m_lumaFilter[phase];
-
-      piSrcY = piSrcBufY + refPos -((NTAPS_US_LUMA>>1) - 1);
-      piDstY = piTempBufY + i;
-
-      for( j = 0; j < heightBL ; j++ )
-      {
-        *piDstY = sumLumaHor(piSrcY, coeff) >> shift1;
-        piSrcY += strideBL;
-        piDstY += strideEL;
-      }
+      planeY.horRefPos[i] = refPos - ((NTAPS_US_LUMA>>1) - 1);
+      planeY.horPhase[i]  = phase;
     }
 
+#if !R0220_REMOVE_EL_CLIP
+    xFilterHor( piSrcBufY, strideBL, piTempBufY, strideEL, widthEL, heightBL, NTAPS_US_LUMA, shift1, &planeY.horRefPos[0], &planeY.horPhase[0] );
+
+#endif
     //========== vertical upsampling ===========
+#if R0220_REMOVE_EL_CLIP
+    // the rows of the temporary picture are filtered and their border is extended by xUpsampleRows()
+#else
     pcTempPic->setBorderExtension(false);
     pcTempPic->setHeight(heightBL);
     pcTempPic->extendPicBorder   (); // extend the border.
     pcTempPic->setHeight(heightEL);
+#endif
 
 #if O0194_JOINT_US_BITSHIFT
     Int nShift = 20 - g_bitDepthYLayer[currLayerId];
@@ -404,6 +448,12 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #endif
     Int iOffset = 1 << (nShift - 1);
 
+    planeY.nShift = nShift;
+    planeY.offset = iOffset;
+    planeY.maxVal = (1 << g_bitDepthY) - 1;
+    planeY.verRefPos.resize( pcTempPic->getHeight() );
+    planeY.verPhase.resize( pcTempPic->getHeight() );
+
     for( j = 0; j < pcTempPic->getHeight(); j++ )
     {
 #if R0220_REMOVE_EL_CLIP
@@ -430,21 +480,15 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #if R0220_REMOVE_EL_CLIP
       refPos = Clip3( rlClipT, rlClipB, refPos );
 #endif
+#if R0220_REMOVE_EL_CLIP
+      planeY.verRefPos[j] = refPos - ((NTAPS_US_LUMA>>1) - 1);
+      planeY.verPhase[j]  = phase;
+#else
       coeff = m_lumaFilter[phase];
 
       piSrcY = piTempBufY + (refPos -((NTAPS_US_LUMA>>1) - 1))*strideEL;
       Pel* piDstY0 = piDstBufY + j * strideEL;
 
-#if R0220_REMOVE_EL_CLIP
-      piDstY = piDstY0;
-
-      for( i = pcTempPic->getWidth(); i > 0; i-- )
-      {
-        *piDstY = ClipY( (sumLumaVer(piSrcY, coeff, strideEL) + iOffset) >> (nShift));
-        piSrcY++;
-        piDstY++;
-      }
-#else
       piDstY = piDstY0 + leftOffset;
       piSrcY += leftOffset;
 
@@ -578,6 +622,20 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #endif
 
     //========== horizontal upsampling ===========
+    TComUpsamplePlane& planeU = m_acPlane[refLayerIdc][1];
+    planeU.srcBuf    = piSrcBufU;
+    planeU.srcStride = strideBL;
+    planeU.srcHeight = heightBL;
+    planeU.tmpBuf    = piTempBufU;
+    planeU.dstBuf    = piDstBufU;
+    planeU.stride    = strideEL;
+    planeU.width     = widthEL;
+    planeU.height    = heightEL;
+    planeU.numTaps   = NTAPS_US_CHROMA;
+    planeU.shift1    = shift1;
+    planeU.horRefPos.resize( widthEL );
+    planeU.horPhase.resize( widthEL );
+
     for( i = 0; i < widthEL; i++ )
     {
 #if R0220_REMOVE_EL_CLIP
@@ -604,30 +662,22 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #if R0220_REMOVE_EL_CLIP
       refPos   = Clip3(rlClipL, rlClipR, refPos);
 #endif
-      coeff = m_chromaFilter[phase];
-
-      piSrcU = piSrcBufU + refPos -((NTAPS_US_CHROMA>>1) - 1);
-      piSrcV = piSrcBufV + refPos -((NTAPS_US_CHROMA>>1) - 1);
-      piDstU = piTempBufU + i;
-      piDstV = piTempBufV + i;
-
-      for( j = 0; j < heightBL ; j++ )
-      {
-        *piDstU = sumChromaHor(piSrcU, coeff) >> shift1;
-        *piDstV = sumChromaHor(piSrcV, coeff) >> shift1;
-
-        piSrcU += strideBL;
-        piSrcV += strideBL;
-        piDstU += strideEL;
-        piDstV += strideEL;
-      }
+      planeU.horRefPos[i] = refPos - ((NTAPS_US_CHROMA>>1) - 1);
+      planeU.horPhase[i]  = phase;
     }
 
+#if !R0220_REMOVE_EL_CLIP
+    xFilterHor( piSrcBufU, strideBL, piTempBufU, strideEL, widthEL, heightBL, NTAPS_US_CHROMA, shift1, &planeU.horRefPos[0], &planeU.horPhase[0] );
+    xFilterHor( piSrcBufV, strideBL, piTempBufV, strideEL, widthEL, heightBL, NTAPS_US_CHROMA, shift1, &planeU.horRefPos[0], &planeU.horPhase[0] );
+
+#endif
     //========== vertical upsampling ===========
+#if !R0220_REMOVE_EL_CLIP
     pcTempPic->setBorderExtension(false);
     pcTempPic->setHeight(heightBL << 1);
     pcTempPic->extendPicBorder   (); // extend the border.
     pcTempPic->setHeight(heightEL << 1);
+#endif
 
 #if O0194_JOINT_US_BITSHIFT
     nShift = 20 - g_bitDepthCLayer[currLayerId];
@@ -636,6 +686,12 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #endif
     iOffset = 1 << (nShift - 1);
 
+    planeU.nShift = nShift;
+    planeU.offset = iOffset;
+    planeU.maxVal = (1 << g_bitDepthC) - 1;
+    planeU.verRefPos.resize( pcTempPic->getHeight() >> 1 );
+    planeU.verPhase.resize( pcTempPic->getHeight() >> 1 );
+
     for( j = 0; j < pcTempPic->getHeight() >> 1; j++ )
     {
 #if R0220_REMOVE_EL_CLIP
@@ -662,6 +718,10 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #if R0220_REMOVE_EL_CLIP
       refPos = Clip3(rlClipT, rlClipB, refPos);
 #endif
+#if R0220_REMOVE_EL_CLIP
+      planeU.verRefPos[j] = refPos - ((NTAPS_US_CHROMA>>1) - 1);
+      planeU.verPhase[j]  = phase;
+#else
       coeff = m_chromaFilter[phase];
 
       piSrcU = piTempBufU  + (refPos -((NTAPS_US_CHROMA>>1) - 1))*strideEL;
@@ -670,20 +730,6 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
       Pel* piDstU0 = piDstBufU + j*strideEL;
       Pel* piDstV0 = piDstBufV + j*strideEL;
 
-#if R0220_REMOVE_EL_CLIP
-      piDstU = piDstU0;
-      piDstV = piDstV0;
-
-      for( i = pcTempPic->getWidth() >> 1; i > 0; i-- )
-      {
-        *piDstU = ClipC( (sumChromaVer(piSrcU, coeff, strideEL) + iOffset) >> (nShift));
-        *piDstV = ClipC( (sumChromaVer(piSrcV, coeff, strideEL) + iOffset) >> (nShift));
-        piSrcU++;
-        piSrcV++;
-        piDstU++;
-        piDstV++;
-      }
-#else
       piDstU = piDstU0 + leftOffset;
       piDstV = piDstV0 + leftOffset;
       piSrcU += leftOffset;
@@ -719,13 +765,584 @@ Void TComUpsampleFilter::upsampleBasePic( UInt refLayerIdc, TComPicYuv* pcUsPic,
 #endif
 
     }
+
+#if R0220_REMOVE_EL_CLIP
+    TComUpsamplePlane& planeV = m_acPlane[refLayerIdc][2];
+    planeV        = planeU;
+    planeV.srcBuf = piSrcBufV;
+    planeV.tmpBuf = piTempBufV;
+    planeV.dstBuf = piDstBufV;
+
+    for( i = 0; i < 3; i++ )
+    {
+      m_acPlane[refLayerIdc][i].tmpRowDone.assign( m_acPlane[refLayerIdc][i].srcHeight, false );
+    }
+
+#if ILR_ON_DEMAND_UPSAMPLING
+    if( m_bDeferred )
+    {
+      // the rows are resampled by upsampleRows() in bands of CTU rows when they are first referenced
+      m_iBandHeight = g_uiMaxCUHeight;
+      Int numBands  = ( planeY.height + m_iBandHeight - 1 ) / m_iBandHeight;
+      m_abBandDone[refLayerIdc].assign( numBands, false );
+      m_aiNumBandsLeft[refLayerIdc] = numBands;
+      m_apcDeferredPic[refLayerIdc] = pcUsPic;
+    }
+    else
+#endif
+    for( i = 0; i < 3; i++ )
+    {
+      xUpsampleRows( m_acPlane[refLayerIdc][i], 0, m_acPlane[refLayerIdc][i].height );
+    }
+#endif
   }
+#if ILR_ON_DEMAND_UPSAMPLING
+  // the border of the rows resampled on demand is extended with them
+  if( !m_apcDeferredPic[refLayerIdc] )
+#endif
+  {
     pcUsPic->setBorderExtension(false);
     pcUsPic->extendPicBorder   (); // extend the border.
+  }
 
     //Reset the Border extension flag
     pcUsPic->setBorderExtension(false);
     pcTempPic->setBorderExtension(false);
-    pcBasePic->setBorderExtension(false);
+    if( bExtendBase )
+    {
+      pcBasePic->setBorderExtension(false);
+    }
 }
+
+#if SIMD_X86
+// ====================================================================================================================
+// Vectorised kernels, bit-exact with the C code of xFilterHor() and xFilterVer()
+// ====================================================================================================================
+
+/** Horizontal filter, one output column per filter evaluation of 4/8 taps gathered at the column reference position
+ */
+template<Int N>
+SIMD_TARGET_SSE41
+static Void xFilterHorGatherSSE41( const Pel* src, Int srcStride, Pel* dst, Int dstStride, Int width, Int height, const Int* refPos, const Int* phase, const Int* filter, Int shift )
+{
+  __m128i coeff[16];
+  for( Int p = 0; p < 16; p++ )
+  {
+    const Int* c = filter + p * N;
+    coeff[p] = N == 8 ? _mm_setr_epi16( c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7] ) : _mm_setr_epi16( c[0], c[1], c[2], c[3], 0, 0, 0, 0 );
+  }
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+  const Int width8 = width & ~7;
+
+  for( Int j = 0; j < height; j++ )
+  {
+    for( Int i = 0; i < width8; i += 8 )
+    {
+      __m128i sum[8];
+      for( Int k = 0; k < 8; k++ )
+      {
+        const Pel* s = src + refPos[i + k];
+        __m128i v = N == 8 ? _mm_loadu_si128( (const __m128i*)s ) : _mm_loadl_epi64( (const __m128i*)s );
+        sum[k] = _mm_madd_epi16( v, coeff[phase[i + k]] );
+      }
+      __m128i lo = _mm_hadd_epi32( _mm_hadd_epi32( sum[0], sum[1] ), _mm_hadd_epi32( sum[2], sum[3] ) );
+      __m128i hi = _mm_hadd_epi32( _mm_hadd_epi32( sum[4], sum[5] ), _mm_hadd_epi32( sum[6], sum[7] ) );
+      lo = _mm_sra_epi32( lo, vShift );
+      hi = _mm_sra_epi32( hi, vShift );
+      _mm_storeu_si128( (__m128i*)( dst + i ), _mm_packs_epi32( lo, hi ) );
+    }
+    for( Int i = width8; i < width; i++ )
+    {
+      const Pel* s = src + refPos[i];
+      const Int* c = filter + phase[i] * N;
+      Int sum = 0;
+      for( Int k = 0; k < N; k++ )
+      {
+        sum += s[k] * c[k];
+      }
+      dst[i] = sum >> shift;
+    }
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+/** Check whether the output columns i to i+length-1 follow a resampling pattern: the phases repeat every period columns and the reference position advances by step samples per period
+ */
+static Bool xIsPolyphaseRun( const Int* refPos, const Int* phase, Int i, Int length, Int period, Int step )
+{
+  for( Int k = period; k < length; k++ )
+  {
+    if( phase[i + k] != phase[i + k % period] || refPos[i + k] != refPos[i + k % period] + step * ( k / period ) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+/** 2x polyphase filter of 8 consecutive reference positions for one phase, v[t] holds the samples at position t
+ */
+template<Int N>
+SIMD_TARGET_SSE41
+static inline __m128i xFilter2xPhaseSSE41( const __m128i* v, const Int* c, __m128i vShift )
+{
+  __m128i lo = _mm_setzero_si128();
+  __m128i hi = _mm_setzero_si128();
+  for( Int t = 0; t < N; t += 2 )
+  {
+    const __m128i cc = _mm_set1_epi32( (Int)( ( (UInt)(UShort)c[t + 1] << 16 ) | (UShort)c[t] ) );
+    lo = _mm_add_epi32( lo, _mm_madd_epi16( _mm_unpacklo_epi16( v[t], v[t + 1] ), cc ) );
+    hi = _mm_add_epi32( hi, _mm_madd_epi16( _mm_unpackhi_epi16( v[t], v[t + 1] ), cc ) );
+  }
+  return _mm_packs_epi32( _mm_sra_epi32( lo, vShift ), _mm_sra_epi32( hi, vShift ) );
+}
+
+/** Horizontal filter of 16 output columns with ratio 2x, the even and odd columns share the loads of the source vectors
+ */
+template<Int N>
+SIMD_TARGET_SSE41
+static Void xFilterHor2xSSE41( const Pel* src, Int srcStride, Pel* dst, Int dstStride, Int height, const Int* refPos, const Int* phase, const Int* filter, Int shift )
+{
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+  const Int  delta = refPos[1] - refPos[0];
+  const Int* cEven = filter + phase[0] * N;
+  const Int* cOdd  = filter + phase[1] * N;
+  src += refPos[0];
+
+  for( Int j = 0; j < height; j++ )
+  {
+    __m128i v[N + 1];
+    for( Int t = 0; t <= N; t++ )
+    {
+      v[t] = _mm_loadu_si128( (const __m128i*)( src + t ) );
+    }
+    __m128i even = xFilter2xPhaseSSE41<N>( v, cEven, vShift );
+    __m128i odd  = xFilter2xPhaseSSE41<N>( v + delta, cOdd, vShift );
+    _mm_storeu_si128( (__m128i*)dst,         _mm_unpacklo_epi16( even, odd ) );
+    _mm_storeu_si128( (__m128i*)( dst + 8 ), _mm_unpackhi_epi16( even, odd ) );
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+template<Int N>
+SIMD_TARGET_AVX2
+static inline __m256i xFilter2xPhaseAVX2( const __m256i* v, const Int* c, __m128i vShift )
+{
+  __m256i lo = _mm256_setzero_si256();
+  __m256i hi = _mm256_setzero_si256();
+  for( Int t = 0; t < N; t += 2 )
+  {
+    const __m256i cc = _mm256_set1_epi32( (Int)( ( (UInt)(UShort)c[t + 1] << 16 ) | (UShort)c[t] ) );
+    lo = _mm256_add_epi32( lo, _mm256_madd_epi16( _mm256_unpacklo_epi16( v[t], v[t + 1] ), cc ) );
+    hi = _mm256_add_epi32( hi, _mm256_madd_epi16( _mm256_unpackhi_epi16( v[t], v[t + 1] ), cc ) );
+  }
+  // the in-lane pack restores the order of the in-lane unpack
+  return _mm256_packs_epi32( _mm256_sra_epi32( lo, vShift ), _mm256_sra_epi32( hi, vShift ) );
+}
+
+/** Horizontal filter of 32 output columns with ratio 2x
+ */
+template<Int N>
+SIMD_TARGET_AVX2
+static Void xFilterHor2xAVX2( const Pel* src, Int srcStride, Pel* dst, Int dstStride, Int height, const Int* refPos, const Int* phase, const Int* filter, Int shift )
+{
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+  const Int  delta = refPos[1] - refPos[0];
+  const Int* cEven = filter + phase[0] * N;
+  const Int* cOdd  = filter + phase[1] * N;
+  src += refPos[0];
+
+  for( Int j = 0; j < height; j++ )
+  {
+    __m256i v[N + 1];
+    for( Int t = 0; t <= N; t++ )
+    {
+      v[t] = _mm256_loadu_si256( (const __m256i*)( src + t ) );
+    }
+    __m256i even = xFilter2xPhaseAVX2<N>( v, cEven, vShift );
+    __m256i odd  = xFilter2xPhaseAVX2<N>( v + delta, cOdd, vShift );
+    __m256i lo   = _mm256_unpacklo_epi16( even, odd );
+    __m256i hi   = _mm256_unpackhi_epi16( even, odd );
+    _mm256_storeu_si256( (__m256i*)dst,          _mm256_permute2x128_si256( lo, hi, 0x20 ) );
+    _mm256_storeu_si256( (__m256i*)( dst + 16 ), _mm256_permute2x128_si256( lo, hi, 0x31 ) );
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+/** 1.5x polyphase filter of 8 reference positions two samples apart, the pairs of adjacent samples match the pairs of taps of madd
+ */
+template<Int N>
+SIMD_TARGET_SSE41
+static inline __m128i xFilter15xPhaseSSE41( const Pel* src, const Int* c, __m128i vShift )
+{
+  __m128i lo = _mm_setzero_si128();
+  __m128i hi = _mm_setzero_si128();
+  for( Int t = 0; t < N; t += 2 )
+  {
+    const __m128i cc = _mm_set1_epi32( (Int)( ( (UInt)(UShort)c[t + 1] << 16 ) | (UShort)c[t] ) );
+    lo = _mm_add_epi32( lo, _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)( src + t ) ), cc ) );
+    hi = _mm_add_epi32( hi, _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)( src + t + 8 ) ), cc ) );
+  }
+  return _mm_packs_epi32( _mm_sra_epi32( lo, vShift ), _mm_sra_epi32( hi, vShift ) );
+}
+
+/** Horizontal filter of 24 output columns with ratio 1.5x, the three phases are filtered separately and interleaved
+ */
+template<Int N>
+SIMD_TARGET_SSE41
+static Void xFilterHor15xSSE41( const Pel* src, Int srcStride, Pel* dst, Int dstStride, Int height, const Int* refPos, const Int* phase, const Int* filter, Int shift )
+{
+  const __m128i vShift = _mm_cvtsi32_si128( shift );
+  const Int* c[3] = { filter + phase[0] * N, filter + phase[1] * N, filter + phase[2] * N };
+
+  // output column o of the run is position o / 3 of phase o % 3
+  __m128i shuffle[3][3];
+  for( Int v = 0; v < 3; v++ )
+  {
+    for( Int p = 0; p < 3; p++ )
+    {
+      Char mask[16];
+      for( Int q = 0; q < 8; q++ )
+      {
+        Int o = 8 * v + q;
+        mask[2 * q]     = o % 3 == p ? Char( 2 * ( o / 3 ) )     : Char( -128 );
+        mask[2 * q + 1] = o % 3 == p ? Char( 2 * ( o / 3 ) + 1 ) : Char( -128 );
+      }
+      shuffle[v][p] = _mm_loadu_si128( (const __m128i*)mask );
+    }
+  }
+
+  for( Int j = 0; j < height; j++ )
+  {
+    __m128i ph[3];
+    for( Int p = 0; p < 3; p++ )
+    {
+      ph[p] = xFilter15xPhaseSSE41<N>( src + refPos[p], c[p], vShift );
+    }
+    for( Int v = 0; v < 3; v++ )
+    {
+      __m128i out = _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( ph[0], shuffle[v][0] ), _mm_shuffle_epi8( ph[1], shuffle[v][1] ) ), _mm_shuffle_epi8( ph[2], shuffle[v][2] ) );
+      _mm_storeu_si128( (__m128i*)( dst + 8 * v ), out );
+    }
+    src += srcStride;
+    dst += dstStride;
+  }
+}
+
+/** Horizontal filter dispatch over the output columns: runs of the 2x and 1.5x patterns use the polyphase kernels, the other columns the gather kernel
+ */
+template<Int N>
+static Void xFilterHorSIMD( const Pel* src, Int srcStride, Pel* dst, Int dstStride, Int width, Int height, const Int* refPos, const Int* phase, const Int* filter, Int shift, Bool bAVX2 )
+{
+  Int start = 0;
+  Int i     = 0;
+
+  while( i < width )
+  {
+    Int run = 0;
+    if( bAVX2 && i + 32 <= width && refPos[i + 1] - refPos[i] >= 0 && refPos[i + 1] - refPos[i] <= 1 && xIsPolyphaseRun( refPos, phase, i, 32, 2, 1 ) )
+    {
+      run = 32;
+    }
+    else if( i + 16 <= width && refPos[i + 1] - refPos[i] >= 0 && refPos[i + 1] - refPos[i] <= 1 && xIsPolyphaseRun( refPos, phase, i, 16, 2, 1 ) )
+    {
+      run = 16;
+    }
+    else if( i + 24 <= width && xIsPolyphaseRun( refPos, phase, i, 24, 3, 2 ) )
+    {
+      run = 24;
+    }
+
+    if( run == 0 )
+    {
+      i++;
+      continue;
+    }
+    if( i > start )
+    {
+      xFilterHorGatherSSE41<N>( src, srcStride, dst + start, dstStride, i - start, height, refPos + start, phase + start, filter, shift );
+    }
+    if( run == 32 )
+    {
+      xFilterHor2xAVX2<N>( src, srcStride, dst + i, dstStride, height, refPos + i, phase + i, filter, shift );
+    }
+    else if( run == 16 )
+    {
+      xFilterHor2xSSE41<N>( src, srcStride, dst + i, dstStride, height, refPos + i, phase + i, filter, shift );
+    }
+    else
+    {
+      xFilterHor15xSSE41<N>( src, srcStride, dst + i, dstStride, height, refPos + i, phase + i, filter, shift );
+    }
+    i    += run;
+    start = i;
+  }
+  if( width > start )
+  {
+    xFilterHorGatherSSE41<N>( src, srcStride, dst + start, dstStride, width - start, height, refPos + start, phase + start, filter, shift );
+  }
+}
+
+/** Vertical filter of one output row, 8 columns per iteration
+ */
+template<Int N>
+SIMD_TARGET_SSE41
+static Void xFilterVerSSE41( const Pel* src, Int srcStride, Pel* dst, Int width, const Int* c, Int offset, Int shift, Int maxVal )
+{
+  __m128i cc[N / 2];
+  for( Int t = 0; t < N; t += 2 )
+  {
+    cc[t >> 1] = _mm_set1_epi32( (Int)( ( (UInt)(UShort)c[t + 1] << 16 ) | (UShort)c[t] ) );
+  }
+  const __m128i vOffset = _mm_set1_epi32( offset );
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m128i vMax    = _mm_set1_epi16( maxVal );
+  const __m128i vZero   = _mm_setzero_si128();
+  Int i = 0;
+
+  for( ; i + 8 <= width; i += 8 )
+  {
+    __m128i lo = vOffset;
+    __m128i hi = vOffset;
+    for( Int t = 0; t < N; t += 2 )
+    {
+      __m128i r0 = _mm_loadu_si128( (const __m128i*)( src + i + t * srcStride ) );
+      __m128i r1 = _mm_loadu_si128( (const __m128i*)( src + i + ( t + 1 ) * srcStride ) );
+      lo = _mm_add_epi32( lo, _mm_madd_epi16( _mm_unpacklo_epi16( r0, r1 ), cc[t >> 1] ) );
+      hi = _mm_add_epi32( hi, _mm_madd_epi16( _mm_unpackhi_epi16( r0, r1 ), cc[t >> 1] ) );
+    }
+    __m128i sum = _mm_packs_epi32( _mm_sra_epi32( lo, vShift ), _mm_sra_epi32( hi, vShift ) );
+    _mm_storeu_si128( (__m128i*)( dst + i ), _mm_min_epi16( _mm_max_epi16( sum, vZero ), vMax ) );
+  }
+  for( ; i < width; i++ )
+  {
+    Int sum = 0;
+    for( Int t = 0; t < N; t++ )
+    {
+      sum += src[i + t * srcStride] * c[t];
+    }
+    dst[i] = Clip3( 0, maxVal, ( sum + offset ) >> shift );
+  }
+}
+
+/** Vertical filter of one output row, 16 columns per iteration
+ */
+template<Int N>
+SIMD_TARGET_AVX2
+static Void xFilterVerAVX2( const Pel* src, Int srcStride, Pel* dst, Int width, const Int* c, Int offset, Int shift, Int maxVal )
+{
+  __m256i cc[N / 2];
+  for( Int t = 0; t < N; t += 2 )
+  {
+    cc[t >> 1] = _mm256_set1_epi32( (Int)( ( (UInt)(UShort)c[t + 1] << 16 ) | (UShort)c[t] ) );
+  }
+  const __m256i vOffset = _mm256_set1_epi32( offset );
+  const __m128i vShift  = _mm_cvtsi32_si128( shift );
+  const __m256i vMax    = _mm256_set1_epi16( maxVal );
+  const __m256i vZero   = _mm256_setzero_si256();
+  const Int width16 = width & ~15;
+
+  for( Int i = 0; i < width16; i += 16 )
+  {
+    __m256i lo = vOffset;
+    __m256i hi = vOffset;
+    for( Int t = 0; t < N; t += 2 )
+    {
+      __m256i r0 = _mm256_loadu_si256( (const __m256i*)( src + i + t * srcStride ) );
+      __m256i r1 = _mm256_loadu_si256( (const __m256i*)( src + i + ( t + 1 ) * srcStride ) );
+      lo = _mm256_add_epi32( lo, _mm256_madd_epi16( _mm256_unpacklo_epi16( r0, r1 ), cc[t >> 1] ) );
+      hi = _mm256_add_epi32( hi, _mm256_madd_epi16( _mm256_unpackhi_epi16( r0, r1 ), cc[t >> 1] ) );
+    }
+    __m256i sum = _mm256_packs_epi32( _mm256_sra_epi32( lo, vShift ), _mm256_sra_epi32( hi, vShift ) );
+    _mm256_storeu_si256( (__m256i*)( dst + i ), _mm256_min_epi16( _mm256_max_epi16( sum, vZero ), vMax ) );
+  }
+  if( width16 < width )
+  {
+    xFilterVerSSE41<N>( src + width16, srcStride, dst + width16, width - width16, c, offset, shift, maxVal );
+  }
+}
+#endif
+
+#if ILR_ON_DEMAND_UPSAMPLING
+/** Resample the bands of the upsampled picture of a reference layer that cover the luma rows iTop to iBottom-1 and are not yet resampled
+ * \param refLayerIdc  reference layer of the last call of upsampleBasePic()
+ * \param iTop         first luma row, clipped to the picture
+ * \param iBottom      luma row after the last one, clipped to the picture
+ */
+Void TComUpsampleFilter::upsampleRows( UInt refLayerIdc, Int iTop, Int iBottom )
+{
+  std::lock_guard<std::mutex> lock( m_acDeferredMutex[refLayerIdc] );
+
+  TComPicYuv* pcUsPic = m_apcDeferredPic[refLayerIdc];
+  if( !pcUsPic )
+  {
+    return;
+  }
+
+  TComUpsamplePlane* plane = m_acPlane[refLayerIdc];
+  Int firstBand = max<Int>( iTop, 0 ) / m_iBandHeight;
+  Int lastBand  = ( min<Int>( iBottom, plane[0].height ) - 1 ) / m_iBandHeight;
+
+  for( Int band = firstBand; band <= lastBand; band++ )
+  {
+    if( m_abBandDone[refLayerIdc][band] )
+    {
+      continue;
+    }
+
+    Int y0 = band * m_iBandHeight;
+    Int y1 = min<Int>( y0 + m_iBandHeight, plane[0].height );
+    xUpsampleRows( plane[0], y0, y1 );
+    xUpsampleRows( plane[1], y0 >> 1, y1 >> 1 );
+    xUpsampleRows( plane[2], y0 >> 1, y1 >> 1 );
+    pcUsPic->extendPicBorderRows( y0, y1 );
+
+    m_abBandDone[refLayerIdc][band] = true;
+    if( --m_aiNumBandsLeft[refLayerIdc] == 0 )
+    {
+      m_apcDeferredPic[refLayerIdc] = NULL;
+    }
+  }
+}
+
+#if DEC_PICTURE_PIPELINE
+/** Number of leading reference layer luma rows read by the resampling of the luma rows 0 to iBottom-1 and of the co-located chroma rows
+ * \param refLayerIdc  reference layer of the last call of upsampleBasePic()
+ * \param iBottom      luma row after the last resampled one
+ */
+Int TComUpsampleFilter::getNumSourceRows( UInt refLayerIdc, Int iBottom )
+{
+  const TComUpsamplePlane* plane = m_acPlane[refLayerIdc];
+  Int bottomY = min<Int>( iBottom, plane[0].height );
+  Int bottomC = min<Int>( ( bottomY + 1 ) >> 1, plane[1].height );
+  if( bottomY <= 0 )
+  {
+    return 0;
+  }
+
+  Int numRows = Clip3( 0, plane[0].srcHeight - 1, plane[0].verRefPos[bottomY - 1] + plane[0].numTaps - 1 ) + 1;
+  if( bottomC > 0 )
+  {
+    Int numRowsC = Clip3( 0, plane[1].srcHeight - 1, plane[1].verRefPos[bottomC - 1] + plane[1].numTaps - 1 ) + 1;
+    numRows = max<Int>( numRows, ( numRowsC * plane[0].srcHeight + plane[1].srcHeight - 1 ) / plane[1].srcHeight );
+  }
+  return numRows;
+}
+
+#endif
+#endif
+/** Resample the output rows y0 to y1-1 of a colour component
+ * The reference layer rows under the vertical filter taps are horizontally resampled first, unless an earlier call did it.
+ */
+Void TComUpsampleFilter::xUpsampleRows( TComUpsamplePlane& plane, Int y0, Int y1 )
+{
+  // the positions of the vertical filter increase with the output row, the rows outside the reference layer picture repeat its first and last row
+  Int first = Clip3( 0, plane.srcHeight - 1, plane.verRefPos[y0] );
+  Int last  = Clip3( 0, plane.srcHeight - 1, plane.verRefPos[y1 - 1] + plane.numTaps - 1 );
+
+  for( Int r = first; r <= last; )
+  {
+    if( plane.tmpRowDone[r] )
+    {
+      r++;
+      continue;
+    }
+
+    Int r1 = r;
+    while( r1 <= last && !plane.tmpRowDone[r1] )
+    {
+      plane.tmpRowDone[r1++] = true;
+    }
+    xFilterHor( plane.srcBuf + r * plane.srcStride, plane.srcStride, plane.tmpBuf + r * plane.stride, plane.stride, plane.width, r1 - r, plane.numTaps, plane.shift1, &plane.horRefPos[0], &plane.horPhase[0] );
+
+    for( Int k = 1; k <= plane.numTaps; k++ )
+    {
+      if( r == 0 )
+      {
+        memcpy( plane.tmpBuf - k * plane.stride, plane.tmpBuf, sizeof(Pel) * plane.width );
+      }
+      if( r1 == plane.srcHeight )
+      {
+        memcpy( plane.tmpBuf + ( plane.srcHeight - 1 + k ) * plane.stride, plane.tmpBuf + ( plane.srcHeight - 1 ) * plane.stride, sizeof(Pel) * plane.width );
+      }
+    }
+    r = r1;
+  }
+
+  Int* filter = plane.numTaps == NTAPS_US_LUMA ? m_lumaFilter[0] : m_chromaFilter[0];
+
+  for( Int y = y0; y < y1; y++ )
+  {
+    xFilterVer( plane.tmpBuf + plane.verRefPos[y] * plane.stride, plane.stride, plane.dstBuf + y * plane.stride, plane.width, plane.numTaps, filter + plane.verPhase[y] * plane.numTaps, plane.offset, plane.nShift, plane.maxVal );
+  }
+}
+
+/** Horizontal pass of the resampling into the temporary picture
+ * \param src       reference layer samples
+ * \param dst       temporary picture, one column per output column
+ * \param numTaps   filter length
+ * \param shift     right shift of the filter output
+ * \param refPos    position of the first tap for each output column
+ * \param phase     filter phase for each output column
+ */
+Void TComUpsampleFilter::xFilterHor( Pel* src, Int srcStride, Pel* dst, Int dstStride, Int width, Int height, Int numTaps, Int shift, const Int* refPos, const Int* phase )
+{
+  const Int* filter = numTaps == NTAPS_US_LUMA ? m_lumaFilter[0] : m_chromaFilter[0];
+
+#if SIMD_X86
+  if( getSimdLevel() >= SIMD_SSE41 )
+  {
+    ( numTaps == NTAPS_US_LUMA ? xFilterHorSIMD<NTAPS_US_LUMA> : xFilterHorSIMD<NTAPS_US_CHROMA> )( src, srcStride, dst, dstStride, width, height, refPos, phase, filter, shift, getSimdLevel() >= SIMD_AVX2 );
+    return;
+  }
+#endif
+
+  for( Int i = 0; i < width; i++ )
+  {
+    Pel* piSrc = src + refPos[i];
+    Pel* piDst = dst + i;
+    Int* coeff = numTaps == NTAPS_US_LUMA ? m_lumaFilter[phase[i]] : m_chromaFilter[phase[i]];
+
+    for( Int j = 0; j < height; j++ )
+    {
+      *piDst = ( numTaps == NTAPS_US_LUMA ? sumLumaHor( piSrc, coeff ) : sumChromaHor( piSrc, coeff ) ) >> shift;
+      piSrc += srcStride;
+      piDst += dstStride;
+    }
+  }
+}
+
+/** Vertical pass of the resampling for one output row
+ * \param src       first tap row in the temporary picture
+ * \param dst       output row
+ * \param coeff     filter taps of the row
+ * \param maxVal    maximum sample value of the output
+ */
+Void TComUpsampleFilter::xFilterVer( Pel* src, Int srcStride, Pel* dst, Int width, Int numTaps, Int* coeff, Int offset, Int shift, Int maxVal )
+{
+#if SIMD_X86
+  if( getSimdLevel() >= SIMD_AVX2 )
+  {
+    ( numTaps == NTAPS_US_LUMA ? xFilterVerAVX2<NTAPS_US_LUMA> : xFilterVerAVX2<NTAPS_US_CHROMA> )( src, srcStride, dst, width, coeff, offset, shift, maxVal );
+    return;
+  }
+  if( getSimdLevel() >= SIMD_SSE41 )
+  {
+    ( numTaps == NTAPS_US_LUMA ? xFilterVerSSE41<NTAPS_US_LUMA> : xFilterVerSSE41<NTAPS_US_CHROMA> )( src, srcStride, dst, width, coeff, offset, shift, maxVal );
+    return;
+  }
+#endif
+
+  for( Int i = 0; i < width; i++ )
+  {
+    Int sum = numTaps == NTAPS_US_LUMA ? sumLumaVer( src, coeff, srcStride ) : sumChromaVer( src, coeff, srcStride );
+    *dst = Clip3( 0, maxVal, ( sum + offset ) >> shift );
+    src++;
+    dst++;
+  }
+}
+
 #endif //SVC_EXTENSION
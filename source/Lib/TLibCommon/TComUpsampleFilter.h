@@ -4,11 +4,38 @@
 #include "TComPic.h"
 #include "TComYuv.h"
 #include "TComDataCU.h"
+#include <vector>
+#if ILR_ON_DEMAND_UPSAMPLING
+#include <mutex>
+#endif
 
 #define NTAPS_US_LUMA        8 ///< Number of taps for luma upsampling filter
 #define NTAPS_US_CHROMA      4 ///< Number of taps for chroma upsampling filter
 #define US_FILTER_PREC       6 ///< Log2 of sum of filter taps
 
+/// resampling of one colour component, with the filter positions and phases of each output column and row
+struct TComUpsamplePlane
+{
+  Pel*              srcBuf;     ///< reference layer samples
+  Int               srcStride;
+  Int               srcHeight;  ///< number of filtered reference layer rows, the rows beyond repeat the first and the last row
+  Pel*              tmpBuf;     ///< horizontally resampled rows
+  Pel*              dstBuf;     ///< upsampled samples
+  Int               stride;     ///< stride of the temporary and the upsampled buffers
+  Int               width;
+  Int               height;
+  Int               numTaps;
+  Int               shift1;     ///< right shift of the horizontal filter output
+  Int               nShift;     ///< right shift of the vertical filter output
+  Int               offset;     ///< rounding offset of the vertical filter output
+  Int               maxVal;     ///< maximum upsampled sample value
+  std::vector<Int>  horRefPos;  ///< first tap of the horizontal filter for each output column
+  std::vector<Int>  horPhase;   ///< phase of the horizontal filter for each output column
+  std::vector<Int>  verRefPos;  ///< first tap row of the vertical filter for each output row
+  std::vector<Int>  verPhase;   ///< phase of the vertical filter for each output row
+  std::vector<Bool> tmpRowDone; ///< reference layer rows that are horizontally resampled
+};
+
 class TComUpsampleFilter
 {
 private:
@@ -18,6 +45,16 @@ private:
   Int m_lumaFilter[16][NTAPS_US_LUMA];
   Int m_chromaFilter[16][NTAPS_US_CHROMA];
 
+  TComUpsamplePlane m_acPlane[MAX_LAYERS][3];               ///< resampling of the colour components for each reference layer
+#if ILR_ON_DEMAND_UPSAMPLING
+  Bool              m_bDeferred;                             ///< upsampleBasePic() only derives the resampling, the rows are resampled by upsampleRows()
+  Int               m_iBandHeight;                           ///< luma rows resampled together on demand
+  TComPicYuv*       m_apcDeferredPic[MAX_LAYERS];            ///< upsampled picture with pending rows for each reference layer
+  std::vector<Bool> m_abBandDone[MAX_LAYERS];                ///< bands of the upsampled picture that are resampled
+  Int               m_aiNumBandsLeft[MAX_LAYERS];            ///< number of bands of the upsampled picture that are pending
+  std::mutex        m_acDeferredMutex[MAX_LAYERS];           ///< serialises the resampling of the rows of each upsampled picture
+#endif
+
   static inline Int sumLumaHor( Pel* pel, Int* coeff )
   {
     return ( pel[0]*coeff[0] + pel[1]*coeff[1] + pel[2]*coeff[2] + pel[3]*coeff[3] + pel[4]*coeff[4] + pel[5]*coeff[5] + pel[6]*coeff[6] + pel[7]*coeff[7]);
@@ -38,6 +75,10 @@ private:
     return ( pel[0]*coeff[0] + pel[stride]*coeff[1] + pel[2*stride]*coeff[2] + pel[3*stride]*coeff[3] );
   }
 
+  Void xFilterHor( Pel* src, Int srcStride, Pel* dst, Int dstStride, Int width, Int height, Int numTaps, Int shift, const Int* refPos, const Int* phase );
+  Void xFilterVer( Pel* src, Int srcStride, Pel* dst, Int width, Int numTaps, Int* coeff, Int offset, Int shift, Int maxVal );
+  Void xUpsampleRows( TComUpsamplePlane& plane, Int y0, Int y1 );
+
 public:
   TComUpsampleFilter(void);
   ~TComUpsampleFilter(void);
@@ -60,6 +101,13 @@ public:
 #endif
 #endif
 
+#if ILR_ON_DEMAND_UPSAMPLING
+  Void setDeferred( Bool b ) { m_bDeferred = b; }
+  Void upsampleRows( UInt refLayerIdc, Int iTop, Int iBottom );
+#if DEC_PICTURE_PIPELINE
+  Int  getNumSourceRows( UInt refLayerIdc, Int iBottom );
+#endif
+#endif
 };
 
 #endif //__TCOMUPSAMPLEFILTER__
@@ -117,7 +117,7 @@
 #endif
 #define Q0048_CGS_3D_ASYMLUT             1      ///< JCTVC-Q0048: Colour gamut scalability with look-up table
 #if Q0048_CGS_3D_ASYMLUT
-#define CGS_GCC_NO_VECTORIZATION         1
+#define CGS_GCC_NO_VECTORIZATION         0      ///< disable the auto-vectorisation of the CGS downsampling filter, only needed for compilers miscompiling it
 #define R0150_CGS_SIGNAL_CONSTRAINTS     1      ///< JCTVC-R0150: CGS signaling improvement and constraints
 #define R0151_CGS_3D_ASYMLUT_IMPROVE     1      ///< JCTVC-R0151: Non-uniform chroma partitioning and improved LUT coefficient coding
 #define R0164_CGS_LUT_BUGFIX             1      ///< JCTVC-R0164: Bug fix with LUT syntax
@@ -305,6 +305,19 @@ enum ScalabilityType
 #define JCTVC_M0259_LAMBDAREFINEMENT     1      ///< JCTVC-M0259: lambda refinement (encoder only optimization)
 #define ENCODER_FAST_MODE                1      ///< JCTVC-L0174: enable encoder fast mode. TestMethod 1 is enabled by setting to 1 and TestMethod 2 is enable by setting to 2. By default it is set to 1.
 #define LAYER_CTB                        0      ///< enable layer-specific CTB structure
+#define ILR_ON_DEMAND_UPSAMPLING         1      ///< resample the inter-layer reference picture by CTU rows when motion compensation first references them (decoder only)
+
+/// parallel processing ------------------
+#define ENC_LAYER_PIPELINE               1      ///< concurrent encoding of the layers of consecutive access units (encoder only)
+#define TOOL_THREAD_POOL                 1      ///< worker threads shared by the parallel coding tools, their number is set with the Threads option
+#if TOOL_THREAD_POOL
+#define ENC_WPP_PARALLEL                 1      ///< wavefront-parallel encoding of the CTU rows of a picture coded with WaveFrontSynchro (encoder only)
+#define DEC_TILE_WPP_PARALLEL            1      ///< concurrent decoding of the tiles or of the WPP CTU rows of a slice (decoder only)
+#define DEC_PICTURE_PIPELINE             1      ///< the pictures of each layer are decoded and filtered in a thread of the layer, gated on the CTU-row progress of the reference layers (decoder only)
+#define LOOP_FILTER_PARALLEL             1      ///< the edges of each direction of the deblocking filter are filtered by bands of CTUs in the worker threads
+#define SAO_STAT_PARALLEL                1      ///< the SAO statistics of the CTU rows of a picture are collected in the worker threads (encoder only)
+#endif
+#define DEC_CTU_ROW_FILTER               1      ///< deblocking and SAO of a CTU row as soon as the rows below it are reconstructed (decoder only)
 
 /// SEI messages -------------------------
 #define P0050_KNEE_FUNCTION_SEI          1      ///< JCTVC-P0050: Knee function SEI
@@ -320,6 +333,21 @@ enum ScalabilityType
 
 #endif // SVC_EXTENSION
 #define Q0074_COLOUR_REMAPPING_SEI       1      ///< JCTVC-Q0074, JCTVC-R0344: SEI Colour Remapping Information
+#define SIMD_KERNELS                     1      ///< vectorised kernels selected at run time from the instruction sets of the CPU (x86 SSE4.1/AVX2), the C code is the reference
+#define INV_TRANSFORM_ZERO_SKIP          1      ///< the inverse transform skips the all-zero rows and columns of the coefficients, DC-only blocks are filled with a constant
+#define FAST_RDOQ                        0      ///< RDOQFast: RDOQ with the rates of the context states at the start of the slice, coefficient groups in the dead zone of the quantiser are skipped (off: below the targeted quantisation speedup)
+#define DEC_CABAC_64BIT_WINDOW           1      ///< CABAC decoder with a 64-bit window refilled 4 bytes at a time, branch-reduced bin decoding and bypass bins decoded in bulk
+#define ANNEXB_MAPPED_INPUT              1      ///< the decoder memory-maps the bitstream file, NAL units and emulation prevention bytes are found with memchr() instead of byte by byte
+#define FAST_YUV_IO                      1      ///< YUV frames are read and written with one file access, the samples are converted and scaled in one vectorised pass, InputReadAhead: frames read in a background thread
+#define FAST_CU_SHVC                     1      ///< FCS: EL depth search limited around the depths of the co-located BL CUs, EL CUs of skipped BL blocks try ILR first and skip AMP and intra (encoder only)
+#define IL_MOTION_SEED                   1      ///< ILMotionSeed: EL motion estimation also starts from the BL motion mapped to the inter-layer reference (REF_IDX_MFM), the search range is reduced when it agrees with the predictor
+#define LOOKAHEAD_ME                     1      ///< LookaheadME: hierarchical motion estimation on half and quarter resolution copies of the source pictures gives start points of the motion search for each 8x8 block (encoder only)
+#define PARALLEL_ME                      1      ///< METhreads: the uni-directional motion searches of the reference pictures of a PU run concurrently in private copies of the search (encoder only)
+#define FAST_INTRA_SEARCH                1      ///< FastIntraSearch: Hadamard pre-selection of the intra modes on every 4th angular mode and the gradient directions of the PU, refined around the best candidates (encoder only)
+#if FAST_INTRA_SEARCH
+#define FAST_INTRA_GRAD_MODES            2      ///< number of gradient directions added to the coarse intra modes
+#define FAST_INTRA_REFINE_MODES          2      ///< number of best angular candidates refined by the fine intra search
+#endif
 
 
 //! \ingroup TLibCommon
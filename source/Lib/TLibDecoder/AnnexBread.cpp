@@ -41,12 +41,142 @@
 #include <cassert>
 #include <vector>
 #include "AnnexBread.h"
+#if ANNEXB_MAPPED_INPUT
+#include <cstring>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#endif
 
 using namespace std;
 
 //! \ingroup TLibDecoder
 //! \{
 
+#if ANNEXB_MAPPED_INPUT
+MappedFileBuffer::MappedFileBuffer(const char* fileName)
+: m_bOpen(false)
+, m_pMapped(NULL)
+, m_size(0)
+{
+#ifndef _WIN32
+  Int fd = open(fileName, O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+      void* pMapped = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (pMapped != MAP_FAILED)
+      {
+        m_pMapped = (char*)pMapped;
+        m_size    = (size_t)fileStat.st_size;
+        m_bOpen   = true;
+#ifdef POSIX_MADV_SEQUENTIAL
+        posix_madvise(pMapped, m_size, POSIX_MADV_SEQUENTIAL);
+#endif
+      }
+    }
+    close(fd);
+  }
+#endif
+  if (!m_bOpen)
+  {
+    // no mapping: read the whole file instead
+    ifstream file(fileName, ifstream::in | ifstream::binary | ifstream::ate);
+    if (file)
+    {
+      m_size = (size_t)file.tellg();
+      m_fallback.resize(m_size + 1);
+      file.seekg(0);
+      m_bOpen = !!file.read(&m_fallback[0], m_size);
+    }
+  }
+  char* pData = m_pMapped ? m_pMapped : (m_fallback.empty() ? NULL : &m_fallback[0]);
+  setg(pData, pData, pData + m_size);
+}
+
+MappedFileBuffer::~MappedFileBuffer()
+{
+#ifndef _WIN32
+  if (m_pMapped)
+  {
+    munmap(m_pMapped, m_size);
+  }
+#endif
+}
+
+std::streambuf::pos_type MappedFileBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+  off_type pos = off;
+  if (dir == std::ios_base::cur)
+  {
+    pos += gptr() - eback();
+  }
+  else if (dir == std::ios_base::end)
+  {
+    pos += egptr() - eback();
+  }
+  return seekpos(pos_type(pos), which);
+}
+
+std::streambuf::pos_type MappedFileBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+  if (!(which & std::ios_base::in) || off_type(pos) < 0 || off_type(pos) > egptr() - eback())
+  {
+    return pos_type(off_type(-1));
+  }
+  setg(eback(), eback() + off_type(pos), egptr());
+  return pos;
+}
+
+/**
+ * Reads the payload of a NAL unit as the byte-by-byte loop of
+ * _byteStreamNALUnit() does: up to the next byte-aligned 0x000000,
+ * 0x000001 or 0x000002, or to the end of the file.  The bytes are
+ * scanned in the buffer of the mapped file with memchr() and appended
+ * to nalUnit with one copy.
+ */
+Void InputByteStream::readMappedPayload(vector<uint8_t>& nalUnit)
+{
+  // the peeked bytes are still in the buffer: step back over them
+  m_pMapped->skipBytes(-Int(m_NumFutureBytes));
+  reset();
+
+  const uint8_t* pucStart = m_pMapped->getReadPointer();
+  const uint8_t* pucEnd   = m_pMapped->getEndPointer();
+  const uint8_t* pucNalEnd = pucEnd;
+  for (const uint8_t* p = pucStart; pucEnd - p >= 3; p++)
+  {
+    p = (const uint8_t*)memchr(p, 0, pucEnd - p - 2);
+    if (p == NULL)
+    {
+      break;
+    }
+    if (p[1] == 0 && p[2] <= 2)
+    {
+      pucNalEnd = p;
+      break;
+    }
+  }
+  // the payload is copied with one bulk insert rather than referenced in the mapping: the emulation prevention bytes
+  // are removed by rewriting the RBSP in place, while the file is mapped read-only
+  nalUnit.insert(nalUnit.end(), pucStart, pucNalEnd);
+  m_pMapped->skipBytes(Int(pucNalEnd - pucStart));
+
+  if (pucNalEnd == pucEnd)
+  {
+    // the NAL unit ends with the file: fail as the byte-by-byte loop does
+    readByte();
+  }
+}
+#endif
+
+
 /**
  * Parse an AVC AnnexB Bytestream bs to extract a single nalUnit
  * while accumulating bytestream statistics into stats.
@@ -116,6 +246,13 @@ _byteStreamNALUnit(
    * decoded using the NAL unit decoding process
    */
   /* NB, (unsigned)x > 2 implies n!=0 && n!=1 */
+#if ANNEXB_MAPPED_INPUT
+  if (bs.isMapped())
+  {
+    bs.readMappedPayload(nalUnit);
+  }
+  else
+#endif
   while (bs.eofBeforeNBytes(24/8) || bs.peekBytes(24/8) > 2) 
   {
     nalUnit.push_back(bs.readByte());
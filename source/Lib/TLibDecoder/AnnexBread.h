@@ -47,6 +47,41 @@
 //! \ingroup TLibDecoder
 //! \{
 
+#if ANNEXB_MAPPED_INPUT
+/**
+ * Stream buffer holding a whole bitstream file, memory-mapped where the
+ * platform allows it.  An istream over it behaves as an ifstream of the
+ * file (tellg/seekg/eof), and an InputByteStream reading from it scans
+ * the NAL unit payloads directly in the buffer.
+ */
+class MappedFileBuffer : public std::streambuf
+{
+public:
+  MappedFileBuffer(const char* fileName);
+  ~MappedFileBuffer();
+
+  /** returns true if the file could be opened */
+  Bool isOpen() const { return m_bOpen; }
+
+  /** returns the bytes from the current position to the end of the file */
+  const uint8_t* getReadPointer() const { return (const uint8_t*)gptr(); }
+  const uint8_t* getEndPointer () const { return (const uint8_t*)egptr(); }
+
+  /** moves the current position by n bytes, n may be negative */
+  Void skipBytes(Int n) { gbump(n); }
+
+protected:
+  pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which);
+  pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+
+private:
+  Bool              m_bOpen;
+  char*             m_pMapped;   ///< start of the mapping, NULL when the file is read into m_fallback
+  size_t            m_size;
+  std::vector<char> m_fallback;  ///< copy of the file where it can not be mapped
+};
+
+#endif
 class InputByteStream
 {
 public:
@@ -65,6 +100,9 @@ public:
   , m_Input(istream)
   {
     istream.exceptions(std::istream::eofbit | std::istream::badbit);
+#if ANNEXB_MAPPED_INPUT
+    m_pMapped = dynamic_cast<MappedFileBuffer*>(istream.rdbuf());
+#endif
   }
 
   /**
@@ -153,10 +191,23 @@ public:
     return val;
   }
 
+#if ANNEXB_MAPPED_INPUT
+  /**
+   * returns true if the input is a MappedFileBuffer, the NAL unit payloads
+   * are then read by readMappedPayload()
+   */
+  Bool isMapped() const { return m_pMapped != NULL; }
+
+  Void readMappedPayload(std::vector<uint8_t>& nalUnit);
+
+#endif
 private:
   UInt m_NumFutureBytes; /* number of valid bytes in m_FutureBytes */
   uint32_t m_FutureBytes; /* bytes that have been peeked */
   std::istream& m_Input; /* Input stream to read from */
+#if ANNEXB_MAPPED_INPUT
+  MappedFileBuffer* m_pMapped; /* buffer of m_Input if it is a mapped file */
+#endif
 };
 
 /**
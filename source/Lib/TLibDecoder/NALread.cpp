@@ -40,6 +40,7 @@
 #include <vector>
 #include <algorithm>
 #include <ostream>
+#include <cstring>
 
 #include "NALread.h"
 #include "TLibCommon/NAL.h"
@@ -51,11 +52,49 @@ using namespace std;
 //! \{
 static void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream *bitstream, Bool isVclNalUnit)
 {
-  UInt zeroCount = 0;
-  vector<uint8_t>::iterator it_read, it_write;
+  vector<uint8_t>::iterator it_write;
 
-  UInt pos = 0;
   bitstream->clearEmulationPreventionByteLocation();
+#if ANNEXB_MAPPED_INPUT
+  // the emulation prevention bytes are found with memchr(), the bytes between them are moved in blocks
+  // and no byte is moved before the first one
+  uint8_t* pucBase  = &nalUnitBuf[0];
+  uint8_t* pucEnd   = pucBase + nalUnitBuf.size();
+  uint8_t* pucRead  = pucBase;
+  uint8_t* pucWrite = pucBase;
+  while (pucRead < pucEnd)
+  {
+    uint8_t* pucEpb = pucEnd;
+    for (uint8_t* p = pucRead; pucEnd - p >= 3; p++)
+    {
+      p = (uint8_t*)memchr(p, 0, pucEnd - p - 2);
+      if (p == NULL)
+      {
+        break;
+      }
+      if (p[1] == 0 && p[2] == 0x03)
+      {
+        pucEpb = p + 2;
+        break;
+      }
+    }
+    if (pucWrite != pucRead)
+    {
+      memmove(pucWrite, pucRead, pucEpb - pucRead);
+    }
+    pucWrite += pucEpb - pucRead;
+    if (pucEpb == pucEnd)
+    {
+      break;
+    }
+    bitstream->pushEmulationPreventionByteLocation( UInt(pucEpb - pucBase) );
+    pucRead = pucEpb + 1;
+  }
+  it_write = nalUnitBuf.begin() + (pucWrite - pucBase);
+#else
+  UInt zeroCount = 0;
+  vector<uint8_t>::iterator it_read;
+  UInt pos = 0;
   for (it_read = it_write = nalUnitBuf.begin(); it_read != nalUnitBuf.end(); it_read++, it_write++, pos++)
   {
     assert(zeroCount < 2 || *it_read >= 0x03);
@@ -75,6 +114,7 @@ static void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, TComInputBitstream
     *it_write = *it_read;
   }
   assert(zeroCount == 0);
+#endif
   
   if (isVclNalUnit)
   {
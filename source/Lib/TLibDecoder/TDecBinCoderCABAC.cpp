@@ -66,9 +66,15 @@ TDecBinCABAC::start()
 {
   assert( m_pcTComBitstream->getNumBitsUntilByteAligned() == 0 );
   m_uiRange    = 510;
+#if DEC_CABAC_64BIT_WINDOW
+  m_bitsNeeded = -32;
+  m_uiValue    = (UInt64)m_pcTComBitstream->readBytes( 2 ) << 32;
+  m_uiValue   |= m_pcTComBitstream->readBytes( 4 );
+#else
   m_bitsNeeded = -8;
   m_uiValue    = (m_pcTComBitstream->readByte() << 8);
   m_uiValue   |= m_pcTComBitstream->readByte();
+#endif
 }
 
 Void
@@ -76,9 +82,18 @@ TDecBinCABAC::finish()
 {
   UInt lastByte;
 
+#if DEC_CABAC_64BIT_WINDOW
+  // give back the bytes read ahead, the bitstream is then where the byte-wise engine would have left it
+  const Int bytesReadAhead = xGetBytesReadAhead();
+  m_pcTComBitstream->rewindBytes( bytesReadAhead );
+  m_pcTComBitstream->peekPreviousByte( lastByte );
+  // Check for proper stop/alignment pattern
+  assert( ((lastByte << (m_bitsNeeded + 8 * bytesReadAhead)) & 0xff) == 0x80 );
+#else
   m_pcTComBitstream->peekPreviousByte( lastByte );
   // Check for proper stop/alignment pattern
   assert( ((lastByte << (8 + m_bitsNeeded)) & 0xff) == 0x80 );
+#endif
 }
 
 /**
@@ -99,6 +114,27 @@ TDecBinCABAC::copyState( TDecBinIf* pcTDecBinIf )
 Void
 TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
 {
+#if DEC_CABAC_64BIT_WINDOW
+  UInt uiLPS = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) & 3 ];
+  m_uiRange -= uiLPS;
+  const UInt64 scaledRange = (UInt64)m_uiRange << VALUE_SHIFT;
+
+  // all ones on the LPS path: the MPS and LPS paths only differ in the masked operations
+  const UInt64 lpsMask = (UInt64)0 - (UInt64)( m_uiValue >= scaledRange );
+  m_uiValue -= scaledRange & lpsMask;
+  m_uiRange ^= ( m_uiRange ^ uiLPS ) & (UInt)lpsMask;
+  ruiBin     = rcCtxModel.getMps() ^ ( (UInt)lpsMask & 1 );
+  rcCtxModel.update( ruiBin );
+
+  const Int numBits = TComCABACTables::sm_aucRenormTableRange[ m_uiRange >> 3 ];
+  m_uiValue   <<= numBits;
+  m_uiRange   <<= numBits;
+  m_bitsNeeded += numBits;
+  if ( m_bitsNeeded >= 0 )
+  {
+    xRefill();
+  }
+#else
   UInt uiLPS = TComCABACTables::sm_aucLPSTable[ rcCtxModel.getState() ][ ( m_uiRange >> 6 ) - 4 ];
   m_uiRange -= uiLPS;
   UInt scaledRange = m_uiRange << 7;
@@ -140,11 +176,28 @@ TDecBinCABAC::decodeBin( UInt& ruiBin, ContextModel &rcCtxModel )
       m_bitsNeeded -= 8;
     }
   }
+#endif
 }
 
 Void
 TDecBinCABAC::decodeBinEP( UInt& ruiBin )
 {
+#if DEC_CABAC_64BIT_WINDOW
+  m_uiValue += m_uiValue;
+
+  if ( ++m_bitsNeeded >= 0 )
+  {
+    xRefill();
+  }
+
+  ruiBin = 0;
+  const UInt64 scaledRange = (UInt64)m_uiRange << VALUE_SHIFT;
+  if ( m_uiValue >= scaledRange )
+  {
+    ruiBin = 1;
+    m_uiValue -= scaledRange;
+  }
+#else
   m_uiValue += m_uiValue;
   
   if ( ++m_bitsNeeded >= 0 )
@@ -160,12 +213,40 @@ TDecBinCABAC::decodeBinEP( UInt& ruiBin )
     ruiBin = 1;
     m_uiValue -= scaledRange;
   }
+#endif
 }
 
 Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
 {
   UInt bins = 0;
   
+#if DEC_CABAC_64BIT_WINDOW
+  const UInt64 scaledRange = (UInt64)m_uiRange << VALUE_SHIFT;
+  while ( numBins > 0 )
+  {
+    // top up the bits read ahead to at least 25, then up to 32 bins are decoded without a refill
+    if ( m_bitsNeeded > -25 )
+    {
+      const Int numBytes = ( m_bitsNeeded + 32 ) >> 3;
+      m_uiValue   |= (UInt64)m_pcTComBitstream->readBytes( numBytes ) << ( m_bitsNeeded + 32 - 8 * numBytes );
+      m_bitsNeeded -= 8 * numBytes;
+    }
+    const Int numBulk = std::min( numBins, 32 );
+    for ( Int i = 0; i < numBulk; i++ )
+    {
+      m_uiValue += m_uiValue;
+      const UInt64 binMask = (UInt64)0 - (UInt64)( m_uiValue >= scaledRange );
+      bins        = ( bins << 1 ) | ( (UInt)binMask & 1 );
+      m_uiValue  -= scaledRange & binMask;
+    }
+    m_bitsNeeded += numBulk;
+    numBins      -= numBulk;
+  }
+  if ( m_bitsNeeded >= 0 )
+  {
+    xRefill();
+  }
+#else
   while ( numBins > 8 )
   {
     m_uiValue = ( m_uiValue << 8 ) + ( m_pcTComBitstream->readByte() << ( 8 + m_bitsNeeded ) );
@@ -204,6 +285,7 @@ Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
       m_uiValue -= scaledRange;
     }
   }
+#endif
   
   ruiBin = bins;
 }
@@ -211,6 +293,28 @@ Void TDecBinCABAC::decodeBinsEP( UInt& ruiBin, Int numBins )
 Void
 TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
 {
+#if DEC_CABAC_64BIT_WINDOW
+  m_uiRange -= 2;
+  const UInt64 scaledRange = (UInt64)m_uiRange << VALUE_SHIFT;
+  if( m_uiValue >= scaledRange )
+  {
+    ruiBin = 1;
+  }
+  else
+  {
+    ruiBin = 0;
+    if ( m_uiRange < 256 )
+    {
+      m_uiRange += m_uiRange;
+      m_uiValue += m_uiValue;
+
+      if ( ++m_bitsNeeded >= 0 )
+      {
+        xRefill();
+      }
+    }
+  }
+#else
   m_uiRange -= 2;
   UInt scaledRange = m_uiRange << 7;
   if( m_uiValue >= scaledRange )
@@ -232,6 +336,7 @@ TDecBinCABAC::decodeBinTrm( UInt& ruiBin )
       }
     }
   }
+#endif
 }
 
 /** Read a PCM code.
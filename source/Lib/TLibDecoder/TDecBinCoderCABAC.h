@@ -67,9 +67,26 @@ public:
   TDecBinCABAC* getTDecBinCABAC()  { return this; }
 
 private:
+#if DEC_CABAC_64BIT_WINDOW
+  /// position of the integer part of the offset in m_uiValue, the bits below it are read ahead
+  static const Int    VALUE_SHIFT = 39;
+
+  /// load 4 more bytes below the bits read ahead, called when m_bitsNeeded >= 0
+  Void  xRefill           ()
+  {
+    m_uiValue   |= (UInt64)m_pcTComBitstream->readBytes( 4 ) << m_bitsNeeded;
+    m_bitsNeeded -= 32;
+  }
+  Int   xGetBytesReadAhead() { return ( 7 - m_bitsNeeded ) >> 3; }   ///< bytes taken from the bitstream that HM's engine would not have read yet
+
+#endif
   TComInputBitstream* m_pcTComBitstream;
   UInt                m_uiRange;
+#if DEC_CABAC_64BIT_WINDOW
+  UInt64              m_uiValue;
+#else
   UInt                m_uiValue;
+#endif
   Int                 m_bitsNeeded;
 };
 
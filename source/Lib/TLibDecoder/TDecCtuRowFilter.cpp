@@ -0,0 +1,227 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecCtuRowFilter.cpp
+    \brief    in-loop filtering of the CTU rows of a picture during its decoding
+*/
+
+#include "TDecCtuRowFilter.h"
+
+#if DEC_CTU_ROW_FILTER
+
+//! \ingroup TLibDecoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / initialization
+// ====================================================================================================================
+
+TDecCtuRowFilter::TDecCtuRowFilter()
+: m_pcLoopFilter       ( NULL )
+, m_pcSAO              ( NULL )
+#if LOOP_FILTER_PARALLEL
+, m_pcThreadPool       ( NULL )
+#endif
+, m_pcPic              ( NULL )
+, m_uiNumDecodedRows   ( 0 )
+, m_uiNumDeblockedRows ( 0 )
+, m_uiNumSavedRows     ( 0 )
+, m_uiNumSAORows       ( 0 )
+#if DEC_PICTURE_PIPELINE
+, m_uiNumFinalRows     ( 0 )
+#endif
+, m_bBusy              ( false )
+{
+}
+
+TDecCtuRowFilter::~TDecCtuRowFilter()
+{
+}
+
+Void TDecCtuRowFilter::init( TComLoopFilter* pcLoopFilter, TComSampleAdaptiveOffset* pcSAO )
+{
+  m_pcLoopFilter = pcLoopFilter;
+  m_pcSAO        = pcSAO;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** reset the row progress at the start of the decoding of a picture
+ * \param pcPic picture to be decoded
+ * \returns Void
+ */
+Void TDecCtuRowFilter::startPicture( TComPic* pcPic )
+{
+  std::lock_guard<std::mutex> cLock( m_mutex );
+
+  m_pcPic = pcPic;
+  m_auiNumDecodedCUs.assign( pcPic->getFrameHeightInCU(), 0 );
+  m_uiNumDecodedRows   = 0;
+  m_uiNumDeblockedRows = 0;
+  m_uiNumSavedRows     = 0;
+  m_uiNumSAORows       = 0;
+#if DEC_PICTURE_PIPELINE
+  m_uiNumFinalRows     = 0;
+#endif
+
+  m_pcLoopFilter->setCfg( pcPic->getSlice(0)->getPPS()->getLoopFilterAcrossTilesEnabledFlag() );
+}
+
+/** count a decoded CTU and filter the rows it completes
+ * \param uiCUAddr raster address of the decoded CTU
+ * \returns Void
+ *
+ * A thread completing a row while another one filters only counts it, the filtering thread takes it over.
+ */
+Void TDecCtuRowFilter::ctuDecoded( UInt uiCUAddr )
+{
+  const UInt uiWidthInCU = m_pcPic->getFrameWidthInCU();
+  UInt uiNumDecodedRows;
+  {
+    std::lock_guard<std::mutex> cLock( m_mutex );
+
+    m_auiNumDecodedCUs[uiCUAddr / uiWidthInCU]++;
+    if( m_bBusy )
+    {
+      return;
+    }
+    m_bBusy = true;
+  }
+
+  for( ;; )
+  {
+    {
+      std::lock_guard<std::mutex> cLock( m_mutex );
+
+      while( m_uiNumDecodedRows < m_auiNumDecodedCUs.size() && m_auiNumDecodedCUs[m_uiNumDecodedRows] == uiWidthInCU )
+      {
+        m_uiNumDecodedRows++;
+      }
+      if( m_uiNumDeblockedRows + 1 >= m_uiNumDecodedRows )
+      {
+        m_bBusy = false;
+        return;
+      }
+      uiNumDecodedRows = m_uiNumDecodedRows;
+    }
+
+    xFilterRows( uiNumDecodedRows, false );
+  }
+}
+
+/** filter the CTU rows which are left once the picture is decoded
+ * \param pcPic decoded picture
+ * \returns Void
+ */
+Void TDecCtuRowFilter::finishPicture( TComPic* pcPic )
+{
+  if( pcPic != m_pcPic )
+  {
+    startPicture( pcPic );
+  }
+
+  std::lock_guard<std::mutex> cLock( m_mutex );
+  xFilterRows( pcPic->getFrameHeightInCU(), true );
+  m_pcPic = NULL;
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+/** filter the CTU rows made ready by the decoded rows
+ * \param uiNumDecodedRows number of leading CTU rows which are completely decoded
+ * \param bPicDone         the picture is decoded, all rows are filtered
+ * \returns Void
+ *
+ * The intra prediction of a row uses the unfiltered bottom samples of the row above, the rows are deblocked
+ * one row behind the decoding. The deblocking of a row is final once the row below is deblocked, and SAO of
+ * a row reads the deblocked samples of the rows above and below it.
+ */
+Void TDecCtuRowFilter::xFilterRows( UInt uiNumDecodedRows, Bool bPicDone )
+{
+  const UInt uiNumRows = m_pcPic->getFrameHeightInCU();
+  const Bool bSAO      = m_pcPic->getSlice(0)->getSPS()->getUseSAO();
+
+  const UInt uiNumDeblockRows = bPicDone ? uiNumRows : uiNumDecodedRows - 1;
+  while( m_uiNumDeblockedRows < uiNumDeblockRows )
+  {
+#if LOOP_FILTER_PARALLEL
+    m_pcLoopFilter->loopFilterCtuRow( m_pcPic, m_uiNumDeblockedRows++, m_pcThreadPool );
+#else
+    m_pcLoopFilter->loopFilterCtuRow( m_pcPic, m_uiNumDeblockedRows++ );
+#endif
+  }
+
+  if( bSAO )
+  {
+    const UInt uiNumSaveRows = bPicDone ? uiNumRows : m_uiNumDeblockedRows - 1;
+    while( m_uiNumSavedRows < uiNumSaveRows )
+    {
+      m_pcSAO->saveDeblockedCtuRow( m_pcPic, m_uiNumSavedRows++ );
+    }
+
+    const UInt uiNumSAORows = bPicDone ? uiNumRows : ( m_uiNumSavedRows > 0 ? m_uiNumSavedRows - 1 : 0 );
+    while( m_uiNumSAORows < uiNumSAORows )
+    {
+      m_pcSAO->SAOProcessCtuRow( m_pcPic, m_uiNumSAORows );
+      m_pcSAO->PCMLFDisableProcessCtuRow( m_pcPic, m_uiNumSAORows++ );
+    }
+  }
+
+#if DEC_PICTURE_PIPELINE
+  // a deblocked row is modified by the deblocking of the row below it, an SAO filtered row is final
+  const UInt uiNumFinalRows = bPicDone ? uiNumRows : bSAO ? m_uiNumSAORows : ( m_uiNumDeblockedRows > 0 ? m_uiNumDeblockedRows - 1 : 0 );
+  if( uiNumFinalRows > m_uiNumFinalRows )
+  {
+#if ILR_ON_DEMAND_UPSAMPLING
+    // the upsampling of an enhancement layer decoded concurrently reads the border of the final rows
+    TComPicYuv* pcPicYuvRec = m_pcPic->getPicYuvRec();
+    const Int   iCUHeight   = m_pcPic->getSlice(0)->getSPS()->getMaxCUHeight();
+    pcPicYuvRec->extendPicBorderRows( m_uiNumFinalRows * iCUHeight, min<Int>( uiNumFinalRows * iCUHeight, pcPicYuvRec->getHeight() ) );
+    if( bPicDone )
+    {
+      pcPicYuvRec->setBorderExtension( true );
+    }
+#endif
+    m_uiNumFinalRows = uiNumFinalRows;
+    m_pcPic->setReconstructedRows( m_uiNumFinalRows );
+  }
+#endif
+}
+
+//! \}
+
+#endif // DEC_CTU_ROW_FILTER
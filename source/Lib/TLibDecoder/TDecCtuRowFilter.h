@@ -0,0 +1,103 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecCtuRowFilter.h
+    \brief    in-loop filtering of the CTU rows of a picture during its decoding (header)
+*/
+
+#ifndef __TDECCTUROWFILTER__
+#define __TDECCTUROWFILTER__
+
+// Include files
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComPic.h"
+#include "TLibCommon/TComLoopFilter.h"
+#include "TLibCommon/TComSampleAdaptiveOffset.h"
+#if LOOP_FILTER_PARALLEL
+#include "TLibCommon/TComThreadPool.h"
+#endif
+
+#if DEC_CTU_ROW_FILTER
+
+#include <vector>
+#include <mutex>
+
+//! \ingroup TLibDecoder
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// deblocking and SAO of the CTU rows of a picture, lagging behind the reconstruction of the rows
+class TDecCtuRowFilter
+{
+private:
+  TComLoopFilter*           m_pcLoopFilter;
+  TComSampleAdaptiveOffset* m_pcSAO;
+#if LOOP_FILTER_PARALLEL
+  TComThreadPool*           m_pcThreadPool;               ///< worker threads deblocking bands of CTU columns of a row
+#endif
+  TComPic*                  m_pcPic;                      ///< picture being decoded
+  std::vector<UInt>         m_auiNumDecodedCUs;           ///< number of decoded CTUs of each CTU row
+  UInt                      m_uiNumDecodedRows;           ///< number of leading CTU rows which are completely decoded
+  UInt                      m_uiNumDeblockedRows;         ///< number of leading CTU rows which are deblocked
+  UInt                      m_uiNumSavedRows;             ///< number of leading CTU rows copied into the SAO source picture
+  UInt                      m_uiNumSAORows;               ///< number of leading CTU rows which are completely filtered
+#if DEC_PICTURE_PIPELINE
+  UInt                      m_uiNumFinalRows;             ///< number of leading CTU rows which are final, signalled to the readers of the picture
+#endif
+  Bool                      m_bBusy;                      ///< a thread is filtering rows
+  std::mutex                m_mutex;
+
+public:
+  TDecCtuRowFilter();
+  virtual ~TDecCtuRowFilter();
+
+  Void  init              ( TComLoopFilter* pcLoopFilter, TComSampleAdaptiveOffset* pcSAO );
+#if LOOP_FILTER_PARALLEL
+  Void  setThreadPool     ( TComThreadPool* pcThreadPool ) { m_pcThreadPool = pcThreadPool; }
+#endif
+  Void  startPicture      ( TComPic* pcPic );
+  Void  ctuDecoded        ( UInt uiCUAddr );              ///< may be called concurrently for the CTUs of different substreams
+  Void  finishPicture     ( TComPic* pcPic );             ///< filter the rows left, all of them for a picture which has not been started
+
+private:
+  Void  xFilterRows       ( UInt uiNumDecodedRows, Bool bPicDone );
+};// END CLASS DEFINITION TDecCtuRowFilter
+
+//! \}
+
+#endif // DEC_CTU_ROW_FILTER
+
+#endif // __TDECCTUROWFILTER__
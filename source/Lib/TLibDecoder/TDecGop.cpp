@@ -47,6 +47,9 @@
 #endif
 
 #include <time.h>
+#if DEC_PICTURE_PIPELINE
+#include <mutex>
+#endif
 
 extern Bool g_md5_mismatch; ///< top level flag to signal when there is a decode problem
 
@@ -66,6 +69,9 @@ TDecGop::TDecGop()
   m_dDecTime = 0;
   m_pcSbacDecoders = NULL;
   m_pcBinCABACs = NULL;
+#if DEC_CTU_ROW_FILTER
+  m_pcCtuRowFilter = NULL;
+#endif
 }
 
 TDecGop::~TDecGop()
@@ -135,6 +141,14 @@ Void TDecGop::decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic)
   m_pcEntropyDecoder->setEntropyDecoder (m_pcSbacDecoder);
 
   UInt uiNumSubstreams = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() ? pcSlice->getNumEntryPointOffsets()+1 : pcSlice->getPPS()->getNumSubstreams();
+#if DEC_TILE_WPP_PARALLEL
+  // the tiles of a slice share one substream, it is split at the tile entry points when the tiles are decoded concurrently
+  Bool bTileSubstreams = !pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() && m_pcSliceDecoder->getUseSubstreamWorkers( rpcPic );
+  if( bTileSubstreams )
+  {
+    uiNumSubstreams = pcSlice->getTileLocationCount()+1;
+  }
+#endif
 
   // init each couple {EntropyDecoder, Substream}
   UInt *puiSubstreamSizes = pcSlice->getSubstreamSizes();
@@ -144,6 +158,13 @@ Void TDecGop::decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic)
   for ( UInt ui = 0 ; ui < uiNumSubstreams ; ui++ )
   {
     m_pcSbacDecoders[ui].init(&m_pcBinCABACs[ui]);
+#if DEC_TILE_WPP_PARALLEL
+    if( bTileSubstreams && ui+1 < uiNumSubstreams )
+    {
+      ppcSubstreams[ui] = pcBitstream->extractSubstream( ( pcSlice->getTileLocation(ui) - ( ui > 0 ? pcSlice->getTileLocation(ui-1) : 0 ) ) << 3 );
+    }
+    else
+#endif
     ppcSubstreams[ui] = pcBitstream->extractSubstream(ui+1 < uiNumSubstreams ? puiSubstreamSizes[ui] : pcBitstream->getNumBitsLeft());
   }
 
@@ -180,6 +201,10 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
   //-- For time output for each slice
   long iBeforeTime = clock();
 
+#if DEC_CTU_ROW_FILTER
+  // deblocking filter and SAO of the CTU rows not yet filtered during the decoding
+  m_pcCtuRowFilter->finishPicture( rpcPic );
+#else
   // deblocking filter
   Bool bLFCrossTileBoundary = pcSlice->getPPS()->getLoopFilterAcrossTilesEnabledFlag();
   m_pcLoopFilter->setCfg(bLFCrossTileBoundary);
@@ -190,10 +215,17 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
     m_pcSAO->SAOProcess(rpcPic);
     m_pcSAO->PCMLFDisableProcess(rpcPic);
   }
+#endif
   rpcPic->compressMotion(); 
   Char c = (pcSlice->isIntra() ? 'I' : pcSlice->isInterP() ? 'P' : 'B');
   if (!pcSlice->isReferenced()) c += 32;
 
+#if DEC_PICTURE_PIPELINE
+  // the pictures of the layers are filtered by concurrent threads, the output of a picture is not interleaved with the one of another picture
+  static std::mutex s_cOutputMutex;
+  std::lock_guard<std::mutex> cOutputLock( s_cOutputMutex );
+#endif
+
   //-- For time output for each slice
 #if SVC_EXTENSION
   printf("\nPOC %4d LId: %1d TId: %1d ( %c-SLICE %s, QP%3d ) ", pcSlice->getPOC(),
@@ -223,10 +255,10 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
       {
         UInt refLayerId = pcSlice->getRefPic(RefPicList(iRefList), iRefIndex)->getLayerId();
         UInt refLayerIdc = pcSlice->getReferenceLayerIdc(refLayerId);
-        assert( g_posScalingFactor[refLayerIdc][0] );
-        assert( g_posScalingFactor[refLayerIdc][1] );
+        assert( pcSlice->getPosScalingFactor(refLayerIdc, 0) );
+        assert( pcSlice->getPosScalingFactor(refLayerIdc, 1) );
 
-        printf( "%d(%d, {%1.2f, %1.2f}x)", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex), refLayerId, 65536.0/g_posScalingFactor[refLayerIdc][0], 65536.0/g_posScalingFactor[refLayerIdc][1] );
+        printf( "%d(%d, {%1.2f, %1.2f}x)", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex), refLayerId, 65536.0/pcSlice->getPosScalingFactor(refLayerIdc, 0), 65536.0/pcSlice->getPosScalingFactor(refLayerIdc, 1) );
       }
       else
       {
@@ -272,12 +304,24 @@ Void TDecGop::filterPicture(TComPic*& rpcPic)
   }
 #endif
 
+#if !DEC_PICTURE_PIPELINE
+  markDecodedPicture( rpcPic );
+#endif
+}
+
+/** mark a decoded picture as reconstructed and as needed for output
+ * \param pcPic decoded picture
+ * \returns Void
+ * With DEC_PICTURE_PIPELINE the marks are set by the decoding thread before the in-loop filtering is queued.
+ */
+Void TDecGop::markDecodedPicture( TComPic* pcPic )
+{
 #if SETTING_PIC_OUTPUT_MARK
-  rpcPic->setOutputMark(rpcPic->getSlice(0)->getPicOutputFlag() ? true : false);
+  pcPic->setOutputMark(pcPic->getSlice(0)->getPicOutputFlag() ? true : false);
 #else
-  rpcPic->setOutputMark(true);
+  pcPic->setOutputMark(true);
 #endif
-  rpcPic->setReconMark(true);
+  pcPic->setReconMark(true);
 }
 
 /**
@@ -52,6 +52,9 @@
 
 #include "TDecEntropy.h"
 #include "TDecSlice.h"
+#if DEC_CTU_ROW_FILTER
+#include "TDecCtuRowFilter.h"
+#endif
 #include "TDecBinCoder.h"
 #include "TDecBinCoderCABAC.h"
 
@@ -79,6 +82,9 @@ private:
   TComLoopFilter*       m_pcLoopFilter;
   
   TComSampleAdaptiveOffset*     m_pcSAO;
+#if DEC_CTU_ROW_FILTER
+  TDecCtuRowFilter*     m_pcCtuRowFilter;
+#endif
   Double                m_dDecTime;
   Int                   m_decodedPictureHashSEIEnabled;  ///< Checksum(3)/CRC(2)/MD5(1)/disable(0) acting on decoded picture hash SEI message
 #if Q0074_COLOUR_REMAPPING_SEI
@@ -113,6 +119,10 @@ Void  init      ( TDecTop**               ppcDecTop,
   Void  destroy ();
   Void  decompressSlice(TComInputBitstream* pcBitstream, TComPic*& rpcPic );
   Void  filterPicture  (TComPic*& rpcPic );
+#if DEC_CTU_ROW_FILTER
+  Void  setCtuRowFilter( TDecCtuRowFilter* pcCtuRowFilter ) { m_pcCtuRowFilter = pcCtuRowFilter; }
+#endif
+  Void  markDecodedPicture( TComPic* pcPic );                  ///< mark a decoded picture as reconstructed and, by its output flag, as needed for output
 
   void setDecodedPictureHashSEIEnabled(Int enabled) { m_decodedPictureHashSEIEnabled = enabled; }
 #if Q0074_COLOUR_REMAPPING_SEI
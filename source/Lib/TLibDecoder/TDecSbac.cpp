@@ -315,6 +315,9 @@ Void TDecSbac::parseIPCMInfo ( TComDataCU* pcCU, UInt uiAbsPartIdx, UInt uiDepth
 
     if (uiSymbol)
     {
+#if DEC_CABAC_64BIT_WINDOW
+    m_pcTDecBinIf->finish(); // the PCM samples follow the bytes of the arithmetic code, return the bytes read ahead
+#endif
     Bool bIpcmFlag = true;
 
     pcCU->setPartSizeSubParts  ( SIZE_2Nx2N, uiAbsPartIdx, uiDepth );
@@ -40,12 +40,6 @@
 //! \ingroup TLibDecoder
 //! \{
 
-#if SVC_EXTENSION
-ParameterSetMap<TComVPS> ParameterSetManagerDecoder::m_vpsBuffer(MAX_NUM_VPS);
-ParameterSetMap<TComSPS> ParameterSetManagerDecoder::m_spsBuffer(MAX_NUM_SPS);
-ParameterSetMap<TComPPS> ParameterSetManagerDecoder::m_ppsBuffer(MAX_NUM_PPS);
-#endif
-
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -56,6 +50,16 @@ TDecSlice::TDecSlice()
   m_pcBufferBinCABACs    = NULL;
   m_pcBufferLowLatSbacDecoders = NULL;
   m_pcBufferLowLatBinCABACs    = NULL;
+#if DEC_TILE_WPP_PARALLEL
+  m_pcThreadPool         = NULL;
+  m_pcTrQuant            = NULL;
+  m_pcWppRowProgress     = NULL;
+  m_pcWppRowBinCABACs    = NULL;
+  m_pcWppRowSbacDecoders = NULL;
+#endif
+#if DEC_CTU_ROW_FILTER
+  m_pcCtuRowFilter       = NULL;
+#endif
 }
 
 TDecSlice::~TDecSlice()
@@ -103,6 +107,20 @@ Void TDecSlice::destroy()
     delete[] m_pcBufferLowLatBinCABACs;
     m_pcBufferLowLatBinCABACs = NULL;
   }
+#if DEC_TILE_WPP_PARALLEL
+  for( Int i = 0; i < m_apcSubstreamWorkers.size(); i++ )
+  {
+    delete m_apcSubstreamWorkers[i];
+  }
+  m_apcSubstreamWorkers.clear();
+  m_apcIdleSubstreamWorkers.clear();
+  delete[] m_pcWppRowProgress;
+  delete[] m_pcWppRowSbacDecoders;
+  delete[] m_pcWppRowBinCABACs;
+  m_pcWppRowProgress     = NULL;
+  m_pcWppRowSbacDecoders = NULL;
+  m_pcWppRowBinCABACs    = NULL;
+#endif
 }
 
 #if SVC_EXTENSION
@@ -143,6 +161,14 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic*& rp
   g_bJustDoIt = g_bEncDecTraceDisable;
 #endif
 
+#if DEC_TILE_WPP_PARALLEL
+  if( getUseSubstreamWorkers( rpcPic ) )
+  {
+    xDecompressSubstreams( ppcSubstreams, rpcPic, pcSbacDecoders );
+    return;
+  }
+#endif
+
   UInt uiTilesAcross   = rpcPic->getPicSym()->getNumColumnsMinus1()+1;
   TComSlice*  pcSlice = rpcPic->getSlice(rpcPic->getCurrSliceIdx());
 #if !WPP_FIX
@@ -266,8 +292,19 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic*& rp
       CTXMem[0]->loadContexts(pcSbacDecoder);
     }
   }
+#if DEC_PICTURE_PIPELINE
+  UInt uiNumGatedRows = 0;
+#endif
   for( Int iCUAddr = iStartCUAddr; !uiIsLast && iCUAddr < rpcPic->getNumCUsInFrame(); iCUAddr = rpcPic->getPicSym()->xCalculateNxtCUAddr(iCUAddr) )
   {
+#if DEC_PICTURE_PIPELINE
+    // the reference layer rows are waited for once per CTU row, the rows of the later tiles are below the ones already waited for
+    if( iCUAddr / uiWidthInLCUs >= uiNumGatedRows )
+    {
+      uiNumGatedRows = iCUAddr / uiWidthInLCUs + 1;
+      xWaitForRefLayerRows( rpcPic, uiNumGatedRows );
+    }
+#endif
     pcCU = rpcPic->getCU( iCUAddr );
     pcCU->initCU( rpcPic, iCUAddr );
     uiTileCol = rpcPic->getPicSym()->getTileIdxMap(iCUAddr) % (rpcPic->getPicSym()->getNumColumnsMinus1()+1); // what column of tiles are we in?
@@ -408,6 +445,9 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic*& rp
 
     m_pcCuDecoder->decodeCU     ( pcCU, uiIsLast );
     m_pcCuDecoder->decompressCU ( pcCU );
+#if DEC_CTU_ROW_FILTER
+    m_pcCtuRowFilter->ctuDecoded( iCUAddr );
+#endif
     
 #if ENC_DEC_TRACE
     g_bJustDoIt = g_bEncDecTraceDisable;
@@ -441,12 +481,334 @@ Void TDecSlice::decompressSlice(TComInputBitstream** ppcSubstreams, TComPic*& rp
   }
 }
 
+#if DEC_TILE_WPP_PARALLEL
+/** allocate the decoding classes of the concurrently decoded substreams for the current picture
+ * \param pcThreadPool worker threads of the decoder
+ * \param ppcDecTop    decoders of the layers
+ * \param layerId      layer of the decoder
+ * \param pcTrQuant    transform & quantization class of the layer decoder
+ * \param uiMaxTrSize  maximum transform size of the SPS
+ */
+#if SVC_EXTENSION
+Void TDecSlice::createSubstreamWorkers( TComThreadPool* pcThreadPool, TDecTop** ppcDecTop, UInt layerId, TComTrQuant* pcTrQuant, UInt uiMaxTrSize )
+#else
+Void TDecSlice::createSubstreamWorkers( TComThreadPool* pcThreadPool, TComTrQuant* pcTrQuant, UInt uiMaxTrSize )
+#endif
+{
+  m_pcThreadPool = pcThreadPool;
+  m_pcTrQuant    = pcTrQuant;
+
+  if( pcThreadPool == NULL || pcThreadPool->getNumThreads() < 2 )
+  {
+    return;
+  }
+  // one set of decoding classes per thread, at most as many substreams as threads are decoded at the same time
+  while( m_apcSubstreamWorkers.size() < pcThreadPool->getNumThreads() )
+  {
+    m_apcSubstreamWorkers.push_back( new TDecSubstreamWorker );
+  }
+  for( Int i = 0; i < m_apcSubstreamWorkers.size(); i++ )
+  {
+#if SVC_EXTENSION
+    m_apcSubstreamWorkers[i]->create( ppcDecTop, layerId, uiMaxTrSize );
+#else
+    m_apcSubstreamWorkers[i]->create( uiMaxTrSize );
+#endif
+  }
+}
+
+Void TDecSlice::destroySubstreamWorkers()
+{
+  for( Int i = 0; i < m_apcSubstreamWorkers.size(); i++ )
+  {
+    m_apcSubstreamWorkers[i]->destroy();
+  }
+}
+
+/** The substreams are decoded concurrently when the slice is the whole picture and they are either the CTU rows
+ * of a single tile (WPP) or the tiles of the picture, since no other state is carried from a substream to the next one.
+ \param  pcPic  picture class
+ \returns true if the substreams of the current slice can be decoded concurrently
+ */
+Bool TDecSlice::getUseSubstreamWorkers( TComPic* pcPic )
+{
+  TComSlice* pcSlice = pcPic->getSlice(pcPic->getCurrSliceIdx());
+
+  if( m_apcSubstreamWorkers.empty() )
+  {
+    return false;
+  }
+  if( pcSlice->getSliceCurStartCUAddr() != 0 || pcSlice->getSliceSegmentCurStartCUAddr() != 0 || pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() )
+  {
+    return false;
+  }
+  const UInt uiNumTiles = pcPic->getPicSym()->getNumTiles();
+  if( pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() )
+  {
+    return uiNumTiles == 1 && pcSlice->getNumEntryPointOffsets()+1 == pcPic->getFrameHeightInCU();
+  }
+  return uiNumTiles > 1 && pcSlice->getNumEntryPointOffsets()+1 == uiNumTiles;
+}
+
+/** Decode the substreams of the slice with the thread pool, the CTU rows two CTUs behind the row above.
+ * The result is the same as the one of the sequential CTU loop of decompressSlice().
+ \param  ppcSubstreams   substreams of the slice, one per CTU row or per tile
+ \param  pcPic           picture class
+ \param  pcSbacDecoders  SBAC decoders initialised at the start of each substream
+ */
+Void TDecSlice::xDecompressSubstreams( TComInputBitstream** ppcSubstreams, TComPic* pcPic, TDecSbac* pcSbacDecoders )
+{
+  TComSlice* pcSlice         = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  const UInt uiNumSubstreams = pcSlice->getNumEntryPointOffsets()+1;
+
+  for( Int i = 0; i < m_apcSubstreamWorkers.size(); i++ )
+  {
+    m_apcSubstreamWorkers[i]->initSlice( m_pcTrQuant );
+  }
+  m_apcIdleSubstreamWorkers = m_apcSubstreamWorkers;
+
+  if( pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() )
+  {
+    delete[] m_pcWppRowProgress;
+    delete[] m_pcWppRowSbacDecoders;
+    delete[] m_pcWppRowBinCABACs;
+    m_pcWppRowProgress     = new TComSyncCounter[uiNumSubstreams];
+    m_pcWppRowSbacDecoders = new TDecSbac       [uiNumSubstreams];
+    m_pcWppRowBinCABACs    = new TDecBinCABAC   [uiNumSubstreams];
+    for( UInt uiRow = 0; uiRow < uiNumSubstreams; uiRow++ )
+    {
+      m_pcWppRowSbacDecoders[uiRow].init( &m_pcWppRowBinCABACs[uiRow] );
+    }
+  }
+
+  // the substreams are queued in order, a CTU row only waits for rows which are already running or done
+  TComSyncCounter cDone;
+  for( UInt uiSubStrm = 0; uiSubStrm < uiNumSubstreams; uiSubStrm++ )
+  {
+#if DEC_PICTURE_PIPELINE
+    // the reference layer rows of a substream are waited for before it is queued, a job of the pool never waits for another layer
+    if( pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() )
+    {
+      xWaitForRefLayerRows( pcPic, uiSubStrm + 1 );
+    }
+    else
+    {
+      TComTile* pcTile = pcPic->getPicSym()->getTComTile( uiSubStrm );
+      xWaitForRefLayerRows( pcPic, pcTile->getFirstCUAddr() / pcPic->getFrameWidthInCU() + pcTile->getTileHeight() );
+    }
+#endif
+    m_pcThreadPool->addJob( std::bind( &TDecSlice::xDecompressSubstreamJob, this, ppcSubstreams[uiSubStrm], pcPic, uiSubStrm, &pcSbacDecoders[uiSubStrm], &cDone ) );
+  }
+  cDone.waitFor( uiNumSubstreams );
+}
+
+Void TDecSlice::xDecompressSubstreamJob( TComInputBitstream* pcSubstream, TComPic* pcPic, UInt uiSubStrm, TDecSbac* pcSbacDecoder, TComSyncCounter* pcDone )
+{
+  TDecSubstreamWorker* pcWorker;
+  {
+    std::lock_guard<std::mutex> cLock( m_cSubstreamWorkerMutex );
+    pcWorker = m_apcIdleSubstreamWorkers.back();
+    m_apcIdleSubstreamWorkers.pop_back();
+  }
+
+  // continue from the state of the substream after the initialisation of the slice
+  pcWorker->getEntropyDecoder()->setBitstream( pcSubstream );
+  pcWorker->getSbacDecoder()->load( pcSbacDecoder );
+
+  if( pcPic->getSlice(pcPic->getCurrSliceIdx())->getPPS()->getEntropyCodingSyncEnabledFlag() )
+  {
+    xDecompressCtuRow( pcPic, uiSubStrm, pcWorker );
+  }
+  else
+  {
+    xDecompressTile( pcPic, uiSubStrm, pcWorker );
+  }
+
+  {
+    std::lock_guard<std::mutex> cLock( m_cSubstreamWorkerMutex );
+    m_apcIdleSubstreamWorkers.push_back( pcWorker );
+  }
+  pcDone->increment();
+}
+
+/** Decode a CTU row of a WPP picture, it follows the CTU loop of decompressSlice() for a single tile.
+ \param  pcPic     picture class
+ \param  uiRow     CTU row, also the substream of the row
+ \param  pcWorker  decoding classes used for the row
+ */
+Void TDecSlice::xDecompressCtuRow( TComPic* pcPic, UInt uiRow, TDecSubstreamWorker* pcWorker )
+{
+  TDecSbac*  pcSbacDecoder = pcWorker->getSbacDecoder();
+  const UInt uiWidthInLCUs = pcPic->getFrameWidthInCU();
+  UInt       uiIsLast      = 0;
+  UInt       uiCol;
+
+  for( uiCol = 0; uiCol < uiWidthInLCUs && !uiIsLast; uiCol++ )
+  {
+    // the reconstruction, the motion and the contexts up to the top-right CTU are needed
+    if( uiRow > 0 )
+    {
+      m_pcWppRowProgress[uiRow-1].waitFor( min( uiCol+2, uiWidthInLCUs ) );
+    }
+
+    Int iCUAddr = uiRow * uiWidthInLCUs + uiCol;
+    TComDataCU* pcCU = pcPic->getCU( iCUAddr );
+    pcCU->initCU( pcPic, iCUAddr );
+
+    // inherit the contexts from the top-right CTU
+    if( uiCol == 0 && uiRow > 0 && uiWidthInLCUs > 1 )
+    {
+      pcSbacDecoder->loadContexts( &m_pcWppRowSbacDecoders[uiRow-1] );
+    }
+
+    xDecodeCtu( pcPic, pcCU, pcWorker, uiIsLast );
+
+    if( uiCol == uiWidthInLCUs-1 && !uiIsLast )
+    {
+      // Parse end_of_substream_one_bit for WPP case
+      UInt binVal;
+      pcSbacDecoder->parseTerminatingBit( binVal );
+      assert( binVal );
+    }
+
+    //Store probabilities of second LCU in line into buffer
+    if( uiCol == 1 )
+    {
+      m_pcWppRowSbacDecoders[uiRow].loadContexts( pcSbacDecoder );
+    }
+
+    m_pcWppRowProgress[uiRow].increment();
+  }
+
+  // a slice ending within the row does not block the rows below
+  for( ; uiCol < uiWidthInLCUs; uiCol++ )
+  {
+    m_pcWppRowProgress[uiRow].increment();
+  }
+}
+
+/** Decode a tile, it follows the CTU loop of decompressSlice() within the tile.
+ \param  pcPic      picture class
+ \param  uiTileIdx  tile, also the substream of the tile
+ \param  pcWorker   decoding classes used for the tile
+ */
+Void TDecSlice::xDecompressTile( TComPic* pcPic, UInt uiTileIdx, TDecSubstreamWorker* pcWorker )
+{
+  TComTile*  pcTile         = pcPic->getPicSym()->getTComTile( uiTileIdx );
+  const UInt uiNumCUsInTile = pcTile->getTileWidth() * pcTile->getTileHeight();
+  UInt       uiIsLast       = 0;
+  Int        iCUAddr        = pcTile->getFirstCUAddr();
+
+  for( UInt ui = 0; ui < uiNumCUsInTile && !uiIsLast; ui++, iCUAddr = pcPic->getPicSym()->xCalculateNxtCUAddr( iCUAddr ) )
+  {
+    TComDataCU* pcCU = pcPic->getCU( iCUAddr );
+    pcCU->initCU( pcPic, iCUAddr );
+
+    xDecodeCtu( pcPic, pcCU, pcWorker, uiIsLast );
+
+    if( ui == uiNumCUsInTile-1 && !uiIsLast )
+    {
+      // Parse end_of_subset_one_bit at the end of the tile
+      UInt binVal;
+      pcWorker->getSbacDecoder()->parseTerminatingBit( binVal );
+      assert( binVal );
+    }
+  }
+}
+
+/** Parse the SAO parameters and decode a CTU with the decoding classes of a substream.
+ \param  pcPic      picture class
+ \param  pcCU       CTU
+ \param  pcWorker   decoding classes of the substream
+ \param  ruiIsLast  set when the CTU is the last one of the slice segment
+ */
+Void TDecSlice::xDecodeCtu( TComPic* pcPic, TComDataCU* pcCU, TDecSubstreamWorker* pcWorker, UInt& ruiIsLast )
+{
+  TComSlice* pcSlice       = pcPic->getSlice(pcPic->getCurrSliceIdx());
+  TDecSbac*  pcSbacDecoder = pcWorker->getSbacDecoder();
+  const Int  iCUAddr       = pcCU->getAddr();
+  const UInt uiWidthInLCUs = pcPic->getFrameWidthInCU();
+
+  if ( pcSlice->getSPS()->getUseSAO() )
+  {
+    SAOBlkParam& saoblkParam = (pcPic->getPicSym()->getSAOBlkParam())[iCUAddr];
+    if (pcSlice->getSaoEnabledFlag()||pcSlice->getSaoEnabledFlagChroma())
+    {
+      Bool sliceEnabled[NUM_SAO_COMPONENTS];
+      sliceEnabled[SAO_Y] = pcSlice->getSaoEnabledFlag();
+      sliceEnabled[SAO_Cb]= sliceEnabled[SAO_Cr]= pcSlice->getSaoEnabledFlagChroma();
+
+      Bool leftMergeAvail = false;
+      Bool aboveMergeAvail= false;
+
+      //merge left condition
+      Int rx = (iCUAddr % uiWidthInLCUs);
+      if(rx > 0)
+      {
+        leftMergeAvail = pcPic->getSAOMergeAvailability(iCUAddr, iCUAddr-1);
+      }
+      //merge up condition
+      Int ry = (iCUAddr / uiWidthInLCUs);
+      if(ry > 0)
+      {
+        aboveMergeAvail = pcPic->getSAOMergeAvailability(iCUAddr, iCUAddr-uiWidthInLCUs);
+      }
+#if SVC_EXTENSION
+      pcSbacDecoder->parseSAOBlkParam( saoblkParam, m_saoMaxOffsetQVal, sliceEnabled, leftMergeAvail, aboveMergeAvail);
+#else
+      pcSbacDecoder->parseSAOBlkParam( saoblkParam, sliceEnabled, leftMergeAvail, aboveMergeAvail);
+#endif
+    }
+    else 
+    {
+      saoblkParam[SAO_Y ].modeIdc = SAO_MODE_OFF;
+      saoblkParam[SAO_Cb].modeIdc = SAO_MODE_OFF;
+      saoblkParam[SAO_Cr].modeIdc = SAO_MODE_OFF;
+    }
+  }
+
+  pcWorker->getCuDecoder()->decodeCU     ( pcCU, ruiIsLast );
+  pcWorker->getCuDecoder()->decompressCU ( pcCU );
+#if DEC_CTU_ROW_FILTER
+  m_pcCtuRowFilter->ctuDecoded( iCUAddr );
+#endif
+}
+#endif
+
+#if DEC_PICTURE_PIPELINE
+/** Wait until the reference layer rows read by the inter-layer prediction of the first uiNumRows CTU rows are reconstructed,
+ * the reference layer pictures may be decoded by the threads of their layers.
+ \param  pcPic      picture class
+ \param  uiNumRows  number of leading CTU rows of the picture
+ */
+Void TDecSlice::xWaitForRefLayerRows( TComPic* pcPic, UInt uiNumRows )
+{
+#if SVC_EXTENSION && ILR_ON_DEMAND_UPSAMPLING
+  TComSlice* pcSlice = pcPic->getSlice(pcPic->getCurrSliceIdx());
+
+  // the inter-layer motion vectors are zero, the interpolation taps below the rows reach into the next CTU row, which is resampled as a whole
+  const Int iBottom = ( uiNumRows + 1 ) * pcSlice->getSPS()->getMaxCUHeight();
+
+  for( Int iList = 0; iList < 2; iList++ )
+  {
+    for( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( RefPicList(iList) ); iRefIdx++ )
+    {
+      TComPic* pcRefPic = pcSlice->getRefPic( RefPicList(iList), iRefIdx );
+      if( pcRefPic->isILR( pcPic->getLayerId() ) )
+      {
+        pcRefPic->waitForUpsampleSource( iBottom );
+      }
+    }
+  }
+#endif
+}
+
+#endif
 ParameterSetManagerDecoder::ParameterSetManagerDecoder()
-#if !SVC_EXTENSION
-: m_vpsBuffer(MAX_NUM_VPS)
+: m_pcBufferStorage(this)
+, m_vpsBuffer(MAX_NUM_VPS)
 , m_spsBuffer(MAX_NUM_SPS)
 , m_ppsBuffer(MAX_NUM_PPS)
-#endif
 {
 }
 
@@ -455,11 +817,21 @@ ParameterSetManagerDecoder::~ParameterSetManagerDecoder()
 
 }
 
+#if SVC_EXTENSION
+/** \param pcBase parameter set manager of the base layer decoder, which stores and buffers the parameter sets of all layers
+ */
+Void ParameterSetManagerDecoder::shareParameterSets(ParameterSetManagerDecoder *pcBase)
+{
+  ParameterSetManager::shareParameterSets( pcBase );
+  m_pcBufferStorage = pcBase->m_pcBufferStorage;
+}
+#endif
+
 TComVPS* ParameterSetManagerDecoder::getPrefetchedVPS  (Int vpsId)
 {
-  if (m_vpsBuffer.getPS(vpsId) != NULL )
+  if (m_pcBufferStorage->m_vpsBuffer.getPS(vpsId) != NULL )
   {
-    return m_vpsBuffer.getPS(vpsId);
+    return m_pcBufferStorage->m_vpsBuffer.getPS(vpsId);
   }
   else
   {
@@ -470,9 +842,9 @@ TComVPS* ParameterSetManagerDecoder::getPrefetchedVPS  (Int vpsId)
 
 TComSPS* ParameterSetManagerDecoder::getPrefetchedSPS  (Int spsId)
 {
-  if (m_spsBuffer.getPS(spsId) != NULL )
+  if (m_pcBufferStorage->m_spsBuffer.getPS(spsId) != NULL )
   {
-    return m_spsBuffer.getPS(spsId);
+    return m_pcBufferStorage->m_spsBuffer.getPS(spsId);
   }
   else
   {
@@ -482,9 +854,9 @@ TComSPS* ParameterSetManagerDecoder::getPrefetchedSPS  (Int spsId)
 
 TComPPS* ParameterSetManagerDecoder::getPrefetchedPPS  (Int ppsId)
 {
-  if (m_ppsBuffer.getPS(ppsId) != NULL )
+  if (m_pcBufferStorage->m_ppsBuffer.getPS(ppsId) != NULL )
   {
-    return m_ppsBuffer.getPS(ppsId);
+    return m_pcBufferStorage->m_ppsBuffer.getPS(ppsId);
   }
   else
   {
@@ -494,9 +866,30 @@ TComPPS* ParameterSetManagerDecoder::getPrefetchedPPS  (Int ppsId)
 
 Void     ParameterSetManagerDecoder::applyPrefetchedPS()
 {
+#if SVC_EXTENSION
+  if (m_pcBufferStorage != this)
+  {
+    // the manager of the base layer stores the parameter sets of all layers
+    m_pcBufferStorage->applyPrefetchedPS();
+    return;
+  }
+#endif
   m_vpsMap.mergePSList(m_vpsBuffer);
   m_ppsMap.mergePSList(m_ppsBuffer);
   m_spsMap.mergePSList(m_spsBuffer);
 }
 
+#if DEC_PICTURE_PIPELINE
+Bool     ParameterSetManagerDecoder::hasPrefetchedPS()
+{
+#if SVC_EXTENSION
+  if (m_pcBufferStorage != this)
+  {
+    return m_pcBufferStorage->hasPrefetchedPS();
+  }
+#endif
+  return !m_vpsBuffer.empty() || !m_spsBuffer.empty() || !m_ppsBuffer.empty();
+}
+#endif
+
 //! \}
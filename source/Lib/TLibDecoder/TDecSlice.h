@@ -49,6 +49,13 @@
 #include "TDecCu.h"
 #include "TDecSbac.h"
 #include "TDecBinCoderCABAC.h"
+#if DEC_TILE_WPP_PARALLEL
+#include "TLibCommon/TComThreadPool.h"
+#include "TDecSubstreamWorker.h"
+#endif
+#if DEC_CTU_ROW_FILTER
+#include "TDecCtuRowFilter.h"
+#endif
 
 //! \ingroup TLibDecoder
 //! \{
@@ -73,6 +80,19 @@ private:
 #if SVC_EXTENSION
   UInt*           m_saoMaxOffsetQVal; 
 #endif 
+#if DEC_TILE_WPP_PARALLEL
+  TComThreadPool* m_pcThreadPool;
+  TComTrQuant*    m_pcTrQuant;                    ///< transform & quantization class of the layer, holds the quantization matrices of the slice
+  std::vector<TDecSubstreamWorker*> m_apcSubstreamWorkers;      ///< decoding classes of the concurrently decoded substreams
+  std::vector<TDecSubstreamWorker*> m_apcIdleSubstreamWorkers;  ///< decoding classes not used by a substream
+  std::mutex      m_cSubstreamWorkerMutex;        ///< protects the list of idle decoding classes
+  TComSyncCounter* m_pcWppRowProgress;            ///< number of decoded CTUs of each CTU row
+  TDecBinCABAC*   m_pcWppRowBinCABACs;
+  TDecSbac*       m_pcWppRowSbacDecoders;         ///< contexts after the second CTU of each CTU row
+#endif
+#if DEC_CTU_ROW_FILTER
+  TDecCtuRowFilter* m_pcCtuRowFilter;             ///< in-loop filter of the CTU rows, told about each decoded CTU
+#endif
   
 public:
   TDecSlice();
@@ -84,12 +104,35 @@ public:
   Void  init              ( TDecEntropy* pcEntropyDecoder, TDecCu* pcMbDecoder );
 #endif
   Void  create            ();
+#if DEC_CTU_ROW_FILTER
+  Void  setCtuRowFilter   ( TDecCtuRowFilter* pcCtuRowFilter ) { m_pcCtuRowFilter = pcCtuRowFilter; }
+#endif
   Void  destroy           ();
   
   Void  decompressSlice   ( TComInputBitstream** ppcSubstreams,   TComPic*& rpcPic, TDecSbac* pcSbacDecoder, TDecSbac* pcSbacDecoders );
   Void      initCtxMem(  UInt i );
   Void      setCtxMem( TDecSbac* sb, Int b )   { CTXMem[b] = sb; }
   Int       getCtxMemSize( )                   { return (Int)CTXMem.size(); }
+#if DEC_TILE_WPP_PARALLEL
+#if SVC_EXTENSION
+  Void      createSubstreamWorkers  ( TComThreadPool* pcThreadPool, TDecTop** ppcDecTop, UInt layerId, TComTrQuant* pcTrQuant, UInt uiMaxTrSize );
+#else
+  Void      createSubstreamWorkers  ( TComThreadPool* pcThreadPool, TComTrQuant* pcTrQuant, UInt uiMaxTrSize );
+#endif
+  Void      destroySubstreamWorkers ();
+  Bool      getUseSubstreamWorkers  ( TComPic* pcPic );     ///< check whether the substreams of the current slice are decoded concurrently
+
+private:
+  Void      xDecompressSubstreams   ( TComInputBitstream** ppcSubstreams, TComPic* pcPic, TDecSbac* pcSbacDecoders );
+  Void      xDecompressSubstreamJob ( TComInputBitstream* pcSubstream, TComPic* pcPic, UInt uiSubStrm, TDecSbac* pcSbacDecoder, TComSyncCounter* pcDone );
+  Void      xDecompressCtuRow       ( TComPic* pcPic, UInt uiRow, TDecSubstreamWorker* pcWorker );
+  Void      xDecompressTile         ( TComPic* pcPic, UInt uiTileIdx, TDecSubstreamWorker* pcWorker );
+  Void      xDecodeCtu              ( TComPic* pcPic, TComDataCU* pcCU, TDecSubstreamWorker* pcWorker, UInt& ruiIsLast );
+#endif
+#if DEC_PICTURE_PIPELINE
+private:
+  Void      xWaitForRefLayerRows    ( TComPic* pcPic, UInt uiNumRows );   ///< wait for the reference layer rows read by the first uiNumRows CTU rows
+#endif
 };
 
 
@@ -98,24 +141,25 @@ class ParameterSetManagerDecoder:public ParameterSetManager
 public:
   ParameterSetManagerDecoder();
   virtual ~ParameterSetManagerDecoder();
-  Void     storePrefetchedVPS(TComVPS *vps)  { m_vpsBuffer.storePS( vps->getVPSId(), vps); };
+#if SVC_EXTENSION
+  Void     shareParameterSets(ParameterSetManagerDecoder *pcBase);
+#endif
+  Void     storePrefetchedVPS(TComVPS *vps)  { m_pcBufferStorage->m_vpsBuffer.storePS( vps->getVPSId(), vps); };
   TComVPS* getPrefetchedVPS  (Int vpsId);
-  Void     storePrefetchedSPS(TComSPS *sps)  { m_spsBuffer.storePS( sps->getSPSId(), sps); };
+  Void     storePrefetchedSPS(TComSPS *sps)  { m_pcBufferStorage->m_spsBuffer.storePS( sps->getSPSId(), sps); };
   TComSPS* getPrefetchedSPS  (Int spsId);
-  Void     storePrefetchedPPS(TComPPS *pps)  { m_ppsBuffer.storePS( pps->getPPSId(), pps); };
+  Void     storePrefetchedPPS(TComPPS *pps)  { m_pcBufferStorage->m_ppsBuffer.storePS( pps->getPPSId(), pps); };
   TComPPS* getPrefetchedPPS  (Int ppsId);
   Void     applyPrefetchedPS();
+#if DEC_PICTURE_PIPELINE
+  Bool     hasPrefetchedPS();     ///< parameter sets are buffered, their activation may replace the ones used by the pictures being decoded
+#endif
 
 private:
-#if SVC_EXTENSION
-  static ParameterSetMap<TComVPS> m_vpsBuffer;
-  static ParameterSetMap<TComSPS> m_spsBuffer; 
-  static ParameterSetMap<TComPPS> m_ppsBuffer;
-#else
+  ParameterSetManagerDecoder* m_pcBufferStorage;  ///< manager buffering the prefetched parameter sets, this one unless they are shared with the base layer
   ParameterSetMap<TComVPS> m_vpsBuffer;
   ParameterSetMap<TComSPS> m_spsBuffer; 
   ParameterSetMap<TComPPS> m_ppsBuffer;
-#endif
 };
 
 
@@ -0,0 +1,107 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecSubstreamWorker.cpp
+    \brief    coding units of a tile or of a CTU row decoded concurrently with the other substreams
+*/
+
+#include "TDecSubstreamWorker.h"
+
+#if DEC_TILE_WPP_PARALLEL
+
+//! \ingroup TLibDecoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TDecSubstreamWorker::TDecSubstreamWorker()
+: m_bCreated ( false )
+{
+  m_cSbacDecoder.init( &m_cBinCABAC );
+  m_cEntropyDecoder.init( &m_cPrediction );
+  m_cEntropyDecoder.setEntropyDecoder( &m_cSbacDecoder );
+  m_cPrediction.initTempBuff();
+}
+
+TDecSubstreamWorker::~TDecSubstreamWorker()
+{
+  destroy();
+}
+
+/** allocate the coding units the same way as the ones of the layer decoder for the current picture
+ * \param ppcDecTop   decoders of the layers
+ * \param layerId     layer of the decoder
+ * \param uiMaxTrSize maximum transform size of the SPS
+ */
+#if SVC_EXTENSION
+Void TDecSubstreamWorker::create( TDecTop** ppcDecTop, UInt layerId, UInt uiMaxTrSize )
+#else
+Void TDecSubstreamWorker::create( UInt uiMaxTrSize )
+#endif
+{
+  m_cCuDecoder.create ( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
+#if SVC_EXTENSION
+  m_cCuDecoder.init   ( ppcDecTop, &m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction, layerId );
+#else
+  m_cCuDecoder.init   ( &m_cEntropyDecoder, &m_cTrQuant, &m_cPrediction );
+#endif
+  m_cTrQuant.init     ( g_uiMaxCUWidth, g_uiMaxCUHeight, uiMaxTrSize );
+  m_bCreated = true;
+}
+
+Void TDecSubstreamWorker::destroy()
+{
+  if( m_bCreated )
+  {
+    m_cCuDecoder.destroy();
+    m_bCreated = false;
+  }
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** copy the quantization matrices that the layer decoder set for the slice
+ * \param pcTrQuant transform and quantization class of the layer decoder
+ */
+Void TDecSubstreamWorker::initSlice( TComTrQuant* pcTrQuant )
+{
+  m_cTrQuant.copySliceSettings( pcTrQuant );
+}
+
+//! \}
+
+#endif // DEC_TILE_WPP_PARALLEL
@@ -0,0 +1,94 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     TDecSubstreamWorker.h
+    \brief    coding units of a tile or of a CTU row decoded concurrently with the other substreams (header)
+*/
+
+#ifndef __TDECSUBSTREAMWORKER__
+#define __TDECSUBSTREAMWORKER__
+
+// Include files
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComPrediction.h"
+#include "TDecEntropy.h"
+#include "TDecSbac.h"
+#include "TDecBinCoderCABAC.h"
+#include "TDecCu.h"
+
+#if DEC_TILE_WPP_PARALLEL
+
+//! \ingroup TLibDecoder
+//! \{
+
+class TDecTop;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of the CU decoder and of the classes it uses, one per substream decoded at the same time
+class TDecSubstreamWorker
+{
+private:
+  TDecCu                  m_cCuDecoder;                   ///< CU decoder
+  TComPrediction          m_cPrediction;                  ///< prediction class
+  TComTrQuant             m_cTrQuant;                     ///< transform & quantization class
+  TDecEntropy             m_cEntropyDecoder;              ///< entropy decoder
+  TDecSbac                m_cSbacDecoder;                 ///< SBAC decoder of the substream
+  TDecBinCABAC            m_cBinCABAC;                    ///< bin decoder CABAC of the substream
+  Bool                    m_bCreated;                     ///< the CU decoder is allocated
+
+public:
+  TDecSubstreamWorker();
+  virtual ~TDecSubstreamWorker();
+
+#if SVC_EXTENSION
+  Void  create            ( TDecTop** ppcDecTop, UInt layerId, UInt uiMaxTrSize );
+#else
+  Void  create            ( UInt uiMaxTrSize );
+#endif
+  Void  destroy           ();
+  Void  initSlice         ( TComTrQuant* pcTrQuant );     ///< take over the quantization matrices of the slice
+
+  TDecCu*                 getCuDecoder          () { return  &m_cCuDecoder;           }
+  TDecEntropy*            getEntropyDecoder     () { return  &m_cEntropyDecoder;      }
+  TDecSbac*               getSbacDecoder        () { return  &m_cSbacDecoder;         }
+};// END CLASS DEFINITION TDecSubstreamWorker
+
+//! \}
+
+#endif // DEC_TILE_WPP_PARALLEL
+
+#endif // __TDECSUBSTREAMWORKER__
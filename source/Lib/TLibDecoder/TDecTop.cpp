@@ -38,34 +38,43 @@
 #include "NALread.h"
 #include "TDecTop.h"
 
+//! \ingroup TLibDecoder
+//! \{
+
 #if SVC_EXTENSION
-UInt  TDecTop::m_prevPOC = MAX_UINT;
-UInt  TDecTop::m_uiPrevLayerId = MAX_UINT;
-Bool  TDecTop::m_bFirstSliceInSequence = true;
+TDecAuState::TDecAuState()
+: m_prevPOC                       ( MAX_UINT )
+, m_uiPrevLayerId                 ( MAX_UINT )
+, m_bFirstSliceInSequence         ( true )
 #if POC_RESET_RESTRICTIONS
-Bool  TDecTop::m_checkPocRestrictionsForCurrAu       = false;
-Int   TDecTop::m_pocResetIdcOrCurrAu                 = -1;
-Bool  TDecTop::m_baseLayerIdrFlag                    = false;
-Bool  TDecTop::m_baseLayerPicPresentFlag             = false;
-Bool  TDecTop::m_baseLayerIrapFlag                   = false;
-Bool  TDecTop::m_nonBaseIdrPresentFlag               = false;
-Int   TDecTop::m_nonBaseIdrType                      = -1;
-Bool  TDecTop::m_picNonIdrWithRadlPresentFlag        = false;
-Bool  TDecTop::m_picNonIdrNoLpPresentFlag            = false;
+, m_checkPocRestrictionsForCurrAu ( false )
+, m_pocResetIdcOrCurrAu           ( -1 )
+, m_baseLayerIdrFlag              ( false )
+, m_baseLayerPicPresentFlag       ( false )
+, m_baseLayerIrapFlag             ( false )
+, m_nonBaseIdrPresentFlag         ( false )
+, m_nonBaseIdrType                ( -1 )
+, m_picNonIdrWithRadlPresentFlag  ( false )
+, m_picNonIdrNoLpPresentFlag      ( false )
 #endif
 #if POC_RESET_VALUE_RESTRICTION
-Int   TDecTop::m_crossLayerPocResetPeriodId          = -1;
-Int   TDecTop::m_crossLayerPocResetIdc               = -1;
+, m_crossLayerPocResetPeriodId    ( -1 )
+, m_crossLayerPocResetIdc         ( -1 )
 #endif
+{
+}
 #endif
 
-//! \ingroup TLibDecoder
-//! \{
-
 TDecTop::TDecTop()
 {
   m_pcPic = 0;
   m_iMaxRefPicNum = 0;
+#if DEC_CABAC_64BIT_WINDOW
+  ContextModel::buildNextStateTable();
+#endif
+#if TOOL_THREAD_POOL
+  m_pcThreadPool = NULL;
+#endif
 #if ENC_DEC_TRACE
   g_hTrace = fopen( "TraceDec.txt", "wb" );
   g_bJustDoIt = g_bEncDecTraceDisable;
@@ -82,11 +91,16 @@ TDecTop::TDecTop()
   m_bFirstSliceInSequence   = true;
 #endif
 #if SVC_EXTENSION 
+  m_pcAuState = &m_cAuState;
   m_layerId = 0;
 #if AVC_BASE
   m_pBLReconFile = NULL;
 #endif
   memset(m_cIlpPic, 0, sizeof(m_cIlpPic));
+#if ILR_ON_DEMAND_UPSAMPLING
+  m_onDemandUpsampling = false;
+  memset(m_pcIlpTempPic, 0, sizeof(m_pcIlpTempPic));
+#endif
 #endif
   m_prevSliceSkipped = false;
   m_skippedPOC = 0;
@@ -153,6 +167,9 @@ Void TDecTop::create()
 
 Void TDecTop::destroy()
 {
+#if DEC_PICTURE_PIPELINE
+  m_cPictureQueue.destroy();
+#endif
   m_cGopDecoder.destroy();
   
   delete m_apcSlicePilot;
@@ -168,6 +185,14 @@ Void TDecTop::destroy()
       delete m_cIlpPic[i];
       m_cIlpPic[i] = NULL;
     }
+#if ILR_ON_DEMAND_UPSAMPLING
+    if(m_pcIlpTempPic[i])
+    {
+      m_pcIlpTempPic[i]->destroy();
+      delete m_pcIlpTempPic[i];
+      m_pcIlpTempPic[i] = NULL;
+    }
+#endif
   }
 #endif
 }
@@ -184,6 +209,11 @@ Void TDecTop::init()
 #else
   m_cGopDecoder.init( &m_cEntropyDecoder, &m_cSbacDecoder, &m_cBinCABAC, &m_cCavlcDecoder, &m_cSliceDecoder, &m_cLoopFilter, &m_cSAO);
   m_cSliceDecoder.init( &m_cEntropyDecoder, &m_cCuDecoder );
+#endif
+#if DEC_CTU_ROW_FILTER
+  m_cCtuRowFilter.init( &m_cLoopFilter, &m_cSAO );
+  m_cGopDecoder.setCtuRowFilter( &m_cCtuRowFilter );
+  m_cSliceDecoder.setCtuRowFilter( &m_cCtuRowFilter );
 #endif
   m_cEntropyDecoder.init(&m_cPrediction);
 }
@@ -267,6 +297,18 @@ Void TDecTop::xInitILRP(TComSlice *slice)
         {
           m_cIlpPic[j]->getPicSym()->getCU(i)->initCU(m_cIlpPic[j], i);
         }
+#if ILR_ON_DEMAND_UPSAMPLING
+        if( m_onDemandUpsampling )
+        {
+          TComPicYuv* pcIlpRec = m_cIlpPic[j]->getPicYuvRec();
+          m_pcIlpTempPic[j] = new TComPicYuv;
+#if AUXILIARY_PICTURES
+          m_pcIlpTempPic[j]->create( pcIlpRec->getWidth(), pcIlpRec->getHeight(), pcIlpRec->getChromaFormat(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+#else
+          m_pcIlpTempPic[j]->create( pcIlpRec->getWidth(), pcIlpRec->getHeight(), g_uiMaxCUWidth, g_uiMaxCUHeight, g_uiMaxCUDepth );
+#endif
+        }
+#endif
       }
     }
   }
@@ -275,6 +317,10 @@ Void TDecTop::xInitILRP(TComSlice *slice)
 
 Void TDecTop::deletePicBuffer ( )
 {
+#if DEC_PICTURE_PIPELINE
+  // the pictures of the layer may be read by the pictures of the other layers being decoded
+  xWaitForFinishedLayers( true );
+#endif
   TComList<TComPic*>::iterator  iterPic   = m_cListPic.begin();
   Int iSize = Int( m_cListPic.size() );
   
@@ -527,6 +573,19 @@ Void TDecTop::xGetNewPicBuffer ( TComSlice* pcSlice, TComPic*& rpcPic )
     rpcPic = new TComPic();
     m_cListPic.pushBack( rpcPic );
   }
+#if DEC_PICTURE_PIPELINE && SVC_EXTENSION
+  else
+  {
+    // the picture may still be read as the reference layer picture of the picture of a higher layer being decoded
+    for( UInt uiLayer = m_layerId + 1; uiLayer < MAX_LAYERS; uiLayer++ )
+    {
+      if( m_ppcTDecTop[uiLayer] && m_ppcTDecTop[uiLayer]->m_pcPic && m_ppcTDecTop[uiLayer]->m_pcPic->getPOC() == rpcPic->getPOC() )
+      {
+        m_ppcTDecTop[uiLayer]->waitForFinishedPictures();
+      }
+    }
+  }
+#endif
   rpcPic->destroy();
 
 #if SVC_EXTENSION
@@ -564,18 +623,112 @@ Void TDecTop::executeLoopFilters(Int& poc, TComList<TComPic*>*& rpcListPic)
   
   TComPic*&   pcPic         = m_pcPic;
 
+  if (m_cCodingContext.isValid())
+  {
+    m_cCodingContext.bind();
+  }
+
   // Execute Deblock + Cleanup
+#if DEC_PICTURE_PIPELINE
+  // the filtering follows the decoding of the slices in the thread of the layer, while the pictures of the other layers are decoded
+  m_cGopDecoder.markDecodedPicture( pcPic );
+  m_cPictureQueue.addJob( std::bind( &TDecTop::xFilterPictureJob, this, pcPic ) );
+#else
   m_cGopDecoder.filterPicture(pcPic);
+#endif
 
   TComSlice::sortPicList( m_cListPic ); // sorting for application output
   poc                 = pcPic->getSlice(m_uiSliceIdx-1)->getPOC();
   rpcListPic          = &m_cListPic;  
+#if !DEC_PICTURE_PIPELINE
   m_cCuDecoder.destroy();        
+#if DEC_TILE_WPP_PARALLEL
+  m_cSliceDecoder.destroySubstreamWorkers();
+#endif
+#endif
   m_bFirstSliceInPicture  = true;
 
   return;
 }
 
+#if DEC_PICTURE_PIPELINE
+/** decode a slice in the thread of the layer
+ * \param pcBitstream slice data, owned by the job
+ * \param pcPic       picture of the slice
+ * \returns Void
+ */
+Void TDecTop::xDecompressSliceJob( TComInputBitstream* pcBitstream, TComPic* pcPic )
+{
+  m_cGopDecoder.decompressSlice( pcBitstream, pcPic );
+  pcBitstream->deleteFifo();
+  delete pcBitstream;
+}
+
+/** filter a decoded picture in the thread of the layer and release the decoding classes of the picture
+ * \param pcPic decoded picture
+ * \returns Void
+ */
+Void TDecTop::xFilterPictureJob( TComPic* pcPic )
+{
+  m_cGopDecoder.filterPicture( pcPic );
+  pcPic->finishReconstruction();
+  m_cCuDecoder.destroy();
+#if DEC_TILE_WPP_PARALLEL
+  m_cSliceDecoder.destroySubstreamWorkers();
+#endif
+}
+
+Void TDecTop::waitForFinishedPictures()
+{
+  m_cPictureQueue.waitForAll();
+}
+
+Void TDecTop::waitForFinishedPicture( TComPic* pcPic )
+{
+  pcPic->waitForReconstruction();
+}
+
+/** wait for the queued decoding and in-loop filtering of the pictures
+ * \param bAllLayers wait for all layers instead of the current layer, whose decoding classes are used by the calling thread
+ * \returns Void
+ */
+Void TDecTop::xWaitForFinishedLayers( Bool bAllLayers )
+{
+#if SVC_EXTENSION
+  if( !bAllLayers )
+  {
+    waitForFinishedPictures();
+    return;
+  }
+  for( UInt uiLayer = 0; uiLayer < MAX_LAYERS; uiLayer++ )
+  {
+    if( m_ppcTDecTop[uiLayer] )
+    {
+      m_ppcTDecTop[uiLayer]->waitForFinishedPictures();
+    }
+  }
+#else
+  waitForFinishedPictures();
+#endif
+}
+#endif
+
+#if TOOL_THREAD_POOL
+/** \param pcThreadPool worker threads of the parallel decoding tools, shared by the layers
+ */
+Void TDecTop::setThreadPool( TComThreadPool* pcThreadPool )
+{
+  m_pcThreadPool = pcThreadPool;
+#if DEC_CTU_ROW_FILTER && LOOP_FILTER_PARALLEL
+  m_cCtuRowFilter.setThreadPool( pcThreadPool );
+#endif
+#if DEC_PICTURE_PIPELINE
+  // without worker threads the pictures are decoded by the calling thread
+  m_cPictureQueue.create( pcThreadPool->getNumThreads() > 0 ? 1 : 0 );
+#endif
+}
+#endif
+
 #if SETTING_NO_OUT_PIC_PRIOR
 Void TDecTop::checkNoOutputPriorPics (TComList<TComPic*>*& rpcListPic)
 {
@@ -729,6 +882,13 @@ Void TDecTop::xCreateLostPicture(Int iLostPoc)
 
 Void TDecTop::xActivateParameterSets()
 {
+#if DEC_PICTURE_PIPELINE
+  // the parameter sets replaced by the buffered ones may be used by the pictures being decoded
+  if( m_parameterSetManagerDecoder.hasPrefetchedPS() )
+  {
+    xWaitForFinishedLayers( true );
+  }
+#endif
   m_parameterSetManagerDecoder.applyPrefetchedPS();
   
   TComPPS *pps = m_parameterSetManagerDecoder.getPPS(m_apcSlicePilot->getPPSId());
@@ -1052,7 +1212,7 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
   if (m_apcSlicePilot->getRapPicFlag())
   {
     if ((m_apcSlicePilot->getNalUnitType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && m_apcSlicePilot->getNalUnitType() <= NAL_UNIT_CODED_SLICE_IDR_N_LP) || 
-        (m_apcSlicePilot->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA && m_bFirstSliceInSequence) ||
+        (m_apcSlicePilot->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA && m_pcAuState->m_bFirstSliceInSequence) ||
         (m_apcSlicePilot->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA && m_apcSlicePilot->getHandleCraAsBlaFlag()))
     {
       m_apcSlicePilot->setNoRaslOutputFlag(true);
@@ -1126,13 +1286,13 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
 
   // exit when a new picture is found
 #if SVC_EXTENSION
-  bNewPOC = (m_apcSlicePilot->getPOC()!= m_prevPOC);
+  bNewPOC = (m_apcSlicePilot->getPOC()!= m_pcAuState->m_prevPOC);
 
 #if NO_OUTPUT_OF_PRIOR_PICS
 #if NO_CLRAS_OUTPUT_FLAG
   if (m_layerId == 0 && m_apcSlicePilot->getRapPicFlag() )
   {
-    if (m_bFirstSliceInSequence)
+    if (m_pcAuState->m_bFirstSliceInSequence)
     {
       setNoClrasOutputFlag(true);
     }
@@ -1160,7 +1320,7 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
 #endif
 
   // Derive the value of NoOutputOfPriorPicsFlag
-  if( bNewPOC || m_layerId!=m_uiPrevLayerId )   // i.e. new coded picture
+  if( bNewPOC || m_layerId!=m_pcAuState->m_uiPrevLayerId )   // i.e. new coded picture
   {
     if( m_apcSlicePilot->getNalUnitType() == NAL_UNIT_CODED_SLICE_CRA && m_apcSlicePilot->getNoRaslOutputFlag() )
     {
@@ -1191,14 +1351,14 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     bNewPOC = false;
   }
 
-  if( (bNewPOC || m_layerId!=m_uiPrevLayerId) && (m_parseIdc == -1) ) // Will be true at the first pass
+  if( (bNewPOC || m_layerId!=m_pcAuState->m_uiPrevLayerId) && (m_parseIdc == -1) ) // Will be true at the first pass
   {
-  //if (bNewPOC || m_layerId!=m_uiPrevLayerId)
+  //if (bNewPOC || m_layerId!=m_pcAuState->m_uiPrevLayerId)
   // Check if new reset period has started - this is needed just so that the SHM decoder which calls slice header decoding twice 
   // does not invoke the output twice
   //if( m_lastPocPeriodId[m_apcSlicePilot->getLayerId()] == m_apcSlicePilot->getPocResetPeriodId() )
     // Update CurrAU marking
-    if(( m_layerId < m_uiPrevLayerId) ||( ( m_layerId == m_uiPrevLayerId) && bNewPOC)) // Decoding a lower layer than or same layer as previous - mark all earlier pictures as not in current AU
+    if(( m_layerId < m_pcAuState->m_uiPrevLayerId) ||( ( m_layerId == m_pcAuState->m_uiPrevLayerId) && bNewPOC)) // Decoding a lower layer than or same layer as previous - mark all earlier pictures as not in current AU
     {
 #if POC_RESET_RESTRICTIONS
       // New access unit; reset all variables related to POC reset restrictions
@@ -1245,22 +1405,22 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
       }
 #if POC_RESET_VALUE_RESTRICTION
       // Check if the POC Reset period ID matches with the Reset Period ID 
-      if( pocResetPeriodId == m_crossLayerPocResetPeriodId )
+      if( pocResetPeriodId == m_pcAuState->m_crossLayerPocResetPeriodId )
       {
         // If matching, and current poc_reset_idc = 3, then the values should match
         if( m_apcSlicePilot->getPocResetIdc() == 3 )
         {
-          assert( ( m_apcSlicePilot->getFullPocResetFlag() == false && m_crossLayerPocResetIdc == 1 ) ||
-                  ( m_apcSlicePilot->getFullPocResetFlag() == true  && m_crossLayerPocResetIdc == 2 ) );
+          assert( ( m_apcSlicePilot->getFullPocResetFlag() == false && m_pcAuState->m_crossLayerPocResetIdc == 1 ) ||
+                  ( m_apcSlicePilot->getFullPocResetFlag() == true  && m_pcAuState->m_crossLayerPocResetIdc == 2 ) );
         }
       }
       else
       {
         // This is the first picture of a POC resetting access unit
-        m_crossLayerPocResetPeriodId = pocResetPeriodId;
+        m_pcAuState->m_crossLayerPocResetPeriodId = pocResetPeriodId;
         if( m_apcSlicePilot->getPocResetIdc() == 1 || m_apcSlicePilot->getPocResetIdc() == 2 )
         {
-          m_crossLayerPocResetIdc = m_apcSlicePilot->getPocResetIdc();
+          m_pcAuState->m_crossLayerPocResetIdc = m_apcSlicePilot->getPocResetIdc();
         }
         else
         { // poc_reset_idc = 3
@@ -1298,7 +1458,7 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
   }
 #endif
 
-  //if(  (bNewPOC || m_layerId != m_uiPrevLayerId) && ( m_parseIdc != 1) )
+  //if(  (bNewPOC || m_layerId != m_pcAuState->m_uiPrevLayerId) && ( m_parseIdc != 1) )
 #if P0297_VPS_POC_LSB_ALIGNED_FLAG
   if (m_parseIdc == 1 && m_pocResettingFlag)
 #else
@@ -1360,6 +1520,9 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
       if (!m_ppcTDecTop[affectedLayerList[layerIdx]]->m_pocDecrementedInDPBFlag)
       {
         m_ppcTDecTop[affectedLayerList[layerIdx]]->m_pocDecrementedInDPBFlag = true;
+#if DEC_PICTURE_PIPELINE
+        m_ppcTDecTop[affectedLayerList[layerIdx]]->waitForFinishedPictures();
+#endif
         TComList<TComPic*>::iterator  iterPic = m_ppcTDecTop[affectedLayerList[layerIdx]]->getListPic()->begin();
         while (iterPic != m_ppcTDecTop[affectedLayerList[layerIdx]]->getListPic()->end())
 #else
@@ -1499,21 +1662,21 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
 #endif
     }
 #else
-  if (bNewPOC || m_layerId!=m_uiPrevLayerId)
+  if (bNewPOC || m_layerId!=m_pcAuState->m_uiPrevLayerId)
   {
 #endif
     m_apcSlicePilot->applyReferencePictureSet(m_cListPic, m_apcSlicePilot->getRPS());
   }
 #endif
 #if POC_RESET_IDC_DECODER
-  if (m_apcSlicePilot->isNextSlice() && (bNewPOC || m_layerId!=m_uiPrevLayerId || m_parseIdc == 1) && !m_bFirstSliceInSequence )
+  if (m_apcSlicePilot->isNextSlice() && (bNewPOC || m_layerId!=m_pcAuState->m_uiPrevLayerId || m_parseIdc == 1) && !m_pcAuState->m_bFirstSliceInSequence )
 #else
-  if (m_apcSlicePilot->isNextSlice() && (bNewPOC || m_layerId!=m_uiPrevLayerId) && !m_bFirstSliceInSequence )
+  if (m_apcSlicePilot->isNextSlice() && (bNewPOC || m_layerId!=m_pcAuState->m_uiPrevLayerId) && !m_pcAuState->m_bFirstSliceInSequence )
 #endif
   {
-    m_prevPOC = m_apcSlicePilot->getPOC();
-    curLayerId = m_uiPrevLayerId; 
-    m_uiPrevLayerId = m_layerId;
+    m_pcAuState->m_prevPOC = m_apcSlicePilot->getPOC();
+    curLayerId = m_pcAuState->m_uiPrevLayerId; 
+    m_pcAuState->m_uiPrevLayerId = m_layerId;
     return true;
   }
 
@@ -1556,11 +1719,11 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
 #endif
   if (m_apcSlicePilot->isNextSlice()) 
   {
-    m_prevPOC = m_apcSlicePilot->getPOC();
+    m_pcAuState->m_prevPOC = m_apcSlicePilot->getPOC();
     curLayerId = m_layerId;
-    m_uiPrevLayerId = m_layerId;
+    m_pcAuState->m_uiPrevLayerId = m_layerId;
   }
-  m_bFirstSliceInSequence = false;
+  m_pcAuState->m_bFirstSliceInSequence = false;
 #if SETTING_NO_OUT_PIC_PRIOR  
   m_bFirstSliceInBitstream  = false;
 #endif
@@ -1836,42 +1999,42 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
 #if POC_RESET_IDC_DECODER
     pcPic->setCurrAuFlag( true );
 #if POC_RESET_RESTRICTIONS
-    if( pcPic->getLayerId() > 0 && m_apcSlicePilot->isIDR() && !m_nonBaseIdrPresentFlag )
+    if( pcPic->getLayerId() > 0 && m_apcSlicePilot->isIDR() && !m_pcAuState->m_nonBaseIdrPresentFlag )
     {
       // IDR picture with nuh_layer_id > 0 present
-      m_nonBaseIdrPresentFlag = true;
-      m_nonBaseIdrType = (m_apcSlicePilot->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL);
+      m_pcAuState->m_nonBaseIdrPresentFlag = true;
+      m_pcAuState->m_nonBaseIdrType = (m_apcSlicePilot->getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR_W_RADL);
     }
     else
     {
       if( m_apcSlicePilot->getNalUnitType() != NAL_UNIT_CODED_SLICE_IDR_W_RADL )
       {
         // Picture with nal_unit_type not equal IDR_W_RADL present
-        m_picNonIdrWithRadlPresentFlag = true;
+        m_pcAuState->m_picNonIdrWithRadlPresentFlag = true;
       }
       if( m_apcSlicePilot->getNalUnitType() != NAL_UNIT_CODED_SLICE_IDR_N_LP )
       {
         // Picture with nal_unit_type not equal IDR_N_LP present
-        m_picNonIdrNoLpPresentFlag = true;
+        m_pcAuState->m_picNonIdrNoLpPresentFlag = true;
       }
     }
-    if( !m_checkPocRestrictionsForCurrAu )  // Will be true for the first slice/picture of the AU
+    if( !m_pcAuState->m_checkPocRestrictionsForCurrAu )  // Will be true for the first slice/picture of the AU
     {
-      m_checkPocRestrictionsForCurrAu = true;
-      m_pocResetIdcOrCurrAu = m_apcSlicePilot->getPocResetIdc();
+      m_pcAuState->m_checkPocRestrictionsForCurrAu = true;
+      m_pcAuState->m_pocResetIdcOrCurrAu = m_apcSlicePilot->getPocResetIdc();
       if( pcPic->getLayerId() == 0 )
       {
         // Base layer picture is present
-        m_baseLayerPicPresentFlag = true;
+        m_pcAuState->m_baseLayerPicPresentFlag = true;
         if( m_apcSlicePilot->isIRAP() )
         {
           // Base layer picture is IRAP
-          m_baseLayerIrapFlag = true;
+          m_pcAuState->m_baseLayerIrapFlag = true;
         }
         if( m_apcSlicePilot->isIDR() )
         {
           // Base layer picture is IDR
-          m_baseLayerIdrFlag = true;
+          m_pcAuState->m_baseLayerIdrFlag = true;
         }
         else
         {
@@ -1888,12 +2051,12 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     else
     {
       // The value of poc_reset_idc of all coded pictures that are present in the bitstream in an access unit shall be the same.
-      assert( m_pocResetIdcOrCurrAu == m_apcSlicePilot->getPocResetIdc() );
+      assert( m_pcAuState->m_pocResetIdcOrCurrAu == m_apcSlicePilot->getPocResetIdc() );
 
       /* When the picture in an access unit with nuh_layer_id equal to 0 is an IRAP picture and vps_base_layer_internal_flag is equal to 1 
       and there is at least one other picture in the same access unit that is not an IRAP picture, 
       the value of poc_reset_idc shall be equal to 1 or 2 for all pictures in the access unit. */
-      if( m_baseLayerPicPresentFlag && m_baseLayerIrapFlag && !m_apcSlicePilot->isIRAP() && m_apcSlicePilot->getVPS()->getBaseLayerInternalFlag() )
+      if( m_pcAuState->m_baseLayerPicPresentFlag && m_pcAuState->m_baseLayerIrapFlag && !m_apcSlicePilot->isIRAP() && m_apcSlicePilot->getVPS()->getBaseLayerInternalFlag() )
       {
         assert( m_apcSlicePilot->getPocResetIdc() == 1 || m_apcSlicePilot->getPocResetIdc() == 2 );
       }
@@ -1901,7 +2064,7 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
       /* When the picture with nuh_layer_id equal to 0 in an access unit is an IDR picture and 
       vps_base_layer_internal_flag is equal to 1 and there is at least one non-IDR picture in the same access unit, 
       the value of poc_reset_idc shall be equal to 2 for all pictures in the access unit. */
-      if( m_baseLayerPicPresentFlag && m_baseLayerIdrFlag && !m_apcSlicePilot->isIDR() && m_apcSlicePilot->getVPS()->getBaseLayerInternalFlag() )
+      if( m_pcAuState->m_baseLayerPicPresentFlag && m_pcAuState->m_baseLayerIdrFlag && !m_apcSlicePilot->isIDR() && m_apcSlicePilot->getVPS()->getBaseLayerInternalFlag() )
       {
         assert( m_apcSlicePilot->getPocResetIdc() == 2 );
       }
@@ -1910,9 +2073,9 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
       with a particular value of nal_unit_type in an access unit and there is at least one other coded picture 
       that is present in the bitstream in the same access unit with a different value of nal_unit_type, 
       the value of poc_reset_idc shall be equal to 1 or 2 for all pictures in the access unit. */
-      if( m_nonBaseIdrPresentFlag && (
-            ( m_nonBaseIdrType == 1 && m_picNonIdrWithRadlPresentFlag ) ||
-            ( m_nonBaseIdrType == 0 && m_picNonIdrNoLpPresentFlag )
+      if( m_pcAuState->m_nonBaseIdrPresentFlag && (
+            ( m_pcAuState->m_nonBaseIdrType == 1 && m_pcAuState->m_picNonIdrWithRadlPresentFlag ) ||
+            ( m_pcAuState->m_nonBaseIdrType == 0 && m_pcAuState->m_picNonIdrNoLpPresentFlag )
         ))
       {
         assert( m_apcSlicePilot->getPocResetIdc() == 1 || m_apcSlicePilot->getPocResetIdc() == 2 );
@@ -1982,6 +2145,16 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     m_cTrQuant.init     ( g_uiMaxCUWidth, g_uiMaxCUHeight, m_apcSlicePilot->getSPS()->getMaxTrSize());
 
     m_cSliceDecoder.create();
+#if DEC_TILE_WPP_PARALLEL
+#if SVC_EXTENSION
+    m_cSliceDecoder.createSubstreamWorkers( m_pcThreadPool, m_ppcTDecTop, curLayerId, &m_cTrQuant, m_apcSlicePilot->getSPS()->getMaxTrSize() );
+#else
+    m_cSliceDecoder.createSubstreamWorkers( m_pcThreadPool, &m_cTrQuant, m_apcSlicePilot->getSPS()->getMaxTrSize() );
+#endif
+#endif
+
+    // keep the coding state of the layer for the following calls
+    m_cCodingContext.save();
   }
   else
   {
@@ -2059,6 +2232,15 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     // Other slices might choose which reference pictures to be used for inter-layer prediction
     if( m_layerId > 0 && m_uiSliceIdx == 0 )
     {      
+#if ILR_ON_DEMAND_UPSAMPLING
+      for( i = 0; i < MAX_NUM_REF; i++ )
+      {
+        if( m_cIlpPic[i] )
+        {
+          m_cIlpPic[i]->setUpsampleFilter( NULL, i );
+        }
+      }
+#endif
 #if M0040_ADAPTIVE_RESOLUTION_CHANGE
       if( !pcSlice->getVPS()->getSingleLayerForNonIrapFlag() || ( pcSlice->getVPS()->getSingleLayerForNonIrapFlag() && pcSlice->isIRAP() ) )
 #endif
@@ -2158,11 +2340,11 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
 #endif
 #endif
 
-        g_mvScalingFactor[refLayerIdc][0] = widthEL  == widthBL  ? 4096 : Clip3(-4096, 4095, ((widthEL  << 8) + (widthBL  >> 1)) / widthBL);
-        g_mvScalingFactor[refLayerIdc][1] = heightEL == heightBL ? 4096 : Clip3(-4096, 4095, ((heightEL << 8) + (heightBL >> 1)) / heightBL);
+        pcSlice->setMvScalingFactor(refLayerIdc, 0, widthEL  == widthBL  ? 4096 : Clip3(-4096, 4095, ((widthEL  << 8) + (widthBL  >> 1)) / widthBL));
+        pcSlice->setMvScalingFactor(refLayerIdc, 1, heightEL == heightBL ? 4096 : Clip3(-4096, 4095, ((heightEL << 8) + (heightBL >> 1)) / heightBL));
 
-        g_posScalingFactor[refLayerIdc][0] = ((widthBL  << 16) + (widthEL  >> 1)) / widthEL;
-        g_posScalingFactor[refLayerIdc][1] = ((heightBL << 16) + (heightEL >> 1)) / heightEL;
+        pcSlice->setPosScalingFactor(refLayerIdc, 0, ((widthBL  << 16) + (widthEL  >> 1)) / widthEL);
+        pcSlice->setPosScalingFactor(refLayerIdc, 1, ((heightBL << 16) + (heightEL >> 1)) / heightEL);
 
 #if Q0048_CGS_3D_ASYMLUT 
         TComPicYuv* pBaseColRec = pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec();
@@ -2177,12 +2359,20 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
           assert( pcSlice->getBaseColPic( refLayerIdc )->getSlice( 0 )->getBitDepthC() == m_c3DAsymLUTPPS.getInputBitDepthC() );
           assert( pcSlice->getBitDepthY() >= m_c3DAsymLUTPPS.getOutputBitDepthY() );
           assert( pcSlice->getBitDepthY() >= m_c3DAsymLUTPPS.getOutputBitDepthC() );
+#endif
+#if DEC_PICTURE_PIPELINE
+          // the colour mapping reads the whole reference layer picture
+          pcSlice->getBaseColPic(refLayerIdc)->waitForReconstruction();
 #endif
           if(!m_pColorMappedPic)
           {
             initAsymLut(pcSlice->getBaseColPic(refLayerIdc)->getSlice(0));
           }
+#if TOOL_THREAD_POOL
+          m_c3DAsymLUTPPS.colorMapping( pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(),  m_pColorMappedPic, m_pcThreadPool );
+#else
           m_c3DAsymLUTPPS.colorMapping( pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(),  m_pColorMappedPic );
+#endif
           pBaseColRec = m_pColorMappedPic;
         }
 #endif
@@ -2192,40 +2382,67 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
           // check for the sample prediction picture type
           if( m_ppcTDecTop[m_layerId]->getSamplePredEnabledFlag(refLayerId) )
           {
+#if ILR_ON_DEMAND_UPSAMPLING
+            // on demand, the inter-layer reference picture is resampled in place when motion compensation first references its rows
+            Bool bOnDemand = m_onDemandUpsampling && m_cIlpPic[refLayerIdc];
+#if Q0048_CGS_3D_ASYMLUT
+            // the colour mapped picture is shared by the reference layers
+            bOnDemand = bOnDemand && ( pBaseColRec != m_pColorMappedPic || pcSlice->getNumILRRefIdx() == 1 );
+#endif
+            TComPicYuv* pcUsPic   = bOnDemand ? m_cIlpPic[refLayerIdc]->getPicYuvRec() : pcPic->getFullPelBaseRec(refLayerIdc);
+            TComPicYuv* pcTempPic = bOnDemand ? m_pcIlpTempPic[refLayerIdc]           : pcPic->getPicYuvRec();
+            m_cPrediction.getUpsampleFilter()->setDeferred( bOnDemand );
+            if( bOnDemand )
+            {
+              m_cIlpPic[refLayerIdc]->setUpsampleFilter( m_cPrediction.getUpsampleFilter(), refLayerIdc );
+            }
+#else
+            TComPicYuv* pcUsPic   = pcPic->getFullPelBaseRec(refLayerIdc);
+            TComPicYuv* pcTempPic = pcPic->getPicYuvRec();
+#endif
+#if DEC_PICTURE_PIPELINE
+            // the reference layer picture is read at once unless it is resampled on demand, the ratio 1x is a copy
+#if ILR_ON_DEMAND_UPSAMPLING
+            if( !bOnDemand || ( pcSlice->getPosScalingFactor(refLayerIdc, 0) == 65536 && pcSlice->getPosScalingFactor(refLayerIdc, 1) == 65536 ) )
+#endif
+            {
+              pcSlice->getBaseColPic(refLayerIdc)->waitForReconstruction();
+            }
+#endif
 #if O0215_PHASE_ALIGNMENT
 #if O0194_JOINT_US_BITSHIFT
 #if Q0048_CGS_3D_ASYMLUT 
-            m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pBaseColRec, pcPic->getPicYuvRec(), pcSlice->getVPS()->getPhaseAlignFlag() );
+            m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcUsPic, pBaseColRec, pcTempPic, pcSlice->getVPS()->getPhaseAlignFlag() );
 #else
-            m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(), pcPic->getPicYuvRec(), pcSlice->getVPS()->getPhaseAlignFlag() );
+            m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcUsPic, pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(), pcTempPic, pcSlice->getVPS()->getPhaseAlignFlag() );
 #endif
 #else
 #if Q0048_CGS_3D_ASYMLUT 
 #if MOVE_SCALED_OFFSET_TO_PPS
-          m_cPrediction.upsampleBasePic( refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pBaseColRec, pcPic->getPicYuvRec(), pcSlice->getPPS()->getScaledRefLayerWindow(refLayerIdc), pcSlice->getVPS()->getPhaseAlignFlag() );
+          m_cPrediction.upsampleBasePic( refLayerIdc, pcUsPic, pBaseColRec, pcTempPic, pcSlice->getPPS()->getScaledRefLayerWindow(refLayerIdc), pcSlice->getVPS()->getPhaseAlignFlag() );
 #else
-          m_cPrediction.upsampleBasePic( refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pBaseColRec, pcPic->getPicYuvRec(), pcSlice->getSPS()->getScaledRefLayerWindow(refLayerIdc), pcSlice->getVPS()->getPhaseAlignFlag() );
+          m_cPrediction.upsampleBasePic( refLayerIdc, pcUsPic, pBaseColRec, pcTempPic, pcSlice->getSPS()->getScaledRefLayerWindow(refLayerIdc), pcSlice->getVPS()->getPhaseAlignFlag() );
 #endif
 #else
-          m_cPrediction.upsampleBasePic( refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(), pcPic->getPicYuvRec(), scalEL, pcSlice->getVPS()->getPhaseAlignFlag() );
+          m_cPrediction.upsampleBasePic( refLayerIdc, pcUsPic, pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(), pcTempPic, scalEL, pcSlice->getVPS()->getPhaseAlignFlag() );
 #endif
 #endif
 #else
 #if O0194_JOINT_US_BITSHIFT
 #if Q0048_CGS_3D_ASYMLUT 
 #if REF_REGION_OFFSET
-          m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pBaseColRec, pcPic->getPicYuvRec(), scalEL, altRL );
+          m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcUsPic, pBaseColRec, pcTempPic, scalEL, altRL );
 #else
-          m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pBaseColRec, pcPic->getPicYuvRec(), scalEL );
+          m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcUsPic, pBaseColRec, pcTempPic, scalEL );
 #endif
 #else
-          m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(), pcPic->getPicYuvRec(), scalEL );
+          m_cPrediction.upsampleBasePic( pcSlice, refLayerIdc, pcUsPic, pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(), pcTempPic, scalEL );
 #endif
 #else
 #if Q0048_CGS_3D_ASYMLUT 
-            m_cPrediction.upsampleBasePic( refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pBaseColRec, pcPic->getPicYuvRec(), scalEL );
+            m_cPrediction.upsampleBasePic( refLayerIdc, pcUsPic, pBaseColRec, pcTempPic, scalEL );
 #else
-            m_cPrediction.upsampleBasePic( refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc), pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(), pcPic->getPicYuvRec(), scalEL );
+            m_cPrediction.upsampleBasePic( refLayerIdc, pcUsPic, pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(), pcTempPic, scalEL );
 #endif
 #endif
 #endif
@@ -2277,6 +2494,26 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
         pcSlice->setFullPelBaseRec ( refLayerIdc, pcPic->getFullPelBaseRec(refLayerIdc) );
       }
 
+#if DEC_PICTURE_PIPELINE
+      // the samples of the inter-layer reference pictures which are not resampled on demand and the mapped motion are copied at once
+#if REF_IDX_MFM
+      Bool bMapMotion = pcSlice->getMFMEnabledFlag() && !( pcSlice->getNalUnitType() >= NAL_UNIT_CODED_SLICE_BLA_W_LP && pcSlice->getNalUnitType() <= NAL_UNIT_CODED_SLICE_CRA );
+#else
+      Bool bMapMotion = false;
+#endif
+      for( i = 0; i < pcSlice->getActiveNumILRRefIdx(); i++ )
+      {
+        UInt refLayerIdc = pcSlice->getInterLayerPredLayerIdc(i);
+#if ILR_ON_DEMAND_UPSAMPLING
+        if( m_cIlpPic[refLayerIdc] && ( bMapMotion || !m_cIlpPic[refLayerIdc]->getUpsampleFilter() ) )
+#else
+        if( m_cIlpPic[refLayerIdc] )
+#endif
+        {
+          pcSlice->getBaseColPic(refLayerIdc)->waitForReconstruction();
+        }
+      }
+#endif
       pcSlice->setILRPic( m_cIlpPic );
 
 #if REF_IDX_MFM
@@ -2407,8 +2644,27 @@ Bool TDecTop::xDecodeSlice(InputNALUnit &nalu, Int &iSkipFrame, Int iPOCLastDisp
     m_cTrQuant.setUseScalingList(false);
   }
 
+#if DEC_CTU_ROW_FILTER
+  if (m_bFirstSliceInPicture)
+  {
+    m_cCtuRowFilter.startPicture(pcPic);
+  }
+#endif
+#if DEC_PICTURE_PIPELINE
+  if (m_bFirstSliceInPicture)
+  {
+    // the pictures of the other layers reading this one wait for its rows from now on
+    pcPic->startReconstruction();
+  }
+#endif
+
   //  Decode a picture
+#if DEC_PICTURE_PIPELINE
+  // the slice data is copied, the NAL unit is released when the call returns
+  m_cPictureQueue.addJob( std::bind( &TDecTop::xDecompressSliceJob, this, nalu.m_Bitstream->extractSubstream( nalu.m_Bitstream->getNumBitsLeft() ), pcPic ) );
+#else
   m_cGopDecoder.decompressSlice(nalu.m_Bitstream, pcPic);
+#endif
 
 #if P0297_VPS_POC_LSB_ALIGNED_FLAG
   setFirstPicInLayerDecodedFlag(true);
@@ -2508,6 +2764,9 @@ Void TDecTop::xDecodeSEI( TComInputBitstream* bs, const NalUnitType nalUnitType
     if (activeParamSets.size()>0)
     {
       SEIActiveParameterSets *seiAps = (SEIActiveParameterSets*)(*activeParamSets.begin());
+#if DEC_PICTURE_PIPELINE
+      xWaitForFinishedLayers( true );
+#endif
 #if !R0247_SEI_ACTIVE
       m_parameterSetManagerDecoder.applyPrefetchedPS();
       assert(seiAps->activeSeqParameterSetId.size()>0);
@@ -2571,6 +2830,16 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay,
 Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
 #endif
 {
+  if (m_cCodingContext.isValid())
+  {
+    m_cCodingContext.bind();
+  }
+
+#if DEC_PICTURE_PIPELINE
+  // a slice uses the decoding classes of its layer and waits for the reference layer pictures it reads, other NAL units may change the state of any layer
+  xWaitForFinishedLayers( !nalu.isSlice() && !nalu.isSei() );
+#endif
+
   // Initialize entropy decoder
   m_cEntropyDecoder.setEntropyDecoder (&m_cCavlcDecoder);
   m_cEntropyDecoder.setBitstream      (nalu.m_Bitstream);
@@ -2687,9 +2956,15 @@ Bool TDecTop::decode(InputNALUnit& nalu, Int& iSkipFrame, Int& iPOCLastDisplay)
       m_associatedIRAPType = NAL_UNIT_INVALID;
       m_pocCRA = 0;
       m_pocRandomAccess = MAX_INT;
+#if SVC_EXTENSION
+      m_pcAuState->m_prevPOC = MAX_INT;
+      m_bFirstSliceInPicture = true;
+      m_pcAuState->m_bFirstSliceInSequence = true;
+#else
       m_prevPOC = MAX_INT;
       m_bFirstSliceInPicture = true;
       m_bFirstSliceInSequence = true;
+#endif
       m_prevSliceSkipped = false;
       m_skippedPOC = 0;
       return false;
@@ -2837,6 +3112,15 @@ Bool TDecTop::isRandomAccessSkipPicture(Int& iSkipFrame,  Int& iPOCLastDisplay)
 }
 
 #if SVC_EXTENSION
+/** \param p decoders of all layers, the base layer decoder holds the access unit state and parameter sets shared by the layers
+ */
+Void TDecTop::setLayerDec( TDecTop **p )
+{
+  m_ppcTDecTop = p;
+  m_pcAuState  = &p[0]->m_cAuState;
+  m_parameterSetManagerDecoder.shareParameterSets( &p[0]->m_parameterSetManagerDecoder );
+}
+
 #if VPS_EXTN_DIRECT_REF_LAYERS
 TDecTop* TDecTop::getRefLayerDec( UInt refLayerIdc )
 {
@@ -3054,15 +3338,15 @@ Void TDecTop::initAsymLut(TComSlice *pcSlice)
 #if POC_RESET_RESTRICTIONS
 Void TDecTop::resetPocRestrictionCheckParameters()
 {
-  TDecTop::m_checkPocRestrictionsForCurrAu       = false;
-  TDecTop::m_pocResetIdcOrCurrAu                 = -1;
-  TDecTop::m_baseLayerIdrFlag                    = false;
-  TDecTop::m_baseLayerPicPresentFlag             = false;
-  TDecTop::m_baseLayerIrapFlag                   = false;
-  TDecTop::m_nonBaseIdrPresentFlag               = false;
-  TDecTop::m_nonBaseIdrType                      = -1;
-  TDecTop::m_picNonIdrWithRadlPresentFlag        = false;
-  TDecTop::m_picNonIdrNoLpPresentFlag            = false;
+  TDecTop::m_pcAuState->m_checkPocRestrictionsForCurrAu       = false;
+  TDecTop::m_pcAuState->m_pocResetIdcOrCurrAu                 = -1;
+  TDecTop::m_pcAuState->m_baseLayerIdrFlag                    = false;
+  TDecTop::m_pcAuState->m_baseLayerPicPresentFlag             = false;
+  TDecTop::m_pcAuState->m_baseLayerIrapFlag                   = false;
+  TDecTop::m_pcAuState->m_nonBaseIdrPresentFlag               = false;
+  TDecTop::m_pcAuState->m_nonBaseIdrType                      = -1;
+  TDecTop::m_pcAuState->m_picNonIdrWithRadlPresentFlag        = false;
+  TDecTop::m_pcAuState->m_picNonIdrNoLpPresentFlag            = false;
 }
 #endif
 #endif //SVC_EXTENSION
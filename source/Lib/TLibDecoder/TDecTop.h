@@ -44,6 +44,9 @@
 #include "TLibCommon/TComPic.h"
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/SEI.h"
+#if TOOL_THREAD_POOL
+#include "TLibCommon/TComThreadPool.h"
+#endif
 #if Q0048_CGS_3D_ASYMLUT
 #include "TLibCommon/TCom3DAsymLUT.h"
 #endif
@@ -63,6 +66,33 @@ struct InputNALUnit;
 // Class definition
 // ====================================================================================================================
 
+#if SVC_EXTENSION
+/// state of the current access unit, shared by the layer decoders of one bitstream
+struct TDecAuState
+{
+  UInt                    m_prevPOC;        // POC of the previous slice
+  UInt                    m_uiPrevLayerId;  // LayerId of the previous slice
+  Bool                    m_bFirstSliceInSequence;
+#if POC_RESET_RESTRICTIONS
+  Bool                    m_checkPocRestrictionsForCurrAu;
+  Int                     m_pocResetIdcOrCurrAu;
+  Bool                    m_baseLayerIdrFlag;
+  Bool                    m_baseLayerPicPresentFlag;
+  Bool                    m_baseLayerIrapFlag;
+  Bool                    m_nonBaseIdrPresentFlag;
+  Int                     m_nonBaseIdrType;
+  Bool                    m_picNonIdrWithRadlPresentFlag;
+  Bool                    m_picNonIdrNoLpPresentFlag;
+#endif
+#if POC_RESET_VALUE_RESTRICTION
+  Int                     m_crossLayerPocResetPeriodId;
+  Int                     m_crossLayerPocResetIdc;
+#endif
+
+  TDecAuState();
+};
+#endif
+
 /// decoder class
 class TDecTop
 {
@@ -74,6 +104,13 @@ private:
   Int                     m_pocRandomAccess;   ///< POC number of the random access point (the first IDR or CRA picture)
 
   TComList<TComPic*>      m_cListPic;         //  Dynamic buffer
+  TComCodingContext       m_cCodingContext;   //  bit-depths and CU structure of the active SPS
+#if TOOL_THREAD_POOL
+  TComThreadPool*         m_pcThreadPool;     //  worker threads of the parallel decoding tools, shared by the layers
+#endif
+#if DEC_PICTURE_PIPELINE
+  TComThreadPool          m_cPictureQueue;    //  thread decoding and filtering the pictures of the layer in order, the layers run concurrently
+#endif
   ParameterSetManagerDecoder m_parameterSetManagerDecoder;  // storage for parameter sets 
   TComSlice*              m_apcSlicePilot;
 
@@ -96,6 +133,9 @@ private:
   SEIReader               m_seiReader;
   TComLoopFilter          m_cLoopFilter;
   TComSampleAdaptiveOffset m_cSAO;
+#if DEC_CTU_ROW_FILTER
+  TDecCtuRowFilter        m_cCtuRowFilter;
+#endif
 
   Bool isSkipPictureForBLA(Int& iPOCLastDisplay);
   Bool isRandomAccessSkipPicture(Int& iSkipFrame,  Int& iPOCLastDisplay);
@@ -120,9 +160,8 @@ private:
   Bool                    m_isLastNALWasEos;
 #endif
 #if SVC_EXTENSION
-  static UInt             m_prevPOC;        // POC of the previous slice
-  static UInt             m_uiPrevLayerId;  // LayerId of the previous slice
-  static Bool             m_bFirstSliceInSequence;
+  TDecAuState             m_cAuState;     // access unit state, used by all layers when held by the base layer decoder
+  TDecAuState*            m_pcAuState;    // access unit state of the base layer decoder
   UInt                    m_layerId;      
   UInt                    m_numLayer;
   TDecTop**               m_ppcTDecTop;
@@ -148,6 +187,10 @@ private:
   Bool                    m_motionPredEnabledFlag[MAX_VPS_LAYER_ID_PLUS1];
 #endif
   TComPic*                m_cIlpPic[MAX_NUM_REF];                    ///<  Inter layer Prediction picture =  upsampled picture
+#if ILR_ON_DEMAND_UPSAMPLING
+  Bool                    m_onDemandUpsampling;                      ///< resample the inter-layer reference pictures by CTU rows when they are first referenced
+  TComPicYuv*             m_pcIlpTempPic[MAX_NUM_REF];               ///< horizontally resampled reference layer pictures of the on-demand resampling
+#endif
 #endif 
 #if OUTPUT_LAYER_SET_INDEX
   CommonDecoderParams*    m_commonDecoderParams;
@@ -167,22 +210,6 @@ private:
                                            // When new VPS is activated, this should be re-initialized to -1
 #endif
 public:
-#if POC_RESET_RESTRICTIONS
-  static Bool                    m_checkPocRestrictionsForCurrAu;
-  static Int                     m_pocResetIdcOrCurrAu;
-  static Bool                    m_baseLayerIdrFlag;
-  static Bool                    m_baseLayerPicPresentFlag;
-  static Bool                    m_baseLayerIrapFlag;
-  static Bool                    m_nonBaseIdrPresentFlag;
-  static Int                     m_nonBaseIdrType;
-  static Bool                    m_picNonIdrWithRadlPresentFlag;
-  static Bool                    m_picNonIdrNoLpPresentFlag;
-#endif
-#if POC_RESET_VALUE_RESTRICTION
-  static Int                     m_crossLayerPocResetPeriodId;
-  static Int                     m_crossLayerPocResetIdc;
-#endif
-
   TDecTop();
   virtual ~TDecTop();
   
@@ -233,8 +260,20 @@ public:
   Void      setLayerId            (UInt layer) { m_layerId = layer; }
   UInt      getNumLayer           () { return m_numLayer;             }
   Void      setNumLayer           (UInt uiNum)   { m_numLayer = uiNum;  }
+#if ILR_ON_DEMAND_UPSAMPLING
+  Void      setOnDemandUpsampling ( Bool b )     { m_onDemandUpsampling = b; }
+#endif
   TComList<TComPic*>*      getListPic() { return &m_cListPic; }
-  Void      setLayerDec(TDecTop **p)    { m_ppcTDecTop = p; }
+  TComCodingContext&       getCodingContext() { return m_cCodingContext; }
+#if TOOL_THREAD_POOL
+  Void                     setThreadPool( TComThreadPool* pcThreadPool );
+  TComThreadPool*          getThreadPool() { return m_pcThreadPool; }
+#endif
+#if DEC_PICTURE_PIPELINE
+  Void      waitForFinishedPictures ();                     ///< wait until the queued decoding and in-loop filtering of the pictures of the layer is done
+  Void      waitForFinishedPicture  ( TComPic* pcPic );     ///< wait until the decoding and the in-loop filtering of pcPic are done
+#endif
+  Void      setLayerDec(TDecTop **p);
   TDecTop*  getLayerDec(UInt layer)     { return m_ppcTDecTop[layer]; }
 #if VPS_EXTN_DIRECT_REF_LAYERS
   TDecTop*  getRefLayerDec(UInt refLayerIdc);
@@ -299,6 +338,11 @@ public:
 protected:
   Void  xGetNewPicBuffer  (TComSlice* pcSlice, TComPic*& rpcPic);
   Void  xCreateLostPicture (Int iLostPOC);
+#if DEC_PICTURE_PIPELINE
+  Void  xWaitForFinishedLayers( Bool bAllLayers );
+  Void  xDecompressSliceJob   ( TComInputBitstream* pcBitstream, TComPic* pcPic );
+  Void  xFilterPictureJob     ( TComPic* pcPic );
+#endif
 
   Void      xActivateParameterSets();
 #if SVC_EXTENSION
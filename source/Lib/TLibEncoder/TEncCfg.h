@@ -158,6 +158,15 @@ protected:
   Int       m_iFastSearch;                      //  0:Full search  1:Diamond  2:PMVFAST
   Int       m_iSearchRange;                     //  0:Full frame
   Int       m_bipredSearchRange;
+#if IL_MOTION_SEED
+  Int       m_ilMotionSeed;                     //  0:off  1:BL motion start points  2:and reduced search range
+#endif
+#if LOOKAHEAD_ME
+  Int       m_lookaheadME;                      //  0:off  1:start points of the lookahead ME  2:and reduced search range
+#endif
+#if PARALLEL_ME
+  Int       m_numMEThreads;                     //  0, 1:serial  >1:concurrent searches of the reference pictures of a PU
+#endif
 
   //====== Quality control ========
   Int       m_iMaxDeltaQP;                      //  Max. absolute delta QP (1:default)
@@ -178,6 +187,9 @@ protected:
   Bool      m_bUseHADME;
   Bool      m_useRDOQ;
   Bool      m_useRDOQTS;
+#if FAST_RDOQ
+  Bool      m_useRDOQFast;
+#endif
   UInt      m_rdPenalty;
   Bool      m_bUseFastEnc;
   Bool      m_bUseEarlyCU;
@@ -276,7 +288,8 @@ protected:
   Bool      m_TransquantBypassEnableFlag;                     ///< transquant_bypass_enable_flag setting in PPS.
   Bool      m_CUTransquantBypassFlagForce;                    ///< if transquant_bypass_enable_flag, then, if true, all CU transquant bypass flags will be set to true.
 #if SVC_EXTENSION
-  static TComVPS             m_cVPS;
+  TComVPS*                   m_pcVPS;                         ///< VPS of the encoder instance, shared by all layers
+  Bool                       m_bOwnVPS;                       ///< VPS is allocated by this layer
 #else
   TComVPS                    m_cVPS;
 #endif
@@ -321,6 +334,9 @@ protected:
 #if M0040_ADAPTIVE_RESOLUTION_CHANGE
   Int       m_adaptiveResolutionChange;
 #endif
+#if ENC_LAYER_PIPELINE
+  Bool      m_layerPipeline;                                  ///< encode the layers of consecutive access units concurrently
+#endif
 #if O0153_ALT_OUTPUT_LAYER_FLAG
   Bool      m_altOutputLayerFlag;
 #endif
@@ -350,6 +366,12 @@ protected:
 #if FAST_INTRA_SHVC
   Bool      m_useFastIntraScalable;
 #endif
+#if FAST_CU_SHVC
+  Bool      m_useFastCUScalable;
+#endif
+#if FAST_INTRA_SEARCH
+  Bool      m_useFastIntraSearch;
+#endif
 #if LAYERS_NOT_PRESENT_SEI
   Int       m_layersNotPresentSEIEnabled;
 #endif
@@ -418,10 +440,21 @@ public:
   TEncCfg()
   : m_tileColumnWidth()
   , m_tileRowHeight()
+#if SVC_EXTENSION
+  , m_pcVPS( new TComVPS )
+  , m_bOwnVPS( true )
+#endif
   {}
 
   virtual ~TEncCfg()
-  {}
+  {
+#if SVC_EXTENSION
+    if( m_bOwnVPS )
+    {
+      delete m_pcVPS;
+    }
+#endif
+  }
   
   Void setProfile(Profile::Name profile) { m_profile = profile; }
   Void setLevel(Level::Tier tier, Level::Name level) { m_levelTier = tier; m_level = level; }
@@ -479,6 +512,15 @@ public:
   Void      setFastSearch                   ( Int   i )      { m_iFastSearch = i; }
   Void      setSearchRange                  ( Int   i )      { m_iSearchRange = i; }
   Void      setBipredSearchRange            ( Int   i )      { m_bipredSearchRange = i; }
+#if IL_MOTION_SEED
+  Void      setILMotionSeed                 ( Int   i )      { m_ilMotionSeed = i; }
+#endif
+#if LOOKAHEAD_ME
+  Void      setLookaheadME                  ( Int   i )      { m_lookaheadME = i; }
+#endif
+#if PARALLEL_ME
+  Void      setNumMEThreads                 ( Int   i )      { m_numMEThreads = i; }
+#endif
 
   //====== Quality control ========
   Void      setMaxDeltaQP                   ( Int   i )      { m_iMaxDeltaQP = i; }
@@ -531,6 +573,18 @@ public:
   //==== Motion search ========
   Int       getFastSearch                   ()      { return  m_iFastSearch; }
   Int       getSearchRange                  ()      { return  m_iSearchRange; }
+#if ENC_WPP_PARALLEL
+  Int       getBipredSearchRange            ()      { return  m_bipredSearchRange; }
+#if IL_MOTION_SEED
+  Int       getILMotionSeed                 ()      { return  m_ilMotionSeed; }
+#endif
+#endif
+#if LOOKAHEAD_ME
+  Int       getLookaheadME                  ()      { return  m_lookaheadME; }
+#endif
+#if PARALLEL_ME
+  Int       getNumMEThreads                 ()      { return  m_numMEThreads; }
+#endif
 
   //==== Quality control ========
   Int       getMaxDeltaQP                   ()      { return  m_iMaxDeltaQP; }
@@ -543,6 +597,9 @@ public:
   Void      setUseHADME                     ( Bool  b )     { m_bUseHADME   = b; }
   Void      setUseRDOQ                      ( Bool  b )     { m_useRDOQ    = b; }
   Void      setUseRDOQTS                    ( Bool  b )     { m_useRDOQTS  = b; }
+#if FAST_RDOQ
+  Void      setUseRDOQFast                  ( Bool  b )     { m_useRDOQFast = b; }
+#endif
   Void      setRDpenalty                 ( UInt  b )     { m_rdPenalty  = b; }
   Void      setUseFastEnc                   ( Bool  b )     { m_bUseFastEnc = b; }
   Void      setUseEarlyCU                   ( Bool  b )     { m_bUseEarlyCU = b; }
@@ -561,6 +618,9 @@ public:
   Bool      getUseHADME                     ()      { return m_bUseHADME;   }
   Bool      getUseRDOQ                      ()      { return m_useRDOQ;    }
   Bool      getUseRDOQTS                    ()      { return m_useRDOQTS;  }
+#if FAST_RDOQ
+  Bool      getUseRDOQFast                  ()      { return m_useRDOQFast; }
+#endif
   Int      getRDpenalty                  ()      { return m_rdPenalty;  }
   Bool      getUseFastEnc                   ()      { return m_bUseFastEnc; }
   Bool      getUseEarlyCU                   ()      { return m_bUseEarlyCU; }
@@ -809,8 +869,22 @@ public:
   Void      setTransquantBypassEnableFlag(Bool flag)  { m_TransquantBypassEnableFlag = flag; }
   Bool      getCUTransquantBypassFlagForceValue()          { return m_CUTransquantBypassFlagForce; }
   Void      setCUTransquantBypassFlagForceValue(Bool flag) { m_CUTransquantBypassFlagForce = flag; }
+#if SVC_EXTENSION
+  Void setVPS(TComVPS *p) { *m_pcVPS = *p; }
+  TComVPS *getVPS() { return m_pcVPS; }
+  Void shareVPS(TComVPS *p)                                   ///< use the VPS of another layer of the same encoder
+  {
+    if( m_bOwnVPS )
+    {
+      delete m_pcVPS;
+    }
+    m_pcVPS = p;
+    m_bOwnVPS = false;
+  }
+#else
   Void setVPS(TComVPS *p) { m_cVPS = *p; }
   TComVPS *getVPS() { return &m_cVPS; }
+#endif
   Void      setUseRecalculateQPAccordingToLambda ( Bool b ) { m_recalculateQPAccordingToLambda = b;    }
   Bool      getUseRecalculateQPAccordingToLambda ()         { return m_recalculateQPAccordingToLambda; }
 
@@ -904,6 +978,10 @@ public:
   Void      setAdaptiveResolutionChange(Int x) { m_adaptiveResolutionChange = x;    }
   Int       getAdaptiveResolutionChange()      { return m_adaptiveResolutionChange; }
 #endif
+#if ENC_LAYER_PIPELINE
+  Void      setLayerPipeline(Bool b)           { m_layerPipeline = b;    }
+  Bool      getLayerPipeline()                 { return m_layerPipeline; }
+#endif
 #if HIGHER_LAYER_IRAP_SKIP_FLAG
   Void      setSkipPictureAtArcSwitch(Int x) { m_skipPictureAtArcSwitch = x;    }
   Int       getSkipPictureAtArcSwitch()      { return m_skipPictureAtArcSwitch; }
@@ -924,6 +1002,14 @@ public:
   Bool      getUseFastIntraScalable         ()      { return m_useFastIntraScalable; }
   Void      setUseFastIntraScalable         ( Bool  b )     { m_useFastIntraScalable = b; }
 #endif
+#if FAST_CU_SHVC
+  Bool      getUseFastCUScalable            ()      { return m_useFastCUScalable; }
+  Void      setUseFastCUScalable            ( Bool  b )     { m_useFastCUScalable = b; }
+#endif
+#if FAST_INTRA_SEARCH
+  Bool      getUseFastIntraSearch           ()      { return m_useFastIntraSearch; }
+  Void      setUseFastIntraSearch           ( Bool  b )     { m_useFastIntraSearch = b; }
+#endif
 #if VPS_EXTN_DIRECT_REF_LAYERS
   Int       getNumDirectRefLayers           ()                              { return m_numDirectRefLayers;      }
   Void      setNumDirectRefLayers           (Int num)                       { m_numDirectRefLayers = num;       }
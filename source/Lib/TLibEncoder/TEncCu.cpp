@@ -198,12 +198,36 @@ Void TEncCu::destroy()
 /** \param    pcEncTop      pointer of encoder class
  */
 Void TEncCu::init( TEncTop* pcEncTop )
+{
+#if ENC_WPP_PARALLEL
+  init( pcEncTop, pcEncTop->getPredSearch(), pcEncTop->getTrQuant(), pcEncTop->getBitCounter(), pcEncTop->getRdCost(),
+        pcEncTop->getEntropyCoder(), pcEncTop->getRDSbacCoder(), pcEncTop->getRDGoOnSbacCoder() );
+}
+
+/** \param    pcEncTop           pointer of encoder class
+ *  \param    pcPredSearch       encoder search class
+ *  \param    pcTrQuant          transform & quantization class
+ *  \param    pcBitCounter       bit counter for RD optimization
+ *  \param    pcRdCost           RD cost computation class
+ *  \param    pcEntropyCoder     entropy encoder
+ *  \param    pppcRDSbacCoder    temporal storage for RD computation
+ *  \param    pcRDGoOnSbacCoder  going on SBAC model for RD stage
+ */
+Void TEncCu::init( TEncTop* pcEncTop, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComBitCounter* pcBitCounter, TComRdCost* pcRdCost,
+                   TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder )
 {
+  m_pcEncCfg           = pcEncTop;
+  m_pcPredSearch       = pcPredSearch;
+  m_pcTrQuant          = pcTrQuant;
+  m_pcBitCounter       = pcBitCounter;
+  m_pcRdCost           = pcRdCost;
+#else
   m_pcEncCfg           = pcEncTop;
   m_pcPredSearch       = pcEncTop->getPredSearch();
   m_pcTrQuant          = pcEncTop->getTrQuant();
   m_pcBitCounter       = pcEncTop->getBitCounter();
   m_pcRdCost           = pcEncTop->getRdCost();
+#endif
   
 #if SVC_EXTENSION
   m_ppcTEncTop         = pcEncTop->getLayerEnc();
@@ -214,13 +238,22 @@ Void TEncCu::init( TEncTop* pcEncTop )
   }
 #endif
   
+#if ENC_WPP_PARALLEL
+  m_pcEntropyCoder     = pcEntropyCoder;
+#else
   m_pcEntropyCoder     = pcEncTop->getEntropyCoder();
+#endif
   m_pcCavlcCoder       = pcEncTop->getCavlcCoder();
   m_pcSbacCoder       = pcEncTop->getSbacCoder();
   m_pcBinCABAC         = pcEncTop->getBinCABAC();
   
+#if ENC_WPP_PARALLEL
+  m_pppcRDSbacCoder   = pppcRDSbacCoder;
+  m_pcRDGoOnSbacCoder = pcRDGoOnSbacCoder;
+#else
   m_pppcRDSbacCoder   = pcEncTop->getRDSbacCoder();
   m_pcRDGoOnSbacCoder = pcEncTop->getRDGoOnSbacCoder();
+#endif
   
   m_pcRateCtrl        = pcEncTop->getRateCtrl();
 }
@@ -439,8 +472,27 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
 #else
   Bool bInsidePicture = ( uiRPelX < rpcBestCU->getSlice()->getSPS()->getPicWidthInLumaSamples() ) && ( uiBPelY < rpcBestCU->getSlice()->getSPS()->getPicHeightInLumaSamples() );
 #endif
+#if FAST_CU_SHVC
+  // depths of the co-located base layer CUs: the modes are tested from one depth above the smallest one,
+  // the CUs of skipped base layer blocks are not split beyond one depth below the largest one
+  Int  iBaseMinDepth = 0;
+  Int  iBaseMaxDepth = g_uiMaxCUDepth - g_uiAddCUDepth;
+  Bool bBaseSkipped  = false;
+  Bool bTestDepth    = true;
+#if ENCODER_FAST_MODE
+  Bool bILRTested    = false;
+#endif
+  if( m_pcEncCfg->getUseFastCUScalable() && rpcBestCU->getLayerId() > 0 && pcSlice->getActiveNumILRRefIdx() > 0 && bInsidePicture
+    && xGetBaseColDepthRange( rpcBestCU, iBaseMinDepth, iBaseMaxDepth, bBaseSkipped ) )
+  {
+    bTestDepth = (Int)uiDepth + 1 >= iBaseMinDepth;
+  }
+  // We need to split, so don't try these modes.
+  if(!bSliceEnd && !bSliceStart && bInsidePicture && bTestDepth )
+#else
   // We need to split, so don't try these modes.
   if(!bSliceEnd && !bSliceStart && bInsidePicture )
+#endif
   {
 #if HIGHER_LAYER_IRAP_SKIP_FLAG
     if (m_pcEncCfg->getSkipPictureAtArcSwitch() && m_pcEncCfg->getAdaptiveResolutionChange() > 0 && pcSlice->getLayerId() == 1 && pcSlice->getPOC() == m_pcEncCfg->getAdaptiveResolutionChange())
@@ -501,6 +553,26 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
         // SKIP
         xCheckRDCostMerge2Nx2N( rpcBestCU, rpcTempCU, &earlyDetectionSkipMode );//by Merge for inter_2Nx2N
         rpcTempCU->initEstData( uiDepth, iQP, bIsLosslessMode );
+#if FAST_CU_SHVC && ENCODER_FAST_MODE
+        // the inter-layer reference is tried before the other partitions when the base layer is skipped
+#if N0383_IL_CONSTRAINED_TILE_SETS_SEI
+        if( bBaseSkipped && !earlyDetectionSkipMode && !m_disableILP )
+#else
+        if( bBaseSkipped && !earlyDetectionSkipMode )
+#endif
+        {
+          for(Int refLayer = 0; refLayer < pcSlice->getActiveNumILRRefIdx(); refLayer++)
+          {
+            xCheckRDCostILRUni( rpcBestCU, rpcTempCU, pcSlice->getVPS()->getRefLayerId( pcSlice->getLayerId(), pcSlice->getInterLayerPredLayerIdc(refLayer) ) );
+            rpcTempCU->initEstData( uiDepth, iQP, bIsLosslessMode );
+          }
+          if(m_pcEncCfg->getUseCbfFastMode())
+          {
+            doNotBlockPu = rpcBestCU->getQtRootCbf( 0 ) != 0;
+          }
+          bILRTested = true;
+        }
+#endif
         
 #if (ENCODER_FAST_MODE == 2)
         if (testInter)
@@ -578,7 +650,11 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
 
 #if 1
           //! Try AMP (SIZE_2NxnU, SIZE_2NxnD, SIZE_nLx2N, SIZE_nRx2N)
+#if FAST_CU_SHVC
+          if( pcPic->getSlice(0)->getSPS()->getAMPAcc(uiDepth) && !bBaseSkipped )
+#else
           if( pcPic->getSlice(0)->getSPS()->getAMPAcc(uiDepth) )
+#endif
           {
 #if AMP_ENC_SPEEDUP        
             Bool bTestAMP_Hor = false, bTestAMP_Ver = false;
@@ -692,6 +768,11 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
         }
 
         // do normal intra modes
+#if FAST_CU_SHVC
+        // no intra for the CUs of skipped base layer blocks
+        if( !bBaseSkipped || rpcBestCU->getPredictionMode(0) == MODE_NONE )
+        {
+#endif
           // speedup for inter frames
 #if (ENCODER_FAST_MODE)
         if( rpcBestCU->getSlice()->getSliceType() == I_SLICE || 
@@ -718,6 +799,9 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
             }
           }
         }
+#if FAST_CU_SHVC
+        }
+#endif
 
         // test PCM
         if(pcPic->getSlice(0)->getSPS()->getUsePCM()
@@ -733,8 +817,12 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
           }
         }
 #if (ENCODER_FAST_MODE)
-#if N0383_IL_CONSTRAINED_TILE_SETS_SEI
+#if N0383_IL_CONSTRAINED_TILE_SETS_SEI && FAST_CU_SHVC
+        if(pcPic->getLayerId() > 0 && !m_disableILP && !bILRTested)
+#elif N0383_IL_CONSTRAINED_TILE_SETS_SEI
         if(pcPic->getLayerId() > 0 && !m_disableILP)
+#elif FAST_CU_SHVC
+        if(pcPic->getLayerId() > 0 && !bILRTested)
 #else
         if(pcPic->getLayerId() > 0)
 #endif
@@ -769,11 +857,21 @@ Void TEncCu::xCompressCU( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt u
     {
       bSubBranch = true;
     }
+#if FAST_CU_SHVC
+    if( (Int)uiDepth > iBaseMaxDepth && bBaseSkipped )
+    {
+      bSubBranch = false;
+    }
+#endif
 #if HIGHER_LAYER_IRAP_SKIP_FLAG
     }
 #endif
   }
+#if FAST_CU_SHVC
+  else if(!(bSliceEnd && bInsidePicture) && bTestDepth)
+#else
   else if(!(bSliceEnd && bInsidePicture))
+#endif
   {
     bBoundary = true;
   }
@@ -1048,8 +1146,17 @@ Void TEncCu::finishCU( TComDataCU* pcCU, UInt uiAbsPartIdx, UInt uiDepth )
   }
   if(granularityBoundary)
   {
+#if ENC_WPP_PARALLEL
+    // the slice bits are only needed by the slice modes limiting the number of bytes, the rows of a wavefront-parallel slice do not share them
+    if( pcSlice->getSliceMode()==FIXED_NUMBER_OF_BYTES || pcSlice->getSliceSegmentMode()==FIXED_NUMBER_OF_BYTES )
+    {
+      pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
+      pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
+    }
+#else
     pcSlice->setSliceBits( (UInt)(pcSlice->getSliceBits() + numberOfWrittenBits) );
     pcSlice->setSliceSegmentBits(pcSlice->getSliceSegmentBits()+numberOfWrittenBits);
+#endif
     if (m_pcBitCounter)
     {
       m_pcEntropyCoder->resetBits();      
@@ -1926,5 +2033,63 @@ Void TEncCu::xCheckRDCostILRUni(TComDataCU *&rpcBestCU, TComDataCU *&rpcTempCU,
   return;
 }
 #endif
+#if FAST_CU_SHVC
+/** derive the depths of the base layer CUs co-located with an enhancement layer CU
+ *\param   pcCU
+ *\param   riMinDepth smallest depth of the base layer CUs, as the depth of the enhancement layer CU of the same size
+ *\param   riMaxDepth largest depth of the base layer CUs, as the depth of the enhancement layer CU of the same size
+ *\param   rbBaseSkipped true if all the base layer CUs are skipped
+ *\returns false if the CU has no co-located base layer CU
+ */
+Bool TEncCu::xGetBaseColDepthRange( TComDataCU* pcCU, Int& riMinDepth, Int& riMaxDepth, Bool& rbBaseSkipped )
+{
+  TComSlice* pcSlice     = pcCU->getSlice();
+  const UInt refLayerIdc = pcSlice->getInterLayerPredLayerIdc(0);
+#if LAYER_CTB
+  const UInt uiBaseMaxCUWidth = pcSlice->getBaseColPic(refLayerIdc)->getPicSym()->getMaxCUWidth();
+#else
+  const UInt uiBaseMaxCUWidth = g_uiMaxCUWidth;
+#endif
+  const Int  iMaxDepth   = g_uiMaxCUDepth - g_uiAddCUDepth;
+  const UInt uiWidth     = pcCU->getWidth(0);
+  const UInt uiStep      = std::max<UInt>( uiWidth >> 2, 8 );
+  Bool bFound = false;
+
+  riMinDepth    = iMaxDepth;
+  riMaxDepth    = 0;
+  rbBaseSkipped = true;
+  // the base layer is sampled at the centres of a grid of at most 4x4 blocks
+  for( UInt y = uiStep >> 1; y < uiWidth; y += uiStep )
+  {
+    for( UInt x = uiStep >> 1; x < uiWidth; x += uiStep )
+    {
+      UInt uiCUAddrBase = 0, uiAbsPartIdxBase = 0;
+      TComDataCU* pcBaseCU = pcCU->getBaseColCU( refLayerIdc, pcCU->getCUPelX() + x, pcCU->getCUPelY() + y, uiCUAddrBase, uiAbsPartIdxBase );
+      if( pcBaseCU == NULL )
+      {
+        continue;
+      }
+      // width of the base layer CU scaled to the enhancement layer
+      UInt uiBaseWidth = ( ( uiBaseMaxCUWidth >> pcBaseCU->getDepth( uiAbsPartIdxBase ) ) << 16 ) / pcSlice->getPosScalingFactor( refLayerIdc, 0 );
+      Int  iDepth = 0;
+      while( iDepth < iMaxDepth && ( g_uiMaxCUWidth >> iDepth ) > uiBaseWidth )
+      {
+        iDepth++;
+      }
+      riMinDepth     = std::min( riMinDepth, iDepth );
+      riMaxDepth     = std::max( riMaxDepth, iDepth );
+      rbBaseSkipped &= pcBaseCU->isSkipped( uiAbsPartIdxBase );
+      bFound = true;
+    }
+  }
+  if( !bFound )
+  {
+    riMinDepth    = 0;
+    riMaxDepth    = iMaxDepth;
+    rbBaseSkipped = false;
+  }
+  return bFound;
+}
+#endif
 #endif //SVC_EXTENSION
 //! \}
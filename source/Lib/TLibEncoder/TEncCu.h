@@ -107,6 +107,11 @@ private:
 public:
   /// copy parameters from encoder class
   Void  init                ( TEncTop* pcEncTop );
+#if ENC_WPP_PARALLEL
+  /// use the given coding classes instead of the ones of the encoder class
+  Void  init                ( TEncTop* pcEncTop, TEncSearch* pcPredSearch, TComTrQuant* pcTrQuant, TComBitCounter* pcBitCounter, TComRdCost* pcRdCost,
+                              TEncEntropy* pcEntropyCoder, TEncSbac*** pppcRDSbacCoder, TEncSbac* pcRDGoOnSbacCoder );
+#endif
   
   /// create internal buffers
   Void  create              ( UChar uhTotalDepth, UInt iMaxWidth, UInt iMaxHeight );
@@ -176,6 +181,9 @@ protected:
 #if ENCODER_FAST_MODE
   Void  xCheckRDCostILRUni  ( TComDataCU*& rpcBestCU, TComDataCU*& rpcTempCU, UInt refLayerId);
 #endif
+#if FAST_CU_SHVC
+  Bool  xGetBaseColDepthRange( TComDataCU* pcCU, Int& riMinDepth, Int& riMaxDepth, Bool& rbBaseSkipped );
+#endif
 #if N0383_IL_CONSTRAINED_TILE_SETS_SEI
   Bool xCheckTileSetConstraint( TComDataCU*& rpcCU );
   Void xVerifyTileSetConstraint( TComDataCU*& rpcCU );
@@ -1002,6 +1002,13 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       }
       if (m_pcEncTop->getNoClrasOutputFlag())
       {
+#if ENC_LAYER_PIPELINE
+        if (m_pcEncTop->getLayerPipeline())
+        {
+          // the higher layers must not be reset while still coding the previous access unit
+          m_pcEncTop->waitForHigherLayers();
+        }
+#endif
         for (UInt i = 0; i < m_pcCfg->getNumLayer(); i++)
         {
           m_ppcTEncTop[i]->setLayerInitializedFlag(false);
@@ -1197,11 +1204,11 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
 #endif
 #endif
 
-        g_mvScalingFactor[refLayerIdc][0] = widthEL  == widthBL  ? 4096 : Clip3(-4096, 4095, ((widthEL  << 8) + (widthBL  >> 1)) / widthBL);
-        g_mvScalingFactor[refLayerIdc][1] = heightEL == heightBL ? 4096 : Clip3(-4096, 4095, ((heightEL << 8) + (heightBL >> 1)) / heightBL);
+        pcSlice->setMvScalingFactor(refLayerIdc, 0, widthEL  == widthBL  ? 4096 : Clip3(-4096, 4095, ((widthEL  << 8) + (widthBL  >> 1)) / widthBL));
+        pcSlice->setMvScalingFactor(refLayerIdc, 1, heightEL == heightBL ? 4096 : Clip3(-4096, 4095, ((heightEL << 8) + (heightBL >> 1)) / heightBL));
 
-        g_posScalingFactor[refLayerIdc][0] = ((widthBL  << 16) + (widthEL  >> 1)) / widthEL;
-        g_posScalingFactor[refLayerIdc][1] = ((heightBL << 16) + (heightEL >> 1)) / heightEL;
+        pcSlice->setPosScalingFactor(refLayerIdc, 0, ((widthBL  << 16) + (widthEL  >> 1)) / widthEL);
+        pcSlice->setPosScalingFactor(refLayerIdc, 1, ((heightBL << 16) + (heightEL >> 1)) / heightEL);
 
 #if Q0048_CGS_3D_ASYMLUT 
         TComPicYuv* pBaseColRec = pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec();
@@ -1212,10 +1219,10 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
           m_Enc3DAsymLUTPPS.addRefLayerId( pcSlice->getVPS()->getRefLayerId(m_layerId, refLayerIdc) );
           m_Enc3DAsymLUTPicUpdate.addRefLayerId( pcSlice->getVPS()->getRefLayerId(m_layerId, refLayerIdc) );
 #endif
-          if(g_posScalingFactor[refLayerIdc][0] < (1<<16) || g_posScalingFactor[refLayerIdc][1] < (1<<16)) //if(pcPic->isSpatialEnhLayer(refLayerIdc))
+          if(pcSlice->getPosScalingFactor(refLayerIdc, 0) < (1<<16) || pcSlice->getPosScalingFactor(refLayerIdc, 1) < (1<<16)) //if(pcPic->isSpatialEnhLayer(refLayerIdc))
           {
             //downsampling;
-            downScalePic(pcPic->getPicYuvOrg(), pcSlice->getBaseColPic(refLayerIdc)->getPicYuvOrg());
+            downScalePic(pcPic->getPicYuvOrg(), pcSlice->getBaseColPic(refLayerIdc)->getPicYuvOrg(), pcSlice->getPosScalingFactor(0, 0));
             //pcSlice->getBaseColPic(refLayerIdc)->getPicYuvOrg()->dump("ds.yuv", true, true);
             m_Enc3DAsymLUTPPS.setDsOrigPic(pcSlice->getBaseColPic(refLayerIdc)->getPicYuvOrg());
             m_Enc3DAsymLUTPicUpdate.setDsOrigPic(pcSlice->getBaseColPic(refLayerIdc)->getPicYuvOrg());
@@ -1229,7 +1236,11 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
           Bool bSignalPPS = m_bSeqFirst;
           bSignalPPS |= m_pcCfg->getGOPSize() > 1 ? pocCurr % m_pcCfg->getIntraPeriod() == 0 : pocCurr % m_pcCfg->getFrameRate() == 0;
           xDetermin3DAsymLUT( pcSlice , pcPic , refLayerIdc , m_pcCfg , bSignalPPS );
+#if TOOL_THREAD_POOL
+          m_Enc3DAsymLUTPPS.colorMapping( pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(),  m_pColorMappedPic, m_pcEncTop->getThreadPool() );
+#else
           m_Enc3DAsymLUTPPS.colorMapping( pcSlice->getBaseColPic(refLayerIdc)->getPicYuvRec(),  m_pColorMappedPic );
+#endif
           pBaseColRec = m_pColorMappedPic;
         }
 #endif
@@ -1999,6 +2010,12 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     {
       m_pcSliceEncoder->setSearchRange(pcSlice);
     }
+#if LOOKAHEAD_ME
+    if ( m_pcCfg->getLookaheadME() && !pcSlice->isIntra() )
+    {
+      m_pcEncTop->getPreanalyzer()->xEstimateMotion( dynamic_cast<TEncPic*>( pcPic ), pcSlice, m_pcCfg->getSearchRange() );
+    }
+#endif
 
     Bool bGPBcheck=false;
     if ( pcSlice->getSliceType() == B_SLICE)
@@ -2153,6 +2170,14 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     pcSbacCoders = m_pcEncTop->getSbacCoders();
     pcSubstreamsOut = new TComOutputBitstream[iNumSubstreams];
 
+#if ENC_LAYER_PIPELINE
+    if( m_pcEncTop->getLayerPipeline() )
+    {
+      // lower layer picture lists are not accessed anymore, the lower layers may continue with the next access unit
+      m_pcEncTop->signalPicSetUp();
+    }
+#endif
+
     UInt startCUAddrSliceIdx = 0; // used to index "m_uiStoredStartCUAddrForEncodingSlice" containing locations of slice boundaries
     UInt startCUAddrSlice    = 0; // used to keep track of current slice's starting CU addr.
     pcSlice->setSliceCurStartCUAddr( startCUAddrSlice ); // Setting "start CU addr" for current slice
@@ -2274,7 +2299,11 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
     {
       dblMetric(pcPic, uiNumSlices);
     }
+#if LOOP_FILTER_PARALLEL
+    m_pcLoopFilter->loopFilterPic( pcPic, m_pcEncTop->getThreadPool() );
+#else
     m_pcLoopFilter->loopFilterPic( pcPic );
+#endif
 
     /////////////////////////////////////////////////////////////////////////////////////////////////// File writing
     // Set entropy coder
@@ -3170,6 +3199,9 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
         accessUnit.insert(it, new NALUnitEBSP(nalu));
       }
 
+#if ENC_LAYER_PIPELINE
+      std::unique_lock<std::mutex> cOutputLock( g_cOutputMutex );
+#endif
       xCalculateAddPSNR( pcPic, pcPic->getPicYuvRec(), accessUnit, dEncTime );
 
       //In case of field coding, compute the interlaced PSNR for both fields
@@ -3433,6 +3465,9 @@ Void TEncGOP::compressGOP( Int iPOCLast, Int iNumPicRcvd, TComList<TComPic*>& rc
       /* logging: insert a newline at end of picture period */
       printf("\n");
       fflush(stdout);
+#if ENC_LAYER_PIPELINE
+      cOutputLock.unlock();
+#endif
 
       delete[] pcSubstreamsOut;
 
@@ -3851,7 +3886,11 @@ Void TEncGOP::preLoopFilterPicAll( TComPic* pcPic, UInt64& ruiDist, UInt64& ruiB
   TComSlice* pcSlice = pcPic->getSlice(pcPic->getCurrSliceIdx());
   Bool bCalcDist = false;
   m_pcLoopFilter->setCfg(m_pcCfg->getLFCrossTileBoundaryFlag());
+#if LOOP_FILTER_PARALLEL
+  m_pcLoopFilter->loopFilterPic( pcPic, m_pcEncTop->getThreadPool() );
+#else
   m_pcLoopFilter->loopFilterPic( pcPic );
+#endif
   
   m_pcEntropyCoder->setEntropyCoder ( m_pcEncTop->getRDGoOnSbacCoder(), pcSlice );
   m_pcEntropyCoder->resetEntropy    ();
@@ -4220,10 +4259,10 @@ Void TEncGOP::xCalculateAddPSNR( TComPic* pcPic, TComPicYuv* pcPicD, const Acces
 #if POC_RESET_IDC_ENCODER
         UInt refLayerId = pcSlice->getRefPic(RefPicList(iRefList), iRefIndex)->getLayerId();
         UInt refLayerIdc = pcSlice->getReferenceLayerIdc(refLayerId);
-        assert( g_posScalingFactor[refLayerIdc][0] );
-        assert( g_posScalingFactor[refLayerIdc][1] );
+        assert( pcSlice->getPosScalingFactor(refLayerIdc, 0) );
+        assert( pcSlice->getPosScalingFactor(refLayerIdc, 1) );
 
-        printf( "%d(%d, {%1.2f, %1.2f}x)", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex), refLayerId, 65536.0/g_posScalingFactor[refLayerIdc][0], 65536.0/g_posScalingFactor[refLayerIdc][1] );
+        printf( "%d(%d, {%1.2f, %1.2f}x)", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex), refLayerId, 65536.0/pcSlice->getPosScalingFactor(refLayerIdc, 0), 65536.0/pcSlice->getPosScalingFactor(refLayerIdc, 1) );
 #else
         printf( "%d(%d)", pcSlice->getRefPOC(RefPicList(iRefList), iRefIndex)-pcSlice->getLastIDR(), pcSlice->getRefPic(RefPicList(iRefList), iRefIndex)->getLayerId() );
 #endif
@@ -5059,7 +5098,7 @@ Void TEncGOP::xDetermin3DAsymLUT( TComSlice * pSlice , TComPic * pCurPic , UInt
   pSlice->getPPS()->setCGSOutputBitDepthC( m_Enc3DAsymLUTPPS.getOutputBitDepthC() );
 }
 
-Void TEncGOP::downScalePic( TComPicYuv* pcYuvSrc, TComPicYuv* pcYuvDest)
+Void TEncGOP::downScalePic( TComPicYuv* pcYuvSrc, TComPicYuv* pcYuvDest, Int posScalingFactor )
 {
   Int inputBitDepth = g_bitDepthYLayer[m_layerId];
   Int outputBitDepth = g_bitDepthYLayer[m_layerId];
@@ -5073,7 +5112,7 @@ Void TEncGOP::downScalePic( TComPicYuv* pcYuvSrc, TComPicYuv* pcYuvDest)
 
     if(!m_temp)
     {
-      initDs(iWidth, iHeight, m_pcCfg->getIntraPeriod()>1);
+      initDs(iWidth, iHeight, m_pcCfg->getIntraPeriod()>1, posScalingFactor);
     }
 
     filterImg(pcYuvSrc->getLumaAddr(), pcYuvSrc->getStride(), pcYuvDest->getLumaAddr(), pcYuvDest->getStride(), iHeight, iWidth,  inputBitDepth-outputBitDepth, 0);
@@ -5205,10 +5244,10 @@ Void TEncGOP::filterImg(
   }
 }
 
-Void TEncGOP::initDs(Int iWidth, Int iHeight, Int iType)
+Void TEncGOP::initDs(Int iWidth, Int iHeight, Int iType, Int posScalingFactor)
 {
   m_iTap = 13;
-  if(g_posScalingFactor[0][0] == (1<<15))
+  if(posScalingFactor == (1<<15))
   {
     m_iM = 4;
     m_iN = 8;
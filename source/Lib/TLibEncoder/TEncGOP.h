@@ -260,10 +260,10 @@ protected:
 #endif
 #if Q0048_CGS_3D_ASYMLUT
   Void xDetermin3DAsymLUT( TComSlice * pSlice , TComPic * pCurPic , UInt refLayerIdc , TEncCfg * pCfg , Bool bSignalPPS );
-  Void downScalePic( TComPicYuv* pcYuvSrc, TComPicYuv* pcYuvDest);
+  Void downScalePic( TComPicYuv* pcYuvSrc, TComPicYuv* pcYuvDest, Int posScalingFactor );
   Void downScaleComponent2x2( const Pel* pSrc, Pel* pDest, const Int iSrcStride, const Int iDestStride, const Int iSrcWidth, const Int iSrcHeight, const Int inputBitDepth, const Int outputBitDepth );
   inline Short  xClip( Short x , Int bitdepth );
-  Void initDs(Int iWidth, Int iHeight, Int iType);
+  Void initDs(Int iWidth, Int iHeight, Int iType, Int posScalingFactor);
   Void filterImg(
     Pel           *src,
     Int           iSrcStride,
@@ -105,7 +105,20 @@ Void TEncPicQPAdaptationLayer::destroy()
 TEncPic::TEncPic()
 : m_acAQLayer(NULL)
 , m_uiMaxAQDepth(0)
+#if LOOKAHEAD_ME
+, m_iNumLookaheadMvFields(0)
+#endif
 {
+#if LOOKAHEAD_ME
+  m_apPyramidY[0] = m_apPyramidY[1] = NULL;
+  m_aiPyramidWidth[0] = m_aiPyramidWidth[1] = 0;
+  m_aiPyramidHeight[0] = m_aiPyramidHeight[1] = 0;
+  for ( Int i = 0; i < 2*MAX_NUM_REF; i++ )
+  {
+    m_aiLookaheadRefPOC[i] = 0;
+    m_apcLookaheadMvField[i] = NULL;
+  }
+#endif
 }
 
 /** Destructor
@@ -177,7 +190,74 @@ Void TEncPic::destroy()
     delete[] m_acAQLayer;
     m_acAQLayer = NULL;
   }
+#if LOOKAHEAD_ME
+  for ( Int i = 0; i < 2; i++ )
+  {
+    delete[] m_apPyramidY[i];
+    m_apPyramidY[i] = NULL;
+  }
+  for ( Int i = 0; i < 2*MAX_NUM_REF; i++ )
+  {
+    delete[] m_apcLookaheadMvField[i];
+    m_apcLookaheadMvField[i] = NULL;
+  }
+  m_iNumLookaheadMvFields = 0;
+#endif
   TComPic::destroy();
 }
+
+#if LOOKAHEAD_ME
+/** Allocate the half and quarter resolution copies of the luma of the source picture, once for the lifetime of the picture
+ * \return Void
+ */
+Void TEncPic::createPyramid()
+{
+  if ( m_apPyramidY[0] )
+  {
+    return;
+  }
+  Int iWidth  = getPicYuvOrg()->getWidth();
+  Int iHeight = getPicYuvOrg()->getHeight();
+  for ( Int i = 0; i < 2; i++ )
+  {
+    iWidth  >>= 1;
+    iHeight >>= 1;
+    m_aiPyramidWidth [i] = iWidth;
+    m_aiPyramidHeight[i] = iHeight;
+    m_apPyramidY     [i] = new Pel[ iWidth * iHeight ];
+  }
+}
+
+/** Motion field of the 8x8 blocks towards a reference picture, the fields of the previous content of the picture are reused
+ * \param iRefPOC POC of the reference picture
+ * \return motion field in raster order of the 8x8 blocks
+ */
+TComMv* TEncPic::addLookaheadMvField( Int iRefPOC )
+{
+  assert( m_iNumLookaheadMvFields < 2*MAX_NUM_REF );
+  if ( m_apcLookaheadMvField[m_iNumLookaheadMvFields] == NULL )
+  {
+    m_apcLookaheadMvField[m_iNumLookaheadMvFields] = new TComMv[ getLookaheadMvStride() * ( ( getPicYuvOrg()->getHeight() + 7 ) >> 3 ) ];
+  }
+  m_aiLookaheadRefPOC[m_iNumLookaheadMvFields] = iRefPOC;
+  return m_apcLookaheadMvField[m_iNumLookaheadMvFields++];
+}
+
+/** Motion field of the 8x8 blocks towards a reference picture
+ * \param iRefPOC POC of the reference picture
+ * \return motion field, NULL when it has not been estimated
+ */
+TComMv* TEncPic::getLookaheadMvField( Int iRefPOC )
+{
+  for ( Int i = 0; i < m_iNumLookaheadMvFields; i++ )
+  {
+    if ( m_aiLookaheadRefPOC[i] == iRefPOC )
+    {
+      return m_apcLookaheadMvField[i];
+    }
+  }
+  return NULL;
+}
+#endif
 //! \}
 
@@ -99,6 +99,14 @@ class TEncPic : public TComPic
 private:
   TEncPicQPAdaptationLayer* m_acAQLayer;
   UInt                      m_uiMaxAQDepth;
+#if LOOKAHEAD_ME
+  Pel*                      m_apPyramidY[2];                        ///< luma of the source picture at half and quarter resolution
+  Int                       m_aiPyramidWidth[2];
+  Int                       m_aiPyramidHeight[2];
+  Int                       m_iNumLookaheadMvFields;
+  Int                       m_aiLookaheadRefPOC[2*MAX_NUM_REF];
+  TComMv*                   m_apcLookaheadMvField[2*MAX_NUM_REF];   ///< integer motion of the 8x8 blocks of the source picture, in quarter samples
+#endif
 
 public:
   TEncPic();
@@ -121,6 +129,18 @@ public:
 
   TEncPicQPAdaptationLayer* getAQLayer( UInt uiDepth )  { return &m_acAQLayer[uiDepth]; }
   UInt                      getMaxAQDepth()             { return m_uiMaxAQDepth;        }
+
+#if LOOKAHEAD_ME
+  Void                      createPyramid();
+  Pel*                      getPyramidY( Int iLevel )       { return m_apPyramidY[iLevel-1];     }  ///< iLevel 1: half, 2: quarter resolution
+  Int                       getPyramidWidth( Int iLevel )   { return m_aiPyramidWidth[iLevel-1];  }
+  Int                       getPyramidHeight( Int iLevel )  { return m_aiPyramidHeight[iLevel-1]; }
+
+  Void                      clearLookaheadMvFields()        { m_iNumLookaheadMvFields = 0; }
+  TComMv*                   addLookaheadMvField( Int iRefPOC );
+  TComMv*                   getLookaheadMvField( Int iRefPOC );
+  Int                       getLookaheadMvStride()          { return ( getPicYuvOrg()->getWidth() + 7 ) >> 3; }
+#endif
 };
 
 //! \}
@@ -137,5 +137,195 @@ Void TEncPreanalyzer::xPreanalyze( TEncPic* pcEPic )
     pcAQLayer->setAvgActivity( dAvgAct );
   }
 }
+
+#if LOOKAHEAD_ME
+/** Compute the half and quarter resolution luma of a source picture by averaging 2x2 samples
+ * \param pcEPic Picture object to be analyzed
+ * \return Void
+ */
+Void TEncPreanalyzer::xBuildPyramid( TEncPic* pcEPic )
+{
+  pcEPic->createPyramid();
+  pcEPic->clearLookaheadMvFields();
+
+  const Pel* pSrc = pcEPic->getPicYuvOrg()->getLumaAddr();
+  Int iSrcStride  = pcEPic->getPicYuvOrg()->getStride();
+  for ( Int iLevel = 1; iLevel <= 2; iLevel++ )
+  {
+    Pel* pDst = pcEPic->getPyramidY( iLevel );
+    const Int iWidth  = pcEPic->getPyramidWidth ( iLevel );
+    const Int iHeight = pcEPic->getPyramidHeight( iLevel );
+    for ( Int y = 0; y < iHeight; y++ )
+    {
+      const Pel* pLine0 = pSrc + 2 * y * iSrcStride;
+      const Pel* pLine1 = pLine0 + iSrcStride;
+      for ( Int x = 0; x < iWidth; x++ )
+      {
+        pDst[y * iWidth + x] = ( pLine0[2*x] + pLine0[2*x+1] + pLine1[2*x] + pLine1[2*x+1] + 2 ) >> 2;
+      }
+    }
+    pSrc       = pDst;
+    iSrcStride = iWidth;
+  }
+}
+
+/** Motion estimation of the source pictures for the reference pictures of a slice which have no motion field yet
+ * \param pcEPic       Picture object to be analyzed
+ * \param pcSlice      slice with the reference picture lists
+ * \param iSearchRange search range of the motion estimation in samples
+ * \return Void
+ */
+Void TEncPreanalyzer::xEstimateMotion( TEncPic* pcEPic, TComSlice* pcSlice, Int iSearchRange )
+{
+  const Int iNumLists = pcSlice->isInterB() ? 2 : ( pcSlice->isInterP() ? 1 : 0 );
+  const Int iMvWeight = 4 << ( pcSlice->getSPS()->getBitDepthY() - 8 );
+  for ( Int iList = 0; iList < iNumLists; iList++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < pcSlice->getNumRefIdx( RefPicList( iList ) ); iRefIdx++ )
+    {
+      TComPic* pcRefPic = pcSlice->getRefPic( RefPicList( iList ), iRefIdx );
+#if SVC_EXTENSION
+      if ( pcRefPic->isILR( pcEPic->getLayerId() ) )
+      {
+        continue;
+      }
+#endif
+      TEncPic* pcERefPic = dynamic_cast<TEncPic*>( pcRefPic );
+      if ( pcERefPic == NULL || pcEPic->getLookaheadMvField( pcRefPic->getPOC() ) != NULL )
+      {
+        continue;
+      }
+      xEstimateMotionField( pcEPic, pcERefPic, iSearchRange, iMvWeight, pcEPic->addLookaheadMvField( pcRefPic->getPOC() ) );
+    }
+  }
+}
+
+/** Sum of absolute differences of two blocks
+ */
+static UInt xBlockSad( const Pel* pCur, Int iCurStride, const Pel* pRef, Int iRefStride, Int iWidth, Int iHeight )
+{
+  UInt uiSad = 0;
+  for ( Int y = 0; y < iHeight; y++ )
+  {
+    for ( Int x = 0; x < iWidth; x++ )
+    {
+      uiSad += abs( pCur[x] - pRef[x] );
+    }
+    pCur += iCurStride;
+    pRef += iRefStride;
+  }
+  return uiSad;
+}
+
+/** Full search of the vectors around a start vector for which the reference block is inside the picture. The cost is the SAD
+ *  plus iMvWeight times the distance to the start vector, which keeps the motion of flat and repetitive areas coherent.
+ */
+static Void xSearchBlock( const Pel* pCur, const Pel* pRef, Int iStride, Int iPicWidth, Int iPicHeight, Int iX, Int iY, Int iBlkWidth, Int iBlkHeight,
+                          Int iStartX, Int iStartY, Int iRange, Int iMvWeight, Int& riMvX, Int& riMvY )
+{
+  iStartX = Clip3( -iX, iPicWidth  - iBlkWidth  - iX, iStartX );
+  iStartY = Clip3( -iY, iPicHeight - iBlkHeight - iY, iStartY );
+  const Int iMinX = max( iStartX - iRange, -iX );
+  const Int iMaxX = min( iStartX + iRange, iPicWidth  - iBlkWidth  - iX );
+  const Int iMinY = max( iStartY - iRange, -iY );
+  const Int iMaxY = min( iStartY + iRange, iPicHeight - iBlkHeight - iY );
+  const Pel* pCurBlk = pCur + iY * iStride + iX;
+
+  riMvX = iStartX;
+  riMvY = iStartY;
+  UInt uiBestCost = xBlockSad( pCurBlk, iStride, pRef + ( iY + iStartY ) * iStride + iX + iStartX, iStride, iBlkWidth, iBlkHeight );
+  for ( Int iMvY = iMinY; iMvY <= iMaxY && uiBestCost > 0; iMvY++ )
+  {
+    for ( Int iMvX = iMinX; iMvX <= iMaxX; iMvX++ )
+    {
+      UInt uiCost = iMvWeight * ( abs( iMvX - iStartX ) + abs( iMvY - iStartY ) );
+      if ( uiCost >= uiBestCost )
+      {
+        continue;
+      }
+      uiCost += xBlockSad( pCurBlk, iStride, pRef + ( iY + iMvY ) * iStride + iX + iMvX, iStride, iBlkWidth, iBlkHeight );
+      if ( uiCost < uiBestCost )
+      {
+        uiBestCost = uiCost;
+        riMvX     = iMvX;
+        riMvY     = iMvY;
+      }
+    }
+  }
+}
+
+/** Hierarchical motion estimation of the 8x8 blocks of a source picture: full search of 8x8 blocks of the quarter resolution
+ *  pictures, refined by +-2 samples for 8x8 blocks of the half resolution pictures and of the source pictures
+ * \param pcEPic       current picture
+ * \param pcERefPic    reference picture
+ * \param iSearchRange search range in samples of the source pictures
+ * \param pcMvField    motion of the 8x8 blocks of the source picture in quarter samples
+ * \return Void
+ */
+Void TEncPreanalyzer::xEstimateMotionField( TEncPic* pcEPic, TEncPic* pcERefPic, Int iSearchRange, Int iMvWeight, TComMv* pcMvField )
+{
+  const Int iBlkSize = 8;
+  std::vector<TComMv> acParentMv;
+  std::vector<TComMv> acMv;
+  Int iParentNumBlkW = 0;
+  Int iParentNumBlkH = 0;
+
+  for ( Int iLevel = 2; iLevel >= 0; iLevel-- )
+  {
+    const Pel* pCur;
+    const Pel* pRef;
+    Int iWidth, iHeight, iStride;
+    if ( iLevel > 0 )
+    {
+      pCur    = pcEPic->getPyramidY( iLevel );
+      pRef    = pcERefPic->getPyramidY( iLevel );
+      iWidth  = pcEPic->getPyramidWidth( iLevel );
+      iHeight = pcEPic->getPyramidHeight( iLevel );
+      iStride = iWidth;
+    }
+    else
+    {
+      pCur    = pcEPic->getPicYuvOrg()->getLumaAddr();
+      pRef    = pcERefPic->getPicYuvOrg()->getLumaAddr();
+      iWidth  = pcEPic->getPicYuvOrg()->getWidth();
+      iHeight = pcEPic->getPicYuvOrg()->getHeight();
+      iStride = pcEPic->getPicYuvOrg()->getStride();
+    }
+    const Int iNumBlkW = ( iWidth  + iBlkSize - 1 ) / iBlkSize;
+    const Int iNumBlkH = ( iHeight + iBlkSize - 1 ) / iBlkSize;
+    acMv.resize( iNumBlkW * iNumBlkH );
+
+    for ( Int by = 0; by < iNumBlkH; by++ )
+    {
+      for ( Int bx = 0; bx < iNumBlkW; bx++ )
+      {
+        const Int iX = bx * iBlkSize;
+        const Int iY = by * iBlkSize;
+        Int iStartX = 0;
+        Int iStartY = 0;
+        Int iRange  = max( ( iSearchRange + 3 ) >> 2, 4 );
+        if ( iLevel < 2 )
+        {
+          const TComMv& rcParent = acParentMv[ min( by >> 1, iParentNumBlkH - 1 ) * iParentNumBlkW + min( bx >> 1, iParentNumBlkW - 1 ) ];
+          iStartX = 2 * rcParent.getHor();
+          iStartY = 2 * rcParent.getVer();
+          iRange  = 2;
+        }
+        Int iMvX, iMvY;
+        xSearchBlock( pCur, pRef, iStride, iWidth, iHeight, iX, iY, min( iBlkSize, iWidth - iX ), min( iBlkSize, iHeight - iY ), iStartX, iStartY, iRange, iMvWeight, iMvX, iMvY );
+        acMv[ by * iNumBlkW + bx ].set( iMvX, iMvY );
+      }
+    }
+    acParentMv.swap( acMv );
+    iParentNumBlkW = iNumBlkW;
+    iParentNumBlkH = iNumBlkH;
+  }
+
+  for ( Int i = 0; i < iParentNumBlkW * iParentNumBlkH; i++ )
+  {
+    pcMvField[i].set( acParentMv[i].getHor() << 2, acParentMv[i].getVer() << 2 );
+  }
+}
+#endif
 //! \}
 
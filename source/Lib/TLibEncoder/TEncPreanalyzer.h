@@ -55,6 +55,13 @@ public:
   virtual ~TEncPreanalyzer();
 
   Void xPreanalyze( TEncPic* pcPic );
+#if LOOKAHEAD_ME
+  Void xBuildPyramid  ( TEncPic* pcPic );
+  Void xEstimateMotion( TEncPic* pcPic, TComSlice* pcSlice, Int iSearchRange );
+
+private:
+  Void xEstimateMotionField( TEncPic* pcPic, TEncPic* pcRefPic, Int iSearchRange, Int iMvWeight, TComMv* pcMvField );
+#endif
 };
 
 //! \}
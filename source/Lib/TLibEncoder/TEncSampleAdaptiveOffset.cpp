@@ -36,10 +36,18 @@
  \brief       estimation part of sample adaptive offset class
  */
 #include "TEncSampleAdaptiveOffset.h"
+#include "TLibCommon/TComSimd.h"
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+#if SAO_STAT_PARALLEL
+#include "TLibCommon/TComThreadPool.h"
+#endif
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <algorithm>
 
 //! \ingroup TLibEncoder
 //! \{
@@ -68,6 +76,9 @@ TEncSampleAdaptiveOffset::TEncSampleAdaptiveOffset()
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
   m_preDBFstatData = NULL;
 #endif
+#if SAO_STAT_PARALLEL
+  m_pcThreadPool = NULL;
+#endif
 }
 
 TEncSampleAdaptiveOffset::~TEncSampleAdaptiveOffset()
@@ -303,6 +314,55 @@ Void TEncSampleAdaptiveOffset::addPreDBFStatistics(SAOStatData*** blkStats)
 #endif
 
 Void TEncSampleAdaptiveOffset::getStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic
+#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+                          , Bool isCalculatePreDeblockSamples
+#endif
+                          )
+{
+#if SAO_STAT_PARALLEL
+  if( m_pcThreadPool && m_pcThreadPool->getNumThreads() > 1 )
+  {
+    // the statistics of a CTU only read the samples, one job per CTU row
+    TComSyncCounter cDone;
+    Int numJobs = 0;
+    for( Int ctu = 0; ctu < m_numCTUsPic; ctu += m_numCTUInWidth, numJobs++ )
+    {
+      m_pcThreadPool->addJob( std::bind( &TEncSampleAdaptiveOffset::getCtuStatisticsJob, this, blkStats, orgYuv, srcYuv, pPic, ctu, std::min( ctu + m_numCTUInWidth, m_numCTUsPic )
+#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+                                       , isCalculatePreDeblockSamples
+#endif
+                                       , &cDone ) );
+    }
+    cDone.waitFor( numJobs );
+    return;
+  }
+#endif
+  getCtuStatistics(blkStats, orgYuv, srcYuv, pPic, 0, m_numCTUsPic
+#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+                 , isCalculatePreDeblockSamples
+#endif
+                 );
+}
+
+#if SAO_STAT_PARALLEL
+Void TEncSampleAdaptiveOffset::getCtuStatisticsJob(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic, Int firstCtu, Int endCtu
+#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+                          , Bool isCalculatePreDeblockSamples
+#endif
+                          , TComSyncCounter* pcDone)
+{
+  getCtuStatistics(blkStats, orgYuv, srcYuv, pPic, firstCtu, endCtu
+#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+                 , isCalculatePreDeblockSamples
+#endif
+                 );
+  pcDone->increment();
+}
+#endif
+
+/** statistics of the CTUs firstCtu to endCtu-1
+ */
+Void TEncSampleAdaptiveOffset::getCtuStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic, Int firstCtu, Int endCtu
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
                           , Bool isCalculatePreDeblockSamples
 #endif
@@ -310,7 +370,7 @@ Void TEncSampleAdaptiveOffset::getStatistics(SAOStatData*** blkStats, TComPicYuv
 {
   Bool isLeftAvail,isRightAvail,isAboveAvail,isBelowAvail,isAboveLeftAvail,isAboveRightAvail,isBelowLeftAvail,isBelowRightAvail;
 
-  for(Int ctu= 0; ctu < m_numCTUsPic; ctu++)
+  for(Int ctu= firstCtu; ctu < endCtu; ctu++)
   {
     Int yPos   = (ctu / m_numCTUInWidth)*m_maxCUHeight;
     Int xPos   = (ctu % m_numCTUInWidth)*m_maxCUWidth;
@@ -893,6 +953,151 @@ Void TEncSampleAdaptiveOffset::decideBlkParams(TComPic* pic, Bool* sliceEnabled,
 }
 
 
+#if SIMD_X86 && SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+// ====================================================================================================================
+// Vectorised kernels, bit-exact with the C code of getBlkStats()
+// ====================================================================================================================
+
+/** Signs of c - n of 8 samples
+ */
+SIMD_TARGET_SSE41
+static inline __m128i xSignSSE41( __m128i c, __m128i n )
+{
+  return _mm_sub_epi16( _mm_cmpgt_epi16( n, c ), _mm_cmpgt_epi16( c, n ) );
+}
+
+/** Edge offset statistics of the samples of a rectangle, diff and count are indexed by the edge class plus 2.
+ *  The edge class of a sample is sgn(c - a) + sgn(c - b) with its neighbours a and b. The last 8 samples of a
+ *  row overlap the previous ones, the samples already counted are masked out.
+ */
+SIMD_TARGET_SSE41
+static Void xEdgeStatsRectSSE41( const Pel* srcBlk, const Pel* orgBlk, Int srcStride, Int orgStride, Int startX, Int endX, Int startY, Int endY
+                               , Int nbOffsetA, Int nbOffsetB, Int64* diff, Int64* count )
+{
+  if( startX >= endX || startY >= endY )
+  {
+    return;
+  }
+  if( endX - startX < 8 )
+  {
+    for( Int y = startY; y < endY; y++ )
+    {
+      const Pel* srcLine = srcBlk + y * srcStride;
+      const Pel* orgLine = orgBlk + y * orgStride;
+      for( Int x = startX; x < endX; x++ )
+      {
+        Int edgeType = sgn( srcLine[x] - srcLine[x + nbOffsetA] ) + sgn( srcLine[x] - srcLine[x + nbOffsetB] ) + 2;
+        diff [edgeType] += ( orgLine[x] - srcLine[x] );
+        count[edgeType] ++;
+      }
+    }
+    return;
+  }
+
+  const __m128i vLane = _mm_setr_epi16( 0, 1, 2, 3, 4, 5, 6, 7 );
+  const __m128i vOne  = _mm_set1_epi16( 1 );
+  __m128i vDiff [NUM_SAO_EO_CLASSES];
+  __m128i vCount[NUM_SAO_EO_CLASSES];
+  for( Int k = 0; k < NUM_SAO_EO_CLASSES; k++ )
+  {
+    vDiff [k] = _mm_setzero_si128();
+    vCount[k] = _mm_setzero_si128();
+  }
+  for( Int y = startY; y < endY; y++ )
+  {
+    const Pel* srcLine = srcBlk + y * srcStride;
+    const Pel* orgLine = orgBlk + y * orgStride;
+    for( Int x = startX; x < endX; x += 8 )
+    {
+      const Int x0 = std::min( x, endX - 8 );
+      const __m128i vValid = _mm_cmpgt_epi16( _mm_add_epi16( vLane, _mm_set1_epi16( x0 - x ) ), _mm_set1_epi16( -1 ) );
+      const __m128i c = _mm_loadu_si128( (const __m128i*)( srcLine + x0 ) );
+      const __m128i a = _mm_loadu_si128( (const __m128i*)( srcLine + x0 + nbOffsetA ) );
+      const __m128i b = _mm_loadu_si128( (const __m128i*)( srcLine + x0 + nbOffsetB ) );
+      const __m128i vEdge = _mm_add_epi16( xSignSSE41( c, a ), xSignSSE41( c, b ) );
+      const __m128i vErr  = _mm_sub_epi16( _mm_loadu_si128( (const __m128i*)( orgLine + x0 ) ), c );
+      for( Int k = 0; k < NUM_SAO_EO_CLASSES; k++ )
+      {
+        const __m128i vMask = _mm_and_si128( _mm_cmpeq_epi16( vEdge, _mm_set1_epi16( k - 2 ) ), vValid );
+        vDiff [k] = _mm_add_epi32( vDiff[k], _mm_madd_epi16( _mm_and_si128( vErr, vMask ), vOne ) );
+        vCount[k] = _mm_sub_epi16( vCount[k], vMask );
+      }
+    }
+  }
+  for( Int k = 0; k < NUM_SAO_EO_CLASSES; k++ )
+  {
+    __m128i vSum = _mm_hadd_epi32( vDiff[k], _mm_madd_epi16( vCount[k], vOne ) );
+    vSum = _mm_hadd_epi32( vSum, vSum );
+    diff [k] += _mm_cvtsi128_si32( vSum );
+    count[k] += _mm_extract_epi32( vSum, 1 );
+  }
+}
+
+/** Vectorised edge offset part of getBlkStats(), the samples of each class of edges are those of the C code
+ */
+SIMD_TARGET_SSE41
+static Void xGetEdgeBlkStatsSSE41( Int typeIdx, SAOStatData& statsData, Pel* srcBlk, Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height
+                                 , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail
+                                 , Int skipLinesR, Int skipLinesB, Bool isCalculatePreDeblockSamples )
+{
+  Int64* diff  = statsData.diff;
+  Int64* count = statsData.count;
+  Int nbOffsetA, nbOffsetB;
+  switch(typeIdx)
+  {
+  case SAO_TYPE_EO_0:   nbOffsetA = -1;            nbOffsetB = 1;             break;
+  case SAO_TYPE_EO_90:  nbOffsetA = -srcStride;    nbOffsetB = srcStride;     break;
+  case SAO_TYPE_EO_135: nbOffsetA = -srcStride-1;  nbOffsetB = srcStride+1;   break;
+  default:              nbOffsetA = -srcStride+1;  nbOffsetB = srcStride-1;   break;
+  }
+
+  Int startX, endX, endY;
+  if( typeIdx == SAO_TYPE_EO_90 )
+  {
+    startX = (!isCalculatePreDeblockSamples) ? 0 : (isRightAvail ? (width - skipLinesR) : width);
+    endX   = (!isCalculatePreDeblockSamples) ? (isRightAvail ? (width - skipLinesR) : width) : width;
+    endY   = isBelowAvail ? (height - skipLinesB) : (height - 1);
+    xEdgeStatsRectSSE41( srcBlk, orgBlk, srcStride, orgStride, startX, endX, isAboveAvail ? 0 : 1, endY, nbOffsetA, nbOffsetB, diff, count );
+  }
+  else
+  {
+    startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
+                                             : (isRightAvail ? (width - skipLinesR) : (width - 1));
+    endX   = (!isCalculatePreDeblockSamples) ? (isRightAvail ? (width - skipLinesR) : (width - 1))
+                                             : (isRightAvail ? width : (width - 1));
+    if( typeIdx == SAO_TYPE_EO_0 )
+    {
+      endY = isBelowAvail ? (height - skipLinesB) : height;
+      xEdgeStatsRectSSE41( srcBlk, orgBlk, srcStride, orgStride, startX, endX, 0, endY, nbOffsetA, nbOffsetB, diff, count );
+    }
+    else
+    {
+      Int firstLineStartX, firstLineEndX;
+      if( typeIdx == SAO_TYPE_EO_135 )
+      {
+        firstLineStartX = (!isCalculatePreDeblockSamples) ? (isAboveLeftAvail ? 0    : 1) : startX;
+        firstLineEndX   = (!isCalculatePreDeblockSamples) ? (isAboveAvail     ? endX : 1) : endX;
+      }
+      else
+      {
+        firstLineStartX = (!isCalculatePreDeblockSamples) ? (isAboveAvail ? startX : endX) : startX;
+        firstLineEndX   = (!isCalculatePreDeblockSamples) ? ((!isRightAvail && isAboveRightAvail) ? width : endX) : endX;
+      }
+      endY = isBelowAvail ? (height - skipLinesB) : (height - 1);
+      xEdgeStatsRectSSE41( srcBlk, orgBlk, srcStride, orgStride, firstLineStartX, firstLineEndX, 0, 1, nbOffsetA, nbOffsetB, diff, count );
+      xEdgeStatsRectSSE41( srcBlk, orgBlk, srcStride, orgStride, startX, endX, 1, endY, nbOffsetA, nbOffsetB, diff, count );
+    }
+  }
+
+  if( isCalculatePreDeblockSamples && isBelowAvail )
+  {
+    startX = ( typeIdx == SAO_TYPE_EO_90 ) ? 0     : ( isLeftAvail  ? 0     : 1 );
+    endX   = ( typeIdx == SAO_TYPE_EO_90 ) ? width : ( isRightAvail ? width : (width - 1) );
+    xEdgeStatsRectSSE41( srcBlk, orgBlk, srcStride, orgStride, startX, endX, endY, endY + skipLinesB, nbOffsetA, nbOffsetB, diff, count );
+  }
+}
+#endif
+
 Void TEncSampleAdaptiveOffset::getBlkStats(Int compIdx, SAOStatData* statsDataTypes  
                         , Pel* srcBlk, Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height
                         , Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail
@@ -901,6 +1106,11 @@ Void TEncSampleAdaptiveOffset::getBlkStats(Int compIdx, SAOStatData* statsDataTy
 #endif
                         )
 {
+#if SAO_STAT_PARALLEL
+  // sign lines of the call, the CTUs are processed concurrently
+  Char signLineBuf1[MAX_CU_SIZE+1];
+  Char signLineBuf2[MAX_CU_SIZE+1];
+#else
   if(m_lineBufWidth != m_maxCUWidth)
   {
     m_lineBufWidth = m_maxCUWidth;
@@ -911,6 +1121,9 @@ Void TEncSampleAdaptiveOffset::getBlkStats(Int compIdx, SAOStatData* statsDataTy
     if (m_signLineBuf2) delete[] m_signLineBuf2; m_signLineBuf2 = NULL;
     m_signLineBuf2 = new Char[m_lineBufWidth+1];
   }
+  Char* signLineBuf1 = m_signLineBuf1;
+  Char* signLineBuf2 = m_signLineBuf2;
+#endif
 
   Int x,y, startX, startY, endX, endY, edgeType, firstLineStartX, firstLineEndX;
   Char signLeft, signRight, signDown;
@@ -923,6 +1136,15 @@ Void TEncSampleAdaptiveOffset::getBlkStats(Int compIdx, SAOStatData* statsDataTy
   {
     SAOStatData& statsData= statsDataTypes[typeIdx];
     statsData.reset();
+#if SIMD_X86 && SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+    if( typeIdx != SAO_TYPE_BO && getSimdLevel() >= SIMD_SSE41 )
+    {
+      xGetEdgeBlkStatsSSE41( typeIdx, statsData, srcBlk, orgBlk, srcStride, orgStride, width, height
+                           , isLeftAvail, isRightAvail, isAboveAvail, isBelowAvail, isAboveLeftAvail, isAboveRightAvail
+                           , skipLinesR[typeIdx], skipLinesB[typeIdx], isCalculatePreDeblockSamples );
+      continue;
+    }
+#endif
 
     srcLine = srcBlk;
     orgLine = orgBlk;
@@ -1012,7 +1234,7 @@ Void TEncSampleAdaptiveOffset::getBlkStats(Int compIdx, SAOStatData* statsDataTy
       {
         diff +=2;
         count+=2;
-        Char *signUpLine = m_signLineBuf1;
+        Char *signUpLine = signLineBuf1;
 
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         startX = (!isCalculatePreDeblockSamples) ? 0
@@ -1111,8 +1333,8 @@ Void TEncSampleAdaptiveOffset::getBlkStats(Int compIdx, SAOStatData* statsDataTy
         count+=2;
         Char *signUpLine, *signDownLine, *signTmpLine;
 
-        signUpLine  = m_signLineBuf1;
-        signDownLine= m_signLineBuf2;
+        signUpLine  = signLineBuf1;
+        signDownLine= signLineBuf2;
 
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
@@ -1231,7 +1453,7 @@ Void TEncSampleAdaptiveOffset::getBlkStats(Int compIdx, SAOStatData* statsDataTy
       {
         diff +=2;
         count+=2;
-        Char *signUpLine = m_signLineBuf1+1;
+        Char *signUpLine = signLineBuf1+1;
 
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
         startX = (!isCalculatePreDeblockSamples) ? (isLeftAvail  ? 0 : 1)
@@ -49,6 +49,11 @@
 //! \ingroup TLibEncoder
 //! \{
 
+#if SAO_STAT_PARALLEL
+class TComThreadPool;
+class TComSyncCounter;
+#endif
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -113,6 +118,9 @@ public:
                 , Bool isPreDBFSamplesUsed
 #endif
                 ); 
+#if SAO_STAT_PARALLEL
+  Void setThreadPool(TComThreadPool* pcThreadPool) { m_pcThreadPool = pcThreadPool; }
+#endif
 public: //methods
 #if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
   Void getPreDBFStatistics(TComPic* pPic); 
@@ -123,6 +131,18 @@ private: //methods
                    , Bool isCalculatePreDeblockSamples = false
 #endif
                    );
+  Void getCtuStatistics(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic, Int firstCtu, Int endCtu
+#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+                      , Bool isCalculatePreDeblockSamples
+#endif
+                      );
+#if SAO_STAT_PARALLEL
+  Void getCtuStatisticsJob(SAOStatData*** blkStats, TComPicYuv* orgYuv, TComPicYuv* srcYuv, TComPic* pPic, Int firstCtu, Int endCtu
+#if SAO_ENCODE_ALLOW_USE_PREDEBLOCK
+                         , Bool isCalculatePreDeblockSamples
+#endif
+                         , TComSyncCounter* pcDone);
+#endif
   Void decidePicParams(Bool* sliceEnabled, Int picTempLayer);
   Void decideBlkParams(TComPic* pic, Bool* sliceEnabled, SAOStatData*** blkStats, TComPicYuv* srcYuv, TComPicYuv* resYuv, SAOBlkParam* reconParams, SAOBlkParam* codedParams);
   Void getBlkStats(Int compIdx, SAOStatData* statsDataTypes, Pel* srcBlk, Pel* orgBlk, Int srcStride, Int orgStride, Int width, Int height, Bool isLeftAvail,  Bool isRightAvail, Bool isAboveAvail, Bool isBelowAvail, Bool isAboveLeftAvail, Bool isAboveRightAvail, Bool isBelowLeftAvail, Bool isBelowRightAvail
@@ -156,6 +176,9 @@ private: //members
 #endif
   Int                    m_skipLinesR[NUM_SAO_COMPONENTS][NUM_SAO_NEW_TYPES];
   Int                    m_skipLinesB[NUM_SAO_COMPONENTS][NUM_SAO_NEW_TYPES];
+#if SAO_STAT_PARALLEL
+  TComThreadPool*        m_pcThreadPool;             ///< worker threads of the statistics of the CTU rows
+#endif
 };
 //! \}
 
@@ -39,6 +39,9 @@
 #include "TLibCommon/TComRom.h"
 #include "TLibCommon/TComMotionInfo.h"
 #include "TEncSearch.h"
+#if LOOKAHEAD_ME
+#include "TEncPic.h"
+#endif
 #include <math.h>
 
 //! \ingroup TLibEncoder
@@ -77,6 +80,16 @@ static const UInt s_auiDFilter[9] =
   0, 1, 0
 };
 
+#if FAST_INTRA_SEARCH
+/// displacement of the angular intra modes in 1/32 samples per row (modes 2 to 17) or per column (modes 18 to 34)
+static const Int s_aiIntraPredAngle[NUM_INTRA_MODE-1] =
+{
+  0, 0,
+  32, 26, 21, 17, 13, 9, 5, 2, 0, -2, -5, -9, -13, -17, -21, -26,
+  -32, -26, -21, -17, -13, -9, -5, -2, 0, 2, 5, 9, 13, 17, 21, 26, 32
+};
+#endif
+
 TEncSearch::TEncSearch()
 {
   m_ppcQTTempCoeffY  = NULL;
@@ -111,11 +124,36 @@ TEncSearch::TEncSearch()
   m_puhQTTempTransformSkipFlag[0] = NULL;
   m_puhQTTempTransformSkipFlag[1] = NULL;
   m_puhQTTempTransformSkipFlag[2] = NULL;
+#if IL_MOTION_SEED
+  m_iNumILMvSeeds = 0;
+#endif
+#if LOOKAHEAD_ME
+  m_bLookaheadMv = false;
+#endif
+#if PARALLEL_ME
+  m_bUseMEHelpers    = true;
+  m_iNumMEHelpers    = 0;
+  m_apcMEHelper      = NULL;
+  m_acMEHelperRdCost = NULL;
+#endif
   setWpScalingDistParam( NULL, -1, REF_PIC_LIST_X );
 }
 
 TEncSearch::~TEncSearch()
 {
+#if PARALLEL_ME
+  m_cMEThreadPool.destroy();
+  for ( Int i = 0; i < m_iNumMEHelpers; i++ )
+  {
+    delete m_apcMEHelper[i];
+  }
+  delete [] m_apcMEHelper;
+  delete [] m_acMEHelperRdCost;
+  m_apcMEHelper      = NULL;
+  m_acMEHelperRdCost = NULL;
+  m_iNumMEHelpers    = 0;
+#endif
+
   if ( m_pTempPel )
   {
     delete [] m_pTempPel;
@@ -280,6 +318,22 @@ void TEncSearch::init(TEncCfg*      pcEncCfg,
   m_puhQTTempTransformSkipFlag[1] = new UChar  [uiNumPartitions];
   m_puhQTTempTransformSkipFlag[2] = new UChar  [uiNumPartitions];
   m_tmpYuvPred.create(MAX_CU_SIZE, MAX_CU_SIZE);
+
+#if PARALLEL_ME
+  // the copies share the settings and the coding classes, only their motion estimation is used
+  if ( m_bUseMEHelpers && pcEncCfg->getNumMEThreads() > 1 )
+  {
+    m_iNumMEHelpers    = pcEncCfg->getNumMEThreads();
+    m_apcMEHelper      = new TEncSearch* [m_iNumMEHelpers];
+    m_acMEHelperRdCost = new TComRdCost  [m_iNumMEHelpers];
+    for ( Int i = 0; i < m_iNumMEHelpers; i++ )
+    {
+      m_apcMEHelper[i] = new TEncSearch;
+      m_apcMEHelper[i]->m_bUseMEHelpers = false;
+      m_apcMEHelper[i]->init( pcEncCfg, pcTrQuant, iSearchRange, bipredSearchRange, iFastSearch, iMaxDeltaQP, pcEntropyCoder, &m_acMEHelperRdCost[i], pppcRDSbacCoder, pcRDGoOnSbacCoder );
+    }
+  }
+#endif
 }
 
 #if FASTME_SMOOTHER_MV
@@ -759,6 +813,25 @@ UInt TEncSearch::xPatternRefinement( TComPattern* pcPatternKey,
   return uiDistBest;
 }
 
+#if FAST_RDOQ
+/** set the rates of the RDOQ of a TU, the fast RDOQ takes the ones estimated at the start of the slice
+ * \param uiWidth    TU width
+ * \param uiHeight   TU height
+ * \param eTextType  plane type
+ */
+Void TEncSearch::xEstimateRDOQBits( UInt uiWidth, UInt uiHeight, TextType eTextType )
+{
+  if( m_pcEncCfg->getUseRDOQFast() )
+  {
+    m_pcTrQuant->selectSliceEstBits( uiWidth, eTextType );
+  }
+  else
+  {
+    m_pcEntropyCoder->estimateBit( m_pcTrQuant->m_pcEstBitsSbac, uiWidth, uiHeight, eTextType );
+  }
+}
+#endif
+
 Void
 TEncSearch::xEncSubdivCbfQT( TComDataCU*  pcCU,
                             UInt         uiTrDepth,
@@ -1094,7 +1167,11 @@ TEncSearch::xIntraCodingLumaBlk( TComDataCU* pcCU,
   //--- init rate estimation arrays for RDOQ ---
   if( useTransformSkip? m_pcEncCfg->getUseRDOQTS():m_pcEncCfg->getUseRDOQ())
   {
+#if FAST_RDOQ
+    xEstimateRDOQBits( uiWidth, uiWidth, TEXT_LUMA );
+#else
     m_pcEntropyCoder->estimateBit( m_pcTrQuant->m_pcEstBitsSbac, uiWidth, uiWidth, TEXT_LUMA );
+#endif
   }
   //--- transform and quantization ---
   UInt uiAbsSum = 0;
@@ -1285,7 +1362,11 @@ TEncSearch::xIntraCodingChromaBlk( TComDataCU* pcCU,
     //--- init rate estimation arrays for RDOQ ---
     if( useTransformSkipChroma? m_pcEncCfg->getUseRDOQTS():m_pcEncCfg->getUseRDOQ())
     {
+#if FAST_RDOQ
+      xEstimateRDOQBits( uiWidth, uiWidth, eText );
+#else
       m_pcEntropyCoder->estimateBit( m_pcTrQuant->m_pcEstBitsSbac, uiWidth, uiWidth, eText );
+#endif
     }
     //--- transform and quantization ---
     UInt uiAbsSum = 0;
@@ -2468,6 +2549,54 @@ TEncSearch::estIntraPredQT( TComDataCU* pcCU,
       }
       CandNum = 0;
       
+#if FAST_INTRA_SEARCH
+      if ( m_pcEncCfg->getUseFastIntraSearch() && numModesAvailable == NUM_INTRA_MODE-1 )
+      {
+        // coarse to fine search: planar, DC, every 4th angular mode and the dominant gradient directions of the PU, then the
+        // modes at a distance of 2 and 1 from the best angular candidates, the cost of each mode is computed once
+        Double adModeCost[NUM_INTRA_MODE-1];
+        for( Int i = 0; i < NUM_INTRA_MODE-1; i++ )
+        {
+          adModeCost[i] = -1.0;
+        }
+        for( UInt uiMode = 0; uiMode < NUM_INTRA_MODE-1; uiMode += ( uiMode <= DC_IDX ? 1 : 4 ) )
+        {
+          xCheckIntraModeHAD( pcCU, uiMode, uiPU, uiPartOffset, uiDepth, uiInitTrDepth, piOrg, piPred, uiStride, uiWidth, uiHeight, bAboveAvail, bLeftAvail,
+                              adModeCost, numModesForFullRD, uiRdModeList, CandCostList, CandNum );
+        }
+        UInt auiGradModes[FAST_INTRA_GRAD_MODES];
+        Int  iNumGradModes = xGetGradientIntraModes( piOrg, uiStride, uiWidth, uiHeight, auiGradModes, FAST_INTRA_GRAD_MODES );
+        for( Int i = 0; i < iNumGradModes; i++ )
+        {
+          xCheckIntraModeHAD( pcCU, auiGradModes[i], uiPU, uiPartOffset, uiDepth, uiInitTrDepth, piOrg, piPred, uiStride, uiWidth, uiHeight, bAboveAvail, bLeftAvail,
+                              adModeCost, numModesForFullRD, uiRdModeList, CandCostList, CandNum );
+        }
+        for( Int iStep = 2; iStep > 0; iStep >>= 1 )
+        {
+          UInt auiCentre[FAST_INTRA_REFINE_MODES];
+          Int  iNumCentres = 0;
+          for( Int i = 0; i < numModesForFullRD && iNumCentres < FAST_INTRA_REFINE_MODES; i++ )
+          {
+            if( CandCostList[i] < MAX_DOUBLE && uiRdModeList[i] > DC_IDX )
+            {
+              auiCentre[iNumCentres++] = uiRdModeList[i];
+            }
+          }
+          for( Int i = 0; i < iNumCentres; i++ )
+          {
+            for( Int iRefMode = auiCentre[i] - iStep; iRefMode <= (Int)auiCentre[i] + iStep; iRefMode += 2 * iStep )
+            {
+              if( iRefMode > DC_IDX && iRefMode < NUM_INTRA_MODE-1 )
+              {
+                xCheckIntraModeHAD( pcCU, iRefMode, uiPU, uiPartOffset, uiDepth, uiInitTrDepth, piOrg, piPred, uiStride, uiWidth, uiHeight, bAboveAvail, bLeftAvail,
+                                    adModeCost, numModesForFullRD, uiRdModeList, CandCostList, CandNum );
+              }
+            }
+          }
+        }
+      }
+      else
+#endif
       for( Int modeIdx = 0; modeIdx < numModesAvailable; modeIdx++ )
       {
         UInt uiMode = modeIdx;
@@ -3226,6 +3355,177 @@ Void TEncSearch::predInterSearch( TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
       Bool doneUniPred = false;
 #endif
 
+#if PARALLEL_ME
+    //  Uni-directional prediction: the motion vector predictors of the reference pictures are derived first, their motion
+    //  searches then run concurrently and the results are compared in the order of the serial search
+    Bool            abTestRef[2][33];
+    UInt            auiBitsRef[2][33];
+    Int             aiMEJob[2][33];
+    MotionSearchJob acMEJobs[2*MAX_NUM_REF];
+    Int             iNumMEJobs = 0;
+
+    for ( Int iRefList = 0; iRefList < iNumPredDir; iRefList++ )
+    {
+      RefPicList  eRefPicList = ( iRefList ? REF_PIC_LIST_1 : REF_PIC_LIST_0 );
+      
+      for ( Int iRefIdxTemp = 0; iRefIdxTemp < pcCU->getSlice()->getNumRefIdx(eRefPicList); iRefIdxTemp++ )
+      {
+        abTestRef[iRefList][iRefIdxTemp] = false;
+#if SVC_EXTENSION
+        TComPic* pcPic = pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxTemp );
+        
+        // motion search only for the ILRP with sample prediction type
+        if( pcPic->isILR( pcCU->getLayerId() ) && !pcCU->getSlice()->getVPS()->isSamplePredictionType( pcCU->getLayerId(), pcPic->getLayerId() ) )
+        {
+          continue;
+        }
+
+#if N0383_IL_CONSTRAINED_TILE_SETS_SEI
+        if( pcPic->isILR(pcCU->getLayerId()) && m_disableILP )
+        {
+          continue;
+        }
+#endif
+#if (ENCODER_FAST_MODE)        
+        if( pcPic->isILR(pcCU->getLayerId()) && (ePartSize == SIZE_2Nx2N) ) 
+        {
+          continue;
+        }
+#endif
+        doneUniPred = true;
+#endif
+        abTestRef[iRefList][iRefIdxTemp] = true;
+
+        uiBitsTemp = uiMbBits[iRefList];
+        if ( pcCU->getSlice()->getNumRefIdx(eRefPicList) > 1 )
+        {
+          uiBitsTemp += iRefIdxTemp+1;
+          if ( iRefIdxTemp == pcCU->getSlice()->getNumRefIdx(eRefPicList)-1 ) uiBitsTemp--;
+        }
+#if ZERO_MVD_EST
+        xEstimateMvPredAMVP( pcCU, pcOrgYuv, iPartIdx, eRefPicList, iRefIdxTemp, cMvPred[iRefList][iRefIdxTemp], false, &biPDistTemp, &uiZeroMvdDistTemp);
+#else
+        xEstimateMvPredAMVP( pcCU, pcOrgYuv, iPartIdx, eRefPicList, iRefIdxTemp, cMvPred[iRefList][iRefIdxTemp], false, &biPDistTemp);
+#endif
+        aaiMvpIdx[iRefList][iRefIdxTemp] = pcCU->getMVPIdx(eRefPicList, uiPartAddr);
+        aaiMvpNum[iRefList][iRefIdxTemp] = pcCU->getMVPNum(eRefPicList, uiPartAddr);
+        
+        if(pcCU->getSlice()->getMvdL1ZeroFlag() && iRefList==1 && biPDistTemp < bestBiPDist)
+        {
+#if REF_IDX_ME_ZEROMV 
+          Bool bZeroMVILR = pcCU->xCheckZeroMVILRMvdL1Zero(iRefList, iRefIdxTemp, aaiMvpIdx[iRefList][iRefIdxTemp]);
+          if(bZeroMVILR)
+          {
+#endif
+          bestBiPDist = biPDistTemp;
+          bestBiPMvpL1 = aaiMvpIdx[iRefList][iRefIdxTemp];
+          bestBiPRefIdxL1 = iRefIdxTemp;
+#if REF_IDX_ME_ZEROMV
+          }
+#endif
+        }
+
+        uiBitsTemp += m_auiMVPIdxCost[aaiMvpIdx[iRefList][iRefIdxTemp]][AMVP_MAX_NUM_CANDS];
+#if ZERO_MVD_EST
+        if ( iRefList == 0 || pcCU->getSlice()->getList1IdxToList0Idx( iRefIdxTemp ) < 0 )
+        {
+          uiZeroMvdBitsTemp = uiBitsTemp;
+          uiZeroMvdBitsTemp += 2; //zero mvd bits
+
+          m_pcRdCost->getMotionCost( 1, 0 );
+          uiZeroMvdCostTemp = uiZeroMvdDistTemp + m_pcRdCost->getCost(uiZeroMvdBitsTemp);
+
+          if (uiZeroMvdCostTemp < uiZeroMvdCost)
+          {
+            uiZeroMvdCost = uiZeroMvdCostTemp;
+            iZeroMvdDir = iRefList + 1;
+            aiZeroMvdRefIdx[iRefList] = iRefIdxTemp;
+            aiZeroMvdMvpIdx[iRefList] = aaiMvpIdx[iRefList][iRefIdxTemp];
+            auiZeroMvdBits[iRefList] = uiZeroMvdBitsTemp;
+          }          
+        }
+#endif
+        
+        xCopyAMVPInfo(pcCU->getCUMvField(eRefPicList)->getAMVPInfo(), &aacAMVPInfo[iRefList][iRefIdxTemp]); // must always be done ( also when AMVP_MODE = AM_NONE )
+        auiBitsRef[iRefList][iRefIdxTemp] = uiBitsTemp;
+
+        aiMEJob[iRefList][iRefIdxTemp] = -1;
+#if GPB_SIMPLE_UNI
+        if ( iRefList == 0 || pcCU->getSlice()->getList1IdxToList0Idx( iRefIdxTemp ) < 0 )
+#endif
+        {
+          MotionSearchJob& rcJob = acMEJobs[iNumMEJobs];
+          rcJob.eRefPicList = eRefPicList;
+          rcJob.iRefIdx     = iRefIdxTemp;
+          rcJob.cMvPred     = cMvPred[iRefList][iRefIdxTemp];
+          rcJob.uiBits      = uiBitsTemp;
+          aiMEJob[iRefList][iRefIdxTemp] = iNumMEJobs++;
+        }
+      }
+    }
+
+    xMotionEstimationRefs( pcCU, pcOrgYuv, iPartIdx, acMEJobs, iNumMEJobs );
+
+    for ( Int iRefList = 0; iRefList < iNumPredDir; iRefList++ )
+    {
+      RefPicList  eRefPicList = ( iRefList ? REF_PIC_LIST_1 : REF_PIC_LIST_0 );
+
+      for ( Int iRefIdxTemp = 0; iRefIdxTemp < pcCU->getSlice()->getNumRefIdx(eRefPicList); iRefIdxTemp++ )
+      {
+        if ( !abTestRef[iRefList][iRefIdxTemp] )
+        {
+          continue;
+        }
+        uiBitsTemp = auiBitsRef[iRefList][iRefIdxTemp];
+        if ( aiMEJob[iRefList][iRefIdxTemp] < 0 )
+        {
+          cMvTemp[1][iRefIdxTemp] = cMvTemp[0][pcCU->getSlice()->getList1IdxToList0Idx( iRefIdxTemp )];
+          uiCostTemp = uiCostTempL0[pcCU->getSlice()->getList1IdxToList0Idx( iRefIdxTemp )];
+          /*first subtract the bit-rate part of the cost of the other list*/
+          uiCostTemp -= m_pcRdCost->getCost( uiBitsTempL0[pcCU->getSlice()->getList1IdxToList0Idx( iRefIdxTemp )] );
+          /*correct the bit-rate part of the current ref*/
+          m_pcRdCost->setPredictor  ( cMvPred[iRefList][iRefIdxTemp] );
+          uiBitsTemp += m_pcRdCost->getBits( cMvTemp[1][iRefIdxTemp].getHor(), cMvTemp[1][iRefIdxTemp].getVer() );
+          /*calculate the correct cost*/
+          uiCostTemp += m_pcRdCost->getCost( uiBitsTemp );
+        }
+        else
+        {
+          MotionSearchJob& rcJob = acMEJobs[aiMEJob[iRefList][iRefIdxTemp]];
+          cMvTemp[iRefList][iRefIdxTemp] = rcJob.cMv;
+          uiBitsTemp = rcJob.uiBits;
+          uiCostTemp = rcJob.uiCost;
+        }
+        xCopyAMVPInfo(&aacAMVPInfo[iRefList][iRefIdxTemp], pcCU->getCUMvField(eRefPicList)->getAMVPInfo());
+        xCheckBestMVP(pcCU, eRefPicList, cMvTemp[iRefList][iRefIdxTemp], cMvPred[iRefList][iRefIdxTemp], aaiMvpIdx[iRefList][iRefIdxTemp], uiBitsTemp, uiCostTemp);
+
+        if ( iRefList == 0 )
+        {
+          uiCostTempL0[iRefIdxTemp] = uiCostTemp;
+          uiBitsTempL0[iRefIdxTemp] = uiBitsTemp;
+        }
+        if ( uiCostTemp < uiCost[iRefList] )
+        {
+          uiCost[iRefList] = uiCostTemp;
+          uiBits[iRefList] = uiBitsTemp; // storing for bi-prediction
+
+          // set motion
+          cMv[iRefList]     = cMvTemp[iRefList][iRefIdxTemp];
+          iRefIdx[iRefList] = iRefIdxTemp;
+        }
+
+        if ( iRefList == 1 && uiCostTemp < costValidList1 && pcCU->getSlice()->getList1IdxToList0Idx( iRefIdxTemp ) < 0 )
+        {
+          costValidList1 = uiCostTemp;
+          bitsValidList1 = uiBitsTemp;
+
+          // set motion
+          mvValidList1     = cMvTemp[iRefList][iRefIdxTemp];
+          refIdxValidList1 = iRefIdxTemp;
+        }
+      }
+    }
+#else
     //  Uni-directional prediction
     for ( Int iRefList = 0; iRefList < iNumPredDir; iRefList++ )
     {
@@ -3364,6 +3664,8 @@ Void TEncSearch::predInterSearch( TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*&
       }
     }
 
+#endif
+
 #if SVC_EXTENSION
     if( pcCU->getLayerId() && !doneUniPred )
     {
@@ -4123,7 +4425,11 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   m_iSearchRange = m_aaiAdaptSR[eRefPicList][iRefIdxPred];
   
   Int           iSrchRng      = ( bBi ? m_bipredSearchRange : m_iSearchRange );
+#if PARALLEL_ME
+  TComPattern*  pcPatternKey  = &m_cPatternKey;
+#else
   TComPattern*  pcPatternKey  = pcCU->getPattern        ();
+#endif
   
   Double        fWeight       = 1.0;
   
@@ -4155,6 +4461,50 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   
   TComMv      cMvPred = *pcMvPred;
   
+#if IL_MOTION_SEED
+  m_iNumILMvSeeds = 0;
+  if ( !bBi && m_pcEncCfg->getILMotionSeed() && pcCU->getLayerId() > 0 && !pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->isILR( pcCU->getLayerId() ) )
+  {
+    xGetILMotionSeeds( pcCU, uiPartAddr, iRoiWidth, iRoiHeight, eRefPicList, iRefIdxPred );
+
+    // the search range is reduced to a quarter when the base layer motion agrees with the predictor within one sample
+    Bool bAgree = m_iNumILMvSeeds > 0;
+    for ( Int i = 0; i < m_iNumILMvSeeds; i++ )
+    {
+      bAgree &= abs( m_acILMvSeeds[i].getHor() - cMvPred.getHor() ) <= 4 && abs( m_acILMvSeeds[i].getVer() - cMvPred.getVer() ) <= 4;
+    }
+    if ( m_pcEncCfg->getILMotionSeed() == 2 && bAgree )
+    {
+      m_iSearchRange = iSrchRng = std::max( iSrchRng >> 2, 8 );
+    }
+  }
+#endif
+#if LOOKAHEAD_ME
+  m_bLookaheadMv = false;
+  TEncPic* pcEPic = dynamic_cast<TEncPic*>( pcCU->getPic() );
+  if ( !bBi && m_pcEncCfg->getLookaheadME() && pcEPic != NULL
+#if SVC_EXTENSION
+    && !pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->isILR( pcCU->getLayerId() )
+#endif
+    )
+  {
+    const TComMv* pcMvField = pcEPic->getLookaheadMvField( pcCU->getSlice()->getRefPic( eRefPicList, iRefIdxPred )->getPOC() );
+    if ( pcMvField != NULL )
+    {
+      // motion of the 8x8 block of the lookahead ME covering the centre of the PU
+      Int iPelX = min<Int>( pcCU->getCUPelX() + g_auiRasterToPelX[ g_auiZscanToRaster[uiPartAddr] ] + ( iRoiWidth  >> 1 ), pcEPic->getPicYuvOrg()->getWidth()  - 1 );
+      Int iPelY = min<Int>( pcCU->getCUPelY() + g_auiRasterToPelY[ g_auiZscanToRaster[uiPartAddr] ] + ( iRoiHeight >> 1 ), pcEPic->getPicYuvOrg()->getHeight() - 1 );
+      m_cLookaheadMv = pcMvField[ ( iPelY >> 3 ) * pcEPic->getLookaheadMvStride() + ( iPelX >> 3 ) ];
+      m_bLookaheadMv = true;
+      // the search window is kept, only the radius of the first TZ search around the best start point is reduced
+      if ( m_pcEncCfg->getLookaheadME() == 2 )
+      {
+        m_iSearchRange = std::max( iSrchRng >> 2, 8 );
+      }
+    }
+  }
+#endif
+
   if ( bBi )  xSetSearchRange   ( pcCU, rcMv   , iSrchRng, cMvSrchRngLT, cMvSrchRngRB );
   else        xSetSearchRange   ( pcCU, cMvPred, iSrchRng, cMvSrchRngLT, cMvSrchRngRB );
   
@@ -4221,6 +4571,124 @@ Void TEncSearch::xMotionEstimation( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPa
   ruiCost       = (UInt)( floor( fWeight * ( (Double)ruiCost - (Double)m_pcRdCost->getCost( uiMvBits ) ) ) + (Double)m_pcRdCost->getCost( ruiBits ) );
 }
 
+#if PARALLEL_ME
+/** uni-directional motion estimation of several reference pictures of a PU, the searches are distributed over the copies
+ *  of the search when there are some, the cost functions are then left in the state of the serial searches
+ */
+Void TEncSearch::xMotionEstimationRefs( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPartIdx, MotionSearchJob* pcJobs, Int iNumJobs )
+{
+  if ( m_iNumMEHelpers < 2 || iNumJobs < 2 )
+  {
+    xMotionEstimationJobs( pcCU, pcYuvOrg, iPartIdx, pcJobs, 0, iNumJobs, 1, NULL );
+    return;
+  }
+
+  if ( m_cMEThreadPool.getNumThreads() == 0 )
+  {
+    TComCodingContext cContext;
+    cContext.save( true );
+    m_cMEThreadPool.create( m_iNumMEHelpers, cContext );
+  }
+
+  Int iNumTasks = std::min( m_iNumMEHelpers, iNumJobs );
+  TComSyncCounter cDone;
+  for ( Int i = 0; i < iNumTasks; i++ )
+  {
+    TEncSearch* pcHelper = m_apcMEHelper[i];
+    *pcHelper->m_pcRdCost = *m_pcRdCost;
+    ::memcpy( pcHelper->m_aaiAdaptSR, m_aaiAdaptSR, sizeof( m_aaiAdaptSR ) );
+    m_cMEThreadPool.addJob( std::bind( &TEncSearch::xMotionEstimationJobs, pcHelper, pcCU, pcYuvOrg, iPartIdx, pcJobs, i, iNumJobs, iNumTasks, &cDone ) );
+  }
+  cDone.waitFor( iNumTasks );
+
+  m_pcRdCost->getMotionCost( 1, 0 );
+  m_pcRdCost->setPredictor ( pcJobs[iNumJobs-1].cMvPred );
+  m_pcRdCost->setCostScale ( 0 );
+}
+
+/** motion estimation of every iJobStep-th job, starting with iFirstJob
+ */
+Void TEncSearch::xMotionEstimationJobs( TComDataCU* pcCU, TComYuv* pcYuvOrg, Int iPartIdx, MotionSearchJob* pcJobs, Int iFirstJob, Int iNumJobs, Int iJobStep, TComSyncCounter* pcDone )
+{
+  for ( Int i = iFirstJob; i < iNumJobs; i += iJobStep )
+  {
+    MotionSearchJob& rcJob = pcJobs[i];
+    xMotionEstimation( pcCU, pcYuvOrg, iPartIdx, rcJob.eRefPicList, &rcJob.cMvPred, rcJob.iRefIdx, rcJob.cMv, rcJob.uiBits, rcJob.uiCost );
+  }
+  if ( pcDone )
+  {
+    pcDone->increment();
+  }
+}
+#endif
+
+#if IL_MOTION_SEED
+/** derive the start points of the motion estimation from the base layer motion, mapped to the inter-layer reference picture
+ *  at the centre of the PU and scaled with the POC distances to the reference picture
+ */
+Void TEncSearch::xGetILMotionSeeds( TComDataCU* pcCU, UInt uiPartAddr, Int iRoiWidth, Int iRoiHeight, RefPicList eRefPicList, Int iRefIdx )
+{
+  TComSlice* pcSlice  = pcCU->getSlice();
+  TComPic*   pcILRPic = NULL;
+
+  for ( Int iList = 0; iList < 2 && pcILRPic == NULL; iList++ )
+  {
+    for ( Int i = 0; i < pcSlice->getNumRefIdx( RefPicList( iList ) ); i++ )
+    {
+      if ( pcSlice->getRefPic( RefPicList( iList ), i )->isILR( pcCU->getLayerId() ) )
+      {
+        pcILRPic = pcSlice->getRefPic( RefPicList( iList ), i );
+        break;
+      }
+    }
+  }
+  if ( pcILRPic == NULL || pcSlice->getIsUsedAsLongTerm( eRefPicList, iRefIdx ) )
+  {
+    return;
+  }
+
+  TComPic* pcPic = pcCU->getPic();
+  UInt uiPelX = g_auiRasterToPelX[ g_auiZscanToRaster[ pcCU->getZorderIdxInCU() + uiPartAddr ] ] + ( iRoiWidth  >> 1 );
+  UInt uiPelY = g_auiRasterToPelY[ g_auiZscanToRaster[ pcCU->getZorderIdxInCU() + uiPartAddr ] ] + ( iRoiHeight >> 1 );
+  UInt uiAbsPartIdx = g_auiRasterToZscan[ ( uiPelY / pcPic->getMinCUHeight() ) * pcPic->getNumPartInWidth() + uiPelX / pcPic->getMinCUWidth() ];
+  TComDataCU* pcColCU = pcILRPic->getCU( pcCU->getAddr() );
+
+  // the units of the mapped motion field without base layer motion are intra
+  if ( pcColCU->getPredictionMode( uiAbsPartIdx ) != MODE_INTER )
+  {
+    return;
+  }
+
+  Int iDiffPocB = pcSlice->getPOC() - pcSlice->getRefPOC( eRefPicList, iRefIdx );
+  for ( Int iList = 0; iList < 2; iList++ )
+  {
+    Int iColRefIdx = pcColCU->getCUMvField( RefPicList( iList ) )->getRefIdx( uiAbsPartIdx );
+    if ( iColRefIdx < 0 || pcILRPic->getSlice(0)->getIsUsedAsLongTerm( RefPicList( iList ), iColRefIdx ) )
+    {
+      continue;
+    }
+    Int iDiffPocD = pcSlice->getPOC() - pcILRPic->getSlice(0)->getRefPOC( RefPicList( iList ), iColRefIdx );
+    if ( iDiffPocD == 0 )
+    {
+      continue;
+    }
+
+    TComMv cMv = pcColCU->getCUMvField( RefPicList( iList ) )->getMv( uiAbsPartIdx );
+    if ( iDiffPocD != iDiffPocB )
+    {
+      Int iTDB   = Clip3( -128, 127, iDiffPocB );
+      Int iTDD   = Clip3( -128, 127, iDiffPocD );
+      Int iX     = ( 0x4000 + abs( iTDD / 2 ) ) / iTDD;
+      Int iScale = Clip3( -4096, 4095, ( iTDB * iX + 32 ) >> 6 );
+      cMv = cMv.scaleMv( iScale );
+    }
+    if ( m_iNumILMvSeeds == 0 || cMv != m_acILMvSeeds[0] )
+    {
+      m_acILMvSeeds[m_iNumILMvSeeds++] = cMv;
+    }
+  }
+}
+#endif
 
 Void TEncSearch::xSetSearchRange ( TComDataCU* pcCU, TComMv& cMvPred, Int iSrchRng, TComMv& rcMvSrchRngLT, TComMv& rcMvSrchRngRB )
 {
@@ -4355,6 +4823,27 @@ Void TEncSearch::xTZSearch( TComDataCU* pcCU, TComPattern* pcPatternKey, Pel* pi
     xTZSearchHelp( pcPatternKey, cStruct, 0, 0, 0, 0 );
   }
   
+#if IL_MOTION_SEED
+  // test whether the base layer motion is a better start point, within the search window
+  for ( Int i = 0; i < m_iNumILMvSeeds; i++ )
+  {
+    TComMv cMv = m_acILMvSeeds[i];
+    pcCU->clipMv( cMv );
+    cMv >>= 2;
+    xTZSearchHelp( pcPatternKey, cStruct, Clip3( iSrchRngHorLeft, iSrchRngHorRight, cMv.getHor() ), Clip3( iSrchRngVerTop, iSrchRngVerBottom, cMv.getVer() ), 0, 0 );
+  }
+#endif
+#if LOOKAHEAD_ME
+  // test whether the motion of the lookahead ME is a better start point, within the search window
+  if ( m_bLookaheadMv )
+  {
+    TComMv cMv = m_cLookaheadMv;
+    pcCU->clipMv( cMv );
+    cMv >>= 2;
+    xTZSearchHelp( pcPatternKey, cStruct, Clip3( iSrchRngHorLeft, iSrchRngHorRight, cMv.getHor() ), Clip3( iSrchRngVerTop, iSrchRngVerBottom, cMv.getVer() ), 0, 0 );
+  }
+#endif
+
   // start search
   Int  iDist = 0;
   Int  iStartX = cStruct.iBestX;
@@ -4827,7 +5316,11 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
 
     if (m_pcEncCfg->getUseRDOQ())
     {
+#if FAST_RDOQ
+      xEstimateRDOQBits( trWidth, trHeight, TEXT_LUMA );
+#else
       m_pcEntropyCoder->estimateBit(m_pcTrQuant->m_pcEstBitsSbac, trWidth, trHeight, TEXT_LUMA );        
+#endif
     }
 
 #if REPN_FORMAT_IN_VPS
@@ -4851,7 +5344,11 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
     {
       if (m_pcEncCfg->getUseRDOQ())
       {
+#if FAST_RDOQ
+        xEstimateRDOQBits( trWidthC, trHeightC, TEXT_CHROMA );
+#else
         m_pcEntropyCoder->estimateBit(m_pcTrQuant->m_pcEstBitsSbac, trWidthC, trHeightC, TEXT_CHROMA );          
+#endif
       }
 
       Int curChromaQpOffset = pcCU->getSlice()->getPPS()->getChromaCbQpOffset() + pcCU->getSlice()->getSliceQpDeltaCb();
@@ -5169,7 +5666,11 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
 
       if (m_pcEncCfg->getUseRDOQTS())
       {
+#if FAST_RDOQ
+        xEstimateRDOQBits( trWidth, trHeight, TEXT_LUMA );
+#else
         m_pcEntropyCoder->estimateBit( m_pcTrQuant->m_pcEstBitsSbac, trWidth, trHeight, TEXT_LUMA );        
+#endif
       }
 
 #if REPN_FORMAT_IN_VPS
@@ -5267,7 +5768,11 @@ Void TEncSearch::xEstimateResidualQT( TComDataCU* pcCU, UInt uiQuadrant, UInt ui
 
       if (m_pcEncCfg->getUseRDOQTS())
       {
+#if FAST_RDOQ
+        xEstimateRDOQBits( trWidthC, trHeightC, TEXT_CHROMA );
+#else
         m_pcEntropyCoder->estimateBit(m_pcTrQuant->m_pcEstBitsSbac, trWidthC, trHeightC, TEXT_CHROMA );          
+#endif
       }
 
       Int curChromaQpOffset = pcCU->getSlice()->getPPS()->getChromaCbQpOffset() + pcCU->getSlice()->getSliceQpDeltaCb();
@@ -5686,6 +6191,112 @@ UInt TEncSearch::xModeBitsIntra( TComDataCU* pcCU, UInt uiMode, UInt uiPU, UInt
   return m_pcEntropyCoder->getNumberOfWrittenBits();
 }
 
+#if FAST_INTRA_SEARCH
+/** Hadamard cost of an intra mode of a PU, added to the candidates of the full RD check, unless it has been tested before
+ * \param pdModeCost    cost of each mode of the PU, negative when it has not been tested yet
+ * \param ruiCandNum    number of updates of the candidate list
+ */
+Void TEncSearch::xCheckIntraModeHAD( TComDataCU* pcCU, UInt uiMode, UInt uiPU, UInt uiPartOffset, UInt uiDepth, UInt uiInitTrDepth,
+                                     Pel* piOrg, Pel* piPred, UInt uiStride, UInt uiWidth, UInt uiHeight, Bool bAboveAvail, Bool bLeftAvail,
+                                     Double* pdModeCost, UInt uiFastCandNum, UInt* puiCandModeList, Double* pdCandCostList, UInt& ruiCandNum )
+{
+  if( pdModeCost[uiMode] >= 0.0 )
+  {
+    return;
+  }
+  predIntraLumaAng( pcCU->getPattern(), uiMode, piPred, uiStride, uiWidth, uiHeight, bAboveAvail, bLeftAvail );
+
+  UInt   uiSad     = m_pcRdCost->calcHAD( g_bitDepthY, piOrg, uiStride, piPred, uiStride, uiWidth, uiHeight );
+  UInt   iModeBits = xModeBitsIntra( pcCU, uiMode, uiPU, uiPartOffset, uiDepth, uiInitTrDepth );
+  Double dCost     = (Double)uiSad + (Double)iModeBits * m_pcRdCost->getSqrtLambda();
+
+  pdModeCost[uiMode] = dCost;
+  ruiCandNum += xUpdateCandList( uiMode, dCost, uiFastCandNum, puiCandModeList, pdCandCostList );
+}
+
+/** Angular intra modes along the dominant edges of a block, from a histogram of the Sobel gradients of the original samples
+ *  weighted by their magnitude
+ * \param puiModes   modes in decreasing order of the histogram
+ * \param iMaxModes  maximum number of modes
+ * \returns number of modes found
+ */
+Int TEncSearch::xGetGradientIntraModes( Pel* piOrg, UInt uiStride, UInt uiWidth, UInt uiHeight, UInt* puiModes, Int iMaxModes )
+{
+  // histogram of the displacement of the edges in 1/32 samples, per row for mainly horizontal edges and per column otherwise
+  Int aaiAngleHist[2][65];
+  ::memset( aaiAngleHist, 0, sizeof( aaiAngleHist ) );
+
+  const Int iStride = uiStride;
+  for( Int y = 1; y < (Int)uiHeight - 1; y++ )
+  {
+    const Pel* p = piOrg + y * iStride;
+    for( Int x = 1; x < (Int)uiWidth - 1; x++ )
+    {
+      const Int iGx = ( p[x-iStride+1] + 2 * p[x+1] + p[x+iStride+1] ) - ( p[x-iStride-1] + 2 * p[x-1] + p[x+iStride-1] );
+      const Int iGy = ( p[x+iStride-1] + 2 * p[x+iStride] + p[x+iStride+1] ) - ( p[x-iStride-1] + 2 * p[x-iStride] + p[x-iStride+1] );
+      if( iGx == 0 && iGy == 0 )
+      {
+        continue;
+      }
+      if( abs( iGy ) >= abs( iGx ) )
+      {
+        aaiAngleHist[0][ 32 + ( 32 * iGx ) / iGy ] += abs( iGx ) + abs( iGy );
+      }
+      else
+      {
+        aaiAngleHist[1][ 32 + ( 32 * iGy ) / iGx ] += abs( iGx ) + abs( iGy );
+      }
+    }
+  }
+
+  // modes 2 to 18 predict along the displacement per row, modes 18 to 34 along the displacement per column
+  Int aiModeHist[NUM_INTRA_MODE-1];
+  ::memset( aiModeHist, 0, sizeof( aiModeHist ) );
+  for( Int iDir = 0; iDir < 2; iDir++ )
+  {
+    const Int iFirstMode = iDir == 0 ? 2 : 18;
+    for( Int iAngle = -32; iAngle <= 32; iAngle++ )
+    {
+      if( aaiAngleHist[iDir][iAngle+32] == 0 )
+      {
+        continue;
+      }
+      Int iBestMode = iFirstMode;
+      for( Int iMode = iFirstMode + 1; iMode <= iFirstMode + 16; iMode++ )
+      {
+        const Int iModeAngle = iMode == 18 ? -32 : s_aiIntraPredAngle[iMode];
+        const Int iBestAngle = iBestMode == 18 ? -32 : s_aiIntraPredAngle[iBestMode];
+        if( abs( iModeAngle - iAngle ) < abs( iBestAngle - iAngle ) )
+        {
+          iBestMode = iMode;
+        }
+      }
+      aiModeHist[iBestMode] += aaiAngleHist[iDir][iAngle+32];
+    }
+  }
+
+  Int iNumModes = 0;
+  for( ; iNumModes < iMaxModes; iNumModes++ )
+  {
+    Int iBestMode = -1;
+    for( Int iMode = 2; iMode < NUM_INTRA_MODE-1; iMode++ )
+    {
+      if( aiModeHist[iMode] > 0 && ( iBestMode < 0 || aiModeHist[iMode] > aiModeHist[iBestMode] ) )
+      {
+        iBestMode = iMode;
+      }
+    }
+    if( iBestMode < 0 )
+    {
+      break;
+    }
+    puiModes[iNumModes]   = iBestMode;
+    aiModeHist[iBestMode] = 0;
+  }
+  return iNumModes;
+}
+#endif
+
 UInt TEncSearch::xUpdateCandList( UInt uiMode, Double uiCost, UInt uiFastCandNum, UInt * CandModeList, Double * CandCostList )
 {
   UInt i;
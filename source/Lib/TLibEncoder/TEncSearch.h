@@ -45,6 +45,9 @@
 #include "TLibCommon/TComPrediction.h"
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/TComPic.h"
+#if PARALLEL_ME
+#include "TLibCommon/TComThreadPool.h"
+#endif
 #include "TEncEntropy.h"
 #include "TEncSbac.h"
 #include "TEncCfg.h"
@@ -109,6 +112,22 @@ protected:
   TComMv          m_cSrchRngLT;
   TComMv          m_cSrchRngRB;
   TComMv          m_acMvPredictors[3];
+#if IL_MOTION_SEED
+  TComMv          m_acILMvSeeds[2];     ///< base layer motion of the current PU, scaled to the reference picture
+  Int             m_iNumILMvSeeds;
+#endif
+#if LOOKAHEAD_ME
+  TComMv          m_cLookaheadMv;       ///< motion of the lookahead ME at the centre of the current PU
+  Bool            m_bLookaheadMv;
+#endif
+#if PARALLEL_ME
+  TComPattern     m_cPatternKey;        ///< search key of the motion estimation
+  Bool            m_bUseMEHelpers;      ///< only the main search of a layer has copies, not the copies and the searches of the WPP workers
+  Int             m_iNumMEHelpers;
+  TEncSearch**    m_apcMEHelper;        ///< copies of the search running the motion estimations of the reference pictures concurrently
+  TComRdCost*     m_acMEHelperRdCost;   ///< cost functions of the copies
+  TComThreadPool  m_cMEThreadPool;      ///< one thread per copy, created by the first concurrent motion estimation
+#endif
   
   // RD computation
   TEncSbac***     m_pppcRDSbacCoder;
@@ -144,6 +163,9 @@ public:
             TComRdCost*   pcRdCost,
             TEncSbac***   pppcRDSbacCoder,
             TEncSbac*     pcRDGoOnSbacCoder );
+#if PARALLEL_ME
+  Void setUseMEHelpers( Bool b ) { m_bUseMEHelpers = b; }   ///< to be called before init()
+#endif
   
 protected:
   
@@ -164,6 +186,19 @@ protected:
     UChar ucPointNr;
   } IntTZSearchStruct;
   
+#if PARALLEL_ME
+  /// uni-directional motion estimation of one reference picture of a PU
+  typedef struct
+  {
+    RefPicList  eRefPicList;
+    Int         iRefIdx;
+    TComMv      cMvPred;
+    TComMv      cMv;
+    UInt        uiBits;
+    UInt        uiCost;
+  } MotionSearchJob;
+#endif
+  
   // sub-functions for ME
   __inline Void xTZSearchHelp         ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStruct, const Int iSearchX, const Int iSearchY, const UChar ucPointNr, const UInt uiDistance );
   __inline Void xTZ2PointSearch       ( TComPattern* pcPatternKey, IntTZSearchStruct& rcStrukt, TComMv* pcMvSrchRngLT, TComMv* pcMvSrchRngRB );
@@ -218,6 +253,9 @@ public:
   
   /// set ME search range
   Void setAdaptiveSearchRange   ( Int iDir, Int iRefIdx, Int iSearchRange) { m_aaiAdaptSR[iDir][iRefIdx] = iSearchRange; }
+#if ENC_WPP_PARALLEL
+  Int  getAdaptiveSearchRange   ( Int iDir, Int iRefIdx )                  { return m_aaiAdaptSR[iDir][iRefIdx]; }
+#endif
   
   Void xEncPCM    (TComDataCU* pcCU, UInt uiAbsPartIdx, Pel* piOrg, Pel* piPCM, Pel* piPred, Pel* piResi, Pel* piReco, UInt uiStride, UInt uiWidth, UInt uiHeight, TextType eText);
   Void IPCMSearch (TComDataCU* pcCU, TComYuv* pcOrgYuv, TComYuv*& rpcPredYuv, TComYuv*& rpcResiYuv, TComYuv*& rpcRecoYuv );
@@ -233,6 +271,10 @@ public:
 
 protected:
   
+#if FAST_RDOQ
+  Void  xEstimateRDOQBits         ( UInt uiWidth, UInt uiHeight, TextType eTextType );  ///< set the rates of the RDOQ of a TU
+#endif
+
   // -------------------------------------------------------------------------------------------------------------------
   // Intra search
   // -------------------------------------------------------------------------------------------------------------------
@@ -412,6 +454,23 @@ protected:
                                     UInt&         ruiCost,
                                     Bool          bBi = false  );
   
+#if PARALLEL_ME
+  Void xMotionEstimationRefs      ( TComDataCU*   pcCU,
+                                    TComYuv*      pcYuvOrg,
+                                    Int           iPartIdx,
+                                    MotionSearchJob* pcJobs,
+                                    Int           iNumJobs );
+  
+  Void xMotionEstimationJobs      ( TComDataCU*   pcCU,
+                                    TComYuv*      pcYuvOrg,
+                                    Int           iPartIdx,
+                                    MotionSearchJob* pcJobs,
+                                    Int           iFirstJob,
+                                    Int           iNumJobs,
+                                    Int           iJobStep,
+                                    TComSyncCounter* pcDone );
+#endif
+  
   Void xTZSearch                  ( TComDataCU*   pcCU,
                                     TComPattern*  pcPatternKey,
                                     Pel*          piRefY,
@@ -421,6 +480,15 @@ protected:
                                     TComMv&       rcMv,
                                     UInt&         ruiSAD );
   
+#if IL_MOTION_SEED
+  Void xGetILMotionSeeds          ( TComDataCU*   pcCU,
+                                    UInt          uiPartAddr,
+                                    Int           iRoiWidth,
+                                    Int           iRoiHeight,
+                                    RefPicList    eRefPicList,
+                                    Int           iRefIdx );
+#endif
+  
   Void xSetSearchRange            ( TComDataCU*   pcCU,
                                     TComMv&       cMvPred,
                                     Int           iSrchRng,
@@ -468,6 +536,12 @@ protected:
   
   UInt  xModeBitsIntra ( TComDataCU* pcCU, UInt uiMode, UInt uiPU, UInt uiPartOffset, UInt uiDepth, UInt uiInitTrDepth );
   UInt  xUpdateCandList( UInt uiMode, Double uiCost, UInt uiFastCandNum, UInt * CandModeList, Double * CandCostList );
+#if FAST_INTRA_SEARCH
+  Void  xCheckIntraModeHAD     ( TComDataCU* pcCU, UInt uiMode, UInt uiPU, UInt uiPartOffset, UInt uiDepth, UInt uiInitTrDepth,
+                                 Pel* piOrg, Pel* piPred, UInt uiStride, UInt uiWidth, UInt uiHeight, Bool bAboveAvail, Bool bLeftAvail,
+                                 Double* pdModeCost, UInt uiFastCandNum, UInt* puiCandModeList, Double* pdCandCostList, UInt& ruiCandNum );
+  Int   xGetGradientIntraModes ( Pel* piOrg, UInt uiStride, UInt uiWidth, UInt uiHeight, UInt* puiModes, Int iMaxModes );
+#endif
   
   // -------------------------------------------------------------------------------------------------------------------
   // compute symbol bits
@@ -58,6 +58,11 @@ TEncSlice::TEncSlice()
   m_pcBufferBinCoderCABACs  = NULL;
   m_pcBufferLowLatSbacCoders    = NULL;
   m_pcBufferLowLatBinCoderCABACs  = NULL;
+#if ENC_WPP_PARALLEL
+  m_pcWppRowProgress       = NULL;
+  m_pcWppRowBinCoderCABACs = NULL;
+  m_pcWppRowSbacCoders     = NULL;
+#endif
 }
 
 TEncSlice::~TEncSlice()
@@ -149,6 +154,21 @@ Void TEncSlice::destroy()
     delete[] m_pcBufferLowLatSbacCoders;
   if ( m_pcBufferLowLatBinCoderCABACs )
     delete[] m_pcBufferLowLatBinCoderCABACs;
+#if ENC_WPP_PARALLEL
+  for( Int i = 0; i < m_apcWppWorkers.size(); i++ )
+  {
+    m_apcWppWorkers[i]->destroy();
+    delete m_apcWppWorkers[i];
+  }
+  m_apcWppWorkers.clear();
+  m_apcIdleWppWorkers.clear();
+  delete[] m_pcWppRowProgress;
+  delete[] m_pcWppRowSbacCoders;
+  delete[] m_pcWppRowBinCoderCABACs;
+  m_pcWppRowProgress       = NULL;
+  m_pcWppRowSbacCoders     = NULL;
+  m_pcWppRowBinCoderCABACs = NULL;
+#endif
 }
 
 Void TEncSlice::init( TEncTop* pcEncTop )
@@ -858,6 +878,17 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
   pppcRDSbacCoder = (TEncBinCABAC *) m_pppcRDSbacCoder[0][CI_CURR_BEST]->getEncBinIf();
   pppcRDSbacCoder->setBinCountingEnableFlag( false );
   pppcRDSbacCoder->setBinsCoded( 0 );
+#if FAST_RDOQ
+  if( m_pcCfg->getUseRDOQFast() )
+  {
+    // rates of the fast RDOQ, estimated once from the context states at the start of the slice
+    for( UInt uiWidth = 4; uiWidth <= 32; uiWidth <<= 1 )
+    {
+      m_pcEntropyCoder->estimateBit( m_pcTrQuant->getSliceEstBits( uiWidth, TEXT_LUMA ),   uiWidth, uiWidth, TEXT_LUMA );
+      m_pcEntropyCoder->estimateBit( m_pcTrQuant->getSliceEstBits( uiWidth, TEXT_CHROMA ), uiWidth, uiWidth, TEXT_CHROMA );
+    }
+  }
+#endif
   
   //------------------------------------------------------------------------------
   //  Weighted Prediction parameters estimation.
@@ -1016,6 +1047,13 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
   }
   // for every CU in slice
   UInt uiEncCUOrder;
+#if ENC_WPP_PARALLEL
+  if( xUseWppWorkers( rpcPic, uiStartCUAddr, uiBoundingCUAddr ) )
+  {
+    xCompressCtuRows( rpcPic );
+  }
+  else
+#endif
   for( uiEncCUOrder = uiStartCUAddr/rpcPic->getNumPartInCU();
        uiEncCUOrder < (uiBoundingCUAddr+(rpcPic->getNumPartInCU()-1))/rpcPic->getNumPartInCU();
        uiCUAddr = rpcPic->getPicSym()->getCUOrderMap(++uiEncCUOrder) )
@@ -1249,6 +1287,207 @@ Void TEncSlice::compressSlice( TComPic*& rpcPic )
   xRestoreWPparam( pcSlice );
 }
 
+#if ENC_WPP_PARALLEL
+/** The CTU rows are encoded concurrently when the slice is the whole picture in a single tile with a substream per CTU row
+ * and no CTU level state is carried from a row to the next one besides the WPP contexts.
+ \param  pcPic            picture class
+ \param  uiStartCUAddr    start address of the slice
+ \param  uiBoundingCUAddr bounding address of the slice
+ \returns true if the CTU rows can be encoded concurrently
+ */
+Bool TEncSlice::xUseWppWorkers( TComPic* pcPic, UInt uiStartCUAddr, UInt uiBoundingCUAddr )
+{
+  TComThreadPool* pcThreadPool = ((TEncTop*) m_pcCfg)->getThreadPool();
+  TComSlice*      pcSlice      = pcPic->getSlice(getSliceIdx());
+
+  if( !m_pcCfg->getWaveFrontsynchro() || pcThreadPool == NULL || pcThreadPool->getNumThreads() < 2 )
+  {
+    return false;
+  }
+  if( uiStartCUAddr != 0 || uiBoundingCUAddr != pcPic->getNumCUsInFrame() * pcPic->getNumPartInCU() ||
+      pcPic->getPicSym()->getNumTiles() != 1 || pcSlice->getPPS()->getDependentSliceSegmentsEnabledFlag() ||
+      pcSlice->getPPS()->getNumSubstreams() != pcPic->getFrameHeightInCU() )
+  {
+    return false;
+  }
+  // the byte limited slices, the rate control and the adaptive QP selection are updated CTU by CTU in coding order
+  if( m_pcCfg->getSliceMode() == FIXED_NUMBER_OF_BYTES || m_pcCfg->getSliceSegmentMode() == FIXED_NUMBER_OF_BYTES || m_pcCfg->getUseRateCtrl() )
+  {
+    return false;
+  }
+#if ADAPTIVE_QP_SELECTION
+  if( m_pcCfg->getUseAdaptQpSelect() )
+  {
+    return false;
+  }
+#endif
+  return true;
+}
+
+/** Encode the CTU rows of the picture with the thread pool, each row two CTUs behind the row above.
+ * The result is the same as the one of the sequential CTU loop of compressSlice().
+ \param  pcPic  picture class
+ */
+Void TEncSlice::xCompressCtuRows( TComPic* pcPic )
+{
+  TEncTop*        pcEncTop       = (TEncTop*) m_pcCfg;
+  TComThreadPool* pcThreadPool   = pcEncTop->getThreadPool();
+  TComSlice*      pcSlice        = pcPic->getSlice(getSliceIdx());
+  const UInt      uiHeightInLCUs = pcPic->getFrameHeightInCU();
+
+  // one set of coding classes per thread, at most as many rows as threads are encoded at the same time
+  if( m_apcWppWorkers.empty() )
+  {
+    for( Int i = 0; i < pcThreadPool->getNumThreads(); i++ )
+    {
+      m_apcWppWorkers.push_back( new TEncWppWorker );
+      m_apcWppWorkers.back()->create( pcEncTop );
+    }
+  }
+  for( Int i = 0; i < m_apcWppWorkers.size(); i++ )
+  {
+    m_apcWppWorkers[i]->initSlice( pcEncTop );
+  }
+  m_apcIdleWppWorkers = m_apcWppWorkers;
+
+  delete[] m_pcWppRowProgress;
+  delete[] m_pcWppRowSbacCoders;
+  delete[] m_pcWppRowBinCoderCABACs;
+  m_pcWppRowProgress       = new TComSyncCounter[uiHeightInLCUs];
+  m_pcWppRowSbacCoders     = new TEncSbac       [uiHeightInLCUs];
+  m_pcWppRowBinCoderCABACs = new TEncBinCABAC   [uiHeightInLCUs];
+  for( UInt uiRow = 0; uiRow < uiHeightInLCUs; uiRow++ )
+  {
+    m_pcWppRowSbacCoders[uiRow].init( &m_pcWppRowBinCoderCABACs[uiRow] );
+  }
+
+  // the rows are queued in order, a row only waits for rows which are already running or done
+  TComSyncCounter cDone;
+  for( UInt uiRow = 0; uiRow < uiHeightInLCUs; uiRow++ )
+  {
+    pcThreadPool->addJob( std::bind( &TEncSlice::xCompressCtuRowJob, this, pcPic, uiRow, &cDone ) );
+  }
+  cDone.waitFor( uiHeightInLCUs );
+
+  // the picture cost is accumulated in coding order for the same rounding as the sequential loop
+  for( UInt uiCUAddr = 0; uiCUAddr < pcPic->getNumCUsInFrame(); uiCUAddr++ )
+  {
+    TComDataCU* pcCU = pcPic->getCU( uiCUAddr );
+    m_uiPicTotalBits += pcCU->getTotalBits();
+    m_dPicRdCost     += pcCU->getTotalCost();
+    m_uiPicDist      += pcCU->getTotalDistortion();
+  }
+
+  // leave the coders as the sequential loop does after the last CTU
+  TEncSbac****    ppppcRDSbacCoders = pcEncTop->getRDSbacCoders();
+  TComBitCounter* pcBitCounters     = pcEncTop->getBitCounters();
+  UInt            uiLastSubStrm     = uiHeightInLCUs - 1;
+  m_pcEntropyCoder->setEntropyCoder ( m_pcRDGoOnSbacCoder, pcSlice );
+  m_pcEntropyCoder->setBitstream( &pcBitCounters[uiLastSubStrm] );
+  ((TEncBinCABAC*)m_pcRDGoOnSbacCoder->getEncBinIf())->setBinCountingEnableFlag(true);
+  m_pppcRDSbacCoder[0][CI_CURR_BEST]->load( ppppcRDSbacCoders[uiLastSubStrm][0][CI_CURR_BEST] );
+  m_pcEntropyCoder->setEntropyCoder ( m_pppcRDSbacCoder[0][CI_CURR_BEST], pcSlice );
+  m_pcEntropyCoder->setBitstream( &pcBitCounters[uiLastSubStrm] );
+  m_pcCuEncoder->setBitCounter( &pcBitCounters[uiLastSubStrm] );
+  m_pcBitCounter = &pcBitCounters[uiLastSubStrm];
+}
+
+Void TEncSlice::xCompressCtuRowJob( TComPic* pcPic, UInt uiRow, TComSyncCounter* pcDone )
+{
+  TEncWppWorker* pcWorker;
+  {
+    std::lock_guard<std::mutex> cLock( m_cWppWorkerMutex );
+    pcWorker = m_apcIdleWppWorkers.back();
+    m_apcIdleWppWorkers.pop_back();
+  }
+
+  xCompressCtuRow( pcPic, uiRow, pcWorker );
+
+  {
+    std::lock_guard<std::mutex> cLock( m_cWppWorkerMutex );
+    m_apcIdleWppWorkers.push_back( pcWorker );
+  }
+  pcDone->increment();
+}
+
+/** Encode a CTU row with its own coding classes, it follows the CTU loop of compressSlice() for a single tile.
+ \param  pcPic     picture class
+ \param  uiRow     CTU row, also the substream of the row
+ \param  pcWorker  coding classes used for the row
+ */
+Void TEncSlice::xCompressCtuRow( TComPic* pcPic, UInt uiRow, TEncWppWorker* pcWorker )
+{
+  TEncTop*        pcEncTop          = (TEncTop*) m_pcCfg;
+  TComSlice*      pcSlice           = pcPic->getSlice(getSliceIdx());
+  TEncSbac****    ppppcRDSbacCoders = pcEncTop->getRDSbacCoders();
+  TComBitCounter* pcBitCounters     = pcEncTop->getBitCounters();
+  TEncSbac***     pppcRDSbacCoder   = pcWorker->getRDSbacCoder();
+  TEncSbac*       pcRDGoOnSbacCoder = pcWorker->getRDGoOnSbacCoder();
+  TEncEntropy*    pcEntropyCoder    = pcWorker->getEntropyCoder();
+  TEncCu*         pcCuEncoder       = pcWorker->getCuEncoder();
+  const UInt      uiWidthInLCUs     = pcPic->getFrameWidthInCU();
+  const UInt      uiSubStrm         = uiRow;
+
+  TEncBinCABAC* pcRDBinCABAC = (TEncBinCABAC*) pppcRDSbacCoder[0][CI_CURR_BEST]->getEncBinIf();
+  pcRDBinCABAC->setBinCountingEnableFlag( false );
+  pcRDBinCABAC->setBinsCoded( 0 );
+
+  for( UInt uiCol = 0; uiCol < uiWidthInLCUs; uiCol++ )
+  {
+    // the reconstruction, the motion and the contexts up to the top-right CTU are needed
+    if( uiRow > 0 )
+    {
+      m_pcWppRowProgress[uiRow-1].waitFor( min( uiCol+2, uiWidthInLCUs ) );
+    }
+
+    UInt uiCUAddr = uiRow * uiWidthInLCUs + uiCol;
+    TComDataCU*& pcCU = pcPic->getCU( uiCUAddr );
+    pcCU->initCU( pcPic, uiCUAddr );
+
+    // inherit the contexts from the top-right CTU
+    if( uiCol == 0 && uiRow > 0 && uiWidthInLCUs > 1 )
+    {
+      ppppcRDSbacCoders[uiSubStrm][0][CI_CURR_BEST]->loadContexts( &m_pcWppRowSbacCoders[uiRow-1] );
+    }
+    pppcRDSbacCoder[0][CI_CURR_BEST]->load( ppppcRDSbacCoders[uiSubStrm][0][CI_CURR_BEST] );
+
+    // set go-on entropy coder
+    pcEntropyCoder->setEntropyCoder ( pcRDGoOnSbacCoder, pcSlice );
+    pcEntropyCoder->setBitstream( &pcBitCounters[uiSubStrm] );
+
+    ((TEncBinCABAC*)pcRDGoOnSbacCoder->getEncBinIf())->setBinCountingEnableFlag(true);
+
+    // run CU encoder
+    pcCuEncoder->compressCU( pcCU );
+
+    // restore entropy coder to an initial stage
+    pcEntropyCoder->setEntropyCoder ( pppcRDSbacCoder[0][CI_CURR_BEST], pcSlice );
+    pcEntropyCoder->setBitstream( &pcBitCounters[uiSubStrm] );
+    pcCuEncoder->setBitCounter( &pcBitCounters[uiSubStrm] );
+    pcRDBinCABAC->setBinCountingEnableFlag( true );
+    pcBitCounters[uiSubStrm].resetBits();
+    pcRDBinCABAC->setBinsCoded( 0 );
+    pcCuEncoder->encodeCU( pcCU );
+    pcRDBinCABAC->setBinCountingEnableFlag( false );
+
+    ppppcRDSbacCoders[uiSubStrm][0][CI_CURR_BEST]->load( pppcRDSbacCoder[0][CI_CURR_BEST] );
+    //Store probabilties of second LCU in line into buffer
+    if( uiCol == 1 )
+    {
+      m_pcWppRowSbacCoders[uiRow].loadContexts( ppppcRDSbacCoders[uiSubStrm][0][CI_CURR_BEST] );
+    }
+
+    m_pcWppRowProgress[uiRow].increment();
+  }
+
+  // the last row finishes last, its go-on coder state (including the fractional bits) is used by the SAO decision
+  if( uiRow == pcPic->getFrameHeightInCU() - 1 )
+  {
+    m_pcRDGoOnSbacCoder->load( pcRDGoOnSbacCoder );
+  }
+}
+#endif
+
 /**
  \param  rpcPic        picture class
  \retval rpcBitstream  bitstream class
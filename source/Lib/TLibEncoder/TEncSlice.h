@@ -46,6 +46,10 @@
 #include "TEncCu.h"
 #include "WeightPredAnalysis.h"
 #include "TEncRateCtrl.h"
+#if ENC_WPP_PARALLEL
+#include "TLibCommon/TComThreadPool.h"
+#include "TEncWppWorker.h"
+#endif
 
 //! \ingroup TLibEncoder
 //! \{
@@ -102,6 +106,14 @@ private:
   TEncRateCtrl*           m_pcRateCtrl;                         ///< Rate control manager
   UInt                    m_uiSliceIdx;
   std::vector<TEncSbac*> CTXMem;
+#if ENC_WPP_PARALLEL
+  std::vector<TEncWppWorker*> m_apcWppWorkers;                  ///< coding classes of the concurrently encoded CTU rows
+  std::vector<TEncWppWorker*> m_apcIdleWppWorkers;              ///< coding classes not used by a CTU row
+  std::mutex              m_cWppWorkerMutex;                    ///< protects the list of idle coding classes
+  TComSyncCounter*        m_pcWppRowProgress;                   ///< number of encoded CTUs of each CTU row
+  TEncBinCABAC*           m_pcWppRowBinCoderCABACs;             ///< bin coders CABAC of the synchronisation contexts
+  TEncSbac*               m_pcWppRowSbacCoders;                 ///< contexts after the second CTU of each CTU row
+#endif
 
 #if SVC_EXTENSION
   TEncTop**               m_ppcTEncTop;
@@ -155,6 +167,12 @@ public:
 
 private:
   Double  xGetQPValueAccordingToLambda ( Double lambda );
+#if ENC_WPP_PARALLEL
+  Bool    xUseWppWorkers      ( TComPic* pcPic, UInt uiStartCUAddr, UInt uiBoundingCUAddr ); ///< check whether the CTU rows of the slice can be encoded concurrently
+  Void    xCompressCtuRows    ( TComPic* pcPic );                                       ///< encode the CTU rows of the picture concurrently
+  Void    xCompressCtuRowJob  ( TComPic* pcPic, UInt uiRow, TComSyncCounter* pcDone );
+  Void    xCompressCtuRow     ( TComPic* pcPic, UInt uiRow, TEncWppWorker* pcWorker );
+#endif
 
 #if SVC_EXTENSION
 #if JCTVC_M0259_LAMBDAREFINEMENT
@@ -44,11 +44,6 @@
 
 //! \ingroup TLibEncoder
 //! \{
-#if SVC_EXTENSION  
-Int TEncTop::m_iSPSIdCnt = 0;
-Int TEncTop::m_iPPSIdCnt = 0;
-TComVPS TEncCfg::m_cVPS;
-#endif
 
 // ====================================================================================================================
 // Constructor / destructor / create / destroy
@@ -59,6 +54,9 @@ TEncTop::TEncTop()
   m_iPOCLast          = -1;
   m_iNumPicRcvd       =  0;
   m_uiNumAllPicCoded  =  0;
+#if TOOL_THREAD_POOL
+  m_pcThreadPool      =  NULL;
+#endif
   m_pppcRDSbacCoder   =  NULL;
   m_pppcBinCoderCABAC =  NULL;
   m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
@@ -83,6 +81,8 @@ TEncTop::TEncTop()
   m_pcBitCounters          = NULL;
   m_pcRdCosts              = NULL;
 #if SVC_EXTENSION
+  m_iSPSIdCnt = 0;
+  m_iPPSIdCnt = 0;
   memset(m_cIlpPic, 0, sizeof(m_cIlpPic));
 #if REF_IDX_MFM
   m_bMFMEnabledFlag = false;
@@ -100,6 +100,9 @@ TEncTop::TEncTop()
 #if P0297_VPS_POC_LSB_ALIGNED_FLAG
   m_pocDecrementedInDPBFlag    = false;
 #endif
+#if ENC_LAYER_PIPELINE
+  m_layerPipeline              = false;
+#endif
 #endif //SVC_EXTENSION
 }
 
@@ -117,6 +120,11 @@ Void TEncTop::create ()
   initROM();
 #endif
 
+#if SIMD_X86
+  // the distortion functions of the instruction set level selected after the construction
+  m_cRdCost.init();
+#endif
+
   // create processing unit classes
 #if SVC_EXTENSION
   m_cGOPEncoder.        create( m_layerId );
@@ -324,11 +332,11 @@ Void TEncTop::init(Bool isFieldCoding)
   xInitSPS();
   
   /* set the VPS profile information */
-  *m_cVPS.getPTL() = *m_cSPS.getPTL();
+  *getVPS()->getPTL() = *m_cSPS.getPTL();
 #if VPS_VUI_BSP_HRD_PARAMS
-  m_cVPS.getTimingInfo()->setTimingInfoPresentFlag       ( true );
+  getVPS()->getTimingInfo()->setTimingInfoPresentFlag       ( true );
 #else
-  m_cVPS.getTimingInfo()->setTimingInfoPresentFlag       ( false );
+  getVPS()->getTimingInfo()->setTimingInfoPresentFlag       ( false );
 #endif
   // initialize PPS
   m_cPPS.setSPS(&m_cSPS);
@@ -352,6 +360,9 @@ Void TEncTop::init(Bool isFieldCoding)
                   ,m_useTransformSkipFast
 #if ADAPTIVE_QP_SELECTION                  
                   , m_bUseAdaptQpSelect
+#endif
+#if FAST_RDOQ
+                  , m_useRDOQFast
 #endif
                   );
   
@@ -360,10 +371,13 @@ Void TEncTop::init(Bool isFieldCoding)
 
   m_iMaxRefPicNum = 0;
 #if SVC_EXTENSION
-  m_iSPSIdCnt ++;
-  m_iPPSIdCnt ++;
+  m_ppcTEncTop[0]->m_iSPSIdCnt ++;
+  m_ppcTEncTop[0]->m_iPPSIdCnt ++;
   xInitILRP();
 #endif
+
+  // the coding state set up by the application is restored whenever the layer is encoded
+  m_cCodingContext.save( true );
 }
 
 // ====================================================================================================================
@@ -399,6 +413,8 @@ Void TEncTop::deletePicBuffer()
 #if SVC_EXTENSION
 Void TEncTop::encode( TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int iPicIdInGOP )
 {
+  m_cCodingContext.bind();
+
   // compress GOP
 #if !RC_SHVC_HARMONIZATION
   if ( m_RCEnableRateControl )
@@ -407,9 +423,24 @@ Void TEncTop::encode( TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicY
   }
 #endif
 
+#if ENC_LAYER_PIPELINE
+  if( m_layerPipeline )
+  {
+    xWaitForPipelineStart();
+  }
+#endif
+
   // compress GOP
   m_cGOPEncoder.compressGOP(iPicIdInGOP, m_iPOCLast, m_iNumPicRcvd, m_cListPic, rcListPicYuvRecOut, accessUnitsOut, false, false);
 
+#if ENC_LAYER_PIPELINE
+  if( m_layerPipeline )
+  {
+    signalPicSetUp();
+    m_cNumPicEncoded.increment();
+  }
+#endif
+
 #if !RC_SHVC_HARMONIZATION
   if ( m_RCEnableRateControl )
   {
@@ -434,11 +465,19 @@ Void TEncTop::encodePrep( TComPicYuv* pcPicYuvOrg )
     {
       m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
     }
+#if LOOKAHEAD_ME
+    if ( getLookaheadME() )
+    {
+      m_cPreanalyzer.xBuildPyramid( dynamic_cast<TEncPic*>( pcPicCurr ) );
+    }
+#endif
   }
 }
 #else
 Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded )
 {
+  m_cCodingContext.bind();
+
   if (pcPicYuvOrg) {
     // get original YUV
     TComPic* pcPicCurr = NULL;
@@ -450,6 +489,12 @@ Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>&
     {
       m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcPicCurr ) );
     }
+#if LOOKAHEAD_ME
+    if ( getLookaheadME() )
+    {
+      m_cPreanalyzer.xBuildPyramid( dynamic_cast<TEncPic*>( pcPicCurr ) );
+    }
+#endif
   }
   
   if (!m_iNumPicRcvd || (!flush && m_iPOCLast != 0 && m_iNumPicRcvd != m_iGOPSize && m_iGOPSize))
@@ -535,7 +580,13 @@ Void TEncTop::encodePrep( TComPicYuv* pcPicYuvOrg, Bool isTff )
     if ( getUseAdaptiveQP() )
     {
       m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcTopField ) );
-    }    
+    }
+#if LOOKAHEAD_ME
+    if ( getLookaheadME() )
+    {
+      m_cPreanalyzer.xBuildPyramid( dynamic_cast<TEncPic*>( pcTopField ) );
+    }
+#endif    
 
     /* -- Defield -- */
     
@@ -575,7 +626,13 @@ Void TEncTop::encodePrep( TComPicYuv* pcPicYuvOrg, Bool isTff )
     if ( getUseAdaptiveQP() )
     {
       m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcBottomField ) );
-    }       
+    }
+#if LOOKAHEAD_ME
+    if ( getLookaheadME() )
+    {
+      m_cPreanalyzer.xBuildPyramid( dynamic_cast<TEncPic*>( pcBottomField ) );
+    }
+#endif       
 
     /* -- Defield -- */
     
@@ -590,6 +647,8 @@ Void TEncTop::encodePrep( TComPicYuv* pcPicYuvOrg, Bool isTff )
 
 Void TEncTop::encode( TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int iPicIdInGOP, Bool isTff )
 {
+  m_cCodingContext.bind();
+
   // compress GOP
   if (m_iPOCLast == 0) // compress field 0
   {
@@ -622,6 +681,8 @@ Void TEncTop::encode( TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicY
 #else
 Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>& rcListPicYuvRecOut, std::list<AccessUnit>& accessUnitsOut, Int& iNumEncoded, Bool isTff)
 {
+  m_cCodingContext.bind();
+
   /* -- TOP FIELD -- */
   
   if (pcPicYuvOrg)
@@ -657,6 +718,12 @@ Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>&
     {
       m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcTopField ) );
     }
+#if LOOKAHEAD_ME
+    if ( getLookaheadME() )
+    {
+      m_cPreanalyzer.xBuildPyramid( dynamic_cast<TEncPic*>( pcTopField ) );
+    }
+#endif
     
     /* -- Defield -- */
     
@@ -720,6 +787,12 @@ Void TEncTop::encode(Bool flush, TComPicYuv* pcPicYuvOrg, TComList<TComPicYuv*>&
     {
       m_cPreanalyzer.xPreanalyze( dynamic_cast<TEncPic*>( pcBottomField ) );
     }
+#if LOOKAHEAD_ME
+    if ( getLookaheadME() )
+    {
+      m_cPreanalyzer.xBuildPyramid( dynamic_cast<TEncPic*>( pcBottomField ) );
+    }
+#endif
     
     /* -- Defield -- */
     
@@ -776,34 +849,38 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
   }
   else
   {
+#if LOOKAHEAD_ME
+    if ( getUseAdaptiveQP() || getLookaheadME() )
+#else
     if ( getUseAdaptiveQP() )
+#endif
     {
       TEncPic* pcEPic = new TEncPic;
 
 #if SVC_EXTENSION //Temporal solution, should be modified
       if(m_layerId > 0)
       {
-        for(UInt i = 0; i < m_cVPS.getNumDirectRefLayers( m_layerId ); i++ )
+        for(UInt i = 0; i < getVPS()->getNumDirectRefLayers( m_layerId ); i++ )
         {
 #if MOVE_SCALED_OFFSET_TO_PPS
 #if O0098_SCALED_REF_LAYER_ID
-          const Window scalEL = getPPS()->getScaledRefLayerWindowForLayer(m_cVPS.getRefLayerId(m_layerId, i));
+          const Window scalEL = getPPS()->getScaledRefLayerWindowForLayer(getVPS()->getRefLayerId(m_layerId, i));
 #else
           const Window scalEL = getPPS()->getScaledRefLayerWindow(i);
 #endif
 #else
 #if O0098_SCALED_REF_LAYER_ID
-          const Window scalEL = getSPS()->getScaledRefLayerWindowForLayer(m_cVPS.getRefLayerId(m_layerId, i));
+          const Window scalEL = getSPS()->getScaledRefLayerWindowForLayer(getVPS()->getRefLayerId(m_layerId, i));
 #else
           const Window scalEL = getSPS()->getScaledRefLayerWindow(i);
 #endif
 #endif
 #if REF_REGION_OFFSET
-          const Window altRL  = getPPS()->getRefLayerWindowForLayer(m_cVPS.getRefLayerId(m_layerId, i));
+          const Window altRL  = getPPS()->getRefLayerWindowForLayer(getVPS()->getRefLayerId(m_layerId, i));
 #if RESAMPLING_FIX
           Bool equalOffsets = scalEL.hasEqualOffset(altRL);
 #if R0209_GENERIC_PHASE
-          Bool zeroPhase = getPPS()->hasZeroResamplingPhase(m_cVPS.getRefLayerId(m_layerId, i));
+          Bool zeroPhase = getPPS()->hasZeroResamplingPhase(getVPS()->getRefLayerId(m_layerId, i));
 #endif
 #else
           Bool zeroOffsets = ( scalEL.getWindowLeftOffset() == 0 && scalEL.getWindowRightOffset() == 0 && scalEL.getWindowTopOffset() == 0 && scalEL.getWindowBottomOffset() == 0
@@ -819,7 +896,7 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
           TEncTop *pcEncTopBase = (TEncTop *)getLayerEnc( m_layerId-1 );
 #endif
 #if O0194_DIFFERENT_BITDEPTH_EL_BL
-          UInt refLayerId = m_cVPS.getRefLayerId(m_layerId, i);
+          UInt refLayerId = getVPS()->getRefLayerId(m_layerId, i);
           Bool sameBitDepths = ( g_bitDepthYLayer[m_layerId] == g_bitDepthYLayer[refLayerId] ) && ( g_bitDepthCLayer[m_layerId] == g_bitDepthCLayer[refLayerId] );
 
 #if REF_IDX_MFM
@@ -863,7 +940,7 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
             pcEPic->setSpatialEnhLayerFlag( i, true );
 
             //only for scalable extension
-            assert( m_cVPS.getScalabilityMask( SCALABILITY_ID ) == true );
+            assert( getVPS()->getScalabilityMask( SCALABILITY_ID ) == true );
           }
         }
       }
@@ -890,27 +967,27 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
 #if SVC_EXTENSION //Temporal solution, should be modified
       if(m_layerId > 0)
       {
-        for(UInt i = 0; i < m_cVPS.getNumDirectRefLayers( m_layerId ); i++ )
+        for(UInt i = 0; i < getVPS()->getNumDirectRefLayers( m_layerId ); i++ )
         {
 #if MOVE_SCALED_OFFSET_TO_PPS
 #if O0098_SCALED_REF_LAYER_ID
-          const Window scalEL = getPPS()->getScaledRefLayerWindowForLayer(m_cVPS.getRefLayerId(m_layerId, i));
+          const Window scalEL = getPPS()->getScaledRefLayerWindowForLayer(getVPS()->getRefLayerId(m_layerId, i));
 #else
           const Window scalEL = getPPS()->getScaledRefLayerWindow(i);
 #endif
 #else
 #if O0098_SCALED_REF_LAYER_ID
-          const Window scalEL = getSPS()->getScaledRefLayerWindowForLayer(m_cVPS.getRefLayerId(m_layerId, i));
+          const Window scalEL = getSPS()->getScaledRefLayerWindowForLayer(getVPS()->getRefLayerId(m_layerId, i));
 #else
           const Window scalEL = getSPS()->getScaledRefLayerWindow(i);
 #endif
 #endif
 #if REF_REGION_OFFSET
-          const Window altRL  = getPPS()->getRefLayerWindowForLayer(m_cVPS.getRefLayerId(m_layerId, i));
+          const Window altRL  = getPPS()->getRefLayerWindowForLayer(getVPS()->getRefLayerId(m_layerId, i));
 #if RESAMPLING_FIX
           Bool equalOffsets = scalEL.hasEqualOffset(altRL);
 #if R0209_GENERIC_PHASE
-          Bool zeroPhase = getPPS()->hasZeroResamplingPhase(m_cVPS.getRefLayerId(m_layerId, i));
+          Bool zeroPhase = getPPS()->hasZeroResamplingPhase(getVPS()->getRefLayerId(m_layerId, i));
 #endif
 #else
           Bool zeroOffsets = ( scalEL.getWindowLeftOffset() == 0 && scalEL.getWindowRightOffset() == 0 && scalEL.getWindowTopOffset() == 0 && scalEL.getWindowBottomOffset() == 0
@@ -926,7 +1003,7 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
           TEncTop *pcEncTopBase = (TEncTop *)getLayerEnc( m_layerId-1 );
 #endif
 #if O0194_DIFFERENT_BITDEPTH_EL_BL
-          UInt refLayerId = m_cVPS.getRefLayerId(m_layerId, i);
+          UInt refLayerId = getVPS()->getRefLayerId(m_layerId, i);
           Bool sameBitDepths = ( g_bitDepthYLayer[m_layerId] == g_bitDepthYLayer[refLayerId] ) && ( g_bitDepthCLayer[m_layerId] == g_bitDepthCLayer[refLayerId] );
 
           if( m_iSourceWidth != pcEncTopBase->getSourceWidth() || m_iSourceHeight != pcEncTopBase->getSourceHeight() || !sameBitDepths 
@@ -961,7 +1038,7 @@ Void TEncTop::xGetNewPicBuffer ( TComPic*& rpcPic )
             rpcPic->setSpatialEnhLayerFlag( i, true );
 
             //only for scalable extension
-            assert( m_cVPS.getScalabilityMask( SCALABILITY_ID ) == true );
+            assert( getVPS()->getScalabilityMask( SCALABILITY_ID ) == true );
           }
         }
       }
@@ -1070,7 +1147,7 @@ Void TEncTop::xInitSPS()
   m_cSPS.setLog2MinCodingBlockSize(log2MinCUSize);
   m_cSPS.setLog2DiffMaxMinCodingBlockSize(m_cSPS.getMaxCUDepth()-g_uiAddCUDepth);
 #if SVC_EXTENSION
-  m_cSPS.setSPSId         ( m_iSPSIdCnt       );
+  m_cSPS.setSPSId         ( m_ppcTEncTop[0]->m_iSPSIdCnt );
 #endif
   
   m_cSPS.setPCMLog2MinSize (m_uiPCMLog2MinSize);
@@ -1102,11 +1179,11 @@ Void TEncTop::xInitSPS()
   }
 
 #if REPN_FORMAT_IN_VPS
-  m_cSPS.setBitDepthY( m_cVPS.getVpsRepFormat( m_cVPS.getVpsRepFormatIdx( m_layerId ) )->getBitDepthVpsLuma() );
-  m_cSPS.setBitDepthC( m_cVPS.getVpsRepFormat( m_cVPS.getVpsRepFormatIdx( m_layerId ) )->getBitDepthVpsChroma()  );
+  m_cSPS.setBitDepthY( getVPS()->getVpsRepFormat( getVPS()->getVpsRepFormatIdx( m_layerId ) )->getBitDepthVpsLuma() );
+  m_cSPS.setBitDepthC( getVPS()->getVpsRepFormat( getVPS()->getVpsRepFormatIdx( m_layerId ) )->getBitDepthVpsChroma()  );
 
-  m_cSPS.setQpBDOffsetY ( 6*(m_cVPS.getVpsRepFormat( m_cVPS.getVpsRepFormatIdx( m_layerId ) )->getBitDepthVpsLuma()  - 8) );
-  m_cSPS.setQpBDOffsetC ( 6*(m_cVPS.getVpsRepFormat( m_cVPS.getVpsRepFormatIdx( m_layerId ) )->getBitDepthVpsChroma()  - 8) );
+  m_cSPS.setQpBDOffsetY ( 6*(getVPS()->getVpsRepFormat( getVPS()->getVpsRepFormatIdx( m_layerId ) )->getBitDepthVpsLuma()  - 8) );
+  m_cSPS.setQpBDOffsetC ( 6*(getVPS()->getVpsRepFormat( getVPS()->getVpsRepFormatIdx( m_layerId ) )->getBitDepthVpsChroma()  - 8) );
 #else
   m_cSPS.setBitDepthY( g_bitDepthY );
   m_cSPS.setBitDepthC( g_bitDepthC );
@@ -1289,8 +1366,8 @@ Void TEncTop::xInitPPS()
     m_cPPS.setExtensionFlag(false);
   }
 
-  m_cPPS.setPPSId( m_iPPSIdCnt );
-  m_cPPS.setSPSId( m_iSPSIdCnt );
+  m_cPPS.setPPSId( m_ppcTEncTop[0]->m_iPPSIdCnt );
+  m_cPPS.setSPSId( m_ppcTEncTop[0]->m_iSPSIdCnt );
 #if POC_RESET_FLAG
   m_cPPS.setNumExtraSliceHeaderBits( 2 );
 #endif
@@ -1683,7 +1760,7 @@ TEncTop* TEncTop::getRefLayerEnc( UInt refLayerIdc )
     return (TEncTop *)getLayerEnc( 0 );
   }
 
-  return (TEncTop *)getLayerEnc( m_cVPS.getRefLayerId( m_layerId, refLayerIdc ) );
+  return (TEncTop *)getLayerEnc( getVPS()->getRefLayerId( m_layerId, refLayerIdc ) );
 }
 #endif
 
@@ -1725,9 +1802,9 @@ Void TEncTop::xInitILRP()
 Void TEncTop::xInitILRP()
 {
 #if O0096_REP_FORMAT_INDEX
-  RepFormat *repFormat = m_cVPS.getVpsRepFormat( m_cVPS.getVpsRepFormatIdx( m_cSPS.getUpdateRepFormatFlag() ? m_cSPS.getUpdateRepFormatIndex() : m_layerId ) );
+  RepFormat *repFormat = getVPS()->getVpsRepFormat( getVPS()->getVpsRepFormatIdx( m_cSPS.getUpdateRepFormatFlag() ? m_cSPS.getUpdateRepFormatIndex() : m_layerId ) );
 #else
-  RepFormat *repFormat = m_cVPS.getVpsRepFormat( m_cVPS.getVpsRepFormatIdx( m_layerId ) );
+  RepFormat *repFormat = getVPS()->getVpsRepFormat( getVPS()->getVpsRepFormatIdx( m_layerId ) );
 #endif
   Int bitDepthY,bitDepthC,picWidth,picHeight;
 
@@ -1790,6 +1867,47 @@ Void TEncTop::xInitILRP()
 }
 #endif
 
+#if ENC_LAYER_PIPELINE
+/** Block until the current picture of this layer may be encoded concurrently with the other layers.
+ * The reference layer picture of the same access unit must be completely reconstructed, and the
+ * higher layer must have resolved its inter-layer references of the previous access unit before
+ * the reference picture set of this layer is updated.
+ */
+Void TEncTop::xWaitForPipelineStart()
+{
+  Int iNumPicEncoded = m_cNumPicEncoded.get();
+
+  if( m_layerId > 0 )
+  {
+    m_ppcTEncTop[m_layerId - 1]->getNumPicEncoded().waitFor( iNumPicEncoded + 1 );
+  }
+  for( UInt layer = m_layerId + 1; layer < m_numLayer; layer++ )
+  {
+    m_ppcTEncTop[layer]->getNumPicSetUp().waitFor( iNumPicEncoded );
+  }
+}
+
+/** Signal that the inter-layer references of the current picture have been resolved
+ */
+Void TEncTop::signalPicSetUp()
+{
+  if( m_cNumPicSetUp.get() <= m_cNumPicEncoded.get() )
+  {
+    m_cNumPicSetUp.set( m_cNumPicEncoded.get() + 1 );
+  }
+}
+
+/** Block until the higher layers have completely encoded the previous access unit
+ */
+Void TEncTop::waitForHigherLayers()
+{
+  for( UInt layer = m_layerId + 1; layer < m_numLayer; layer++ )
+  {
+    m_ppcTEncTop[layer]->getNumPicEncoded().waitFor( m_cNumPicEncoded.get() );
+  }
+}
+#endif
+
 #if O0098_SCALED_REF_LAYER_ID
 Window& TEncTop::getScaledRefLayerWindowForLayer(Int layerId)
 {
@@ -43,6 +43,9 @@
 #include "TLibCommon/TComPrediction.h"
 #include "TLibCommon/TComTrQuant.h"
 #include "TLibCommon/AccessUnit.h"
+#if ENC_LAYER_PIPELINE || TOOL_THREAD_POOL
+#include "TLibCommon/TComThreadPool.h"
+#endif
 
 #include "TLibVideoIO/TVideoIOYuv.h"
 
@@ -72,6 +75,10 @@ private:
   Int                     m_iNumPicRcvd;                  ///< number of received pictures
   UInt                    m_uiNumAllPicCoded;             ///< number of coded pictures
   TComList<TComPic*>      m_cListPic;                     ///< dynamic list of pictures
+  TComCodingContext       m_cCodingContext;               ///< bit-depths and CU structure of the layer
+#if TOOL_THREAD_POOL
+  TComThreadPool*         m_pcThreadPool;                 ///< worker threads of the parallel coding tools, shared by the layers
+#endif
  
   // encoder search
   TEncSearch              m_cSearch;                      ///< encoder search class
@@ -122,8 +129,8 @@ private:
   TEncRateCtrl            m_cRateCtrl;                    ///< Rate control class
   
 #if SVC_EXTENSION
-  static Int              m_iSPSIdCnt;                    ///< next Id number for SPS    
-  static Int              m_iPPSIdCnt;                    ///< next Id number for PPS    
+  Int                     m_iSPSIdCnt;                   ///< next Id number for SPS, counted by the base layer encoder for all layers
+  Int                     m_iPPSIdCnt;                   ///< next Id number for PPS, counted by the base layer encoder for all layers
   TEncTop**               m_ppcTEncTop;
   TEncTop*                getLayerEnc(UInt layer)   { return m_ppcTEncTop[layer]; }
   TComPic*                m_cIlpPic[MAX_NUM_REF];                    ///<  Inter layer Prediction picture =  upsampled picture 
@@ -171,9 +178,16 @@ private:
   Bool                    m_pocDecrementedInDPBFlag;
   Int                     m_currPocMsb;
 #endif
+#if ENC_LAYER_PIPELINE
+  TComSyncCounter         m_cNumPicSetUp;                 ///< number of pictures whose inter-layer references are resolved
+  TComSyncCounter         m_cNumPicEncoded;               ///< number of completely encoded pictures
+#endif
 #endif //SVC_EXTENSION
 protected:
   Void  xGetNewPicBuffer  ( TComPic*& rpcPic );           ///< get picture buffer which will be processed
+#if ENC_LAYER_PIPELINE
+  Void  xWaitForPipelineStart ();                         ///< wait for the neighbouring layers before encoding a picture
+#endif
   Void  xInitSPS          ();                             ///< initialize SPS from encoder options
   Void  xInitPPS          ();                             ///< initialize PPS from encoder options
   
@@ -198,6 +212,15 @@ public:
   // -------------------------------------------------------------------------------------------------------------------
   
   TComList<TComPic*>*     getListPic            () { return  &m_cListPic;             }
+  TComCodingContext&      getCodingContext      () { return  m_cCodingContext;        }
+#if TOOL_THREAD_POOL
+  TComThreadPool*         getThreadPool         () { return  m_pcThreadPool;          }
+#if SAO_STAT_PARALLEL
+  Void                    setThreadPool         ( TComThreadPool* pcThreadPool ) { m_pcThreadPool = pcThreadPool; m_cEncSAO.setThreadPool( pcThreadPool ); }
+#else
+  Void                    setThreadPool         ( TComThreadPool* pcThreadPool ) { m_pcThreadPool = pcThreadPool; }
+#endif
+#endif
   TEncSearch*             getPredSearch         () { return  &m_cSearch;              }
   
   TComTrQuant*            getTrQuant            () { return  &m_cTrQuant;             }
@@ -205,6 +228,9 @@ public:
   TEncSampleAdaptiveOffset* getSAO              () { return  &m_cEncSAO;              }
   TEncGOP*                getGOPEncoder         () { return  &m_cGOPEncoder;          }
   TEncSlice*              getSliceEncoder       () { return  &m_cSliceEncoder;        }
+#if LOOKAHEAD_ME
+  TEncPreanalyzer*        getPreanalyzer        () { return  &m_cPreanalyzer;         }
+#endif
   TEncCu*                 getCuEncoder          () { return  &m_cCuEncoder;           }
   TEncEntropy*            getEntropyCoder       () { return  &m_cEntropyCoder;        }
   TEncCavlc*              getCavlcCoder         () { return  &m_cCavlcCoder;          }
@@ -309,6 +335,12 @@ public:
   Void setNumAddLayerSets(Int x)             { m_numAddLayerSets = x; }
   Int  getNumAddLayerSets()                  { return m_numAddLayerSets; }
 #endif
+#if ENC_LAYER_PIPELINE
+  TComSyncCounter& getNumPicSetUp()          { return m_cNumPicSetUp;   }
+  TComSyncCounter& getNumPicEncoded()        { return m_cNumPicEncoded; }
+  Void signalPicSetUp();
+  Void waitForHigherLayers();
+#endif
 #if P0297_VPS_POC_LSB_ALIGNED_FLAG
   Void setPocDecrementedInDPBFlag(Bool x)    { m_pocDecrementedInDPBFlag = x; }
   Bool getPocDecrementedInDPBFlag()          { return m_pocDecrementedInDPBFlag; }
@@ -0,0 +1,171 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncWppWorker.cpp
+    \brief    CU coding units of a CTU row encoded concurrently with the other rows
+*/
+
+#include "TEncWppWorker.h"
+#include "TEncTop.h"
+
+#if ENC_WPP_PARALLEL
+
+//! \ingroup TLibEncoder
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / create / destroy
+// ====================================================================================================================
+
+TEncWppWorker::TEncWppWorker()
+: m_pppcRDSbacCoder   ( NULL )
+, m_pppcBinCoderCABAC ( NULL )
+{
+  m_cRDGoOnSbacCoder.init( &m_cRDGoOnBinCoderCABAC );
+}
+
+TEncWppWorker::~TEncWppWorker()
+{
+}
+
+/** allocate the coding units of a CTU row the same way as the ones of the layer encoder
+ * \param pcEncTop encoder of the layer
+ */
+Void TEncWppWorker::create( TEncTop* pcEncTop )
+{
+  m_cCuEncoder.create( g_uiMaxCUDepth, g_uiMaxCUWidth, g_uiMaxCUHeight );
+
+  m_pppcRDSbacCoder = new TEncSbac** [g_uiMaxCUDepth+1];
+#if FAST_BIT_EST
+  m_pppcBinCoderCABAC = new TEncBinCABACCounter** [g_uiMaxCUDepth+1];
+#else
+  m_pppcBinCoderCABAC = new TEncBinCABAC** [g_uiMaxCUDepth+1];
+#endif
+
+  for ( Int iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    m_pppcRDSbacCoder[iDepth] = new TEncSbac* [CI_NUM];
+#if FAST_BIT_EST
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABACCounter* [CI_NUM];
+#else
+    m_pppcBinCoderCABAC[iDepth] = new TEncBinCABAC* [CI_NUM];
+#endif
+
+    for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
+    {
+      m_pppcRDSbacCoder[iDepth][iCIIdx] = new TEncSbac;
+#if FAST_BIT_EST
+      m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABACCounter;
+#else
+      m_pppcBinCoderCABAC [iDepth][iCIIdx] = new TEncBinCABAC;
+#endif
+      m_pppcRDSbacCoder   [iDepth][iCIIdx]->init( m_pppcBinCoderCABAC [iDepth][iCIIdx] );
+    }
+  }
+
+  m_cCuEncoder.init( pcEncTop, &m_cSearch, &m_cTrQuant, &m_cBitCounter, &m_cRdCost, &m_cEntropyCoder, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+
+  m_cTrQuant.init( 1 << pcEncTop->getQuadtreeTULog2MaxSize(),
+                  pcEncTop->getUseRDOQ(),
+                  pcEncTop->getUseRDOQTS(),
+                  true
+                  ,pcEncTop->getUseTransformSkipFast()
+#if ADAPTIVE_QP_SELECTION
+                  , pcEncTop->getUseAdaptQpSelect()
+#endif
+#if FAST_RDOQ
+                  , pcEncTop->getUseRDOQFast()
+#endif
+                  );
+
+#if PARALLEL_ME
+  // the CTU rows already run concurrently, further ME threads per worker would oversubscribe the CPUs
+  m_cSearch.setUseMEHelpers( false );
+#endif
+  m_cSearch.init( pcEncTop, &m_cTrQuant, pcEncTop->getSearchRange(), pcEncTop->getBipredSearchRange(), pcEncTop->getFastSearch(), 0, &m_cEntropyCoder, &m_cRdCost, m_pppcRDSbacCoder, &m_cRDGoOnSbacCoder );
+}
+
+Void TEncWppWorker::destroy()
+{
+  m_cCuEncoder.destroy();
+
+  if ( m_pppcRDSbacCoder == NULL )
+  {
+    return;
+  }
+  for ( Int iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    for (Int iCIIdx = 0; iCIIdx < CI_NUM; iCIIdx ++ )
+    {
+      delete m_pppcRDSbacCoder[iDepth][iCIIdx];
+      delete m_pppcBinCoderCABAC[iDepth][iCIIdx];
+    }
+  }
+
+  for ( Int iDepth = 0; iDepth < g_uiMaxCUDepth+1; iDepth++ )
+  {
+    delete [] m_pppcRDSbacCoder[iDepth];
+    delete [] m_pppcBinCoderCABAC[iDepth];
+  }
+
+  delete [] m_pppcRDSbacCoder;
+  delete [] m_pppcBinCoderCABAC;
+  m_pppcRDSbacCoder   = NULL;
+  m_pppcBinCoderCABAC = NULL;
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+/** copy the slice settings that the slice and GOP encoders set on the classes of the layer encoder
+ * \param pcEncTop encoder of the layer
+ */
+Void TEncWppWorker::initSlice( TEncTop* pcEncTop )
+{
+  m_cRdCost = *pcEncTop->getRdCost();
+  m_cTrQuant.copySliceSettings( pcEncTop->getTrQuant() );
+
+  for ( Int iDir = 0; iDir < 2; iDir++ )
+  {
+    for ( Int iRefIdx = 0; iRefIdx < 33; iRefIdx++ )
+    {
+      m_cSearch.setAdaptiveSearchRange( iDir, iRefIdx, pcEncTop->getPredSearch()->getAdaptiveSearchRange( iDir, iRefIdx ) );
+    }
+  }
+}
+
+//! \}
+
+#endif // ENC_WPP_PARALLEL
@@ -0,0 +1,102 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.  
+ *
+ * Copyright (c) 2010-2014, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TEncWppWorker.h
+    \brief    CU coding units of a CTU row encoded concurrently with the other rows (header)
+*/
+
+#ifndef __TENCWPPWORKER__
+#define __TENCWPPWORKER__
+
+// Include files
+#include "TLibCommon/CommonDef.h"
+#include "TLibCommon/TComTrQuant.h"
+#include "TLibCommon/TComRdCost.h"
+#include "TLibCommon/TComBitCounter.h"
+#include "TEncEntropy.h"
+#include "TEncSbac.h"
+#include "TEncBinCoderCABACCounter.h"
+#include "TEncSearch.h"
+#include "TEncCu.h"
+
+#if ENC_WPP_PARALLEL
+
+//! \ingroup TLibEncoder
+//! \{
+
+class TEncTop;
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// private copy of the CU encoder and of the classes it uses, one per CTU row coded at the same time
+class TEncWppWorker
+{
+private:
+  TEncCu                  m_cCuEncoder;                   ///< CU encoder
+  TEncSearch              m_cSearch;                      ///< encoder search class
+  TComTrQuant             m_cTrQuant;                     ///< transform & quantization class
+  TComRdCost              m_cRdCost;                      ///< RD cost computation class
+  TEncEntropy             m_cEntropyCoder;                ///< entropy encoder
+  TComBitCounter          m_cBitCounter;                  ///< bit counter for RD optimization
+  TEncSbac***             m_pppcRDSbacCoder;              ///< temporal storage for RD computation
+  TEncSbac                m_cRDGoOnSbacCoder;             ///< going on SBAC model for RD stage
+#if FAST_BIT_EST
+  TEncBinCABACCounter***  m_pppcBinCoderCABAC;            ///< temporal CABAC state storage for RD computation
+  TEncBinCABACCounter     m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+#else
+  TEncBinCABAC***         m_pppcBinCoderCABAC;            ///< temporal CABAC state storage for RD computation
+  TEncBinCABAC            m_cRDGoOnBinCoderCABAC;         ///< going on bin coder CABAC for RD stage
+#endif
+
+public:
+  TEncWppWorker();
+  virtual ~TEncWppWorker();
+
+  Void  create            ( TEncTop* pcEncTop );
+  Void  destroy           ();
+  Void  initSlice         ( TEncTop* pcEncTop );          ///< take over the lambdas, quantization matrices and search ranges of the slice
+
+  TEncCu*                 getCuEncoder          () { return  &m_cCuEncoder;           }
+  TEncEntropy*            getEntropyCoder       () { return  &m_cEntropyCoder;        }
+  TEncSbac***             getRDSbacCoder        () { return  m_pppcRDSbacCoder;       }
+  TEncSbac*               getRDGoOnSbacCoder    () { return  &m_cRDGoOnSbacCoder;     }
+};// END CLASS DEFINITION TEncWppWorker
+
+//! \}
+
+#endif // ENC_WPP_PARALLEL
+
+#endif // __TENCWPPWORKER__
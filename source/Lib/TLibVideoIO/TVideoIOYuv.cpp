@@ -44,6 +44,13 @@
 
 #include "TLibCommon/TComRom.h"
 #include "TVideoIOYuv.h"
+#if FAST_YUV_IO
+#include <cstring>
+#include "TLibCommon/TComSimd.h"
+#if SIMD_X86
+#include <immintrin.h>
+#endif
+#endif
 
 using namespace std;
 
@@ -129,6 +136,172 @@ static void scalePlane(Pel* img, UInt stride, UInt width, UInt height,
   }
 }
 
+#if FAST_YUV_IO
+/**
+ * Scale one sample as scalePlane() does.
+ */
+static inline Pel scaleSample(Pel val, Int shiftbits, Pel minval, Pel maxval)
+{
+  if (shiftbits > 0)
+  {
+    return val << shiftbits;
+  }
+  if (shiftbits < 0)
+  {
+    Pel offset = 1 << (-shiftbits-1);
+    Pel scaled = (val + offset) >> -shiftbits;
+    return Clip3(minval, maxval, scaled);
+  }
+  return val;
+}
+
+#if SIMD_X86
+/**
+ * Vectorised scalePlane() of 8 samples.
+ */
+SIMD_TARGET_SSE41
+static inline __m128i scaleSamplesSSE41(__m128i val, Int shiftbits, __m128i minval, __m128i maxval)
+{
+  if (shiftbits > 0)
+  {
+    return _mm_sll_epi16(val, _mm_cvtsi32_si128(shiftbits));
+  }
+  if (shiftbits < 0)
+  {
+    // 32-bit sums as in invScalePlane(), the shifted values fit in 16 bits
+    const __m128i shift  = _mm_cvtsi32_si128(-shiftbits);
+    const __m128i offset = _mm_set1_epi32((Short)(1 << (-shiftbits-1)));
+    __m128i lo = _mm_sra_epi32(_mm_add_epi32(_mm_cvtepi16_epi32(val), offset), shift);
+    __m128i hi = _mm_sra_epi32(_mm_add_epi32(_mm_cvtepi16_epi32(_mm_srli_si128(val, 8)), offset), shift);
+    return _mm_min_epi16(_mm_max_epi16(_mm_packs_epi32(lo, hi), minval), maxval);
+  }
+  return val;
+}
+
+/**
+ * Vectorised part of unpackPlane() for one row, returns the number of samples converted.
+ */
+SIMD_TARGET_SSE41
+static UInt unpackRowSSE41(Pel* dst, const UChar* src, Bool is16bit, UInt width, Int shiftbits, Pel minval, Pel maxval)
+{
+  const __m128i vMin = _mm_set1_epi16(minval);
+  const __m128i vMax = _mm_set1_epi16(maxval);
+  UInt x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    __m128i val = is16bit ? _mm_loadu_si128((const __m128i*)(src + 2*x))
+                          : _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i*)(src + x)));
+    _mm_storeu_si128((__m128i*)(dst + x), scaleSamplesSSE41(val, shiftbits, vMin, vMax));
+  }
+  return x;
+}
+
+/**
+ * Vectorised part of packPlane() for one row, returns the number of samples converted.
+ */
+SIMD_TARGET_SSE41
+static UInt packRowSSE41(UChar* dst, const Pel* src, Bool is16bit, UInt width, Int shiftbits, Pel minval, Pel maxval)
+{
+  const __m128i vMin = _mm_set1_epi16(minval);
+  const __m128i vMax = _mm_set1_epi16(maxval);
+  const __m128i vLowByte = _mm_set1_epi16(0xff);
+  UInt x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    __m128i val = scaleSamplesSSE41(_mm_loadu_si128((const __m128i*)(src + x)), shiftbits, vMin, vMax);
+    if (is16bit)
+    {
+      _mm_storeu_si128((__m128i*)(dst + 2*x), val);
+    }
+    else
+    {
+      _mm_storel_epi64((__m128i*)(dst + x), _mm_packus_epi16(_mm_and_si128(val, vLowByte), val));
+    }
+  }
+  return x;
+}
+#endif
+
+/**
+ * Convert width*height file samples (8bit or 16bit little-endian words)
+ * from src into dst, scale them by 2<sup>shiftbits</sup> and pad the right
+ * and bottom edges by edge-extension: readPlane() followed by scalePlane()
+ * in one pass.
+ */
+static Void unpackPlane(Pel* dst, const UChar* src, Bool is16bit,
+                        UInt stride,
+                        UInt width, UInt height,
+                        UInt pad_x, UInt pad_y,
+                        Int shiftbits, Pel minval, Pel maxval)
+{
+  const UInt srcStride = width * (is16bit ? 2 : 1);
+  for (UInt y = 0; y < height; y++)
+  {
+    UInt x = 0;
+#if SIMD_X86
+    if (getSimdLevel() >= SIMD_SSE41)
+    {
+      x = unpackRowSSE41(dst, src, is16bit, width, shiftbits, minval, maxval);
+    }
+#endif
+    for (; x < width; x++)
+    {
+      Pel val = is16bit ? (Pel)((src[2*x+1] << 8) | src[2*x]) : (Pel)src[x];
+      dst[x] = scaleSample(val, shiftbits, minval, maxval);
+    }
+    for (x = width; x < width + pad_x; x++)
+    {
+      dst[x] = dst[width - 1];
+    }
+    dst += stride;
+    src += srcStride;
+  }
+  for (UInt y = height; y < height + pad_y; y++)
+  {
+    memcpy(dst, dst - stride, (width + pad_x) * sizeof(Pel));
+    dst += stride;
+  }
+}
+
+/**
+ * Scale width*height samples of src by 2<sup>shiftbits</sup> and store
+ * them in dst as file samples (8bit or 16bit little-endian words):
+ * scalePlane() of a copy followed by writePlane() in one pass.
+ */
+static Void packPlane(UChar* dst, const Pel* src, Bool is16bit,
+                      UInt stride,
+                      UInt width, UInt height,
+                      Int shiftbits, Pel minval, Pel maxval)
+{
+  const UInt dstStride = width * (is16bit ? 2 : 1);
+  for (UInt y = 0; y < height; y++)
+  {
+    UInt x = 0;
+#if SIMD_X86
+    if (getSimdLevel() >= SIMD_SSE41)
+    {
+      x = packRowSSE41(dst, src, is16bit, width, shiftbits, minval, maxval);
+    }
+#endif
+    for (; x < width; x++)
+    {
+      Pel val = scaleSample(src[x], shiftbits, minval, maxval);
+      if (is16bit)
+      {
+        dst[2*x]   = val & 0xff;
+        dst[2*x+1] = (val >> 8) & 0xff;
+      }
+      else
+      {
+        dst[x] = (UChar)val;
+      }
+    }
+    dst += dstStride;
+    src += stride;
+  }
+}
+#endif
+
 
 // ====================================================================================================================
 // Public member functions
@@ -184,19 +357,95 @@ Void TVideoIOYuv::open( Char* pchFile, Bool bWriteMode, Int fileBitDepthY, Int f
 
 Void TVideoIOYuv::close()
 {
+#if FAST_YUV_IO
+  xStopReadAhead();
+#endif
   m_cHandle.close();
 }
 
 Bool TVideoIOYuv::isEof()
 {
+#if FAST_YUV_IO
+  if (m_iReadAhead > 0)
+  {
+    return m_bReadEof;
+  }
+#endif
   return m_cHandle.eof();
 }
 
 Bool TVideoIOYuv::isFail()
 {
+#if FAST_YUV_IO
+  if (m_iReadAhead > 0)
+  {
+    return m_bReadEof;
+  }
+#endif
   return m_cHandle.fail();
 }
 
+#if FAST_YUV_IO
+/**
+ * Read frames of uiFrameSize bytes until the end of the file, keeping at
+ * most m_iReadAhead of them queued in m_cReadFrames.
+ */
+Void TVideoIOYuv::xReadAheadLoop( size_t uiFrameSize )
+{
+  for (;;)
+  {
+    std::vector<UChar> cFrame;
+    {
+      std::unique_lock<std::mutex> cLock( m_cReadMutex );
+      m_cReadCond.wait( cLock, [this]{ return m_bReadStop || (Int)m_cReadFrames.size() < m_iReadAhead; } );
+      if (m_bReadStop)
+      {
+        return;
+      }
+      if (!m_cFreeFrames.empty())
+      {
+        cFrame.swap( m_cFreeFrames.front() );
+        m_cFreeFrames.pop_front();
+      }
+    }
+
+    cFrame.resize( uiFrameSize );
+    m_cHandle.read( reinterpret_cast<Char*>(&cFrame[0]), uiFrameSize );
+    const Bool bEof = m_cHandle.eof() || m_cHandle.fail();
+    if (bEof)
+    {
+      cFrame.clear();
+    }
+
+    std::lock_guard<std::mutex> cLock( m_cReadMutex );
+    m_cReadFrames.push_back( std::vector<UChar>() );
+    m_cReadFrames.back().swap( cFrame );
+    m_cReadCond.notify_all();
+    if (bEof)
+    {
+      return;
+    }
+  }
+}
+
+Void TVideoIOYuv::xStopReadAhead()
+{
+  if (m_cReadThread.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> cLock( m_cReadMutex );
+      m_bReadStop = true;
+    }
+    m_cReadCond.notify_all();
+    m_cReadThread.join();
+  }
+  m_cReadFrames.clear();
+  m_cFreeFrames.clear();
+  m_bReadStop = false;
+  m_bReadEof  = false;
+}
+#endif
+
 /**
  * Skip numFrames in input.
  *
@@ -227,6 +476,7 @@ void TVideoIOYuv::skipFrames(UInt numFrames, UInt width, UInt height)
   m_cHandle.read(buf, offset_mod_bufsize);
 }
 
+#if !FAST_YUV_IO
 /**
  * Read width*height pixels from fd into dst, optionally
  * padding the left and right edges by edge-extension.  Input may be
@@ -338,6 +588,8 @@ static Bool writePlane(ostream& fd, Pel* src, Bool is16bit,
   return true;
 }
 
+#endif
+
 static Bool writeField(ostream& fd, Pel* top, Pel* bottom, Bool is16bit,
                        UInt stride,
                        UInt width, UInt height, bool isTff)
@@ -428,6 +680,55 @@ Bool TVideoIOYuv::read ( TComPicYuv*  pPicYuv, Int aiPad[2] )
   }
 #endif
   
+#if FAST_YUV_IO
+  // read the file samples of the whole frame at once
+  const size_t lumaSize   = (size_t)width * height * (is16bit ? 2 : 1);
+  const size_t chromaSize = (size_t)(width >> 1) * (height >> 1) * (is16bit ? 2 : 1);
+  const size_t frameSize  = lumaSize + 2 * chromaSize;
+  if (m_iReadAhead > 0)
+  {
+    if (m_bReadEof)
+    {
+      return false;
+    }
+    if (!m_cReadThread.joinable())
+    {
+      m_cReadThread = std::thread( &TVideoIOYuv::xReadAheadLoop, this, frameSize );
+    }
+    std::unique_lock<std::mutex> cLock( m_cReadMutex );
+    m_cReadCond.wait( cLock, [this]{ return !m_cReadFrames.empty(); } );
+    m_cFrameBuf.swap( m_cReadFrames.front() );
+    m_cReadFrames.pop_front();
+    if (m_cFrameBuf.empty())
+    {
+      m_bReadEof = true;
+      return false;
+    }
+  }
+  else
+  {
+    m_cFrameBuf.resize( frameSize );
+    m_cHandle.read( reinterpret_cast<Char*>(&m_cFrameBuf[0]), frameSize );
+    if (m_cHandle.eof() || m_cHandle.fail())
+    {
+      return false;
+    }
+  }
+
+  unpackPlane(pPicYuv->getLumaAddr(), &m_cFrameBuf[0], is16bit, iStride, width, height, pad_h, pad_v, m_bitDepthShiftY, minvalY, maxvalY);
+  unpackPlane(pPicYuv->getCbAddr(), &m_cFrameBuf[lumaSize], is16bit, iStride >> 1, width >> 1, height >> 1, pad_h >> 1, pad_v >> 1, m_bitDepthShiftC, minvalC, maxvalC);
+  unpackPlane(pPicYuv->getCrAddr(), &m_cFrameBuf[lumaSize + chromaSize], is16bit, iStride >> 1, width >> 1, height >> 1, pad_h >> 1, pad_v >> 1, m_bitDepthShiftC, minvalC, maxvalC);
+
+  if (m_iReadAhead > 0)
+  {
+    // give the buffer back to the read-ahead thread
+    std::lock_guard<std::mutex> cLock( m_cReadMutex );
+    m_cFreeFrames.push_back( std::vector<UChar>() );
+    m_cFreeFrames.back().swap( m_cFrameBuf );
+    m_cReadCond.notify_all();
+  }
+  return true;
+#else
   if (! readPlane(pPicYuv->getLumaAddr(), m_cHandle, is16bit, iStride, width, height, pad_h, pad_v))
     return false;
   scalePlane(pPicYuv->getLumaAddr(), iStride, width_full, height_full, m_bitDepthShiftY, minvalY, maxvalY);
@@ -449,6 +750,7 @@ Bool TVideoIOYuv::read ( TComPicYuv*  pPicYuv, Int aiPad[2] )
   scalePlane(pPicYuv->getCrAddr(), iStride, width_full, height_full, m_bitDepthShiftC, minvalC, maxvalC);
 
   return true;
+#endif
 }
 
 /**
@@ -466,14 +768,48 @@ Bool TVideoIOYuv::write( TComPicYuv* pPicYuv, Int confLeft, Int confRight, Int c
   UInt  width  = pPicYuv->getWidth()  - confLeft - confRight;
   UInt  height = pPicYuv->getHeight() - confTop  - confBottom;
   Bool is16bit = m_fileBitDepthY > 8 || m_fileBitDepthC > 8;
+#if !FAST_YUV_IO
   TComPicYuv *dstPicYuv = NULL;
   Bool retval = true;
+#endif
 
   if ((width==0)||(height==0))
   {
     printf ("\nWarning: writing %d x %d luma sample output picture!", width, height);
   }
 
+#if FAST_YUV_IO
+  Pel minvalY = 0;
+  Pel minvalC = 0;
+  Pel maxvalY = (1 << m_fileBitDepthY) - 1;
+  Pel maxvalC = (1 << m_fileBitDepthC) - 1;
+#if CLIP_TO_709_RANGE
+  if (-m_bitDepthShiftY < 0 && m_fileBitDepthY >= 8)
+  {
+    /* ITU-R BT.709 compliant clipping for converting say 10b to 8b */
+    minvalY = 1 << (m_fileBitDepthY - 8);
+    maxvalY = (0xff << (m_fileBitDepthY - 8)) -1;
+  }
+  if (-m_bitDepthShiftC < 0 && m_fileBitDepthC >= 8)
+  {
+    /* ITU-R BT.709 compliant clipping for converting say 10b to 8b */
+    minvalC = 1 << (m_fileBitDepthC - 8);
+    maxvalC = (0xff << (m_fileBitDepthC - 8)) -1;
+  }
+#endif
+  // convert the samples of the whole frame, then write them at once
+  const size_t lumaSize   = (size_t)width * height * (is16bit ? 2 : 1);
+  const size_t chromaSize = (size_t)(width >> 1) * (height >> 1) * (is16bit ? 2 : 1);
+  m_cFrameBuf.resize( lumaSize + 2 * chromaSize + 1 );
+  packPlane(&m_cFrameBuf[0], pPicYuv->getLumaAddr() + confLeft + confTop * iStride, is16bit, iStride, width, height, -m_bitDepthShiftY, minvalY, maxvalY);
+  iStride >>= 1;
+  Int planeOffset = (confLeft >> 1) + (confTop >> 1) * iStride;
+  packPlane(&m_cFrameBuf[lumaSize], pPicYuv->getCbAddr() + planeOffset, is16bit, iStride, width >> 1, height >> 1, -m_bitDepthShiftC, minvalC, maxvalC);
+  packPlane(&m_cFrameBuf[lumaSize + chromaSize], pPicYuv->getCrAddr() + planeOffset, is16bit, iStride, width >> 1, height >> 1, -m_bitDepthShiftC, minvalC, maxvalC);
+
+  m_cHandle.write( reinterpret_cast<Char*>(&m_cFrameBuf[0]), lumaSize + 2 * chromaSize );
+  return !(m_cHandle.eof() || m_cHandle.fail());
+#else
   if (m_bitDepthShiftY != 0 || m_bitDepthShiftC != 0)
   {
     dstPicYuv = new TComPicYuv;
@@ -547,6 +883,7 @@ exit:
     delete dstPicYuv;
   }  
   return retval;
+#endif
 }
 
 
@@ -43,6 +43,13 @@
 #include <iostream>
 #include "TLibCommon/CommonDef.h"
 #include "TLibCommon/TComPicYuv.h"
+#if FAST_YUV_IO
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
 
 using namespace std;
 
@@ -59,13 +66,35 @@ private:
   Int m_fileBitDepthC; ///< bitdepth of input/output video file chroma component
   Int m_bitDepthShiftY;  ///< number of bits to increase or decrease luma by before/after write/read
   Int m_bitDepthShiftC;  ///< number of bits to increase or decrease chroma by before/after write/read
+#if FAST_YUV_IO
+  std::vector<UChar>               m_cFrameBuf;             ///< file samples of the frame read or written
+  Int                              m_iReadAhead;            ///< number of frames read ahead in m_cReadThread, 0: frames are read when requested
+  std::thread                      m_cReadThread;
+  std::mutex                       m_cReadMutex;
+  std::condition_variable          m_cReadCond;             ///< signalled when a frame is queued or a buffer is released
+  std::deque< std::vector<UChar> > m_cReadFrames;           ///< frames read ahead, an empty frame marks the end of the file
+  std::deque< std::vector<UChar> > m_cFreeFrames;           ///< buffers of the frames already converted
+  Bool                             m_bReadStop;
+  Bool                             m_bReadEof;              ///< the end of the file was taken from m_cReadFrames
+
+  Void  xReadAheadLoop  ( size_t uiFrameSize );
+  Void  xStopReadAhead  ();
+#endif
   
 public:
+#if FAST_YUV_IO
+  TVideoIOYuv() : m_iReadAhead( 0 ), m_bReadStop( false ), m_bReadEof( false ) {}
+  virtual ~TVideoIOYuv()  { xStopReadAhead(); }
+#else
   TVideoIOYuv()           {}
   virtual ~TVideoIOYuv()  {}
+#endif
   
   Void  open  ( Char* pchFile, Bool bWriteMode, Int fileBitDepthY, Int fileBitDepthC, Int internalBitDepthY, Int internalBitDepthC ); ///< open or create file
   Void  close ();                                           ///< close file
+#if FAST_YUV_IO
+  Void  setReadAhead ( Int iNumFrames )  { m_iReadAhead = iNumFrames; }   ///< read up to iNumFrames frames ahead of read() in a background thread, set before the first read()
+#endif
 
   void skipFrames(UInt numFrames, UInt width, UInt height);
   